@@ -43,9 +43,25 @@ LibKY_Tools_Header = \
     $${LibKY_Tools_Dir}/ky_vector.h \
     $${LibKY_Tools_Dir}/ky_uuid.h \
     $${LibKY_Tools_Dir}/ky_url.h \
+    $${LibKY_Tools_Dir}/ky_url_view.h \
+    $${LibKY_Tools_Dir}/ky_url_view.inl \
     $${LibKY_Tools_Dir}/ky_typeinfo.h \
     $${LibKY_Tools_Dir}/ky_timer.h \
     $${LibKY_Tools_Dir}/ky_string.h \
+    $${LibKY_Tools_Dir}/ky_stringview.h \
+    $${LibKY_Tools_Dir}/ky_stringview.inl \
+    $${LibKY_Tools_Dir}/ky_search.h \
+    $${LibKY_Tools_Dir}/ky_search.inl \
+    $${LibKY_Tools_Dir}/ky_number.h \
+    $${LibKY_Tools_Dir}/ky_number.inl \
+    $${LibKY_Tools_Dir}/ky_u8string.h \
+    $${LibKY_Tools_Dir}/ky_u8string.inl \
+    $${LibKY_Tools_Dir}/ky_format.h \
+    $${LibKY_Tools_Dir}/ky_format.inl \
+    $${LibKY_Tools_Dir}/ky_atom.h \
+    $${LibKY_Tools_Dir}/ky_atom.inl \
+    $${LibKY_Tools_Dir}/ky_utf.h \
+    $${LibKY_Tools_Dir}/ky_utf.inl \
     $${LibKY_Tools_Dir}/ky_stream.h \
     $${LibKY_Tools_Dir}/ky_stack.h \
     $${LibKY_Tools_Dir}/ky_queue.h \
@@ -55,23 +71,45 @@ LibKY_Tools_Header = \
     $${LibKY_Tools_Dir}/ky_mapdata.h \
     $${LibKY_Tools_Dir}/ky_map.h \
     $${LibKY_Tools_Dir}/ky_hash_map.h \
+    $${LibKY_Tools_Dir}/ky_flat_hash_map.h \
+    $${LibKY_Tools_Dir}/ky_concurrent_hash_map.h \
+    $${LibKY_Tools_Dir}/ky_btree_map.h \
+    $${LibKY_Tools_Dir}/ky_persistent_map.h \
+    $${LibKY_Tools_Dir}/ky_lockfree_stack.h \
+    $${LibKY_Tools_Dir}/ky_sort.h \
+    $${LibKY_Tools_Dir}/ky_parallel.h \
     $${LibKY_Tools_Dir}/ky_list.h \
     $${LibKY_Tools_Dir}/ky_linked.h \
     $${LibKY_Tools_Dir}/ky_color.h \
     $${LibKY_Tools_Dir}/ky_image.h \
     $${LibKY_Tools_Dir}/ky_datetime.h \
     $${LibKY_Tools_Dir}/ky_array.h \
+    $${LibKY_Tools_Dir}/ky_small_array.h \
+    $${LibKY_Tools_Dir}/ky_small_vector.h \
     $${LibKY_Tools_Dir}/ky_vector.inl \
     $${LibKY_Tools_Dir}/ky_stream.inl \
     $${LibKY_Tools_Dir}/ky_map.inl \
     $${LibKY_Tools_Dir}/ky_list.inl \
     $${LibKY_Tools_Dir}/ky_linked.inl \
     $${LibKY_Tools_Dir}/ky_array.inl \
+    $${LibKY_Tools_Dir}/ky_small_array.inl \
+    $${LibKY_Tools_Dir}/ky_small_vector.inl \
     $${LibKY_Tools_Dir}/ky_hash_map.inl \
+    $${LibKY_Tools_Dir}/ky_flat_hash_map.inl \
+    $${LibKY_Tools_Dir}/ky_concurrent_hash_map.inl \
+    $${LibKY_Tools_Dir}/ky_btree_map.inl \
+    $${LibKY_Tools_Dir}/ky_persistent_map.inl \
+    $${LibKY_Tools_Dir}/ky_lockfree_stack.inl \
+    $${LibKY_Tools_Dir}/ky_sort.inl \
+    $${LibKY_Tools_Dir}/ky_parallel.inl \
     $${LibKY_Tools_Dir}/ky_bitset.h \
     $${LibKY_Tools_Dir}/ky_bitset.inl \
+    $${LibKY_Tools_Dir}/ky_dynbitset.h \
+    $${LibKY_Tools_Dir}/ky_dynbitset.inl \
     $${LibKY_Tools_Dir}/ky_signal.inl \
     $${LibKY_Tools_Dir}/ky_regex.h  \
+    $${LibKY_Tools_Dir}/ky_regex_dfa.h  \
+    $${LibKY_Tools_Dir}/ky_regex_dfa.inl  \
     $${LibKY_Tools_Dir}/ky_variant.h
 
 LibKY_Network_Dir = $${LibKY_Dir}/network
@@ -99,6 +137,7 @@ LibKY_Header = \
     $${LibKY_Dir}/ky_atomic.h \
     $${LibKY_Dir}/ky_atomic.inl \
     $${LibKY_Dir}/ky_thread.h \
+    $${LibKY_Dir}/ky_thread_pool.h \
     $${LibKY_Dir}/ky_debug.h \
     $${LibKY_Dir}/ky_ptr.h \
     $${LibKY_Dir}/ky_utils.h \
@@ -14,7 +14,7 @@
  *
  * @author   kunyang
  * @email    kunyang.yk@gmail.com
- * @version  1.3.2.2
+ * @version  1.3.2.3
  * @date     2012/04/01
  * @license  GNU General Public License (GPL)
  *
@@ -31,6 +31,7 @@
  * 2017/08/20 | 1.3.1.1   | kunyang  | 在类中加入编译器编译断言
  * 2018/02/22 | 1.3.2.1   | kunyang  | 修改比较交换引用错误
  * 2018/03/09 | 1.3.2.2   | kunyang  | 修改windows下编译时setne指令错误
+ * 2026/10/18 | 1.3.2.3   | kunyang  | 修改load按值传参，读取不在内存屏障内的错误
  */
 
 #ifndef KY_ATOMIC
@@ -174,11 +175,12 @@ struct atomic_base
         return _v;
     }
 
+    //! 按引用传入，由原子操作读取原值，按值传入时读取在调用前已完成
     template <typename T>
-    static T load(T _v, eMemoryFences mf= Fence_Relaxed)
+    static T load(const T &_v, eMemoryFences mf= Fence_Relaxed)
     {
         T lv;
-        kyArchAtomics[sizeof(T)]->load (&_v, &lv, mf);
+        kyArchAtomics[sizeof(T)]->load ((void *)&_v, &lv, mf);
         return lv;
     }
 
@@ -9,10 +9,12 @@
  *       2.全局日志功能打印
  *       3.加入日志和调试信息过滤配置
  *       4.统一所有程序的断言
+ *       5.调用点限流(令牌桶)和采样输出
+ *       6.log_xxx_fmt 使用ky_format格式，编译期检查参数个数
  *
  * @author   kunyang
  * @email    kunyang.yk@gmail.com
- * @version  1.1.2.0
+ * @version  1.1.4.1
  * @date     2012/04/01
  * @license  GNU General Public License (GPL)
  *
@@ -23,6 +25,9 @@
  * 2014/03/10 | 1.0.2.0   | kunyang  | 加入日志打印方式
  * 2014/04/06 | 1.1.0.1   | kunyang  | 修改日志模式为统一方式实现
  * 2015/06/06 | 1.1.2.0   | kunyang  | 修改日志打印函数并加入日志等级过滤
+ * 2026/10/18 | 1.1.3.0   | kunyang  | 加入调用点令牌桶限流和采样，输出丢弃计数
+ * 2026/10/18 | 1.1.4.0   | kunyang  | 加入ky_format格式的日志宏
+ * 2026/10/18 | 1.1.4.1   | kunyang  | 规则表变更时清空调用点规则，定时报告丢弃及采样跳过计数
  *
  */
 #ifndef KY_DEBUG_H
@@ -30,12 +35,19 @@
 #include "ky_define.h"
 #include "tools/ky_stream.h"
 #include "tools/ky_string.h"
+#include "tools/ky_format.h"
 
 #if defined(kyHasLog) || defined(kyHasDebug)
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <pthread.h>
+
+//! 限流丢弃及采样跳过计数的定时报告周期(毫秒)
+#ifndef kyLogFlushPeriod
+#define kyLogFlushPeriod 1000
+#endif
 
 typedef enum log_level {
     Log_Fatal = 0,   ///< 致命
@@ -61,6 +73,76 @@ public:
     };
     struct config{int level[Log_Count];};
 
+    //!
+    //! \brief The limit struct 调用点限流配置，和filter一起通过append加入
+    //!
+    struct limit
+    {
+        int rate;      ///< 每个周期补充的令牌数，0为不限制
+        int period;    ///< 令牌补充周期(毫秒)，0为默认1000ms
+        int burst;     ///< 令牌桶容量，0为等于rate
+        int sample;    ///< 采样输出，每N条输出1条，0或1为全部输出
+    };
+
+    //!
+    //! \brief The limit_rule struct 限流规则，属于某个版本的规则表，发布后不再修改
+    //!
+    struct limit_rule
+    {
+        filter flt;
+        limit lmt;
+        int handle;
+        int stamp;       ///< 所属规则表的版本
+        int64 interval;  ///< 每个令牌的间隔(纳秒)
+        int64 tolerance; ///< 桶容量允许的提前量(纳秒)
+    };
+    //!
+    //! \brief The limit_table struct 限流规则表，变更时复制出新表并原子替换表头
+    //! \note 旧表链接在prev上不释放，调用点可无锁持有其中的规则
+    //!        rules[0]为不限流规则，rules[1...count]为加入的规则
+    //!
+    struct limit_table
+    {
+        limit_table *prev;
+        int stamp;
+        int serial;
+        int count;
+        limit_rule rules[1];
+    };
+
+    //!
+    //! \brief The site struct 日志调用点状态，由日志宏在每个调用点静态定义
+    //! \note 首次调用时登记到调用点链表，规则表变更时清空各调用点的规则指针，
+    //!        之后由resolve重新匹配
+    //!
+    struct site
+    {
+        const char *file;
+        int line;
+        const char *func;
+        const char *subs;
+
+        const limit_rule *rule; ///< 匹配的限流规则，为空时需重新匹配
+        int64 tat;              ///< 令牌桶的理论到达时间(纳秒)
+        int64 seen;             ///< 采样计数
+        int64 dropped;          ///< 限流丢弃计数
+        int64 skipped;          ///< 采样跳过计数
+        site *next;             ///< 调用点链表
+        int linked;             ///< 是否已登记
+
+        //!
+        //! \brief pass 返回本次调用是否允许输出
+        //! \note 没有限流和采样时只读取一次规则指针；限流时每条输出
+        //!       还需读取一次时钟并以CAS更新令牌桶
+        //! \return
+        //!
+        inline bool pass();
+        //!
+        //! \brief report 输出并清零丢弃及跳过计数
+        //!
+        inline void report();
+    };
+
 public:
     ky_debug(const char* fn = NULL, bool clr = true);
     ~ky_debug();
@@ -75,6 +157,39 @@ public:
 
     static bool relog(const char* fn = NULL, bool clr = true);
 
+    // limit operate
+    //!
+    //! \brief append 加入调用点限流规则，匹配方式同filter
+    //! \param flt 匹配条件，空字符串或行号小于0时不参与匹配
+    //! \param lmt 限流和采样配置
+    //! \return 规则句柄
+    //!
+    static inline int append(const filter &flt, const limit &lmt);
+    static inline void remove_limit(int h);
+    static inline void clear_limit();
+    //!
+    //! \brief flush_limit 报告全部调用点的丢弃及跳过计数
+    //! \note 加入限流或采样规则后由后台线程每kyLogFlushPeriod毫秒调用一次
+    //!
+    static inline void flush_limit();
+
+    //!
+    //! \brief limiter 当前的限流规则表
+    //! \return
+    //!
+    static inline limit_table *limiter();
+    //!
+    //! \brief resolve 按当前规则表为调用点匹配限流规则
+    //! \param s
+    //! \return
+    //!
+    static inline const limit_rule *resolve(site &s);
+    //!
+    //! \brief tick 单调时钟纳秒数，用于令牌补充
+    //! \return
+    //!
+    static inline int64 tick();
+
 public:
     __attribute__((format(printf, 7, 8)))
     static void formats(const char *file, int line, const char *func,
@@ -92,10 +207,292 @@ protected:
 private:
     static impl::log_core *impl;
     friend struct impl::log_core;
+    struct limit_flusher;
+    static inline limit_table *&limiter_head();
+    static inline site *&limiter_sites();
+    static inline int limiter_update(const limit_rule *add, int drop);
+    static inline bool limiter_match(const filter &flt, const site &s);
+    static inline void limiter_link(site &s);
+    static inline void limiter_start();
+
 public:
     static config cfg;
 };
 
+inline int64 ky_debug::tick()
+{
+#ifdef kyHasClockGetTime
+    timespec ts;
+#  ifdef CLOCK_MONOTONIC_COARSE
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+#  else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#  endif
+    return (int64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#else
+    return (int64)time(NULL) * 1000000000;
+#endif
+}
+
+inline ky_debug::limit_table *&ky_debug::limiter_head()
+{
+    static limit_table none = {NULL, 0, 0, 0, {}};
+    static limit_table *head = &none;
+    return head;
+}
+inline ky_debug::limit_table *ky_debug::limiter()
+{
+    return atomic_base::load(limiter_head(), Fence_Acquire);
+}
+inline ky_debug::site *&ky_debug::limiter_sites()
+{
+    static site *head = NULL;
+    return head;
+}
+
+//!
+//! \brief The limit_flusher struct 定时报告丢弃计数，不依赖调用点再次输出
+//! \note 首个限流或采样规则加入时创建，静态析构时停止并等待线程退出；
+//!       ky_debug对象需在加入规则前创建，先于本对象析构时不再报告
+//!
+struct ky_debug::limit_flusher
+{
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool retire;
+
+    limit_flusher():retire(false)
+    {
+        pthread_mutex_init(&lock, NULL);
+        pthread_cond_init(&wake, NULL);
+        pthread_create(&thread, NULL, entry, this);
+    }
+    ~limit_flusher()
+    {
+        pthread_mutex_lock(&lock);
+        retire = true;
+        pthread_cond_signal(&wake);
+        pthread_mutex_unlock(&lock);
+        pthread_join(thread, NULL);
+        pthread_cond_destroy(&wake);
+        pthread_mutex_destroy(&lock);
+    }
+
+    static void *entry(void *arg)
+    {
+        limit_flusher *f = (limit_flusher*)arg;
+        pthread_mutex_lock(&f->lock);
+        while (!f->retire)
+        {
+            timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            const int64 ns = ts.tv_nsec + (int64)kyLogFlushPeriod * 1000000;
+            ts.tv_sec += ns / 1000000000;
+            ts.tv_nsec = ns % 1000000000;
+            pthread_cond_timedwait(&f->wake, &f->lock, &ts);
+            if (f->retire)
+                break;
+            pthread_mutex_unlock(&f->lock);
+            ky_debug::flush_limit();
+            pthread_mutex_lock(&f->lock);
+        }
+        pthread_mutex_unlock(&f->lock);
+        return NULL;
+    }
+
+private:
+    limit_flusher(const limit_flusher &);
+    limit_flusher &operator = (const limit_flusher &);
+};
+
+//!
+//! \brief limiter_update 复制当前规则表，去掉drop句柄(0为全部)的规则并加入add
+//! \return add的句柄，未加入时返回-1
+//!
+inline int ky_debug::limiter_update(const limit_rule *add, int drop)
+{
+    for (;;)
+    {
+        limit_table *cur = limiter();
+        limit_table *tab = (limit_table*)kyMalloc(sizeof(limit_table) +
+                                                  (cur->count + 1) * sizeof(limit_rule));
+        tab->prev = cur;
+        tab->stamp = cur->stamp + 1;
+        tab->serial = cur->serial;
+        tab->count = 0;
+        memset(&tab->rules[0], 0, sizeof(limit_rule));
+        tab->rules[0].stamp = tab->stamp;
+
+        for (int i = 1; i <= cur->count; ++i)
+        {
+            if (drop == 0 || cur->rules[i].handle == drop)
+                continue;
+            tab->rules[++tab->count] = cur->rules[i];
+            tab->rules[tab->count].stamp = tab->stamp;
+        }
+
+        int h = -1;
+        if (add)
+        {
+            h = ++tab->serial;
+            tab->rules[++tab->count] = *add;
+            tab->rules[tab->count].handle = h;
+            tab->rules[tab->count].stamp = tab->stamp;
+        }
+        if (atomic_base::compare_exchange(limiter_head(), cur, tab))
+        {
+            // 已登记的调用点在下次输出时按新表重新匹配
+            for (site *s = atomic_base::load(limiter_sites(), Fence_Acquire); s; s = s->next)
+                atomic_base::store(s->rule, (const limit_rule*)NULL, Fence_Release);
+            return h;
+        }
+        kyFree(tab);
+    }
+}
+
+inline int ky_debug::append(const filter &flt, const limit &lmt)
+{
+    limit_rule r;
+    memset(&r, 0, sizeof(r));
+    r.flt = flt;
+    r.lmt = lmt;
+    if (lmt.rate > 0)
+    {
+        const int64 period = lmt.period > 0 ? lmt.period : 1000;
+        const int64 burst = lmt.burst > 0 ? lmt.burst : lmt.rate;
+        r.interval = period * 1000000 / lmt.rate;
+        r.tolerance = (burst - 1) * r.interval;
+    }
+    if (lmt.rate > 0 || lmt.sample > 1)
+        limiter_start();
+    return limiter_update(&r, -1);
+}
+inline void ky_debug::remove_limit(int h)
+{
+    if (h > 0)
+        limiter_update(NULL, h);
+}
+inline void ky_debug::clear_limit()
+{
+    limiter_update(NULL, 0);
+}
+inline void ky_debug::limiter_start()
+{
+    static limit_flusher flusher;
+    (void)flusher;
+}
+inline void ky_debug::flush_limit()
+{
+    // ky_debug析构后日志已关闭，计数留到下次报告
+    if (!atomic_base::load(impl, Fence_Acquire))
+        return;
+    for (site *s = atomic_base::load(limiter_sites(), Fence_Acquire); s; s = s->next)
+        s->report();
+}
+
+//!
+//! \brief limiter_link 调用点首次匹配前加入链表，只加入一次，不移除
+//!
+inline void ky_debug::limiter_link(site &s)
+{
+    if (atomic_base::load(s.linked, Fence_Acquire) ||
+            !atomic_base::compare_exchange(s.linked, 0, 1))
+        return;
+    for (;;)
+    {
+        site *head = atomic_base::load(limiter_sites(), Fence_Acquire);
+        s.next = head;
+        if (atomic_base::compare_exchange(limiter_sites(), head, &s))
+            return;
+    }
+}
+
+inline bool ky_debug::limiter_match(const filter &flt, const site &s)
+{
+    if (flt.file[0] && (!s.file || strncmp(flt.file, s.file, sizeof(flt.file))))
+        return false;
+    if (flt.line >= 0 && flt.line != s.line)
+        return false;
+    if (flt.func[0] && (!s.func || strncmp(flt.func, s.func, sizeof(flt.func))))
+        return false;
+    if (flt.subs[0] && (!s.subs || strncmp(flt.subs, s.subs, sizeof(flt.subs))))
+        return false;
+    return true;
+}
+
+inline const ky_debug::limit_rule *ky_debug::resolve(site &s)
+{
+    limiter_link(s);
+    for (;;)
+    {
+        const limit_table *tab = limiter();
+        const limit_rule *r = &tab->rules[0];
+        for (int i = 1; i <= tab->count; ++i)
+        {
+            if (limiter_match(tab->rules[i].flt, s))
+            {
+                r = &tab->rules[i];
+                break;
+            }
+        }
+        // 交换带有完整屏障，之后读到的表头未变时，更新方的清空一定在此之后
+        atomic_base::fetch_store(s.rule, r);
+        if (limiter() == tab)
+        {
+            s.report();
+            return r;
+        }
+    }
+}
+
+inline void ky_debug::site::report()
+{
+    if (kyLikely(!atomic_base::load(dropped, Fence_Relaxed) &&
+                 !atomic_base::load(skipped, Fence_Relaxed)))
+        return;
+    const int64 drop = atomic_base::fetch_store(dropped, (int64)0);
+    const int64 skip = atomic_base::fetch_store(skipped, (int64)0);
+    if (drop > 0 || skip > 0)
+        ky_debug::formats(file, line, func, &ky_debug::cfg, subs, Log_Warning,
+                          "dropped %lld messages by rate limit, skipped %lld by sampling",
+                          (long long)drop, (long long)skip);
+}
+
+inline bool ky_debug::site::pass()
+{
+    const limit_rule *r = atomic_base::load(rule, Fence_Acquire);
+    if (kyUnLikely(!r))
+        r = ky_debug::resolve(*this);
+    if (kyLikely(r->lmt.rate <= 0 && r->lmt.sample <= 1))
+        return true;
+
+    if (r->lmt.sample > 1 && atomic_base::fetch_add(seen, (int64)1) % r->lmt.sample)
+    {
+        atomic_base::fetch_add(skipped, (int64)1);
+        return false;
+    }
+
+    // GCRA形式的令牌桶，桶状态只有一个理论到达时间，竞争失败时重试
+    if (r->lmt.rate > 0)
+    {
+        const int64 now = ky_debug::tick();
+        for (;;)
+        {
+            const int64 cur = atomic_base::load(tat, Fence_Acquire);
+            const int64 base = cur > now ? cur : now;
+            if (base - now > r->tolerance)
+            {
+                atomic_base::fetch_add(dropped, (int64)1);
+                return false;
+            }
+            if (atomic_base::compare_exchange(tat, cur, base + r->interval))
+                break;
+        }
+    }
+    return true;
+}
+
 #define kyLogConfigAll(debug, info, notice, warning, error, critical, alert, fatal) \
     { (fatal), (alert),(critical),(error),(warning),(notice),(info),(debug), }
 #define kyLogConfigDebug(debug) \
@@ -109,9 +506,14 @@ public:
 #define kyLogDefaultBase __FILE__, __LINE__, __func__
 #define kyLogDefaultCfg kyLogDefaultBase, &ky_debug::cfg
 #define kyLogDefault kyLogDefaultCfg, kyLogSubSystem
+#define kyLogSite {kyLogDefaultBase, kyLogSubSystem, NULL, 0, 0, 0, 0, NULL, 0}
 
 #define ky_log_printf(level, format, ...) \
-    ky_debug::formats(kyLogDefault, (level), (format), ##__VA_ARGS__)
+    do { \
+        static ky_debug::site _log_site_ = kyLogSite; \
+        if (_log_site_.pass()) \
+            ky_debug::formats(kyLogDefault, (level), (format), ##__VA_ARGS__); \
+    } while (0)
 
 #ifdef kyHasDebug
     #define log_debug(format, ...) \
@@ -138,6 +540,60 @@ void ky_log_dummyf(unsigned int , const char *, ...){}
 #define log_fatal(format, ...) \
     ky_log_printf(Log_Fatal, (format), ##__VA_ARGS__)
 
+//!
+//! \brief ky_log_format 按ky_format格式输出日志
+//! \note 先写入栈上缓冲，超出时改用ky_u8string
+//!
+template <typename... A>
+inline void ky_log_format(const char *file, int line, const char *func,
+                          const ky_debug::config *config, const char *subs,
+                          eLogLevels level, const char *format, const A &...args)
+{
+    char buf[512];
+    const size_t n = ky_format::format_to (buf, format, args...);
+    if (n < sizeof(buf))
+        ky_debug::formats (file, line, func, config, subs, level, "%.*s", (int)n, buf);
+    else
+    {
+        ky_u8string s;
+        ky_format::format_to (s, format, args...);
+        ky_debug::formats (file, line, func, config, subs, level, "%.*s", s.count (), s.data ());
+    }
+}
+
+#define ky_log_fmt(level, format, ...) \
+    do { \
+        ky_format::_check_<ky_format::count (format), \
+                           decltype(ky_format::_arity_ (__VA_ARGS__))::value>(); \
+        static ky_debug::site _log_site_ = kyLogSite; \
+        if (_log_site_.pass()) \
+            ky_log_format(kyLogDefault, (level), (format), ##__VA_ARGS__); \
+    } while (0)
+
+#ifdef kyHasDebug
+    #define log_debug_fmt(format, ...) \
+        ky_log_fmt(Log_Debug, format, ##__VA_ARGS__)
+#else
+    #define log_debug_fmt(format, ...) \
+        ky_format::_check_<ky_format::count (format), \
+                           decltype(ky_format::_arity_ (__VA_ARGS__))::value>()
+#endif
+
+#define log_info_fmt(format, ...) \
+    ky_log_fmt(Log_Info, format, ##__VA_ARGS__)
+#define log_notice_fmt(format, ...) \
+    ky_log_fmt(Log_Notice, format, ##__VA_ARGS__)
+#define log_warning_fmt(format, ...) \
+    ky_log_fmt(Log_Warning, format, ##__VA_ARGS__)
+#define log_error_fmt(format, ...) \
+    ky_log_fmt(Log_Error, format, ##__VA_ARGS__)
+#define log_critical_fmt(format, ...) \
+    ky_log_fmt(Log_Critical, format, ##__VA_ARGS__)
+#define log_alert_fmt(format, ...) \
+    ky_log_fmt(Log_Alert, format, ##__VA_ARGS__)
+#define log_fatal_fmt(format, ...) \
+    ky_log_fmt(Log_Fatal, format, ##__VA_ARGS__)
+
 #else // no logs
 struct ky_debug{};
 #define log_info(format, ...)
@@ -147,6 +603,13 @@ struct ky_debug{};
 #define log_critical(format, ...)
 #define log_alert(format, ...)
 #define log_fatal(format, ...)
+#define log_info_fmt(format, ...)
+#define log_notice_fmt(format, ...)
+#define log_warning_fmt(format, ...)
+#define log_error_fmt(format, ...)
+#define log_critical_fmt(format, ...)
+#define log_alert_fmt(format, ...)
+#define log_fatal_fmt(format, ...)
 
 #endif
 
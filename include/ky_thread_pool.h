@@ -0,0 +1,191 @@
+
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_thread_pool.h
+ * @brief    分叉-汇合式线程池
+ *       1.run(fn, arg, count)以序号0..count-1并行调用fn，调用线程也参与执行
+ *       2.序号由原子计数器领取，任务粒度由调用者划分
+ *       3.嵌套或并发提交时不等待，直接在调用线程顺序执行
+ *       4.工作线程直接使用pthread，析构时join全部线程后再释放资源
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ */
+#ifndef ky_THREAD_POOL_H
+#define ky_THREAD_POOL_H
+
+#include "ky_define.h"
+#include "ky_thread.h"
+#include "ky_cpu.h"
+
+class ky_thread_pool
+{
+public:
+    typedef void (*task_fn)(void *arg, int index);
+
+private:
+    // 预编译库的ky_mutex::lock在竞争时直接返回失败，ky_thread::wait也不保证线程已退出，
+    // 这里直接使用pthread的互斥、条件和join
+    pthread_mutex_t lock;
+    pthread_mutex_t submit;
+    pthread_cond_t wake;
+    pthread_cond_t idle;
+    pthread_t *threads;
+    int workers;
+    bool retire;
+
+    // 当前任务，只在lock内修改
+    task_fn job_fn;
+    void *job_arg;
+    int job_count;
+    ky_atomic<int> next;
+    uint64 generation;
+    int active;
+
+    ky_thread_pool(const ky_thread_pool &) = delete;
+    ky_thread_pool &operator = (const ky_thread_pool &) = delete;
+
+    //! 领取并执行序号，直到全部领取完
+    static void drain(task_fn fn, void *arg, int count, ky_atomic<int> &next)
+    {
+        for (int i = next.fetch_add (1); i < count; i = next.fetch_add (1))
+            fn (arg, i);
+    }
+
+    static void *entry(void *pool)
+    {
+        ((ky_thread_pool *)pool)->loop ();
+        return NULL;
+    }
+
+    void loop()
+    {
+        pthread_mutex_lock (&lock);
+        uint64 seen = generation;
+        for (;;)
+        {
+            while (!retire && generation == seen)
+                pthread_cond_wait (&wake, &lock);
+            if (retire)
+                break;
+
+            seen = generation;
+            task_fn fn = job_fn;
+            void *arg = job_arg;
+            const int count = job_count;
+            ++active;
+            pthread_mutex_unlock (&lock);
+
+            drain (fn, arg, count, next);
+
+            pthread_mutex_lock (&lock);
+            if (--active == 0)
+                pthread_cond_broadcast (&idle);
+        }
+        pthread_mutex_unlock (&lock);
+    }
+
+public:
+    //!
+    //! \brief ky_thread_pool
+    //! \param threads 并发数(含调用线程)，0为CPU核数
+    //!
+    explicit ky_thread_pool(int concurrency = 0):
+        threads(NULL), workers(0), retire(false), job_fn(NULL), job_arg(NULL),
+        job_count(0), next(0), generation(0), active(0)
+    {
+        pthread_mutex_init (&lock, NULL);
+        pthread_mutex_init (&submit, NULL);
+        pthread_cond_init (&wake, NULL);
+        pthread_cond_init (&idle, NULL);
+
+        if (concurrency <= 0)
+            concurrency = ky_cpu().count ();
+        if (concurrency <= 1)
+            return;
+
+        threads = new pthread_t[concurrency - 1];
+        for (int i = 0; i < concurrency - 1; ++i)
+        {
+            if (pthread_create (&threads[i], NULL, entry, this) != 0)
+                break;
+            ++workers;
+        }
+    }
+    //! 全部工作线程join之后才释放线程表和同步对象
+    ~ky_thread_pool()
+    {
+        pthread_mutex_lock (&lock);
+        retire = true;
+        pthread_cond_broadcast (&wake);
+        pthread_mutex_unlock (&lock);
+        for (int i = 0; i < workers; ++i)
+            pthread_join (threads[i], NULL);
+        delete [] threads;
+
+        pthread_cond_destroy (&idle);
+        pthread_cond_destroy (&wake);
+        pthread_mutex_destroy (&submit);
+        pthread_mutex_destroy (&lock);
+    }
+
+    //! 并发数，工作线程加调用线程
+    int concurrency() const {return workers + 1;}
+
+    //!
+    //! \brief run 以序号0..count-1并行调用fn，全部完成后返回
+    //! \param fn
+    //! \param arg
+    //! \param count
+    //!
+    void run(task_fn fn, void *arg, int count)
+    {
+        if (count <= 0)
+            return;
+        // 单线程、单任务或池正被占用(嵌套提交)时在本线程顺序执行
+        if (workers == 0 || count == 1 || pthread_mutex_trylock (&submit) != 0)
+        {
+            for (int i = 0; i < count; ++i)
+                fn (arg, i);
+            return;
+        }
+
+        pthread_mutex_lock (&lock);
+        // 等待上一任务中迟到的工作线程离开，之后才能重置序号
+        while (active > 0)
+            pthread_cond_wait (&idle, &lock);
+        job_fn = fn;
+        job_arg = arg;
+        job_count = count;
+        next = 0;
+        ++generation;
+        pthread_cond_broadcast (&wake);
+        pthread_mutex_unlock (&lock);
+
+        drain (fn, arg, count, next);
+
+        pthread_mutex_lock (&lock);
+        while (active > 0)
+            pthread_cond_wait (&idle, &lock);
+        pthread_mutex_unlock (&lock);
+        pthread_mutex_unlock (&submit);
+    }
+
+    //! 进程内共享的线程池
+    static ky_thread_pool &global()
+    {
+        static ky_thread_pool pool;
+        return pool;
+    }
+};
+
+#endif // ky_THREAD_POOL_H
@@ -8,7 +8,7 @@
  *       1.实现了一个bool_t数据类型，用于真正占位为1bit的bool类型
  *       2.实现数据类型的判断
  *         is_int, is_flt, is_void, is_array, is_pointer, is_const,
- *         is_volatile, is_enum, is_union, is_class, is_function
+ *         is_volatile, is_enum, is_union, is_class, is_function, is_relocatable
  *       3.实现编译过程断言机制
  *         kyCompilerAssert
  *       4.支持16bit的浮点数
@@ -16,7 +16,7 @@
  *
  * @author   kunyang
  * @email    kunyang.yk@gmail.com
- * @version  1.2.2.1
+ * @version  1.2.3.1
  * @date     2011/03/01
  * @license  GNU General Public License (GPL)
  *
@@ -32,6 +32,7 @@
  * 2017/05/01 | 1.2.0.1   | kunyang  | 加入数据类型的判断
  * 2017/07/23 | 1.2.1.1   | kunyang  | 加入编译阶段断言宏
  * 2018/01/15 | 1.2.2.1   | kunyang  | 去除long double,修改boolean_t为bool_t,加入half_float
+ * 2026/10/18 | 1.2.3.1   | kunyang  | 加入is_relocatable按位重定位判断
  */
 #ifndef KY_TYPE_H
 #define KY_TYPE_H
@@ -151,4 +151,12 @@ template<typename Ret, typename... ArgsT>struct is_function<Ret(ArgsT......) con
 template<typename Ret, typename... ArgsT>struct is_function<Ret(ArgsT......) const volatile &&>:
       public true_type_t {};
 
+/// is_relocatable 对象可按位移动(memmove)到新地址，不需要调用拷贝构造和析构
+/// 内部不保存指向自身的指针的类可用kyDeclareRelocatable声明
+template<typename T>struct is_relocatable: public constant_int<bool,
+        is_int<T>::value || is_flt<T>::value || is_enum<T>::value || is_pointer<T>::value ||
+        (__has_trivial_copy(T) && __has_trivial_destructor(T))>{ };
+#define kyDeclareRelocatable(...) \
+    template<>struct is_relocatable< __VA_ARGS__ >: public true_type_t { }
+
 #endif // KY_DEFINE_INL
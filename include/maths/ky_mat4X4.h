@@ -958,6 +958,25 @@ ky_streamt &operator >> (ky_streamt &out, ky_matrix4X4<T> &v)
         out >> v.elem[i];
     return out;
 }
+
+//! 按行输出为[[t00 t01 t02 t03] [t10 ...] ...]
+template<typename T>
+void ky_format_value(ky_format::writer &w, const ky_format::spec &sp, const ky_matrix4X4<T> &v)
+{
+    w.put ('[');
+    for (int r = 0; r < v.rows; ++r)
+    {
+        w.write (r ? " [" : "[", r ? 2 : 1);
+        for (int c = 0; c < v.cols; ++c)
+        {
+            if (c)
+                w.put (' ');
+            ky_format::value (w, sp, v.elemRowCol[r][c]);
+        }
+        w.put (']');
+    }
+    w.put (']');
+}
 template<typename T>
 ky_variant &operator << (ky_variant &va, const ky_matrix4X4<T> &col)
 {
@@ -657,6 +657,21 @@ ky_streamt &operator >> (ky_streamt &out, ky_quaternion<T> &v)
         out >> v.elem[i];
     return out;
 }
+
+//! 输出为{ x y z w }
+template<typename T>
+void ky_format_value(ky_format::writer &w, const ky_format::spec &sp, const ky_quaternion<T> &v)
+{
+    w.write ("{ ", 2);
+    ky_format::value (w, sp, v.x);
+    w.put (' ');
+    ky_format::value (w, sp, v.y);
+    w.put (' ');
+    ky_format::value (w, sp, v.z);
+    w.put (' ');
+    ky_format::value (w, sp, v.w);
+    w.write (" }", 2);
+}
 template<typename T>
 ky_variant &operator << (ky_variant &va, const ky_quaternion<T> &col)
 {
@@ -982,6 +982,20 @@ ky_streamt &operator >> (ky_streamt &out, ky_vector3<T> &v)
         out >> v.elem[i];
     return out;
 }
+
+//! 输出为[x y ...]，格式应用到每个分量
+template<typename T>
+void ky_format_value(ky_format::writer &w, const ky_format::spec &sp, const ky_vector3<T> &v)
+{
+    w.put ('[');
+    for (int i = 0; i < v.size; ++i)
+    {
+        if (i)
+            w.put (' ');
+        ky_format::value (w, sp, v.elem[i]);
+    }
+    w.put (']');
+}
 template<typename T>
 ky_variant &operator << (ky_variant &va, const ky_vector3<T> &col)
 {
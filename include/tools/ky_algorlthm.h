@@ -6,13 +6,14 @@
  * @file     ky_algorlthm.h
  * @brief    基本算法定义和实现
  *       1.数据类型的大小判断
- *       2.常用排序算法
+ *       2.常用排序算法(并行及基数排序见ky_sort.h)
  *       3.基本数据类型的交换
  *       3.一些哈希算法实现(散列)
+ *       4.带进程随机种子的64位散列(wyhash及向量化长键)
  *
  * @author   kunyang
  * @email    kunyang.yk@gmail.com
- * @version  1.2.1.1
+ * @version  1.3.1.0
  * @date     2015/04/15
  * @license  GNU General Public License (GPL)
  *
@@ -23,6 +24,9 @@
  * 2016/02/11 | 1.1.0.1   | kunyang  | 加入散列计算算法
  * 2016/06/04 | 1.2.0.1   | kunyang  | 加入排序算法
  * 2016/11/22 | 1.2.1.1   | kunyang  | 修改排序算法并加入归并排序算法
+ * 2026/10/18 | 1.3.0.1   | kunyang  | ky_hash改为带种子的64位散列，长键采用条带累加
+ * 2026/10/18 | 1.3.0.2   | kunyang  | 加入默认比较器ky_less
+ * 2026/10/18 | 1.3.1.0   | kunyang  | 快速排序改为模式消除快速排序，小分区AVX2排序网络，归并排序改用堆缓冲
  */
 #ifndef ky_ALGORLTHM_H
 #define ky_ALGORLTHM_H
@@ -37,6 +41,13 @@ template <typename T>
 inline const T _ref ky_bound(_in T _ref min, _in T _ref val, _in T _ref max)
 {return ky_max(min, ky_min(max, val));}
 
+//! 默认的比较器，使用类型的 < 运算
+template <typename T>
+struct ky_less
+{
+    bool operator ()(const T &a, const T &b)const {return a < b;}
+};
+
 #define _SWAP_(T) inline void ky_swap(T _ref a, T _ref b){T tmp = a; a = b; b = tmp;}
 _SWAP_(bool)
 _SWAP_(bool_t)
@@ -90,22 +101,27 @@ namespace __sort__
     void insert2(T* a, size_t alength);
 
     //!
-    //! @brief quick 数组型快速排序
+    //! @brief quick 数组型快速排序(模式消除快速排序，不稳定)
     //!
     //! @param begin 是数组的开始地址
     //! @param end 是数组的结束地址
+    //! @note 不超过16个元素的int、uint、float分区使用AVX2排序网络
     //!
     template<typename T>
     void quick(T *begin, T *end);
+    template<typename T, typename Compare>
+    void quick(T *begin, T *end, Compare comp);
 
     //!
-    //! @brief quick 容器型快速排序
+    //! @brief quick 容器型快速排序(模式消除快速排序，不稳定)
     //!
     //! @param begin 是容器开始迭代
     //! @param end 是容器结束迭代
     //!
     template<typename container_iterator>
     void quick(container_iterator begin, container_iterator end);
+    template<typename container_iterator, typename Compare>
+    void quick(container_iterator begin, container_iterator end, Compare comp);
 
     //!
     //! @brief heap 堆排序算法
@@ -125,13 +141,16 @@ namespace __sort__
     template <typename T>
     void bubble (T *r, size_t length);
     //!
-    //! @brief merge 归并排序算法
+    //! @brief merge 归并排序算法(稳定)
     //!
     //! @param arr 是待调整的堆数组
     //! @param length是数组的长度
+    //! @note 缓冲区在堆上申请，长度不受栈大小限制
     //!
     template <typename T>
     void merge(T *arr, size_t length);
+    template <typename T, typename Compare>
+    void merge(T *arr, size_t length, Compare comp);
 }
 template<typename T>
 inline void ky_isort( T *a, size_t length){__sort__::insert(a, length);}
@@ -143,12 +162,18 @@ template<typename T>
 inline void ky_qsort(T *begin, T *end){__sort__::quick(begin, end);}
 template<typename container_iterator>
 inline void ky_qsort(container_iterator begin, container_iterator end){__sort__::quick(begin, end);}
+template<typename T, typename Compare>
+inline void ky_qsort(T *begin, T *end, Compare comp){__sort__::quick(begin, end, comp);}
+template<typename container_iterator, typename Compare>
+inline void ky_qsort(container_iterator begin, container_iterator end, Compare comp){__sort__::quick(begin, end, comp);}
 template<typename T>
 inline void ky_hsort(T *H, size_t length){__sort__::heap(H, length);}
 template<typename T>
 inline void ky_bsort(T *H, size_t length){__sort__::bubble(H, length);}
 template<typename T>
 inline void ky_msort(T *H, size_t length){__sort__::merge(H, length);}
+template<typename T, typename Compare>
+inline void ky_msort(T *H, size_t length, Compare comp){__sort__::merge(H, length, comp);}
 
 namespace __hash_
 {
@@ -175,22 +200,60 @@ namespace __hash_
     /*FNVHash*/
     uint32 FNV(char *str, size_t len);
     uint32 H64(uint64 v);
+
+    //!
+    //! \brief The secret struct 进程级散列密钥
+    //! \note 首次使用时由地址和时钟熵生成，用于抵御哈希洪水攻击
+    //!
+    struct secret
+    {
+        enum
+        {
+            StripeLanes = 8,                          ///< 条带内64位通道数(64字节)
+            BlockStripes = 16,                        ///< 每块条带数，块结束时搅拌累加器
+            Words = BlockStripes + StripeLanes,       ///< 密钥字数
+            LongKey = 256                             ///< 超过此长度采用条带累加
+        };
+        uint64 seed;
+        uint64 key[Words];
+
+        explicit secret(uint64 sd);
+        static const secret &process();
+    };
+
+    //!
+    //! \brief seed 返回进程级随机种子
+    //!
+    inline uint64 seed();
+    //!
+    //! \brief mix 64x64->128乘法后高低位折叠
+    //!
+    inline uint64 mix(uint64 a, uint64 b);
+    //!
+    //! \brief WY64 64位整数散列
+    //!
+    inline uint64 WY64(uint64 v, uint64 sd = seed());
+    //!
+    //! \brief WY 字节串散列，短键为wyhash，长键为8通道条带累加(AVX2/SSE2)
+    //!
+    inline uint64 WY(const void *data, size_t len, uint64 sd = seed());
 }
 
-inline uint32 ky_hash(_in char _ref v){return (uint32)v;}
-inline uint32 ky_hash(_in uchar _ref v){return (uint32)v;}
-inline uint32 ky_hash(_in short _ref v){return (uint32)v;}
-inline uint32 ky_hash(_in ushort _ref v){return (uint32)v;}
-inline uint32 ky_hash(_in int _ref v){return (uint32)v;}
-inline uint32 ky_hash(_in uint _ref v){return (uint32)v;}
-inline uint32 ky_hash(_in wchar_t _ref v){return (uint32)v;}
-inline uint32 ky_hash(_in long _ref v){return __hash_::H64 (v);}
-inline uint32 ky_hash(_in ulong _ref v){return __hash_::H64 (v);}
-inline uint32 ky_hash(_in longlong _ref v){return __hash_::H64 (v);}
-inline uint32 ky_hash(_in ulonglong _ref v){return __hash_::H64 (v);}
-inline uint32 ky_hash(float v){union{float tv;uint64 v64;};tv = v; return __hash_::H64(v64);}
-inline uint32 ky_hash(real v){union{real tv;uint64 v64;};tv = v; return __hash_::H64(v64);}
-inline uint32 ky_hash(char *v, int len = -1){if (len < 0) len = strlen (v);return __hash_::DJB(v, len);}
+inline uint64 ky_hash(_in char _ref v){return __hash_::WY64 ((uint64)v);}
+inline uint64 ky_hash(_in uchar _ref v){return __hash_::WY64 ((uint64)v);}
+inline uint64 ky_hash(_in short _ref v){return __hash_::WY64 ((uint64)v);}
+inline uint64 ky_hash(_in ushort _ref v){return __hash_::WY64 ((uint64)v);}
+inline uint64 ky_hash(_in int _ref v){return __hash_::WY64 ((uint64)v);}
+inline uint64 ky_hash(_in uint _ref v){return __hash_::WY64 ((uint64)v);}
+inline uint64 ky_hash(_in wchar_t _ref v){return __hash_::WY64 ((uint64)v);}
+inline uint64 ky_hash(_in long _ref v){return __hash_::WY64 ((uint64)v);}
+inline uint64 ky_hash(_in ulong _ref v){return __hash_::WY64 ((uint64)v);}
+inline uint64 ky_hash(_in longlong _ref v){return __hash_::WY64 ((uint64)v);}
+inline uint64 ky_hash(_in ulonglong _ref v){return __hash_::WY64 ((uint64)v);}
+inline uint64 ky_hash(float v){union{float tv;uint32 v32;};tv = v == 0.f ? 0.f : v; return __hash_::WY64(v32);}
+inline uint64 ky_hash(real v){union{real tv;uint64 v64;};tv = v == 0. ? 0. : v; return __hash_::WY64(v64);}
+inline uint64 ky_hash(const char *v, int len = -1){if (len < 0) len = strlen (v);return __hash_::WY(v, len);}
+inline uint64 ky_hash(char *v, int len = -1){return ky_hash ((const char *)v, len);}
 
 #include "ky_algorlthm.inl"
 #endif //ky_ALGORLTHM_H
@@ -61,110 +61,496 @@ void insert2(T* a, size_t alength)
         a[i] = b[(i + first) % alength];
 }
 
-template<typename T>
-void quick(T *begin, T *end)
+#if kyLanguage >= kyLanguage11
+template <typename T>
+inline T &&moved(T &v) {return std::move (v);}
+#else
+template <typename T>
+inline T &moved(T &v) {return v;}
+#endif
+
+template <typename T>
+inline void exchange(T &a, T &b)
 {
-top:
-    int length = end - begin;
-    if (length < 2)
-        return;
+    T tmp(moved (a));
+    a = moved (b);
+    b = moved (tmp);
+}
 
-    --end;
-    T *low = begin, *high = end-1;
-    T *pivot = begin + length / 2 ;
+enum
+{
+    InsertionLimit = 24,            ///< 短于此长度的区间使用插入排序
+    NintherLimit = 128,             ///< 长于此长度的区间以九数取中选择枢轴
+    PartialLimit = 8,               ///< 有序检测时插入排序最多移动的元素数
+    StableRun = 32                  ///< 归并排序的初始有序段长度
+};
 
-    if (*end < *begin)
-        ky_swap(*end, *begin);
-    if (length == 2)
-        return ;
+//!
+//! \brief The _pdq_ struct 模式消除快速排序(pattern-defeating quicksort)
+//! \note
+//!   1.划分后若无需交换，尝试有限次插入排序，已有序的输入为O(n)
+//!   2.与上一个枢轴相等的区间整体划到左侧，大量重复元素为O(n)
+//!   3.不平衡划分打乱固定位置元素，次数用完后退化为堆排序
+//!
+template <typename It, typename Compare, typename T>
+struct _pdq_
+{
+    static void sort(It begin, It end, Compare comp);
 
-    if (*pivot < *begin)
-        ky_swap(*pivot, *begin);
-    if (*end < *pivot)
-        ky_swap(*end, *pivot);
-    if (length == 3)
-        return ;
+    static void loop(It begin, It end, Compare comp, int bad, bool leftmost);
+    static void insertion(It begin, It end, Compare comp);
+    static void unguarded_insertion(It begin, It end, Compare comp);
+    static bool partial_insertion(It begin, It end, Compare comp);
+    static It partition_right(It begin, It end, Compare comp, bool &partitioned);
+    static It partition_left(It begin, It end, Compare comp);
+    static void sift(It begin, intptr root, intptr length, Compare comp);
+    static void heap(It begin, It end, Compare comp);
+    static void shuffle(It begin, It end);
 
-    ky_swap(*pivot, *end);
+    static void sort2(It a, It b, Compare comp)
+    {
+        if (comp (*b, *a))
+            exchange (*a, *b);
+    }
+    static void sort3(It a, It b, It c, Compare comp)
+    {
+        sort2 (a, b, comp);
+        sort2 (b, c, comp);
+        sort2 (a, b, comp);
+    }
+};
 
-    while (low < high)
+template <typename It, typename Compare>
+inline bool network(It , It , Compare ) {return false;}
+
+#if defined(kyHAS_AVX2)
+struct _avx2_i32_
+{
+    typedef int type;
+    typedef __m256i reg;
+    static type highest() {return INT_MAX;}
+    static bool ordered(type ) {return true;}
+    static reg load(const type *p) {return _mm256_loadu_si256 ((const __m256i *)p);}
+    static void store(type *p, reg v) {_mm256_storeu_si256 ((__m256i *)p, v);}
+    static reg permute(reg v, __m256i idx) {return _mm256_permutevar8x32_epi32 (v, idx);}
+    static reg min(reg a, reg b) {return _mm256_min_epi32 (a, b);}
+    static reg max(reg a, reg b) {return _mm256_max_epi32 (a, b);}
+    template <int Mask>
+    static reg blend(reg a, reg b) {return _mm256_blend_epi32 (a, b, Mask);}
+};
+struct _avx2_u32_ : _avx2_i32_
+{
+    typedef uint type;
+    static type highest() {return UINT_MAX;}
+    static bool ordered(type ) {return true;}
+    static reg load(const type *p) {return _mm256_loadu_si256 ((const __m256i *)p);}
+    static void store(type *p, reg v) {_mm256_storeu_si256 ((__m256i *)p, v);}
+    static reg min(reg a, reg b) {return _mm256_min_epu32 (a, b);}
+    static reg max(reg a, reg b) {return _mm256_max_epu32 (a, b);}
+};
+struct _avx2_f32_
+{
+    typedef float type;
+    typedef __m256 reg;
+    static type highest() {return FLT_MAX;}
+    //! NaN不满足严格弱序，min/max会丢失元素，交给插入排序
+    static bool ordered(type v) {return v == v;}
+    static reg load(const type *p) {return _mm256_loadu_ps (p);}
+    static void store(type *p, reg v) {_mm256_storeu_ps (p, v);}
+    static reg permute(reg v, __m256i idx) {return _mm256_permutevar8x32_ps (v, idx);}
+    static reg min(reg a, reg b) {return _mm256_min_ps (a, b);}
+    static reg max(reg a, reg b) {return _mm256_max_ps (a, b);}
+    template <int Mask>
+    static reg blend(reg a, reg b) {return _mm256_blend_ps (a, b, Mask);}
+};
+
+//!
+//! \brief The _network_ struct 寄存器内排序网络，最多16个元素
+//! \note 每层为一次置换加min/max，Mask中置位的通道取大值
+//!
+template <typename Ops>
+struct _network_
+{
+    typedef typename Ops::type type;
+    typedef typename Ops::reg reg;
+
+    template <int Mask>
+    static reg layer(reg v, __m256i perm)
     {
-        while (low < high && *low < *end)
-            ++low;
-        while (high > low && *end < *high)
-            --high;
+        const reg p = Ops::permute (v, perm);
+        return Ops::template blend<Mask> (Ops::min (v, p), Ops::max (v, p));
+    }
+    //! 8输入最优网络，19次比较6层
+    static reg sort8(reg v)
+    {
+        v = layer<0xCC> (v, _mm256_setr_epi32 (2, 3, 0, 1, 6, 7, 4, 5));
+        v = layer<0xF0> (v, _mm256_setr_epi32 (4, 5, 6, 7, 0, 1, 2, 3));
+        v = layer<0xAA> (v, _mm256_setr_epi32 (1, 0, 3, 2, 5, 4, 7, 6));
+        v = layer<0x30> (v, _mm256_setr_epi32 (0, 1, 4, 5, 2, 3, 6, 7));
+        v = layer<0x50> (v, _mm256_setr_epi32 (0, 4, 2, 6, 1, 5, 3, 7));
+        v = layer<0x54> (v, _mm256_setr_epi32 (0, 2, 1, 4, 3, 6, 5, 7));
+        return v;
+    }
+    //! 双调序列排序
+    static reg bitonic8(reg v)
+    {
+        v = layer<0xF0> (v, _mm256_setr_epi32 (4, 5, 6, 7, 0, 1, 2, 3));
+        v = layer<0xCC> (v, _mm256_setr_epi32 (2, 3, 0, 1, 6, 7, 4, 5));
+        v = layer<0xAA> (v, _mm256_setr_epi32 (1, 0, 3, 2, 5, 4, 7, 6));
+        return v;
+    }
+    static bool sort(type *begin, type *end)
+    {
+        const intptr n = end - begin;
+        if (n > 16)
+            return false;
 
-        if (low < high)
+        type buf[16];
+        for (intptr i = 0; i < n; ++i)
         {
-            ky_swap(*low, *high);
-            ++low;
-            --high;
-        } else
-            break;
+            if (!Ops::ordered (begin[i]))
+                return false;
+            buf[i] = begin[i];
+        }
+        for (intptr i = n; i < 16; ++i)
+            buf[i] = Ops::highest ();
+
+        reg a = sort8 (Ops::load (buf));
+        if (n > 8)
+        {
+            // 两个有序寄存器，翻转后一个得到双调序列再合并
+            reg b = sort8 (Ops::load (buf + 8));
+            b = Ops::permute (b, _mm256_setr_epi32 (7, 6, 5, 4, 3, 2, 1, 0));
+            const reg lo = Ops::min (a, b);
+            const reg hi = Ops::max (a, b);
+            a = bitonic8 (lo);
+            Ops::store (buf + 8, bitonic8 (hi));
+        }
+        Ops::store (buf, a);
+        for (intptr i = 0; i < n; ++i)
+            begin[i] = buf[i];
+        return true;
     }
+};
 
-    if (*low < *end)
-        ++low;
+inline bool network(int *begin, int *end, ky_less<int> ) {return _network_<_avx2_i32_>::sort (begin, end);}
+inline bool network(uint *begin, uint *end, ky_less<uint> ) {return _network_<_avx2_u32_>::sort (begin, end);}
+inline bool network(float *begin, float *end, ky_less<float> ) {return _network_<_avx2_f32_>::sort (begin, end);}
+#endif
 
-    ky_swap(*end, *low);
-    quick(begin, low);
+template <typename It, typename Compare, typename T>
+void _pdq_<It, Compare, T>::insertion(It begin, It end, Compare comp)
+{
+    if (begin == end)
+        return;
 
-    begin = low + 1;
-    ++end;
-    goto top;
+    for (It cur = begin + 1; cur != end; ++cur)
+    {
+        It sift = cur;
+        It sift_1 = cur - 1;
+        if (comp (*sift, *sift_1))
+        {
+            T tmp(moved (*sift));
+            do
+            {
+                *sift = moved (*sift_1);
+                --sift;
+            } while (sift != begin && comp (tmp, *--sift_1));
+            *sift = moved (tmp);
+        }
+    }
 }
 
-template<typename container_iterator>
-void quick(container_iterator begin, container_iterator end)
+template <typename It, typename Compare, typename T>
+void _pdq_<It, Compare, T>::unguarded_insertion(It begin, It end, Compare comp)
 {
-top:
-    int span = int(end - begin);
-    if (span < 2)
+    if (begin == end)
         return;
 
-    --end;
-    container_iterator low = begin, high = end - 1;
-    container_iterator pivot = begin + span / 2;
+    // begin左侧的元素不大于区间内任何元素，可作为哨兵
+    for (It cur = begin + 1; cur != end; ++cur)
+    {
+        It sift = cur;
+        It sift_1 = cur - 1;
+        if (comp (*sift, *sift_1))
+        {
+            T tmp(moved (*sift));
+            do
+            {
+                *sift = moved (*sift_1);
+                --sift;
+            } while (comp (tmp, *--sift_1));
+            *sift = moved (tmp);
+        }
+    }
+}
 
-    if (*end < *begin)
-        ky_swap(*end, *begin);
-    if (span == 2)
-        return;
+template <typename It, typename Compare, typename T>
+bool _pdq_<It, Compare, T>::partial_insertion(It begin, It end, Compare comp)
+{
+    if (begin == end)
+        return true;
 
-    if (*pivot < *begin)
-        ky_swap(*pivot, *begin);
-    if (*end < *pivot)
-        ky_swap(*end, *pivot);
-    if (span == 3)
-        return;
+    intptr limit = 0;
+    for (It cur = begin + 1; cur != end; ++cur)
+    {
+        if (limit > PartialLimit)
+            return false;
 
-    ky_swap(*pivot, *end);
+        It sift = cur;
+        It sift_1 = cur - 1;
+        if (comp (*sift, *sift_1))
+        {
+            T tmp(moved (*sift));
+            do
+            {
+                *sift = moved (*sift_1);
+                --sift;
+            } while (sift != begin && comp (tmp, *--sift_1));
+            *sift = moved (tmp);
+            limit += cur - sift;
+        }
+    }
+    return true;
+}
 
-    while (low < high)
+template <typename It, typename Compare, typename T>
+It _pdq_<It, Compare, T>::partition_right(It begin, It end, Compare comp, bool &partitioned)
+{
+    T pivot(moved (*begin));
+    // 位置f、l与迭代器同步移动，链表迭代器的大小比较没有先后意义
+    It first = begin;
+    It last = end;
+    intptr f = 0;
+    intptr l = end - begin;
+
+    // 找到第一个不小于枢轴的元素，枢轴为三数取中，一定存在
+    do {++first; ++f;} while (comp (*first, pivot));
+    if (f == 1)
     {
-        while (low < high && *low < *end)
-            ++low;
-        while (high > low && *end < *high)
-            --high;
+        while (f < l)
+        {
+            --last; --l;
+            if (comp (*last, pivot))
+                break;
+        }
+    }
+    else
+        do {--last; --l;} while (!comp (*last, pivot));
+
+    // 一次交换都不需要说明区间已按枢轴划分
+    partitioned = f >= l;
+    while (f < l)
+    {
+        exchange (*first, *last);
+        do {++first; ++f;} while (comp (*first, pivot));
+        do {--last; --l;} while (!comp (*last, pivot));
+    }
+
+    It pos = --first;
+    *begin = moved (*pos);
+    *pos = moved (pivot);
+    return pos;
+}
+
+template <typename It, typename Compare, typename T>
+It _pdq_<It, Compare, T>::partition_left(It begin, It end, Compare comp)
+{
+    T pivot(moved (*begin));
+    It first = begin;
+    It last = end;
+    intptr f = 0;
+    const intptr size = end - begin;
+    intptr l = size;
 
-        if (low < high)
+    do {--last; --l;} while (comp (pivot, *last));
+    if (l == size - 1)
+    {
+        while (f < l)
         {
-            ky_swap(*low, *high);
-            ++low;
-            --high;
-        } else
+            ++first; ++f;
+            if (comp (pivot, *first))
+                break;
+        }
+    }
+    else
+        do {++first; ++f;} while (!comp (pivot, *first));
+
+    while (f < l)
+    {
+        exchange (*first, *last);
+        do {--last; --l;} while (comp (pivot, *last));
+        do {++first; ++f;} while (!comp (pivot, *first));
+    }
+
+    *begin = moved (*last);
+    *last = moved (pivot);
+    return last;
+}
+
+template <typename It, typename Compare, typename T>
+void _pdq_<It, Compare, T>::sift(It begin, intptr root, intptr length, Compare comp)
+{
+    T tmp(moved (*(begin + root)));
+    intptr child = 2 * root + 1;
+    while (child < length)
+    {
+        if (child + 1 < length && comp (*(begin + child), *(begin + (child + 1))))
+            ++child;
+        if (!comp (tmp, *(begin + child)))
             break;
+        *(begin + root) = moved (*(begin + child));
+        root = child;
+        child = 2 * root + 1;
     }
+    *(begin + root) = moved (tmp);
+}
 
-    if (*low < *end)
-        ++low;
+template <typename It, typename Compare, typename T>
+void _pdq_<It, Compare, T>::heap(It begin, It end, Compare comp)
+{
+    const intptr length = end - begin;
+    for (intptr i = length / 2; i > 0; --i)
+        sift (begin, i - 1, length, comp);
+    for (intptr i = length - 1; i > 0; --i)
+    {
+        exchange (*begin, *(begin + i));
+        sift (begin, 0, i, comp);
+    }
+}
+
+template <typename It, typename Compare, typename T>
+void _pdq_<It, Compare, T>::shuffle(It begin, It end)
+{
+    // 划分极不平衡时交换几个固定位置的元素，打破会让枢轴退化的输入模式
+    const intptr size = end - begin;
+    if (size < InsertionLimit)
+        return;
+    const intptr q = size / 4;
+    exchange (*begin, *(begin + q));
+    exchange (*(end - 1), *(end - q));
+    if (size > NintherLimit)
+    {
+        exchange (*(begin + 1), *(begin + (q + 1)));
+        exchange (*(begin + 2), *(begin + (q + 2)));
+        exchange (*(end - 2), *(end - (q + 1)));
+        exchange (*(end - 3), *(end - (q + 2)));
+    }
+}
+
+template <typename It, typename Compare, typename T>
+void _pdq_<It, Compare, T>::loop(It begin, It end, Compare comp, int bad, bool leftmost)
+{
+    for (;;)
+    {
+        const intptr size = end - begin;
+        if (size < InsertionLimit)
+        {
+            if (network (begin, end, comp))
+                return;
+            if (leftmost)
+                insertion (begin, end, comp);
+            else
+                unguarded_insertion (begin, end, comp);
+            return;
+        }
 
-    ky_swap(*end, *low);
-    quick(begin, low);
+        // 枢轴放在begin，长区间以九数取中
+        const intptr half = size / 2;
+        if (size > NintherLimit)
+        {
+            sort3 (begin, begin + half, end - 1, comp);
+            sort3 (begin + 1, begin + (half - 1), end - 2, comp);
+            sort3 (begin + 2, begin + (half + 1), end - 3, comp);
+            sort3 (begin + (half - 1), begin + half, begin + (half + 1), comp);
+            exchange (*begin, *(begin + half));
+        }
+        else
+            sort3 (begin + half, begin, end - 1, comp);
+
+        // 左邻元素(上一个枢轴)不小于本枢轴，说明区间内有大量相等元素，整体放到左侧
+        if (!leftmost && !comp (*(begin - 1), *begin))
+        {
+            begin = partition_left (begin, end, comp) + 1;
+            continue;
+        }
 
-    begin = low + 1;
-    ++end;
-    goto top;
+        bool partitioned = false;
+        It pos = partition_right (begin, end, comp, partitioned);
+        const intptr lsize = pos - begin;
+        const intptr rsize = end - (pos + 1);
+
+        if (lsize < size / 8 || rsize < size / 8)
+        {
+            // 不平衡次数用完后退化为堆排序，保证O(n log n)
+            if (--bad == 0)
+            {
+                heap (begin, end, comp);
+                return;
+            }
+            shuffle (begin, pos);
+            shuffle (pos + 1, end);
+        }
+        else if (partitioned && partial_insertion (begin, pos, comp)
+                 && partial_insertion (pos + 1, end, comp))
+            return;
+
+        loop (begin, pos, comp, bad, leftmost);
+        begin = pos + 1;
+        leftmost = false;
+    }
+}
+
+template <typename It, typename Compare, typename T>
+void _pdq_<It, Compare, T>::sort(It begin, It end, Compare comp)
+{
+    intptr size = end - begin;
+    if (size < 2)
+        return;
+    int bad = 0;
+    for (; size > 0; size >>= 1)
+        ++bad;
+    loop (begin, end, comp, bad, true);
+}
+
+//! 由元素地址推导容器迭代器的元素类型
+template <typename It, typename T>
+inline void _quick_(It begin, It end, T *)
+{
+    _pdq_<It, ky_less<T>, T>::sort (begin, end, ky_less<T>());
+}
+template <typename It, typename Compare, typename T>
+inline void _quick_(It begin, It end, Compare comp, T *)
+{
+    _pdq_<It, Compare, T>::sort (begin, end, comp);
+}
+
+template<typename T>
+void quick(T *begin, T *end)
+{
+    _pdq_<T *, ky_less<T>, T>::sort (begin, end, ky_less<T>());
+}
+
+template<typename T, typename Compare>
+void quick(T *begin, T *end, Compare comp)
+{
+    _pdq_<T *, Compare, T>::sort (begin, end, comp);
+}
+
+template<typename container_iterator>
+void quick(container_iterator begin, container_iterator end)
+{
+    if (end - begin < 2)
+        return;
+    _quick_ (begin, end, &*begin);
+}
+
+template<typename container_iterator, typename Compare>
+void quick(container_iterator begin, container_iterator end, Compare comp)
+{
+    if (end - begin < 2)
+        return;
+    _quick_ (begin, end, comp, &*begin);
 }
 
 template <typename T>
@@ -219,49 +605,312 @@ void bubble (T *r, size_t length)
     }
 }
 
-template <typename T>
-inline void _merge_( T *arr, int low, int mid, int high)
+//! 合并两个有序区间到out，相等时先取a，保持稳定
+template <typename InA, typename InB, typename Out, typename Compare>
+Out _merge_(InA a, InA ae, InB b, InB be, Out out, Compare comp)
 {
-    int i = low, j = mid+1, k=0;
-    T temp[high-low+1]= {T()};
-    while (i <= mid && j <= high)
+    while (a != ae && b != be)
     {
-        if (arr[i] <= arr[j])
-            temp[k++] = arr[i++];
+        if (comp (*b, *a))
+        {
+            *out = moved (*b);
+            ++b;
+        }
         else
-            temp[k++] = arr[j++];
+        {
+            *out = moved (*a);
+            ++a;
+        }
+        ++out;
     }
-    while (i <= mid)
-        temp[k++] = arr[i++];
-    while (j <= high)
-        temp[k++] = arr[j++];
-    for(i = low, k = 0; i <= high; i++, k++)
-        arr[i] = temp[k];
+    for (; a != ae; ++a, ++out)
+        *out = moved (*a);
+    for (; b != be; ++b, ++out)
+        *out = moved (*b);
+    return out;
 }
-//!
-//! @brief bs_msort 归并排序算法
-//!
-//! @param arr 是待调整的堆数组
-//! @param length是数组的长度
-//!
+
+template <typename T, typename Compare>
+void merge(T *arr, size_t length, Compare comp)
+{
+    if (length < 2)
+        return;
+
+    // 先以插入排序得到定长有序段，再自底向上在数组与缓冲间交替归并
+    for (size_t i = 0; i < length; i += StableRun)
+        _pdq_<T *, Compare, T>::insertion (arr + i, arr + ky_min<size_t> (i + StableRun, length), comp);
+    if (length <= StableRun)
+        return;
+
+    T *buf = (T*)kyMalloc (sizeof(T) * length);
+    for (size_t i = 0; i < length; ++i)
+        new (buf + i) T(arr[i]);
+
+    T *src = arr;
+    T *dst = buf;
+    for (size_t width = StableRun; width < length; width *= 2)
+    {
+        for (size_t lo = 0; lo < length; lo += 2 * width)
+        {
+            const size_t mid = ky_min (lo + width, length);
+            const size_t hi = ky_min (lo + 2 * width, length);
+            if (mid < hi && comp (src[mid], src[mid - 1]))
+                _merge_ (src + lo, src + mid, src + mid, src + hi, dst + lo, comp);
+            else
+            {
+                for (size_t i = lo; i < hi; ++i)
+                    dst[i] = moved (src[i]);
+            }
+        }
+        T *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != arr)
+    {
+        for (size_t i = 0; i < length; ++i)
+            arr[i] = moved (src[i]);
+    }
+    for (size_t i = 0; i < length; ++i)
+        buf[i].~T();
+    kyFree (buf);
+}
+
 template <typename T>
 void merge(T *arr, size_t length)
 {
-    int size = 1, low, mid, high;
-    while(size <= (int)length-1)
+    merge (arr, length, ky_less<T>());
+}
+
+}
+
+namespace __hash_ {
+
+static const uint64 WYP[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+                              0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+inline void _mum_(uint64 &a, uint64 &b)
+{
+#if defined(__SIZEOF_INT128__)
+    const __uint128_t r = (__uint128_t)a * b;
+    a = (uint64)r;
+    b = (uint64)(r >> 64);
+#else
+    const uint64 ha = a >> 32, hb = b >> 32, la = (uint32)a, lb = (uint32)b;
+    const uint64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const uint64 t = rl + (rm0 << 32);
+    uint64 c = t < rl;
+    const uint64 lo = t + (rm1 << 32);
+    c += lo < t;
+    a = lo;
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+inline uint64 mix(uint64 a, uint64 b)
+{
+    _mum_(a, b);
+    return a ^ b;
+}
+
+inline uint64 _r8_(const uint8 *p){uint64 v; memcpy (&v, p, 8); return v;}
+inline uint64 _r4_(const uint8 *p){uint32 v; memcpy (&v, p, 4); return v;}
+inline uint64 _r3_(const uint8 *p, size_t k)
+{
+    return ((uint64)p[0] << 16) | ((uint64)p[k >> 1] << 8) | p[k - 1];
+}
+
+inline secret::secret(uint64 sd):seed(sd)
+{
+    // wyrand 序列展开密钥
+    for (int i = 0; i < Words; ++i)
+    {
+        sd += 0xa0761d6478bd642full;
+        key[i] = mix (sd, sd ^ 0xe7037ed1a0b428dbull);
+    }
+}
+
+inline const secret &secret::process()
+{
+    struct entropy
+    {
+        static uint64 gather()
+        {
+            static const int anchor = 0;
+            uint64 e = (uint64)(uintptr)&anchor ^ ((uint64)(uintptr)&gather << 21);
+            e ^= (uint64)time (NULL) * WYP[2];
+#ifdef kyHasClockGetTime
+            timespec ts;
+            clock_gettime (CLOCK_MONOTONIC, &ts);
+            e ^= ((uint64)ts.tv_sec << 30) ^ (uint64)ts.tv_nsec;
+#endif
+            return mix (e ^ WYP[0], WYP[1]);
+        }
+    };
+    static const secret sc(entropy::gather ());
+    return sc;
+}
+
+inline uint64 seed(){return secret::process ().seed;}
+
+inline uint64 WY64(uint64 v, uint64 sd)
+{
+    uint64 a = v ^ WYP[0], b = sd ^ WYP[1];
+    _mum_(a, b);
+    return mix (a ^ WYP[0], b ^ WYP[1]);
+}
+
+//! 一个64字节条带: acc[i] += d[i^1] + lo32(d^k) * hi32(d^k)
+inline void _accumulate_(uint64 *acc, const uint8 *p, const uint64 *key)
+{
+#if defined(kyHAS_AVX2)
+    for (int i = 0; i < 2; ++i)
+    {
+        const __m256i a = _mm256_loadu_si256 ((const __m256i *)acc + i);
+        const __m256i d = _mm256_loadu_si256 ((const __m256i *)p + i);
+        const __m256i dk = _mm256_xor_si256 (d, _mm256_loadu_si256 ((const __m256i *)key + i));
+        const __m256i pr = _mm256_mul_epu32 (dk, _mm256_srli_epi64 (dk, 32));
+        const __m256i sw = _mm256_shuffle_epi32 (d, _MM_SHUFFLE(1, 0, 3, 2));
+        _mm256_storeu_si256 ((__m256i *)acc + i, _mm256_add_epi64 (a, _mm256_add_epi64 (pr, sw)));
+    }
+#elif defined(kyHAS_SSE2)
+    for (int i = 0; i < 4; ++i)
+    {
+        const __m128i a = _mm_loadu_si128 ((const __m128i *)acc + i);
+        const __m128i d = _mm_loadu_si128 ((const __m128i *)p + i);
+        const __m128i dk = _mm_xor_si128 (d, _mm_loadu_si128 ((const __m128i *)key + i));
+        const __m128i pr = _mm_mul_epu32 (dk, _mm_srli_epi64 (dk, 32));
+        const __m128i sw = _mm_shuffle_epi32 (d, _MM_SHUFFLE(1, 0, 3, 2));
+        _mm_storeu_si128 ((__m128i *)acc + i, _mm_add_epi64 (a, _mm_add_epi64 (pr, sw)));
+    }
+#else
+    for (int i = 0; i < secret::StripeLanes; ++i)
+    {
+        const uint64 d = _r8_(p + i * 8);
+        const uint64 dk = d ^ key[i];
+        acc[i ^ 1] += d;
+        acc[i] += (dk & 0xffffffffull) * (dk >> 32);
+    }
+#endif
+}
+
+//! 块结束时搅拌: acc = (acc ^ acc >> 47 ^ k) * PRIME32
+inline void _scramble_(uint64 *acc, const uint64 *key)
+{
+    static const uint32 prime = 0x9E3779B1u;
+#if defined(kyHAS_AVX2)
+    const __m256i p32 = _mm256_set1_epi32 ((int)prime);
+    for (int i = 0; i < 2; ++i)
+    {
+        __m256i a = _mm256_loadu_si256 ((const __m256i *)acc + i);
+        a = _mm256_xor_si256 (a, _mm256_srli_epi64 (a, 47));
+        a = _mm256_xor_si256 (a, _mm256_loadu_si256 ((const __m256i *)key + i));
+        const __m256i lo = _mm256_mul_epu32 (a, p32);
+        const __m256i hi = _mm256_mul_epu32 (_mm256_srli_epi64 (a, 32), p32);
+        _mm256_storeu_si256 ((__m256i *)acc + i, _mm256_add_epi64 (lo, _mm256_slli_epi64 (hi, 32)));
+    }
+#elif defined(kyHAS_SSE2)
+    const __m128i p32 = _mm_set1_epi32 ((int)prime);
+    for (int i = 0; i < 4; ++i)
+    {
+        __m128i a = _mm_loadu_si128 ((const __m128i *)acc + i);
+        a = _mm_xor_si128 (a, _mm_srli_epi64 (a, 47));
+        a = _mm_xor_si128 (a, _mm_loadu_si128 ((const __m128i *)key + i));
+        const __m128i lo = _mm_mul_epu32 (a, p32);
+        const __m128i hi = _mm_mul_epu32 (_mm_srli_epi64 (a, 32), p32);
+        _mm_storeu_si128 ((__m128i *)acc + i, _mm_add_epi64 (lo, _mm_slli_epi64 (hi, 32)));
+    }
+#else
+    for (int i = 0; i < secret::StripeLanes; ++i)
+        acc[i] = (acc[i] ^ (acc[i] >> 47) ^ key[i]) * prime;
+#endif
+}
+
+inline uint64 _stripes_(const uint8 *p, size_t len, const secret &sc)
+{
+    enum {StripeBytes = secret::StripeLanes * 8, BlockBytes = StripeBytes * secret::BlockStripes};
+    const uint64 *key = sc.key;
+    uint64 acc[secret::StripeLanes] = {WYP[0], WYP[1], WYP[2], WYP[3],
+                                       ~WYP[0], ~WYP[1], ~WYP[2], ~WYP[3]};
+
+    const size_t nblock = (len - 1) / BlockBytes;
+    for (size_t b = 0; b < nblock; ++b)
+    {
+        for (int s = 0; s < secret::BlockStripes; ++s)
+            _accumulate_(acc, p + b * BlockBytes + s * StripeBytes, key + s);
+        _scramble_(acc, key + secret::BlockStripes);
+    }
+
+    const size_t nstripe = ((len - 1) - nblock * BlockBytes) / StripeBytes;
+    for (size_t s = 0; s < nstripe; ++s)
+        _accumulate_(acc, p + nblock * BlockBytes + s * StripeBytes, key + s);
+    // 最后一个条带与前面重叠，保证尾部字节参与
+    _accumulate_(acc, p + len - StripeBytes, key + secret::StripeLanes - 1);
+
+    uint64 r = (uint64)len * WYP[0] ^ sc.seed;
+    for (int i = 0; i < secret::StripeLanes; i += 2)
+        r += mix (acc[i] ^ key[secret::BlockStripes + i], acc[i + 1] ^ key[secret::BlockStripes + i + 1]);
+    return mix (r ^ WYP[2], sc.seed ^ WYP[3]);
+}
+
+inline uint64 WY(const void *data, size_t len, uint64 sd)
+{
+    const uint8 *p = (const uint8 *)data;
+    if (kyUnLikely(len > secret::LongKey))
+    {
+        const secret &ps = secret::process ();
+        if (kyLikely(sd == ps.seed))
+            return _stripes_(p, len, ps);
+        return _stripes_(p, len, secret(sd));
+    }
+
+    sd ^= mix (sd ^ WYP[0], WYP[1]);
+    uint64 a, b;
+    if (kyLikely(len <= 16))
     {
-        low = 0;
-        while(low + size <= (int)length-1)
+        if (kyLikely(len >= 4))
+        {
+            a = (_r4_(p) << 32) | _r4_(p + ((len >> 3) << 2));
+            b = (_r4_(p + len - 4) << 32) | _r4_(p + len - 4 - ((len >> 3) << 2));
+        }
+        else if (kyLikely(len > 0))
+        {
+            a = _r3_(p, len);
+            b = 0;
+        }
+        else
+            a = b = 0;
+    }
+    else
+    {
+        size_t i = len;
+        if (kyUnLikely(i > 48))
+        {
+            uint64 see1 = sd, see2 = sd;
+            do
+            {
+                sd = mix (_r8_(p) ^ WYP[1], _r8_(p + 8) ^ sd);
+                see1 = mix (_r8_(p + 16) ^ WYP[2], _r8_(p + 24) ^ see1);
+                see2 = mix (_r8_(p + 32) ^ WYP[3], _r8_(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (kyLikely(i > 48));
+            sd ^= see1 ^ see2;
+        }
+        while (kyUnLikely(i > 16))
         {
-            mid = low + size-1;
-            high = mid + size;
-            if(high > (int)length-1)
-                high = length-1;
-            _merge_<T>(arr, low, mid, high);
-            low = high+1;
+            sd = mix (_r8_(p) ^ WYP[1], _r8_(p + 8) ^ sd);
+            i -= 16;
+            p += 16;
         }
-        size *= 2;
+        a = _r8_(p + i - 16);
+        b = _r8_(p + i - 8);
     }
+    a ^= WYP[1];
+    b ^= sd;
+    _mum_(a, b);
+    return mix (a ^ WYP[0] ^ len, b ^ WYP[1]);
 }
 
 }
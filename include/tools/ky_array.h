@@ -13,7 +13,7 @@
  *
  * @author   kunyang
  * @email    kunyang.yk@gmail.com
- * @version  1.2.0.1
+ * @version  1.2.1.1
  * @date     2010/05/02
  * @license  GNU General Public License (GPL)
  *
@@ -26,6 +26,7 @@
  * 2016/06/29 | 1.0.2.3   | kunyang  | 修改引用计数的可复制对象
  * 2017/11/09 | 1.1.0.1   | kunyang  | 将内存分配器去掉，并把内存分配并入私有类中，用于实现内存池机制
  * 2018/03/26 | 1.2.0.1   | kunyang  | 将内存操作部分修改为ky_memory::array,实现高效内存操作
+ * 2026/10/18 | 1.2.1.1   | kunyang  | 加入右值添加及emplace就地构造，修正移动构造
  */
 
 #ifndef KY_ARRAY_H
@@ -34,6 +35,7 @@
 #include "ky_define.h"
 #include "ky_memory.h"
 #include "ky_typeinfo.h"
+#include "ky_algorlthm.h"
 
 /*!
  * @brief The ky_array class
@@ -60,6 +62,29 @@ public:
     ky_array& operator =(ky_array&& rhs);
     ky_array(const std::initializer_list<Type> & il);
 
+    //!
+    //! \brief prepend append insert 右值版本，元素移动构造
+    //! \param c
+    //! \return
+    //! \note 当内部有数据时并且也被引用此时会将数据分离
+    //!
+    ky_array &prepend(Type &&c);
+    ky_array &append(Type &&c);
+    ky_array &insert(int i, Type &&c);
+
+    //!
+    //! \brief emplace 在i位置以args就地构造元素
+    //! \param i
+    //! \param args
+    //! \return 返回构造的元素
+    //! \note 当内部有数据时并且也被引用此时会将数据分离
+    //!
+    template <typename ... Args>
+    Type &emplace(int i, Args &&...args);
+    template <typename ... Args>
+    Type &emplace_back(Args &&...args){return emplace (INT_MAX, std::forward<Args>(args)...);}
+    template <typename ... Args>
+    Type &emplace_front(Args &&...args){return emplace (0, std::forward<Args>(args)...);}
 #endif
 
 public:
@@ -309,13 +334,22 @@ public:
 protected:
     void  __detach_helper();
     T *__detach_insert(int i, int c);
+    T *__slot(int i);
     void __destroy_helper();
 };
 
 #include "ky_array.inl"
 
+//! 对象只保存内存块指针，可按位重定位
+template<typename T>
+struct is_relocatable<ky_array<T> >: public true_type_t { };
+
 typedef ky_array<uint8> ky_byte;
 
+//! 按字节散列数组内容，用于ky_byte、ky_utf16等作为哈希表的键
+template<typename T>
+inline uint64 ky_hash(const ky_array<T> &a){return __hash_::WY(a.data (), a.bytecount ());}
+
 namespace ky_codec
 {
 static const char base64Breaks = '\n';
@@ -46,7 +46,7 @@ T* ky_array<T>::__detach_insert(int i, int c)
     {
         T * cur = (T*)old.begin();
         T * e = (T*)old.end ();
-        while (cur++ != e)
+        for (; cur != e; ++cur)
         {
             if (not_construct)
                 ;
@@ -59,6 +59,19 @@ T* ky_array<T>::__detach_insert(int i, int c)
     return (T*)Layout::at (i);
 }
 
+//! 在i位置腾出一个未构造的元素，共享时先分离
+template <typename T>
+T* ky_array<T>::__slot(int i)
+{
+    if (refer ().is_shared ())
+        return __detach_insert (i, 1);
+    if (i <= 0)
+        return (T*)Layout::prepend (1);
+    if (i >= (int)size ())
+        return (T*)Layout::append (1);
+    return (T*)Layout::insert (i, 1);
+}
+
 template <typename T>
 void ky_array<T>::__destroy_helper()
 {
@@ -66,7 +79,7 @@ void ky_array<T>::__destroy_helper()
     {
         T* cur = (T*)Layout::begin();
         T* e = (T*)Layout::end ();
-        while (cur++ != e)
+        for (; cur != e; ++cur)
         {
             if (not_construct)
                 ;
@@ -279,7 +292,7 @@ ky_array<T> &ky_array<T>::prepend(const T *s, int len)
     }
     else
     {
-        T* n = Layout::prepend(len);
+        T* n = (T*)Layout::prepend(len);
         while (len-- > 0)
         {
             if (not_construct)
@@ -494,21 +507,49 @@ template<typename T>
 ky_array<T>::ky_array(ky_array&& rhs):
     Layout()
 {
-    *this = rhs;
+    *this = std::move (rhs);
 }
 
 template<typename T>
 ky_array<T>& ky_array<T>::operator =(ky_array&& rhs)
 {
-    __destroy_helper ();
-    if (rhs.is_null())
+    if (header == rhs.header)
         return *this;
 
+    __destroy_helper ();
     header = rhs.header;
     rhs.header = null();
     return *this;
 }
 
+template<typename T>
+ky_array<T> &ky_array<T>::prepend(T &&c)
+{
+    new (__slot (0)) T(std::move (c));
+    return *this;
+}
+
+template<typename T>
+ky_array<T> &ky_array<T>::append(T &&c)
+{
+    new (__slot (INT_MAX)) T(std::move (c));
+    return *this;
+}
+
+template<typename T>
+ky_array<T> &ky_array<T>::insert(int i, T &&c)
+{
+    new (__slot (i)) T(std::move (c));
+    return *this;
+}
+
+template<typename T>
+template <typename ... Args>
+T &ky_array<T>::emplace(int i, Args &&...args)
+{
+    return *new (__slot (i)) T(std::forward<Args>(args)...);
+}
+
 template<typename T>
 ky_array<T>::ky_array(const std::initializer_list<T> & il):
     Layout()
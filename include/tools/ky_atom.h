@@ -0,0 +1,90 @@
+
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_atom.h
+ * @brief    字符串驻留表(原子串)
+ *       1.相同内容的字符串映射为同一个32位编号，编号在进程内不变，0为空串
+ *       2.比较、散列只使用编号，为O(1)；用作ky_map、ky_hash_map的键时不再逐字符比较
+ *       3.驻留表按散列高位分为64段，查找不加锁，插入只锁所在的段
+ *       4.字符串以UTF-8存放在64K的块中，进程结束前不释放，name()返回的视图始终有效
+ *       5.编号上限为2^26个，用尽后新的字符串驻留为空的原子串
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ */
+#ifndef ky_ATOM_H
+#define ky_ATOM_H
+
+#include "ky_define.h"
+#include "ky_atomic.h"
+#include "ky_thread.h"
+#include "tools/ky_algorlthm.h"
+#include "tools/ky_u8string.h"
+#include "tools/ky_format.h"
+
+/*!
+ * @brief The ky_atom class 驻留后的字符串
+ * @class ky_atom
+ *  只保存编号，可按值传递；ky_string的内容先转为UTF-8再驻留
+ */
+class ky_atom
+{
+public:
+    ky_atom():ident(0){}
+    explicit ky_atom(const char *s);
+    ky_atom(const char *s, int len);
+    explicit ky_atom(const ky_u8stringview &s);
+    explicit ky_atom(const ky_u8string &s);
+    explicit ky_atom(const ky_stringview &s);
+    explicit ky_atom(const ky_string &s);
+
+    //!
+    //! \brief find 只查找不驻留
+    //! \return 字符串没有驻留过时返回空的原子串
+    //!
+    static ky_atom find(const ky_u8stringview &s);
+    static ky_atom find(const ky_stringview &s);
+
+    uint32 id()const{return ident;}
+    bool is_empty()const{return ident == 0;}
+
+    //! 驻留的内容，以0结尾
+    ky_u8stringview name()const;
+    const char *c_str()const;
+    int count()const;
+
+    ky_u8string to_u8string()const;
+    ky_string to_string()const;
+
+    //! 按编号比较，ky_map<ky_atom, V>的顺序为驻留的先后顺序而不是字典序
+    bool operator == (const ky_atom &rhs)const{return ident == rhs.ident;}
+    bool operator != (const ky_atom &rhs)const{return ident != rhs.ident;}
+    bool operator < (const ky_atom &rhs)const{return ident < rhs.ident;}
+
+    //! 已驻留的字符串个数，包括空串
+    static size_t total();
+    //! 驻留表占用的内存字节数
+    static size_t bytes();
+
+private:
+    uint32 ident;
+};
+
+inline uint64 ky_hash(const ky_atom &a){return __hash_::WY64 (a.id ());}
+
+inline void ky_format_value(ky_format::writer &w, const ky_format::spec &sp, const ky_atom &a)
+{
+    ky_format::value (w, sp, a.name ());
+}
+
+#include "ky_atom.inl"
+#endif // ky_ATOM_H
@@ -0,0 +1,349 @@
+#ifndef KY_ATOM_INL
+#define KY_ATOM_INL
+
+namespace __atom__
+{
+    enum
+    {
+        ChunkBits = 12,
+        ChunkSize = 1 << ChunkBits,     ///< 每块的条目数
+        ChunkCount = 1 << 14,           ///< 编号上限为ChunkSize * ChunkCount
+        Shards = 64,
+        ShardBits = 6,
+        IndexSize = 64,                 ///< 段的初始槽数
+        BlockSize = 64 * 1024,          ///< 字符串块
+        LargeSize = BlockSize / 4       ///< 超过时单独分配
+    };
+
+    //! 驻留的字符串，写入后不再修改
+    struct entry
+    {
+        const char *s;
+        uint32 n;
+        uint64 hash;
+    };
+
+    //! 段的开放寻址索引，槽中为编号，0为空槽
+    struct index
+    {
+        index *retired;     ///< 扩容前的索引，无锁查找可能仍在使用，不释放
+        uint32 mask;
+        uint32 used;
+        uint32 slots[1];
+    };
+
+    //! 每段独占缓存行，插入只锁所在的段
+    struct shard
+    {
+        ky_rwlock lock;             ///< 只用写锁
+        ky_atomic<index*> idx;
+    } kyQualifyAligned(64);
+
+    struct table
+    {
+        shard shards[Shards];
+        entry *chunks[ChunkCount];
+        ky_rwlock lock;             ///< 保护编号分配及字符串块，只用写锁
+        uint32 next;
+        char *block;
+        size_t left;
+        size_t bytes;
+
+        table():next(0), block(NULL), left(0), bytes(0)
+        {
+            memset (chunks, 0, sizeof(chunks));
+            for (int i = 0; i < Shards; ++i)
+                shards[i].idx.store (create (IndexSize), Fence_Release);
+            append ("", 0, __hash_::WY ("", 0));
+        }
+
+        const entry &at(uint32 id)const
+        {
+            return chunks[id >> ChunkBits][id & (ChunkSize - 1)];
+        }
+
+        index *create(uint32 size)
+        {
+            const size_t b = sizeof(index) + (size - 1) * sizeof(uint32);
+            index *ix = (index *)kyMalloc (b);
+            memset (ix, 0, b);
+            ix->mask = size - 1;
+            bytes += b;
+            return ix;
+        }
+
+        //! 复制到字符串块并追加条目，调用者持有段锁；编号用尽时返回0
+        uint32 append(const char *s, uint32 n, uint64 h);
+        //! 在索引中查找，不加锁
+        uint32 probe(const index *ix, const char *s, uint32 n, uint64 h)const;
+        uint32 intern(const char *s, uint32 n, uint64 h);
+    };
+
+    //! 按缓存行对齐分配，C++14的new不保证超对齐类型的对齐
+    inline table *create_table()
+    {
+        void *p = NULL;
+        if (posix_memalign (&p, 64, sizeof(table)) != 0)
+            abort ();
+        return new (p) table;
+    }
+    //! 进程级驻留表，不析构，保证静态对象析构时仍可使用
+    inline table &instance()
+    {
+        static table *t = create_table ();
+        return *t;
+    }
+
+    //! UTF-16先转为UTF-8，短串使用栈上缓冲
+    struct utf8
+    {
+        char buf[256 * 3];
+        char *s;
+        uint32 n;
+
+        explicit utf8(const ky_stringview &v):s(buf), n(0)
+        {
+            const size_t len = v.length ();
+            if (len * 3 > sizeof(buf))
+                s = (char *)kyMalloc (len * 3);
+            n = (uint32)ky_utf::utf16_to_utf8 (v.data (), len, (uint8 *)s, true);
+        }
+        ~utf8()
+        {
+            if (s != buf)
+                kyFree (s);
+        }
+    };
+}
+
+inline uint32 __atom__::table::append(const char *s, uint32 n, uint64 h)
+{
+    lock.lockwr ();
+    const uint32 id = next;
+    if (kyUnLikely(id >= (uint32)ChunkSize * ChunkCount))
+    {
+        lock.unlock ();
+        return 0;
+    }
+    if ((id & (ChunkSize - 1)) == 0)
+    {
+        chunks[id >> ChunkBits] = (entry *)kyMalloc (sizeof(entry) * ChunkSize);
+        bytes += sizeof(entry) * ChunkSize;
+    }
+
+    const size_t need = (size_t)n + 1;
+    char *p;
+    if (need > (size_t)LargeSize)
+    {
+        p = (char *)kyMalloc (need);
+        bytes += need;
+    }
+    else
+    {
+        if (need > left)
+        {
+            // 块尾不足时丢弃剩余部分，最多浪费LargeSize
+            block = (char *)kyMalloc (BlockSize);
+            left = BlockSize;
+            bytes += BlockSize;
+        }
+        p = block;
+        block += need;
+        left -= need;
+    }
+    memcpy (p, s, n);
+    p[n] = 0;
+
+    entry &e = chunks[id >> ChunkBits][id & (ChunkSize - 1)];
+    e.s = p;
+    e.n = n;
+    e.hash = h;
+    ++next;
+    lock.unlock ();
+    return id;
+}
+
+inline uint32 __atom__::table::probe(const index *ix, const char *s, uint32 n, uint64 h)const
+{
+    for (uint32 i = (uint32)h & ix->mask; ; i = (i + 1) & ix->mask)
+    {
+        // 编号在条目写入后以release发布，acquire读取后条目可见
+        const uint32 id = atomic_base::load (ix->slots[i], Fence_Acquire);
+        if (id == 0)
+            return 0;
+        const entry &e = at (id);
+        if (e.hash == h && e.n == n && memcmp (e.s, s, n) == 0)
+            return id;
+    }
+}
+
+inline uint32 __atom__::table::intern(const char *s, uint32 n, uint64 h)
+{
+    shard &sh = shards[h >> (64 - ShardBits)];
+    index *ix = sh.idx.load (Fence_Acquire);
+    uint32 id = probe (ix, s, n, h);
+    if (kyLikely(id != 0))
+        return id;
+
+    sh.lock.lockwr ();
+    ix = sh.idx.load (Fence_Acquire);
+    id = probe (ix, s, n, h);
+    if (id == 0)
+    {
+        if ((ix->used + 1) * 2 > ix->mask + 1)
+        {
+            // 装载因子超过1/2时加倍，新索引填好后再发布
+            lock.lockwr ();
+            index *nx = create ((ix->mask + 1) * 2);
+            lock.unlock ();
+            for (uint32 i = 0; i <= ix->mask; ++i)
+            {
+                const uint32 old = ix->slots[i];
+                if (old == 0)
+                    continue;
+                uint32 j = (uint32)at (old).hash & nx->mask;
+                while (nx->slots[j] != 0)
+                    j = (j + 1) & nx->mask;
+                nx->slots[j] = old;
+            }
+            nx->used = ix->used;
+            nx->retired = ix;
+            sh.idx.store (nx, Fence_Release);
+            ix = nx;
+        }
+
+        id = append (s, n, h);
+        if (kyUnLikely(id == 0))
+        {
+            sh.lock.unlock ();
+            return 0;
+        }
+        uint32 j = (uint32)h & ix->mask;
+        while (ix->slots[j] != 0)
+            j = (j + 1) & ix->mask;
+        atomic_base::store (ix->slots[j], id, Fence_Release);
+        ++ix->used;
+    }
+    sh.lock.unlock ();
+    return id;
+}
+
+inline ky_atom::ky_atom(const char *s):
+    ident(0)
+{
+    *this = ky_atom(s, s ? (int)strlen (s) : 0);
+}
+
+inline ky_atom::ky_atom(const char *s, int len):
+    ident(0)
+{
+    if (s != NULL && len > 0)
+        ident = __atom__::instance ().intern (s, (uint32)len, __hash_::WY (s, (size_t)len));
+}
+
+inline ky_atom::ky_atom(const ky_u8stringview &s):
+    ident(0)
+{
+    *this = ky_atom(s.data (), s.count ());
+}
+
+inline ky_atom::ky_atom(const ky_u8string &s):
+    ident(0)
+{
+    *this = ky_atom(s.data (), s.count ());
+}
+
+inline ky_atom::ky_atom(const ky_stringview &s):
+    ident(0)
+{
+    if (s.count () > 0)
+    {
+        const __atom__::utf8 u(s);
+        *this = ky_atom(u.s, (int)u.n);
+    }
+}
+
+inline ky_atom::ky_atom(const ky_string &s):
+    ident(0)
+{
+    *this = ky_atom(s.view ());
+}
+
+inline ky_atom ky_atom::find(const ky_u8stringview &s)
+{
+    ky_atom a;
+    if (s.count () > 0)
+    {
+        const uint64 h = __hash_::WY (s.data (), s.length ());
+        __atom__::table &t = __atom__::instance ();
+        __atom__::shard &sh = t.shards[h >> (64 - __atom__::ShardBits)];
+        // 扩容后发布的索引包含全部旧编号，读到最新的索引不会漏掉已完成的插入
+        const __atom__::index *ix = sh.idx.load (Fence_Acquire);
+        a.ident = t.probe (ix, s.data (), (uint32)s.length (), h);
+    }
+    return a;
+}
+
+inline ky_atom ky_atom::find(const ky_stringview &s)
+{
+    if (s.count () <= 0)
+        return ky_atom();
+    const __atom__::utf8 u(s);
+    return find (ky_u8stringview(u.s, (int)u.n));
+}
+
+inline ky_u8stringview ky_atom::name()const
+{
+    const __atom__::entry &e = __atom__::instance ().at (ident);
+    return ky_u8stringview(e.s, (int)e.n);
+}
+
+inline const char *ky_atom::c_str()const
+{
+    return __atom__::instance ().at (ident).s;
+}
+
+inline int ky_atom::count()const
+{
+    return (int)__atom__::instance ().at (ident).n;
+}
+
+inline ky_u8string ky_atom::to_u8string()const
+{
+    const __atom__::entry &e = __atom__::instance ().at (ident);
+    return ky_u8string(e.s, (int)e.n);
+}
+
+inline ky_string ky_atom::to_string()const
+{
+    const __atom__::entry &e = __atom__::instance ().at (ident);
+    if (e.n == 0)
+        return ky_string();
+    uint16 buf[256];
+    uint16 *u = e.n <= 256 ? buf : (uint16 *)kyMalloc (e.n * sizeof(uint16));
+    const size_t w = ky_utf::utf8_to_utf16 ((const uint8 *)e.s, e.n, u, true);
+    ky_string out((const ky_char *)u, (int)w);
+    if (u != buf)
+        kyFree (u);
+    return out;
+}
+
+inline size_t ky_atom::total()
+{
+    __atom__::table &t = __atom__::instance ();
+    t.lock.lockwr ();
+    const size_t n = t.next;
+    t.lock.unlock ();
+    return n;
+}
+
+inline size_t ky_atom::bytes()
+{
+    __atom__::table &t = __atom__::instance ();
+    t.lock.lockwr ();
+    const size_t n = t.bytes + sizeof(__atom__::table);
+    t.lock.unlock ();
+    return n;
+}
+
+#endif // KY_ATOM_INL
@@ -4,13 +4,14 @@
  * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
  *
  * @file     ky_bitset.h
- * @brief    位操作类最大支持64位
+ * @brief    位操作类
  *       1.位操作支持bin宏实现的ky_binary对象.
  *       2.支持运算符操作
+ *       3.超过64位时以uint64数组存储，整块运算、计数和查找由__bitset__中的函数完成
  *
  * @author   kunyang
  * @email    kunyang.yk@gmail.com
- * @version  1.0.3.0
+ * @version  1.1.0.0
  * @date     2016/04/11
  * @license  GNU General Public License (GPL)
  *
@@ -20,6 +21,7 @@
  * 2016/04/12 | 1.0.1.0   | kunyang  | 修改内部操作位时使用BIT方法
  * 2017/01/07 | 1.0.2.0   | kunyang  | 实现基本的运算符操作
  * 2017/04/29 | 1.0.3.0   | kunyang  | 实现bin宏模式赋值
+ * 2026/10/18 | 1.1.0.0   | kunyang  | 增加超过64位的数组存储特化及AVX2整块运算
  */
 #ifndef ky_BITSET_H
 #define ky_BITSET_H
@@ -51,20 +53,62 @@ typedef enum
     YES = 1
 } eBitsets;
 
+//! 以uint64数组存储位的整块运算，ky_bitset的宽位特化和ky_dynbitset共用
+namespace __bitset__
+{
+    enum {WordBits = 64};
+
+    inline size_t words(size_t bits) {return (bits + WordBits - 1) / WordBits;}
+    //! 最后一个字中有效位的掩码
+    inline uint64 tail_mask(size_t bits)
+    {return bits % WordBits ? (uint64(1) << (bits % WordBits)) - 1 : ~uint64(0);}
+
+    //! 最低位1的序号，w不能为0
+    inline int ctz(uint64 w);
+    inline int popcount(uint64 w);
+
+    inline size_t count(const uint64 *w, size_t n);
+    inline bool any(const uint64 *w, size_t n);
+    inline bool equal(const uint64 *a, const uint64 *b, size_t n);
+
+    //! d = a op b，d可与a或b相同
+    inline void bit_and(uint64 *d, const uint64 *a, const uint64 *b, size_t n);
+    inline void bit_or(uint64 *d, const uint64 *a, const uint64 *b, size_t n);
+    inline void bit_xor(uint64 *d, const uint64 *a, const uint64 *b, size_t n);
+    inline void bit_not(uint64 *d, const uint64 *a, size_t n);
+
+    //! 向高位(左)或低位(右)移动b位，移出的位丢弃
+    inline void shift_left(uint64 *w, size_t n, size_t b);
+    inline void shift_right(uint64 *w, size_t n, size_t b);
+
+    //!
+    //! \brief find 从from位开始的第一个1
+    //! \return 没有时返回n * WordBits
+    //!
+    inline size_t find(const uint64 *w, size_t n, size_t from);
+    //! 按从低到高的次序以fn(序号)访问每个1
+    template <typename Fn>
+    void each(const uint64 *w, size_t n, Fn &fn);
+}
+
 /*!
  * @brief The ky_bitset class
  * @class ky_bitset
+ * @note 不超过64位时以位域存储，超过时以uint64数组存储
  */
+template <int tBits, bool tWide = (tBits > 64)>
+class ky_bitset;
+
 template <int tBits>
-class ky_bitset
+class ky_bitset<tBits, false>
 {
 public:
     enum{bits = tBits, size = tBits};
 
     ky_bitset(uint64 v = 0);
-    ky_bitset(const ky_bitset<tBits> &rhs);
+    ky_bitset(const ky_bitset<tBits, false> &rhs);
 
-    ky_bitset<tBits> &operator = (const ky_binary &v){form_string (v.bc);return *this;}
+    ky_bitset<tBits, false> &operator = (const ky_binary &v){form_string (v.bc);return *this;}
 private:
     struct BIT
     {
@@ -85,42 +129,42 @@ public:
     //! \param rhs
     //! \return  返回一个运算结果
     //!
-    ky_bitset<tBits> operator & (const ky_bitset<tBits> &rhs)const;
-    ky_bitset<tBits> operator | (const ky_bitset<tBits> &rhs)const;
-    ky_bitset<tBits> operator ~ ()const;
-    ky_bitset<tBits> operator ^ (const ky_bitset<tBits> &rhs)const;
+    ky_bitset<tBits, false> operator & (const ky_bitset<tBits, false> &rhs)const;
+    ky_bitset<tBits, false> operator | (const ky_bitset<tBits, false> &rhs)const;
+    ky_bitset<tBits, false> operator ~ ()const;
+    ky_bitset<tBits, false> operator ^ (const ky_bitset<tBits, false> &rhs)const;
 
     //!
     //! \brief operator 重载按位与、或、非、异或运算,并改变自身值
     //! \param rhs
     //! \return
     //!
-    ky_bitset<tBits> &operator &= (const ky_bitset<tBits> &rhs);
-    ky_bitset<tBits> &operator |= (const ky_bitset<tBits> &rhs);
-    ky_bitset<tBits> &operator ~ ();
-    ky_bitset<tBits> &operator ^= (const ky_bitset<tBits> &rhs);
+    ky_bitset<tBits, false> &operator &= (const ky_bitset<tBits, false> &rhs);
+    ky_bitset<tBits, false> &operator |= (const ky_bitset<tBits, false> &rhs);
+    ky_bitset<tBits, false> &operator ~ ();
+    ky_bitset<tBits, false> &operator ^= (const ky_bitset<tBits, false> &rhs);
 
     //!
     //! \brief operator 重载左右移位操作
     //! \param rhs
     //! \return
     //!
-    ky_bitset<tBits> operator << (uint b)const;
-    ky_bitset<tBits> operator >> (uint b)const;
-    ky_bitset<tBits> &operator <<= (uint b);
-    ky_bitset<tBits> &operator >>= (uint b);
+    ky_bitset<tBits, false> operator << (uint b)const;
+    ky_bitset<tBits, false> operator >> (uint b)const;
+    ky_bitset<tBits, false> &operator <<= (uint b);
+    ky_bitset<tBits, false> &operator >>= (uint b);
 
     //!
     //! \brief operator 重载逻辑运算
     //! \param rhs
     //! \return
     //!
-    bool operator || (const ky_bitset<tBits> &rhs)const;
-    bool operator && (const ky_bitset<tBits> &rhs)const;
+    bool operator || (const ky_bitset<tBits, false> &rhs)const;
+    bool operator && (const ky_bitset<tBits, false> &rhs)const;
     bool operator ! ()const;
 
-    bool operator == (const ky_bitset<tBits> &rhs);
-    bool operator != (const ky_bitset<tBits> &rhs);
+    bool operator == (const ky_bitset<tBits, false> &rhs);
+    bool operator != (const ky_bitset<tBits, false> &rhs);
 
 public:
     //!
@@ -192,6 +236,109 @@ private:
         BIT val;
 };
 
+/*!
+ * @brief The ky_bitset class 超过64位的定长位集
+ * @class ky_bitset
+ */
+template <int tBits>
+class ky_bitset<tBits, true>
+{
+public:
+    enum{bits = tBits, size = tBits, words = (tBits + 63) / 64};
+
+    ky_bitset(uint64 v = 0);
+    ky_bitset(const ky_bitset<tBits, true> &rhs);
+
+    ky_bitset<tBits, true> &operator = (const ky_bitset<tBits, true> &rhs);
+    ky_bitset<tBits, true> &operator = (const ky_binary &v){form_string (v.bc);return *this;}
+
+    //! 单个位的引用
+    class reference
+    {
+        friend class ky_bitset<tBits, true>;
+        uint64 *word;
+        uint64 mask;
+        reference(uint64 *w, uint bit):word(w + bit / 64), mask(uint64(1) << (bit % 64)){}
+    public:
+        reference &operator = (bool b){if (b) *word |= mask; else *word &= ~mask; return *this;}
+        reference &operator = (eBitsets b){return *this = (b != FALSE);}
+        operator bool() const {return (*word & mask) != 0;}
+        bool operator == (eBitsets b)const{return bool(*this) == (b != FALSE);}
+        bool operator != (eBitsets b)const{return bool(*this) != (b != FALSE);}
+    };
+
+public:
+    ky_bitset<tBits, true> operator & (const ky_bitset<tBits, true> &rhs)const;
+    ky_bitset<tBits, true> operator | (const ky_bitset<tBits, true> &rhs)const;
+    ky_bitset<tBits, true> operator ~ ()const;
+    ky_bitset<tBits, true> operator ^ (const ky_bitset<tBits, true> &rhs)const;
+
+    ky_bitset<tBits, true> &operator &= (const ky_bitset<tBits, true> &rhs);
+    ky_bitset<tBits, true> &operator |= (const ky_bitset<tBits, true> &rhs);
+    ky_bitset<tBits, true> &operator ~ ();
+    ky_bitset<tBits, true> &operator ^= (const ky_bitset<tBits, true> &rhs);
+
+    ky_bitset<tBits, true> operator << (uint b)const;
+    ky_bitset<tBits, true> operator >> (uint b)const;
+    ky_bitset<tBits, true> &operator <<= (uint b);
+    ky_bitset<tBits, true> &operator >>= (uint b);
+
+    bool operator || (const ky_bitset<tBits, true> &rhs)const;
+    bool operator && (const ky_bitset<tBits, true> &rhs)const;
+    bool operator ! ()const;
+
+    bool operator == (const ky_bitset<tBits, true> &rhs)const;
+    bool operator != (const ky_bitset<tBits, true> &rhs)const;
+
+public:
+    reference operator [](uint bit){return reference(word, bit);}
+    bool operator [](uint bit)const{return test (bit);}
+    bool test(uint bit)const{return (word[bit / 64] >> (bit % 64)) & 1;}
+
+    //! 低64位的值
+    uint64 value()const{return word[0];}
+    uint64 *data(){return word;}
+    const uint64 *data()const{return word;}
+
+public:
+    void set();
+    void set(uint bit){word[bit / 64] |= uint64(1) << (bit % 64);}
+    void unset();
+    void unset(uint bit){word[bit / 64] &= ~(uint64(1) << (bit % 64));}
+
+    bool any()const;
+    bool none()const;
+    int count()const;
+
+    void flip();
+    void flip(uint bit){word[bit / 64] ^= uint64(1) << (bit % 64);}
+
+    //!
+    //! \brief find_first 第一个有效位的序号，没有时返回-1
+    //!
+    int find_first()const;
+    //!
+    //! \brief find_next bit之后的第一个有效位的序号，没有时返回-1
+    //!
+    int find_next(int bit)const;
+    //!
+    //! \brief each 从低到高以fn(int)访问每个有效位
+    //!
+    template <typename Fn>
+    void each(Fn fn)const;
+
+    ky_string to_string()const;
+    void form_string(const ky_string &s);
+
+    void swap(ky_bitset &b);
+    friend void ky_swap(ky_bitset &a, ky_bitset &b) {a.swap(b);}
+
+private:
+    void trim(){word[words - 1] &= __bitset__::tail_mask (bits);}
+
+    uint64 word[words];
+};
+
 
 #include "ky_bitset.inl"
 #endif
@@ -1,20 +1,238 @@
 
+namespace __bitset__ {
+
+inline int ctz(uint64 w)
+{
+#if defined(kyHAS_BMI)
+    return (int)_tzcnt_u64 (w);
+#elif (kyCompiler == kyCompiler_GNUC) || (kyCompiler == kyCompiler_CLANG)
+    return __builtin_ctzll (w);
+#else
+    int n = 0;
+    while (!(w & 1))
+    {
+        w >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+inline int popcount(uint64 w)
+{
+#if defined(kyHAS_POPCNT)
+    return (int)_mm_popcnt_u64 (w);
+#elif (kyCompiler == kyCompiler_GNUC) || (kyCompiler == kyCompiler_CLANG)
+    return __builtin_popcountll (w);
+#else
+    w = w - ((w >> 1) & 0x5555555555555555ull);
+    w = (w & 0x3333333333333333ull) + ((w >> 2) & 0x3333333333333333ull);
+    w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return (int)((w * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+#if defined(kyHAS_AVX2)
+//! 每字节查表求4位的计数再按64位横向求和，结果为4个64位计数
+inline __m256i _popcount256_(__m256i v)
+{
+    const __m256i lookup = _mm256_setr_epi8 (0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                             0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8 (0x0f);
+    const __m256i lo = _mm256_and_si256 (v, low);
+    const __m256i hi = _mm256_and_si256 (_mm256_srli_epi16 (v, 4), low);
+    const __m256i c = _mm256_add_epi8 (_mm256_shuffle_epi8 (lookup, lo),
+                                       _mm256_shuffle_epi8 (lookup, hi));
+    return _mm256_sad_epu8 (c, _mm256_setzero_si256 ());
+}
+#endif
+
+inline size_t count(const uint64 *w, size_t n)
+{
+    size_t i = 0;
+    size_t c = 0;
+#if defined(kyHAS_AVX2)
+    __m256i acc = _mm256_setzero_si256 ();
+    for (; i + 4 <= n; i += 4)
+        acc = _mm256_add_epi64 (acc, _popcount256_ (_mm256_loadu_si256 ((const __m256i *)(w + i))));
+    c = (size_t)(_mm256_extract_epi64 (acc, 0) + _mm256_extract_epi64 (acc, 1) +
+                 _mm256_extract_epi64 (acc, 2) + _mm256_extract_epi64 (acc, 3));
+#endif
+    for (; i < n; ++i)
+        c += popcount (w[i]);
+    return c;
+}
+
+inline bool any(const uint64 *w, size_t n)
+{
+    size_t i = 0;
+#if defined(kyHAS_AVX2)
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m256i v = _mm256_loadu_si256 ((const __m256i *)(w + i));
+        if (!_mm256_testz_si256 (v, v))
+            return true;
+    }
+#endif
+    for (; i < n; ++i)
+        if (w[i])
+            return true;
+    return false;
+}
+
+inline bool equal(const uint64 *a, const uint64 *b, size_t n)
+{
+    size_t i = 0;
+#if defined(kyHAS_AVX2)
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m256i x = _mm256_xor_si256 (_mm256_loadu_si256 ((const __m256i *)(a + i)),
+                                            _mm256_loadu_si256 ((const __m256i *)(b + i)));
+        if (!_mm256_testz_si256 (x, x))
+            return false;
+    }
+#endif
+    for (; i < n; ++i)
+        if (a[i] != b[i])
+            return false;
+    return true;
+}
+
+#if defined(kyHAS_AVX2)
+#define kyBitsetBinary(name, simd, op) \
+    inline void name(uint64 *d, const uint64 *a, const uint64 *b, size_t n) \
+    { \
+        size_t i = 0; \
+        for (; i + 4 <= n; i += 4) \
+            _mm256_storeu_si256 ((__m256i *)(d + i), \
+                                 simd (_mm256_loadu_si256 ((const __m256i *)(a + i)), \
+                                       _mm256_loadu_si256 ((const __m256i *)(b + i)))); \
+        for (; i < n; ++i) \
+            d[i] = a[i] op b[i]; \
+    }
+#else
+#define kyBitsetBinary(name, simd, op) \
+    inline void name(uint64 *d, const uint64 *a, const uint64 *b, size_t n) \
+    { \
+        for (size_t i = 0; i < n; ++i) \
+            d[i] = a[i] op b[i]; \
+    }
+#endif
+
+kyBitsetBinary(bit_and, _mm256_and_si256, &)
+kyBitsetBinary(bit_or, _mm256_or_si256, |)
+kyBitsetBinary(bit_xor, _mm256_xor_si256, ^)
+#undef kyBitsetBinary
+
+inline void bit_not(uint64 *d, const uint64 *a, size_t n)
+{
+    size_t i = 0;
+#if defined(kyHAS_AVX2)
+    const __m256i ones = _mm256_set1_epi64x (-1);
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_si256 ((__m256i *)(d + i),
+                             _mm256_xor_si256 (_mm256_loadu_si256 ((const __m256i *)(a + i)), ones));
+#endif
+    for (; i < n; ++i)
+        d[i] = ~a[i];
+}
+
+inline void shift_left(uint64 *w, size_t n, size_t b)
+{
+    const size_t s = b / WordBits;
+    const int r = (int)(b % WordBits);
+    if (n == 0)
+        return;
+    if (s >= n)
+    {
+        memset (w, 0, n * sizeof(uint64));
+        return;
+    }
+    for (size_t i = n; i-- > s; )
+    {
+        uint64 v = w[i - s] << r;
+        if (r && i > s)
+            v |= w[i - s - 1] >> (WordBits - r);
+        w[i] = v;
+    }
+    memset (w, 0, s * sizeof(uint64));
+}
+
+inline void shift_right(uint64 *w, size_t n, size_t b)
+{
+    const size_t s = b / WordBits;
+    const int r = (int)(b % WordBits);
+    if (n == 0)
+        return;
+    if (s >= n)
+    {
+        memset (w, 0, n * sizeof(uint64));
+        return;
+    }
+    for (size_t i = 0; i + s < n; ++i)
+    {
+        uint64 v = w[i + s] >> r;
+        if (r && i + s + 1 < n)
+            v |= w[i + s + 1] << (WordBits - r);
+        w[i] = v;
+    }
+    memset (w + (n - s), 0, s * sizeof(uint64));
+}
+
+inline size_t find(const uint64 *w, size_t n, size_t from)
+{
+    size_t i = from / WordBits;
+    if (i >= n)
+        return n * WordBits;
+    uint64 x = w[i] & (~uint64(0) << (from % WordBits));
+    if (x)
+        return i * WordBits + ctz (x);
+
+    // 跳过全0的区域
+    ++i;
+#if defined(kyHAS_AVX2)
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m256i v = _mm256_loadu_si256 ((const __m256i *)(w + i));
+        if (!_mm256_testz_si256 (v, v))
+            break;
+    }
+#endif
+    for (; i < n; ++i)
+        if (w[i])
+            return i * WordBits + ctz (w[i]);
+    return n * WordBits;
+}
+
+template <typename Fn>
+void each(const uint64 *w, size_t n, Fn &fn)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        // 每次清除最低位的1，只访问有效位
+        for (uint64 x = w[i]; x; x &= x - 1)
+            fn (i * WordBits + ctz (x));
+    }
+}
+
+}
+
 
 template <int tBits>
-ky_bitset<tBits>::ky_bitset(uint64 v)
+ky_bitset<tBits, false>::ky_bitset(uint64 v)
 {
     val.ob = 0;val.v = v;
 }
 
 template <int tBits>
-ky_bitset<tBits>::ky_bitset(const ky_bitset<tBits> &rhs)
+ky_bitset<tBits, false>::ky_bitset(const ky_bitset<tBits, false> &rhs)
 {
     val.v = rhs.val.v;
     val.ob = rhs.val.ob;
 }
 
 template <int tBits>
-typename ky_bitset<tBits>::BIT &ky_bitset<tBits>::BIT::operator = (eBitsets b)
+typename ky_bitset<tBits, false>::BIT &ky_bitset<tBits, false>::BIT::operator = (eBitsets b)
 {
     if (b)
         v |= ((1 << ob) & ~(0));
@@ -23,122 +241,122 @@ typename ky_bitset<tBits>::BIT &ky_bitset<tBits>::BIT::operator = (eBitsets b)
     return *this;
 }
 template <int tBits>
-bool ky_bitset<tBits>::BIT::operator == (eBitsets b)const
+bool ky_bitset<tBits, false>::BIT::operator == (eBitsets b)const
 {
     return ((v >> ob) & 0x01) == b;
 }
 template <int tBits>
-bool ky_bitset<tBits>::BIT::operator != (eBitsets b)const
+bool ky_bitset<tBits, false>::BIT::operator != (eBitsets b)const
 {
     return ((v >> ob) & 0x01) != b;
 }
 
 template <int tBits>
-ky_bitset<tBits> ky_bitset<tBits>::operator & (const ky_bitset<tBits> &rhs)const
+ky_bitset<tBits, false> ky_bitset<tBits, false>::operator & (const ky_bitset<tBits, false> &rhs)const
 {
-    ky_bitset<tBits> out;
+    ky_bitset<tBits, false> out;
     out.val.v = this->val.v & rhs.val.v;
     return out;
 }
 template <int tBits>
-ky_bitset<tBits> ky_bitset<tBits>::operator | (const ky_bitset<tBits> &rhs)const
+ky_bitset<tBits, false> ky_bitset<tBits, false>::operator | (const ky_bitset<tBits, false> &rhs)const
 {
-    ky_bitset<tBits> out;
+    ky_bitset<tBits, false> out;
     out.val.v = this->val.v | rhs.val.v;
     return out;
 }
 template <int tBits>
-ky_bitset<tBits> ky_bitset<tBits>::operator ~ ()const
+ky_bitset<tBits, false> ky_bitset<tBits, false>::operator ~ ()const
 {
     ky_bitset<bits> out;
     out.val.v = ~this->val.v;
     return out;
 }
 template <int tBits>
-ky_bitset<tBits> ky_bitset<tBits>::operator ^ (const ky_bitset<tBits> &rhs)const
+ky_bitset<tBits, false> ky_bitset<tBits, false>::operator ^ (const ky_bitset<tBits, false> &rhs)const
 {
     ky_bitset<bits> out;
     out.val.v = ~this->val.v ^ rhs.val.v;
     return out;
 }
 template <int tBits>
-ky_bitset<tBits> &ky_bitset<tBits>::operator &= (const ky_bitset<tBits> &rhs)
+ky_bitset<tBits, false> &ky_bitset<tBits, false>::operator &= (const ky_bitset<tBits, false> &rhs)
 {
     this->val.v &= rhs.val.v;
     return *this;
 }
 template <int tBits>
-ky_bitset<tBits> &ky_bitset<tBits>::operator |= (const ky_bitset<tBits> &rhs)
+ky_bitset<tBits, false> &ky_bitset<tBits, false>::operator |= (const ky_bitset<tBits, false> &rhs)
 {
     this->val.v |= rhs.val.v;
     return *this;
 }
 template <int tBits>
-ky_bitset<tBits> &ky_bitset<tBits>::operator ~ ()
+ky_bitset<tBits, false> &ky_bitset<tBits, false>::operator ~ ()
 {
     this->val.v = ~this->val.v;
     return *this;
 }
 template <int tBits>
-ky_bitset<tBits> &ky_bitset<tBits>::operator ^= (const ky_bitset<tBits> &rhs)
+ky_bitset<tBits, false> &ky_bitset<tBits, false>::operator ^= (const ky_bitset<tBits, false> &rhs)
 {
     this->val.v ^= rhs.val.v;
     return *this;
 }
 template <int tBits>
-ky_bitset<tBits> ky_bitset<tBits>::operator << (uint b)const
+ky_bitset<tBits, false> ky_bitset<tBits, false>::operator << (uint b)const
 {
     ky_bitset<bits> out;
     out.val.v = this->val.v << b;
     return out;
 }
 template <int tBits>
-ky_bitset<tBits> ky_bitset<tBits>::operator >> (uint b)const
+ky_bitset<tBits, false> ky_bitset<tBits, false>::operator >> (uint b)const
 {
     ky_bitset<bits> out;
     out.val.v = this->val.v >> b;
     return out;
 }
 template <int tBits>
-ky_bitset<tBits> &ky_bitset<tBits>::operator <<= (uint b)
+ky_bitset<tBits, false> &ky_bitset<tBits, false>::operator <<= (uint b)
 {
     this->val.v <<= b;
     return *this;
 }
 template <int tBits>
-ky_bitset<tBits> &ky_bitset<tBits>::operator >>= (uint b)
+ky_bitset<tBits, false> &ky_bitset<tBits, false>::operator >>= (uint b)
 {
     this->val.v >>= b;
     return *this;
 }
 template <int tBits>
-bool ky_bitset<tBits>::operator || (const ky_bitset<tBits> &rhs)const
+bool ky_bitset<tBits, false>::operator || (const ky_bitset<tBits, false> &rhs)const
 {
     return this->val.v || rhs.val.v;
 }
 template <int tBits>
-bool ky_bitset<tBits>::operator && (const ky_bitset<tBits> &rhs)const
+bool ky_bitset<tBits, false>::operator && (const ky_bitset<tBits, false> &rhs)const
 {
     return this->val.v && rhs.val.v;
 }
 template <int tBits>
-bool ky_bitset<tBits>::operator ! ()const
+bool ky_bitset<tBits, false>::operator ! ()const
 {
     return !this->val.v;
 }
 
 template <int tBits>
-bool ky_bitset<tBits>::operator == (const ky_bitset<tBits> &rhs)
+bool ky_bitset<tBits, false>::operator == (const ky_bitset<tBits, false> &rhs)
 {
     return this->val.v == rhs.val.v;
 }
 template <int tBits>
-bool ky_bitset<tBits>::operator != (const ky_bitset<tBits> &rhs)
+bool ky_bitset<tBits, false>::operator != (const ky_bitset<tBits, false> &rhs)
 {
     return !this->operator == (rhs);
 }
 template <int tBits>
-typename ky_bitset<tBits>::BIT &ky_bitset<tBits>::operator [](uint bit)
+typename ky_bitset<tBits, false>::BIT &ky_bitset<tBits, false>::operator [](uint bit)
 {
     static BIT sv;
     if (bit < bits)
@@ -149,10 +367,10 @@ typename ky_bitset<tBits>::BIT &ky_bitset<tBits>::operator [](uint bit)
     return sv;
 }
 template <int tBits>
-const typename ky_bitset<tBits>::BIT &ky_bitset<tBits>::operator [](uint bit)const
+const typename ky_bitset<tBits, false>::BIT &ky_bitset<tBits, false>::operator [](uint bit)const
 {
     static BIT sv;
-    ky_bitset<tBits> *fack = (ky_bitset<tBits> *)this;
+    ky_bitset<tBits, false> *fack = (ky_bitset<tBits, false> *)this;
     if (bit < bits)
     {
         fack->val.ob = bit;
@@ -161,51 +379,47 @@ const typename ky_bitset<tBits>::BIT &ky_bitset<tBits>::operator [](uint bit)con
     return sv;
 }
 template <int tBits>
-void ky_bitset<tBits>::set()
+void ky_bitset<tBits, false>::set()
 {
     val.v = ~(0);
 }
 template <int tBits>
-void ky_bitset<tBits>::set(uint bit)
+void ky_bitset<tBits, false>::set(uint bit)
 {
     this->operator [] (bit) = TRUE;
 }
 template <int tBits>
-void ky_bitset<tBits>::unset()
+void ky_bitset<tBits, false>::unset()
 {
     val.v = 0;
 }
 template <int tBits>
-void ky_bitset<tBits>::unset(uint bit)
+void ky_bitset<tBits, false>::unset(uint bit)
 {
     this->operator [] (bit) = FALSE;
 }
 template <int tBits>
-bool ky_bitset<tBits>::any()const
+bool ky_bitset<tBits, false>::any()const
 {
     return val.v & ~(0);
 }
 template <int tBits>
-bool ky_bitset<tBits>::none()const
+bool ky_bitset<tBits, false>::none()const
 {
     return !any();
 }
 template <int tBits>
-int ky_bitset<tBits>::count()const
+int ky_bitset<tBits, false>::count()const
 {
-    int num = 0;
-    for (int i = 0; i < bits; ++i)
-        if (this->operator [] (i) == TRUE)
-            num++;
-    return num;
+    return __bitset__::popcount (val.v);
 }
 template <int tBits>
-void ky_bitset<tBits>::flip()
+void ky_bitset<tBits, false>::flip()
 {
     this->operator ~ ();
 }
 template <int tBits>
-void ky_bitset<tBits>::flip(uint bit)
+void ky_bitset<tBits, false>::flip(uint bit)
 {
     if (this->operator [] (bit))
         unset(bit);
@@ -215,7 +429,7 @@ void ky_bitset<tBits>::flip(uint bit)
 
 
 template <int tBits>
-ky_string ky_bitset<tBits>::to_string()const
+ky_string ky_bitset<tBits, false>::to_string()const
 {
     ky_string out("b");
     out.form (val.v, 2);
@@ -223,7 +437,7 @@ ky_string ky_bitset<tBits>::to_string()const
 }
 
 template <int tBits>
-void ky_bitset<tBits>::form_string(const ky_string &s)
+void ky_bitset<tBits, false>::form_string(const ky_string &s)
 {
     ky_string tmp(s);
     if (tmp[0] == ky_char('b'))
@@ -233,10 +447,217 @@ void ky_bitset<tBits>::form_string(const ky_string &s)
     val.v = tmp.to_ulonglong (2);
 }
 template <int tBits>
-void ky_bitset<tBits>::swap(ky_bitset &b)
+void ky_bitset<tBits, false>::swap(ky_bitset &b)
 {
      BIT tmp = b.val;
      b.val = this->val;
      this->val = tmp;
 }
 
+
+template <int tBits>
+ky_bitset<tBits, true>::ky_bitset(uint64 v)
+{
+    memset (word, 0, sizeof(word));
+    word[0] = v;
+}
+template <int tBits>
+ky_bitset<tBits, true>::ky_bitset(const ky_bitset<tBits, true> &rhs)
+{
+    memcpy (word, rhs.word, sizeof(word));
+}
+template <int tBits>
+ky_bitset<tBits, true> &ky_bitset<tBits, true>::operator = (const ky_bitset<tBits, true> &rhs)
+{
+    memcpy (word, rhs.word, sizeof(word));
+    return *this;
+}
+
+template <int tBits>
+ky_bitset<tBits, true> ky_bitset<tBits, true>::operator & (const ky_bitset<tBits, true> &rhs)const
+{
+    ky_bitset<tBits, true> out(*this);
+    return out &= rhs;
+}
+template <int tBits>
+ky_bitset<tBits, true> ky_bitset<tBits, true>::operator | (const ky_bitset<tBits, true> &rhs)const
+{
+    ky_bitset<tBits, true> out(*this);
+    return out |= rhs;
+}
+template <int tBits>
+ky_bitset<tBits, true> ky_bitset<tBits, true>::operator ~ ()const
+{
+    ky_bitset<tBits, true> out;
+    __bitset__::bit_not (out.word, word, words);
+    out.trim ();
+    return out;
+}
+template <int tBits>
+ky_bitset<tBits, true> ky_bitset<tBits, true>::operator ^ (const ky_bitset<tBits, true> &rhs)const
+{
+    ky_bitset<tBits, true> out(*this);
+    return out ^= rhs;
+}
+template <int tBits>
+ky_bitset<tBits, true> &ky_bitset<tBits, true>::operator &= (const ky_bitset<tBits, true> &rhs)
+{
+    __bitset__::bit_and (word, word, rhs.word, words);
+    return *this;
+}
+template <int tBits>
+ky_bitset<tBits, true> &ky_bitset<tBits, true>::operator |= (const ky_bitset<tBits, true> &rhs)
+{
+    __bitset__::bit_or (word, word, rhs.word, words);
+    return *this;
+}
+template <int tBits>
+ky_bitset<tBits, true> &ky_bitset<tBits, true>::operator ~ ()
+{
+    flip ();
+    return *this;
+}
+template <int tBits>
+ky_bitset<tBits, true> &ky_bitset<tBits, true>::operator ^= (const ky_bitset<tBits, true> &rhs)
+{
+    __bitset__::bit_xor (word, word, rhs.word, words);
+    return *this;
+}
+template <int tBits>
+ky_bitset<tBits, true> ky_bitset<tBits, true>::operator << (uint b)const
+{
+    ky_bitset<tBits, true> out(*this);
+    return out <<= b;
+}
+template <int tBits>
+ky_bitset<tBits, true> ky_bitset<tBits, true>::operator >> (uint b)const
+{
+    ky_bitset<tBits, true> out(*this);
+    return out >>= b;
+}
+template <int tBits>
+ky_bitset<tBits, true> &ky_bitset<tBits, true>::operator <<= (uint b)
+{
+    __bitset__::shift_left (word, words, b);
+    trim ();
+    return *this;
+}
+template <int tBits>
+ky_bitset<tBits, true> &ky_bitset<tBits, true>::operator >>= (uint b)
+{
+    __bitset__::shift_right (word, words, b);
+    return *this;
+}
+template <int tBits>
+bool ky_bitset<tBits, true>::operator || (const ky_bitset<tBits, true> &rhs)const
+{
+    return any () || rhs.any ();
+}
+template <int tBits>
+bool ky_bitset<tBits, true>::operator && (const ky_bitset<tBits, true> &rhs)const
+{
+    return any () && rhs.any ();
+}
+template <int tBits>
+bool ky_bitset<tBits, true>::operator ! ()const
+{
+    return none ();
+}
+template <int tBits>
+bool ky_bitset<tBits, true>::operator == (const ky_bitset<tBits, true> &rhs)const
+{
+    return __bitset__::equal (word, rhs.word, words);
+}
+template <int tBits>
+bool ky_bitset<tBits, true>::operator != (const ky_bitset<tBits, true> &rhs)const
+{
+    return !this->operator == (rhs);
+}
+template <int tBits>
+void ky_bitset<tBits, true>::set()
+{
+    memset (word, 0xff, sizeof(word));
+    trim ();
+}
+template <int tBits>
+void ky_bitset<tBits, true>::unset()
+{
+    memset (word, 0, sizeof(word));
+}
+template <int tBits>
+bool ky_bitset<tBits, true>::any()const
+{
+    return __bitset__::any (word, words);
+}
+template <int tBits>
+bool ky_bitset<tBits, true>::none()const
+{
+    return !any ();
+}
+template <int tBits>
+int ky_bitset<tBits, true>::count()const
+{
+    return (int)__bitset__::count (word, words);
+}
+template <int tBits>
+void ky_bitset<tBits, true>::flip()
+{
+    __bitset__::bit_not (word, word, words);
+    trim ();
+}
+template <int tBits>
+int ky_bitset<tBits, true>::find_first()const
+{
+    const size_t i = __bitset__::find (word, words, 0);
+    return i < (size_t)bits ? (int)i : -1;
+}
+template <int tBits>
+int ky_bitset<tBits, true>::find_next(int bit)const
+{
+    if (bit + 1 >= bits)
+        return -1;
+    const size_t i = __bitset__::find (word, words, bit + 1);
+    return i < (size_t)bits ? (int)i : -1;
+}
+template <int tBits>
+template <typename Fn>
+void ky_bitset<tBits, true>::each(Fn fn)const
+{
+    __bitset__::each (word, words, fn);
+}
+
+template <int tBits>
+ky_string ky_bitset<tBits, true>::to_string()const
+{
+    ky_string out("b");
+    int i = bits - 1;
+    while (i > 0 && !test (i))
+        --i;
+    for (; i >= 0; --i)
+        out.append (test (i) ? '1' : '0');
+    return out;
+}
+template <int tBits>
+void ky_bitset<tBits, true>::form_string(const ky_string &s)
+{
+    ky_string tmp(s);
+    if (tmp[0] == ky_char('b'))
+        tmp.remove(0,1);
+    else if (tmp.is_empty ())
+        return ;
+    unset ();
+    const int n = tmp.count ();
+    for (int i = 0; i < n && i < bits; ++i)
+        if (tmp[n - 1 - i] == ky_char('1'))
+            set (i);
+}
+template <int tBits>
+void ky_bitset<tBits, true>::swap(ky_bitset &b)
+{
+    for (int i = 0; i < words; ++i)
+    {
+        const uint64 tmp = b.word[i];
+        b.word[i] = word[i];
+        word[i] = tmp;
+    }
+}
@@ -0,0 +1,374 @@
+
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_btree_map.h
+ * @brief    B+树有序映射
+ *       1.节点内连续存放多个键值，节点大小按缓存行选取，减少指针跳转
+ *       2.叶子节点双向链接，迭代和区间扫描只顺序访问叶子
+ *       3.支持从有序输入O(n)批量构建
+ *       4.迭代器接口与ky_map兼容
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ */
+#ifndef ky_BTREE_MAP_H
+#define ky_BTREE_MAP_H
+
+#include "ky_define.h"
+#include "tools/ky_memory.h"
+#include "tools/ky_algorlthm.h"
+#include "tools/ky_list.h"
+#include <utility>
+
+template <typename K, typename V, typename Alloc = ky_alloc<void>, typename Compare = ky_less<K> >
+class ky_btree_map : public Alloc
+{
+public:
+    enum
+    {
+        NodeBytes = 256,           ///< 节点键值区的目标大小(4个缓存行)
+        LeafSlots = NodeBytes / (sizeof(K) + sizeof(V)) < 4 ? 4 :
+                    NodeBytes / (sizeof(K) + sizeof(V)),
+        InnerSlots = NodeBytes / (sizeof(K) + sizeof(void*)) < 4 ? 4 :
+                     NodeBytes / (sizeof(K) + sizeof(void*)),
+        LeafMin = LeafSlots / 2,                ///< 叶子节点最少元素数
+        InnerMin = (InnerSlots + 2) / 2 - 1     ///< 内部节点最少键数
+    };
+
+private:
+    //! 节点公共头，count 为叶子的元素数或内部节点的键数
+    struct node_t
+    {
+        int count;
+        node_t *next;
+    };
+    //! 叶子: [leaf_t][K x LeafSlots][V x LeafSlots]
+    struct leaf_t : node_t
+    {
+        leaf_t *prev;
+
+        static size_t key_offset() {return align_up (sizeof(leaf_t), alignof(K));}
+        static size_t val_offset() {return align_up (key_offset () + sizeof(K) * LeafSlots, alignof(V));}
+        static size_t bytes() {return val_offset () + sizeof(V) * LeafSlots;}
+
+        K *keys() {return (K *)((char *)this + key_offset ());}
+        V *vals() {return (V *)((char *)this + val_offset ());}
+        leaf_t *after() const {return (leaf_t *)this->next;}
+    };
+    //! 内部节点: [inner_t][K x InnerSlots][node_t* x (InnerSlots + 1)]
+    struct inner_t : node_t
+    {
+        static size_t key_offset() {return align_up (sizeof(inner_t), alignof(K));}
+        static size_t child_offset() {return align_up (key_offset () + sizeof(K) * InnerSlots, alignof(node_t*));}
+        static size_t bytes() {return child_offset () + sizeof(node_t*) * (InnerSlots + 1);}
+
+        K *keys() {return (K *)((char *)this + key_offset ());}
+        node_t **childs() {return (node_t **)((char *)this + child_offset ());}
+    };
+    struct tree_t
+    {
+        ky_ref ref;                 ///< 引用计数
+        node_t *root;
+        leaf_t *head;               ///< 最左叶子
+        leaf_t *tail;               ///< 最右叶子
+        size_t count;               ///< 元素数
+        int height;                 ///< 根到叶子的层数，0表示根为叶子
+    };
+
+    tree_t *impl;
+
+    static size_t align_up(size_t v, size_t a) {return (v + a - 1) & ~(a - 1);}
+    static bool less(const K &a, const K &b) {return Compare()(a, b);}
+    //! 节点内第一个不排在key之前的位置
+    static int lower(const K *keys, int n, const K &key);
+    //! 节点内第一个排在key之后的位置
+    static int upper(const K *keys, int n, const K &key);
+
+    //! 节点内元素的插入删除，arr[0, n)为已构造元素
+    template <typename T>
+    static void insert_at(T *arr, int n, int pos, const T &val);
+    template <typename T>
+    static void erase_at(T *arr, int n, int pos);
+    //! 将src[0, n)构造到未初始化的dst并析构src
+    template <typename T>
+    static void relocate(T *dst, T *src, int n);
+
+    leaf_t *new_leaf();
+    inner_t *new_inner();
+    tree_t *create();
+    void release(tree_t *t);
+    void destroy();
+    void destroy(node_t *n, int height);
+    void detach();
+
+    leaf_t *locate(const K &key)const;
+    bool insert(node_t *n, int height, const K &key, const V &val,
+                K &sep, node_t *&split, leaf_t *&at, int &pos);
+    bool erase(node_t *n, int height, const K &key);
+    void rebalance(inner_t *parent, int i, int height);
+
+    //! 有序批量构建
+    class builder;
+    friend class builder;
+
+public:
+    class opebtree_node;
+    class const_opebtree_node;
+    typedef opebtree_node iterator;
+    typedef const_opebtree_node const_iterator;
+
+    /// STL style
+public:
+    ky_btree_map():impl(NULL){}
+    ky_btree_map(const ky_btree_map &rhs):impl(rhs.impl)
+    {
+        if (impl)
+            impl->ref.addref ();
+    }
+    ~ky_btree_map()
+    {
+        destroy ();
+    }
+
+    ky_btree_map &operator = (const ky_btree_map &rhs);
+
+    iterator begin();
+    const_iterator begin() const;
+    iterator end();
+    const_iterator end() const;
+
+    //!
+    //! \brief find 查找key并返回一个迭代器
+    //! \param key
+    //! \return
+    //!
+    iterator find(const K &key);
+    const_iterator find(const K &key) const;
+    //!
+    //! \brief lower_bound 返回第一个不排在key之前的迭代器
+    //! \param key
+    //! \return
+    //!
+    iterator lower_bound(const K &key);
+    const_iterator lower_bound(const K &key) const;
+    //!
+    //! \brief upper_bound 返回第一个排在key之后的迭代器
+    //! \param key
+    //! \return
+    //!
+    iterator upper_bound(const K &key);
+    const_iterator upper_bound(const K &key) const;
+    //!
+    //! \brief equal_range 返回等于key的迭代器范围
+    //! \param key
+    //! \return
+    //!
+    std::pair<iterator, iterator> equal_range(const K &key);
+    std::pair<const_iterator, const_iterator> equal_range(const K &key) const;
+
+    //!
+    //! \brief insert 插入key，val并返回迭代器，key已存在时修改其值
+    //! \param key
+    //! \param val
+    //! \return
+    //!
+    iterator insert(const K& key, const V& val);
+    iterator insert(const K& key) {return insert (key, V());}
+    //!
+    //! \brief erase 擦除迭代器所指元素，返回下一个元素
+    //! \param pos
+    //! \return
+    //!
+    iterator erase(const_iterator pos);
+    //!
+    //! \brief erase 擦除key，返回擦除的元素数
+    //! \param key
+    //! \return
+    //!
+    size_t erase(const K& key);
+
+    V &operator [](const K &key);
+    const V operator [](const K &key)const {return value (key);}
+
+    void swap(ky_btree_map &rhs){tree_t *tmp = impl; impl = rhs.impl; rhs.impl = tmp;}
+    friend void ky_swap(ky_btree_map &a, ky_btree_map &b) {a.swap (b);}
+    void clear();
+    bool empty() const {return is_empty ();}
+    size_t size() const {return count ();}
+
+#if kyLanguage >= kyLanguage11
+public:
+    ky_btree_map(ky_btree_map &&m):impl(m.impl){m.impl = NULL;}
+    ky_btree_map& operator = (ky_btree_map &&m)
+    {
+        if (this != &m)
+        {
+            destroy ();
+            impl = m.impl;
+            m.impl = NULL;
+        }
+        return *this;
+    }
+    const_iterator cbegin() const {return begin ();}
+    const_iterator cend() const {return end ();}
+#endif
+
+    // base
+public:
+    //!
+    //! \brief from_sorted 从按键升序排列的[first, last)批量构建，元素为std::pair<K, V>
+    //! \param first
+    //! \param last
+    //! \return
+    //! \note 相邻的相同键保留最后一个值，O(n)且不进行节点分裂
+    //!
+    template <typename Iter>
+    static ky_btree_map from_sorted(Iter first, Iter last);
+
+    //!
+    //! \brief scan 按键顺序对[lo, hi)内的每个元素调用fn(key, value)
+    //! \param lo
+    //! \param hi
+    //! \param fn
+    //!
+    template <typename Fn>
+    void scan(const K &lo, const K &hi, Fn fn)const;
+
+    void append(const K& key, const V& val) {insert (key, val);}
+    void remove(const K& key) {erase (key);}
+    bool contains(const K &key) const {return find (key) != end ();}
+    V value(const K &key, const V &defval = V()) const;
+
+    //!
+    //! \brief keys
+    //! \return 返回map的全部key
+    //!
+    ky_list<K> keys() const;
+    //!
+    //! \brief values
+    //! \return 返回map的全部值
+    //!
+    ky_list<V> values() const;
+
+    size_t count()const {return impl ? impl->count : 0;}
+    bool is_empty()const {return count () == 0;}
+    bool is_null()const {return impl == NULL;}
+    //!
+    //! \brief height 树的层数，空树为0
+    //! \return
+    //!
+    int height()const {return impl && impl->root ? impl->height + 1 : 0;}
+
+public:
+    class opebtree_node
+    {
+        friend class ky_btree_map;
+        friend class const_opebtree_node;
+    private:
+        leaf_t *leaf;
+        int index;
+
+        //! 位于叶子末尾且有后继叶子时移到后继叶子开始
+        opebtree_node(leaf_t *l, int i):leaf(l), index(i)
+        {
+            if (leaf && index >= leaf->count && leaf->next)
+            {
+                leaf = leaf->after ();
+                index = 0;
+            }
+        }
+    public:
+        opebtree_node():leaf(NULL), index(0){}
+
+        const K &key() const { return leaf->keys ()[index]; }
+        V &value() const { return leaf->vals ()[index]; }
+        V &operator*() const { return value (); }
+        V *operator->() const { return &value (); }
+        bool operator==(const opebtree_node &o) const { return leaf == o.leaf && index == o.index; }
+        bool operator!=(const opebtree_node &o) const { return !(*this == o); }
+
+        opebtree_node& operator++()
+        {
+            if (++index >= leaf->count && leaf->next)
+            {
+                leaf = leaf->after ();
+                index = 0;
+            }
+            return *this;
+        }
+        opebtree_node operator++(int){opebtree_node tn = *this; ++*this; return tn;}
+        opebtree_node& operator--()
+        {
+            if (index == 0 && leaf->prev)
+            {
+                leaf = leaf->prev;
+                index = leaf->count;
+            }
+            --index;
+            return *this;
+        }
+        opebtree_node operator--(int){opebtree_node tn = *this; --*this; return tn;}
+    };
+    class const_opebtree_node
+    {
+        friend class ky_btree_map;
+    private:
+        leaf_t *leaf;
+        int index;
+
+        const_opebtree_node(leaf_t *l, int i):leaf(l), index(i)
+        {
+            if (leaf && index >= leaf->count && leaf->next)
+            {
+                leaf = leaf->after ();
+                index = 0;
+            }
+        }
+    public:
+        const_opebtree_node():leaf(NULL), index(0){}
+        const_opebtree_node(const opebtree_node &it):leaf(it.leaf), index(it.index){}
+
+        const K &key() const { return leaf->keys ()[index]; }
+        const V &value() const { return leaf->vals ()[index]; }
+        const V &operator*() const { return value (); }
+        const V *operator->() const { return &value (); }
+        bool operator==(const const_opebtree_node &o) const { return leaf == o.leaf && index == o.index; }
+        bool operator!=(const const_opebtree_node &o) const { return !(*this == o); }
+
+        const_opebtree_node& operator++()
+        {
+            if (++index >= leaf->count && leaf->next)
+            {
+                leaf = leaf->after ();
+                index = 0;
+            }
+            return *this;
+        }
+        const_opebtree_node operator++(int){const_opebtree_node tn = *this; ++*this; return tn;}
+        const_opebtree_node& operator--()
+        {
+            if (index == 0 && leaf->prev)
+            {
+                leaf = leaf->prev;
+                index = leaf->count;
+            }
+            --index;
+            return *this;
+        }
+        const_opebtree_node operator--(int){const_opebtree_node tn = *this; --*this; return tn;}
+    };
+    friend class opebtree_node;
+    friend class const_opebtree_node;
+};
+
+#include "ky_btree_map.inl"
+#endif // ky_BTREE_MAP_H
@@ -0,0 +1,752 @@
+#ifndef KY_BTREE_MAP_INL
+#define KY_BTREE_MAP_INL
+
+template <typename K, typename V, typename Alloc, typename Compare>
+int ky_btree_map<K, V, Alloc, Compare>::lower(const K *keys, int n, const K &key)
+{
+    int lo = 0;
+    while (n > 0)
+    {
+        const int half = n >> 1;
+        if (less (keys[lo + half], key))
+        {
+            lo += half + 1;
+            n -= half + 1;
+        }
+        else
+            n = half;
+    }
+    return lo;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+int ky_btree_map<K, V, Alloc, Compare>::upper(const K *keys, int n, const K &key)
+{
+    int lo = 0;
+    while (n > 0)
+    {
+        const int half = n >> 1;
+        if (!less (key, keys[lo + half]))
+        {
+            lo += half + 1;
+            n -= half + 1;
+        }
+        else
+            n = half;
+    }
+    return lo;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+template <typename T>
+void ky_btree_map<K, V, Alloc, Compare>::insert_at(T *arr, int n, int pos, const T &val)
+{
+    if (pos == n)
+    {
+        new (arr + n) T(val);
+        return ;
+    }
+    new (arr + n) T(arr[n - 1]);
+    for (int i = n - 1; i > pos; --i)
+        arr[i] = arr[i - 1];
+    arr[pos] = val;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+template <typename T>
+void ky_btree_map<K, V, Alloc, Compare>::erase_at(T *arr, int n, int pos)
+{
+    for (int i = pos; i < n - 1; ++i)
+        arr[i] = arr[i + 1];
+    arr[n - 1].~T();
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+template <typename T>
+void ky_btree_map<K, V, Alloc, Compare>::relocate(T *dst, T *src, int n)
+{
+    // 同一数组内向后移动时从尾部开始，避免覆盖未移动的元素
+    if (dst > src)
+    {
+        for (int i = n - 1; i >= 0; --i)
+        {
+            new (dst + i) T(src[i]);
+            src[i].~T();
+        }
+        return ;
+    }
+    for (int i = 0; i < n; ++i)
+    {
+        new (dst + i) T(src[i]);
+        src[i].~T();
+    }
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_btree_map<K, V, Alloc, Compare>::leaf_t *ky_btree_map<K, V, Alloc, Compare>::new_leaf()
+{
+    leaf_t *l = (leaf_t *)Alloc::alloc (leaf_t::bytes ());
+    l->count = 0;
+    l->next = NULL;
+    l->prev = NULL;
+    return l;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_btree_map<K, V, Alloc, Compare>::inner_t *ky_btree_map<K, V, Alloc, Compare>::new_inner()
+{
+    inner_t *in = (inner_t *)Alloc::alloc (inner_t::bytes ());
+    in->count = 0;
+    in->next = NULL;
+    return in;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_btree_map<K, V, Alloc, Compare>::tree_t *ky_btree_map<K, V, Alloc, Compare>::create()
+{
+    tree_t *t = (tree_t *)Alloc::alloc (sizeof(tree_t));
+    new (&t->ref) ky_ref();
+    t->ref.set (ky_ref::refShareableDetach);
+    t->root = NULL;
+    t->head = NULL;
+    t->tail = NULL;
+    t->count = 0;
+    t->height = 0;
+    return t;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_btree_map<K, V, Alloc, Compare>::destroy(node_t *n, int height)
+{
+    if (height == 0)
+    {
+        leaf_t *l = (leaf_t *)n;
+        for (int i = 0; i < l->count; ++i)
+        {
+            l->keys ()[i].~K();
+            l->vals ()[i].~V();
+        }
+    }
+    else
+    {
+        inner_t *in = (inner_t *)n;
+        for (int i = 0; i < in->count; ++i)
+            in->keys ()[i].~K();
+        for (int i = 0; i <= in->count; ++i)
+            destroy (in->childs ()[i], height - 1);
+    }
+    Alloc::destroy (n);
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_btree_map<K, V, Alloc, Compare>::release(tree_t *t)
+{
+    if (t->root)
+        destroy (t->root, t->height);
+    Alloc::destroy (t);
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_btree_map<K, V, Alloc, Compare>::destroy()
+{
+    if (impl && impl->ref.lessref ())
+        release (impl);
+    impl = NULL;
+}
+
+//! 按键顺序逐个追加元素，叶子填满后再逐层构建内部节点
+template <typename K, typename V, typename Alloc, typename Compare>
+class ky_btree_map<K, V, Alloc, Compare>::builder
+{
+public:
+    explicit builder(ky_btree_map *m):map(m), tree(m->create ()), leaves(0){}
+
+    void push(const K &key, const V &val)
+    {
+        leaf_t *tail = tree->tail;
+        if (tail && tail->count > 0)
+        {
+            const K &back = tail->keys ()[tail->count - 1];
+            kyASSERT(!less (key, back), "from_sorted input is not sorted");
+            if (!less (back, key))
+            {
+                tail->vals ()[tail->count - 1] = val;
+                return ;
+            }
+        }
+        if (tail == NULL || tail->count == LeafSlots)
+        {
+            leaf_t *l = map->new_leaf ();
+            l->prev = tail;
+            if (tail)
+                tail->next = l;
+            else
+                tree->head = l;
+            tree->tail = l;
+            tail = l;
+            ++leaves;
+        }
+        new (tail->keys () + tail->count) K(key);
+        new (tail->vals () + tail->count) V(val);
+        ++tail->count;
+        ++tree->count;
+    }
+
+    tree_t *finish()
+    {
+        if (leaves == 0)
+            return tree;
+
+        // 最后一个叶子不足时从前一个叶子匀出元素
+        leaf_t *tail = tree->tail;
+        if (tail->prev && tail->count < LeafMin)
+        {
+            leaf_t *prev = tail->prev;
+            const int move = (prev->count + tail->count) / 2 - tail->count;
+            relocate (tail->keys () + move, tail->keys (), tail->count);
+            relocate (tail->vals () + move, tail->vals (), tail->count);
+            relocate (tail->keys (), prev->keys () + prev->count - move, move);
+            relocate (tail->vals (), prev->vals () + prev->count - move, move);
+            prev->count -= move;
+            tail->count += move;
+        }
+
+        // 每层平均分配子节点，保证每个内部节点不少于最小子节点数
+        node_t *level = tree->head;
+        size_t n = leaves;
+        int height = 0;
+        while (n > 1)
+        {
+            const size_t parents = (n + InnerSlots) / (InnerSlots + 1);
+            const size_t base = n / parents;
+            const size_t extra = n % parents;
+            node_t *child = level;
+            inner_t *first = NULL;
+            inner_t *last = NULL;
+            for (size_t p = 0; p < parents; ++p)
+            {
+                inner_t *in = map->new_inner ();
+                const int c = (int)(base + (p < extra ? 1 : 0));
+                for (int i = 0; i < c; ++i)
+                {
+                    in->childs ()[i] = child;
+                    if (i > 0)
+                        new (in->keys () + i - 1) K(min_key (child, height));
+                    child = child->next;
+                }
+                in->count = c - 1;
+                if (last)
+                    last->next = in;
+                else
+                    first = in;
+                last = in;
+            }
+            level = first;
+            n = parents;
+            ++height;
+        }
+        tree->root = level;
+        tree->height = height;
+        return tree;
+    }
+
+private:
+    static const K &min_key(node_t *n, int height)
+    {
+        for (; height > 0; --height)
+            n = ((inner_t *)n)->childs ()[0];
+        return ((leaf_t *)n)->keys ()[0];
+    }
+
+    ky_btree_map *map;
+    tree_t *tree;
+    size_t leaves;
+};
+
+template <typename K, typename V, typename Alloc, typename Compare>
+template <typename Iter>
+ky_btree_map<K, V, Alloc, Compare> ky_btree_map<K, V, Alloc, Compare>::from_sorted(Iter first, Iter last)
+{
+    ky_btree_map out;
+    builder b(&out);
+    for (; first != last; ++first)
+        b.push (first->first, first->second);
+    out.impl = b.finish ();
+    return out;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_btree_map<K, V, Alloc, Compare>::detach()
+{
+    if (impl == NULL)
+        impl = create ();
+    else if (impl->ref.is_shared () && impl->ref.has_detach ())
+    {
+        tree_t *olds = impl;
+        builder b(this);
+        for (leaf_t *l = olds->head; l; l = l->after ())
+            for (int i = 0; i < l->count; ++i)
+                b.push (l->keys ()[i], l->vals ()[i]);
+        impl = b.finish ();
+        if (olds->ref.lessref ())
+            release (olds);
+    }
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_btree_map<K, V, Alloc, Compare> &ky_btree_map<K, V, Alloc, Compare>::operator = (const ky_btree_map &rhs)
+{
+    if (impl != rhs.impl)
+    {
+        ky_btree_map tmp(rhs);
+        swap (tmp);
+    }
+    return *this;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_btree_map<K, V, Alloc, Compare>::leaf_t *ky_btree_map<K, V, Alloc, Compare>::locate(const K &key)const
+{
+    if (impl == NULL || impl->root == NULL)
+        return NULL;
+    node_t *n = impl->root;
+    for (int h = impl->height; h > 0; --h)
+    {
+        inner_t *in = (inner_t *)n;
+        n = in->childs ()[upper (in->keys (), in->count, key)];
+    }
+    return (leaf_t *)n;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_btree_map<K, V, Alloc, Compare>::iterator ky_btree_map<K, V, Alloc, Compare>::begin()
+{
+    detach ();
+    return iterator(impl->head, 0);
+}
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_btree_map<K, V, Alloc, Compare>::const_iterator ky_btree_map<K, V, Alloc, Compare>::begin() const
+{
+    return impl ? const_iterator(impl->head, 0) : const_iterator();
+}
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_btree_map<K, V, Alloc, Compare>::iterator ky_btree_map<K, V, Alloc, Compare>::end()
+{
+    detach ();
+    return iterator(impl->tail, impl->tail ? impl->tail->count : 0);
+}
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_btree_map<K, V, Alloc, Compare>::const_iterator ky_btree_map<K, V, Alloc, Compare>::end() const
+{
+    if (impl == NULL || impl->tail == NULL)
+        return const_iterator();
+    return const_iterator(impl->tail, impl->tail->count);
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_btree_map<K, V, Alloc, Compare>::iterator ky_btree_map<K, V, Alloc, Compare>::find(const K &key)
+{
+    detach ();
+    leaf_t *l = locate (key);
+    if (l)
+    {
+        const int pos = lower (l->keys (), l->count, key);
+        if (pos < l->count && !less (key, l->keys ()[pos]))
+            return iterator(l, pos);
+    }
+    return end ();
+}
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_btree_map<K, V, Alloc, Compare>::const_iterator ky_btree_map<K, V, Alloc, Compare>::find(const K &key) const
+{
+    leaf_t *l = locate (key);
+    if (l)
+    {
+        const int pos = lower (l->keys (), l->count, key);
+        if (pos < l->count && !less (key, l->keys ()[pos]))
+            return const_iterator(l, pos);
+    }
+    return end ();
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_btree_map<K, V, Alloc, Compare>::iterator ky_btree_map<K, V, Alloc, Compare>::lower_bound(const K &key)
+{
+    detach ();
+    leaf_t *l = locate (key);
+    return l ? iterator(l, lower (l->keys (), l->count, key)) : end ();
+}
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_btree_map<K, V, Alloc, Compare>::const_iterator ky_btree_map<K, V, Alloc, Compare>::lower_bound(const K &key) const
+{
+    leaf_t *l = locate (key);
+    return l ? const_iterator(l, lower (l->keys (), l->count, key)) : end ();
+}
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_btree_map<K, V, Alloc, Compare>::iterator ky_btree_map<K, V, Alloc, Compare>::upper_bound(const K &key)
+{
+    detach ();
+    leaf_t *l = locate (key);
+    return l ? iterator(l, upper (l->keys (), l->count, key)) : end ();
+}
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_btree_map<K, V, Alloc, Compare>::const_iterator ky_btree_map<K, V, Alloc, Compare>::upper_bound(const K &key) const
+{
+    leaf_t *l = locate (key);
+    return l ? const_iterator(l, upper (l->keys (), l->count, key)) : end ();
+}
+template <typename K, typename V, typename Alloc, typename Compare>
+std::pair<typename ky_btree_map<K, V, Alloc, Compare>::iterator, typename ky_btree_map<K, V, Alloc, Compare>::iterator>
+ky_btree_map<K, V, Alloc, Compare>::equal_range(const K &key)
+{
+    return std::pair<iterator, iterator>(lower_bound (key), upper_bound (key));
+}
+template <typename K, typename V, typename Alloc, typename Compare>
+std::pair<typename ky_btree_map<K, V, Alloc, Compare>::const_iterator, typename ky_btree_map<K, V, Alloc, Compare>::const_iterator>
+ky_btree_map<K, V, Alloc, Compare>::equal_range(const K &key) const
+{
+    return std::pair<const_iterator, const_iterator>(lower_bound (key), upper_bound (key));
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+bool ky_btree_map<K, V, Alloc, Compare>::insert(node_t *n, int height, const K &key, const V &val,
+                            K &sep, node_t *&split, leaf_t *&at, int &pos)
+{
+    if (height == 0)
+    {
+        leaf_t *l = (leaf_t *)n;
+        int i = lower (l->keys (), l->count, key);
+        if (i < l->count && !less (key, l->keys ()[i]))
+        {
+            l->vals ()[i] = val;
+            at = l;
+            pos = i;
+            return false;
+        }
+        if (l->count == LeafSlots)
+        {
+            // 在最右叶子末尾追加时不对半分裂，顺序插入可保持叶子满载
+            const int mid = (i == LeafSlots && l->next == NULL) ? LeafSlots : LeafSlots / 2;
+            leaf_t *r = new_leaf ();
+            relocate (r->keys (), l->keys () + mid, l->count - mid);
+            relocate (r->vals (), l->vals () + mid, l->count - mid);
+            r->count = l->count - mid;
+            l->count = mid;
+
+            r->next = l->next;
+            r->prev = l;
+            if (r->next)
+                r->after ()->prev = r;
+            else
+                impl->tail = r;
+            l->next = r;
+            split = r;
+
+            if (i > mid || mid == LeafSlots)
+            {
+                l = r;
+                i -= mid;
+            }
+        }
+        insert_at (l->keys (), l->count, i, key);
+        insert_at (l->vals (), l->count, i, val);
+        ++l->count;
+        if (split)
+            sep = ((leaf_t *)split)->keys ()[0];
+        at = l;
+        pos = i;
+        return true;
+    }
+
+    inner_t *in = (inner_t *)n;
+    int i = upper (in->keys (), in->count, key);
+    K csep = K();
+    node_t *csplit = NULL;
+    const bool inserted = insert (in->childs ()[i], height - 1, key, val, csep, csplit, at, pos);
+    if (csplit == NULL)
+        return inserted;
+
+    if (in->count == InnerSlots)
+    {
+        // 中间键上移，右半部分移入新节点
+        const int mid = InnerSlots / 2;
+        inner_t *r = new_inner ();
+        sep = in->keys ()[mid];
+        relocate (r->keys (), in->keys () + mid + 1, in->count - mid - 1);
+        for (int c = mid + 1; c <= in->count; ++c)
+            r->childs ()[c - mid - 1] = in->childs ()[c];
+        r->count = in->count - mid - 1;
+        in->keys ()[mid].~K();
+        in->count = mid;
+        split = r;
+
+        if (i > mid)
+        {
+            in = r;
+            i -= mid + 1;
+        }
+    }
+    insert_at (in->keys (), in->count, i, csep);
+    for (int c = in->count + 1; c > i + 1; --c)
+        in->childs ()[c] = in->childs ()[c - 1];
+    in->childs ()[i + 1] = csplit;
+    ++in->count;
+    return inserted;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_btree_map<K, V, Alloc, Compare>::iterator ky_btree_map<K, V, Alloc, Compare>::insert(const K& key, const V& val)
+{
+    detach ();
+    if (impl->root == NULL)
+    {
+        leaf_t *l = new_leaf ();
+        impl->root = l;
+        impl->head = l;
+        impl->tail = l;
+        impl->height = 0;
+    }
+
+    K sep = K();
+    node_t *split = NULL;
+    leaf_t *at = NULL;
+    int pos = 0;
+    if (insert (impl->root, impl->height, key, val, sep, split, at, pos))
+        ++impl->count;
+    if (split)
+    {
+        inner_t *root = new_inner ();
+        new (root->keys ()) K(sep);
+        root->childs ()[0] = impl->root;
+        root->childs ()[1] = split;
+        root->count = 1;
+        impl->root = root;
+        ++impl->height;
+    }
+    return iterator(at, pos);
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_btree_map<K, V, Alloc, Compare>::rebalance(inner_t *parent, int i, int height)
+{
+    // 优先向左兄弟借，其次向右兄弟借，都不能借时与兄弟合并
+    node_t **childs = parent->childs ();
+    K *seps = parent->keys ();
+    node_t *child = childs[i];
+    node_t *left = i > 0 ? childs[i - 1] : NULL;
+    node_t *right = i < parent->count ? childs[i + 1] : NULL;
+
+    if (height == 0)
+    {
+        leaf_t *c = (leaf_t *)child;
+        leaf_t *l = (leaf_t *)left;
+        leaf_t *r = (leaf_t *)right;
+        if (l && l->count > LeafMin)
+        {
+            insert_at (c->keys (), c->count, 0, l->keys ()[l->count - 1]);
+            insert_at (c->vals (), c->count, 0, l->vals ()[l->count - 1]);
+            ++c->count;
+            --l->count;
+            l->keys ()[l->count].~K();
+            l->vals ()[l->count].~V();
+            seps[i - 1] = c->keys ()[0];
+            return ;
+        }
+        if (r && r->count > LeafMin)
+        {
+            new (c->keys () + c->count) K(r->keys ()[0]);
+            new (c->vals () + c->count) V(r->vals ()[0]);
+            ++c->count;
+            erase_at (r->keys (), r->count, 0);
+            erase_at (r->vals (), r->count, 0);
+            --r->count;
+            seps[i] = r->keys ()[0];
+            return ;
+        }
+        if (l == NULL)
+        {
+            l = c;
+            c = r;
+            ++i;
+        }
+        // 将c合并到l，删除分隔键seps[i - 1]和子节点childs[i]
+        relocate (l->keys () + l->count, c->keys (), c->count);
+        relocate (l->vals () + l->count, c->vals (), c->count);
+        l->count += c->count;
+        l->next = c->next;
+        if (c->next)
+            c->after ()->prev = l;
+        else
+            impl->tail = l;
+        Alloc::destroy (c);
+    }
+    else
+    {
+        inner_t *c = (inner_t *)child;
+        inner_t *l = (inner_t *)left;
+        inner_t *r = (inner_t *)right;
+        if (l && l->count > InnerMin)
+        {
+            insert_at (c->keys (), c->count, 0, seps[i - 1]);
+            for (int k = c->count + 1; k > 0; --k)
+                c->childs ()[k] = c->childs ()[k - 1];
+            c->childs ()[0] = l->childs ()[l->count];
+            ++c->count;
+            seps[i - 1] = l->keys ()[l->count - 1];
+            --l->count;
+            l->keys ()[l->count].~K();
+            return ;
+        }
+        if (r && r->count > InnerMin)
+        {
+            new (c->keys () + c->count) K(seps[i]);
+            c->childs ()[c->count + 1] = r->childs ()[0];
+            ++c->count;
+            seps[i] = r->keys ()[0];
+            erase_at (r->keys (), r->count, 0);
+            for (int k = 0; k < r->count; ++k)
+                r->childs ()[k] = r->childs ()[k + 1];
+            --r->count;
+            return ;
+        }
+        if (l == NULL)
+        {
+            l = c;
+            c = r;
+            ++i;
+        }
+        new (l->keys () + l->count) K(seps[i - 1]);
+        relocate (l->keys () + l->count + 1, c->keys (), c->count);
+        for (int k = 0; k <= c->count; ++k)
+            l->childs ()[l->count + 1 + k] = c->childs ()[k];
+        l->count += c->count + 1;
+        Alloc::destroy (c);
+    }
+    erase_at (seps, parent->count, i - 1);
+    for (int k = i; k < parent->count; ++k)
+        childs[k] = childs[k + 1];
+    --parent->count;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+bool ky_btree_map<K, V, Alloc, Compare>::erase(node_t *n, int height, const K &key)
+{
+    if (height == 0)
+    {
+        leaf_t *l = (leaf_t *)n;
+        const int i = lower (l->keys (), l->count, key);
+        if (i >= l->count || less (key, l->keys ()[i]))
+            return false;
+        erase_at (l->keys (), l->count, i);
+        erase_at (l->vals (), l->count, i);
+        --l->count;
+        return true;
+    }
+
+    inner_t *in = (inner_t *)n;
+    const int i = upper (in->keys (), in->count, key);
+    node_t *child = in->childs ()[i];
+    if (!erase (child, height - 1, key))
+        return false;
+    if (child->count < (height == 1 ? (int)LeafMin : (int)InnerMin))
+        rebalance (in, i, height - 1);
+    return true;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+size_t ky_btree_map<K, V, Alloc, Compare>::erase(const K& key)
+{
+    if (locate (key) == NULL)
+        return 0;
+    detach ();
+    if (!erase (impl->root, impl->height, key))
+        return 0;
+    --impl->count;
+
+    // 根只剩一个子节点时降低树高
+    if (impl->height > 0 && impl->root->count == 0)
+    {
+        inner_t *root = (inner_t *)impl->root;
+        impl->root = root->childs ()[0];
+        --impl->height;
+        Alloc::destroy (root);
+    }
+    return 1;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_btree_map<K, V, Alloc, Compare>::iterator ky_btree_map<K, V, Alloc, Compare>::erase(const_iterator pos)
+{
+    if (impl == NULL || pos.leaf == NULL || pos.index >= pos.leaf->count)
+        return end ();
+    const K key = pos.key ();
+    erase (key);
+    return lower_bound (key);
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+V &ky_btree_map<K, V, Alloc, Compare>::operator [](const K &key)
+{
+    iterator it = find (key);
+    if (it == end ())
+        it = insert (key, V());
+    return it.value ();
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+V ky_btree_map<K, V, Alloc, Compare>::value(const K &key, const V &defval) const
+{
+    const_iterator it = find (key);
+    return it == end () ? defval : it.value ();
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_btree_map<K, V, Alloc, Compare>::clear()
+{
+    destroy ();
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+template <typename Fn>
+void ky_btree_map<K, V, Alloc, Compare>::scan(const K &lo, const K &hi, Fn fn)const
+{
+    leaf_t *l = locate (lo);
+    if (l == NULL)
+        return ;
+    int i = lower (l->keys (), l->count, lo);
+    for (; l; l = l->after (), i = 0)
+    {
+        for (; i < l->count; ++i)
+        {
+            if (!less (l->keys ()[i], hi))
+                return ;
+            fn (l->keys ()[i], l->vals ()[i]);
+        }
+    }
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_list<K> ky_btree_map<K, V, Alloc, Compare>::keys() const
+{
+    ky_list<K> res;
+    res.reserve (count ());
+    if (impl)
+        for (leaf_t *l = impl->head; l; l = l->after ())
+            for (int i = 0; i < l->count; ++i)
+                res.append (l->keys ()[i]);
+    return res;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_list<V> ky_btree_map<K, V, Alloc, Compare>::values() const
+{
+    ky_list<V> res;
+    res.reserve (count ());
+    if (impl)
+        for (leaf_t *l = impl->head; l; l = l->after ())
+            for (int i = 0; i < l->count; ++i)
+                res.append (l->vals ()[i]);
+    return res;
+}
+
+#endif // KY_BTREE_MAP_INL
@@ -14,10 +14,11 @@
  *         线性插值、双线性插值
  *       5.支持RGB颜色的合成及混合
  *       6.支持伽马校正、亮度值计算、强度值计算
+ *       7.支持ky_format输出
  *
  * @author   kunyang
  * @email    kunyang.yk@gmail.com
- * @version  1.4.0.1
+ * @version  1.4.1.0
  * @date     2012/01/02
  * @license  GNU General Public License (GPL)
  *
@@ -32,6 +33,7 @@
  * 2017/04/13 | 1.3.1.0   | kunyang  | 修改内部算法
  * 2017/08/03 | 1.3.1.1   | kunyang  | 修改HEX颜色定义
  * 2018/01/16 | 1.4.0.1   | kunyang  | 加入YCoCg,YCoCg-R,YCrCb颜色转换
+ * 2026/10/18 | 1.4.1.0   | kunyang  | 加入ky_format输出
  *
  */
 #ifndef ky_COLOR_H
@@ -39,6 +41,7 @@
 #include "maths/ky_maths.h"
 #include "tools/ky_stream.h"
 #include "tools/ky_variant.h"
+#include "tools/ky_format.h"
 
 typedef uint ky_color32; // R8-G8-B8-A8
 
@@ -266,4 +269,19 @@ ky_streamt &operator << (ky_streamt &in, const ky_color &v);
 ky_streamt &operator >> (ky_streamt &out, ky_color &v);
 ky_variant &operator << (ky_variant &va, const ky_color &col);
 ky_variant &operator >> (ky_variant &va, ky_color &col);
+
+//! 输出为[r g b a]，格式应用到每个分量
+inline void ky_format_value(ky_format::writer &w, const ky_format::spec &sp, const ky_color &v)
+{
+    w.put ('[');
+    ky_format::value (w, sp, v.r);
+    w.put (' ');
+    ky_format::value (w, sp, v.g);
+    w.put (' ');
+    ky_format::value (w, sp, v.b);
+    w.put (' ');
+    ky_format::value (w, sp, v.a);
+    w.put (']');
+}
+
 #endif // COLOR_H
@@ -0,0 +1,212 @@
+
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_concurrent_hash_map.h
+ * @brief    多线程共享的分段哈希表
+ *       1.按散列高位分为多个段，每段一个读写锁(锁分段)
+ *       2.扩容只在单个段的写锁内进行，其他段的读写不受影响
+ *       3.快照为全部段的写时复制引用，代价为O(段数)
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ */
+#ifndef ky_CONCURRENT_HASH_MAP_H
+#define ky_CONCURRENT_HASH_MAP_H
+
+#include "ky_define.h"
+#include "ky_thread.h"
+#include "tools/ky_flat_hash_map.h"
+
+template <typename K, typename V, int Shards = 64, typename Alloc = ky_alloc<void> >
+class ky_concurrent_hash_map
+{
+    kyCompilerAssert((Shards & (Shards - 1)) == 0);
+public:
+    typedef ky_flat_hash_map<K, V, Alloc> shard_map;
+
+private:
+    //! 段之间以一个缓存行填充隔开，避免伪共享
+    //! \note 不使用对齐属性，否则对象的new在C++14下得不到对齐保证
+    struct shard
+    {
+        mutable ky_rwlock lock;
+        shard_map map;
+        char pad[64];
+    };
+
+    shard shards[Shards];
+
+    static int shard_of(const K &k)
+    {
+        // 段由散列高位选择，段内的平坦哈希表使用低位
+        return (int)((uint64)ky_hash(k) >> 40) & (Shards - 1);
+    }
+
+    ky_concurrent_hash_map(const ky_concurrent_hash_map &) = delete;
+    ky_concurrent_hash_map &operator = (const ky_concurrent_hash_map &) = delete;
+
+public:
+    class snapshot;
+
+public:
+    ky_concurrent_hash_map(){}
+    ~ky_concurrent_hash_map(){}
+
+    //!
+    //! \brief find 查找key，找到时将值拷贝到val
+    //! \param key
+    //! \param val
+    //! \return
+    //!
+    bool find(const K &key, V &val)const;
+    //!
+    //! \brief contains 是否包含key
+    //! \param key
+    //! \return
+    //!
+    bool contains(const K &key)const;
+    //!
+    //! \brief value 返回key的值，不存在时返回defval
+    //! \param key
+    //! \param defval
+    //! \return
+    //!
+    V value(const K &key, const V &defval = V())const;
+
+    //!
+    //! \brief insert 插入key，val，key已存在时不修改并返回false
+    //! \param key
+    //! \param val
+    //! \return
+    //!
+    bool insert(const K &key, const V &val);
+    //!
+    //! \brief upsert 插入或覆盖key的值，返回是否为新插入
+    //! \param key
+    //! \param val
+    //! \return
+    //!
+    bool upsert(const K &key, const V &val);
+    //!
+    //! \brief upsert 在段写锁内以fn(V&)修改key的值，不存在时先插入默认值
+    //! \param key
+    //! \param fn
+    //! \return 是否为新插入
+    //!
+    template <typename Fn>
+    bool upsert(const K &key, Fn fn);
+    //!
+    //! \brief erase 删除key，返回是否删除
+    //! \param key
+    //! \return
+    //!
+    bool erase(const K &key);
+
+    //!
+    //! \brief reserve 为全部段预留容纳size个元素的空间
+    //! \param size
+    //!
+    void reserve(size_t size);
+    //!
+    //! \brief clear 清空全部段
+    //!
+    void clear();
+    //!
+    //! \brief count 元素数，并发修改时仅为近似值
+    //! \return
+    //!
+    size_t count()const;
+    size_t size()const{return count ();}
+    bool is_empty()const{return count () == 0;}
+
+    //!
+    //! \brief snapshot 返回全部段的一致快照
+    //! \return
+    //! \note 同时持有全部段的读锁后复制各段的引用，之后写入的段会写时分离
+    //!
+    snapshot take()const;
+
+public:
+    class snapshot
+    {
+        friend class ky_concurrent_hash_map;
+    public:
+        class const_iterator
+        {
+            friend class snapshot;
+        private:
+            const snapshot *snap;
+            int sindex;
+            typename shard_map::const_iterator it;
+
+            const_iterator(const snapshot *s, int idx):snap(s), sindex(idx)
+            {
+                if (sindex < Shards)
+                    it = snap->maps[sindex].begin ();
+                settle ();
+            }
+            void settle()
+            {
+                while (sindex < Shards && it == snap->maps[sindex].end ())
+                {
+                    if (++sindex < Shards)
+                        it = snap->maps[sindex].begin ();
+                }
+            }
+        public:
+            const_iterator():snap(0), sindex(Shards){}
+
+            friend bool operator == (const const_iterator &a, const const_iterator &b)
+            {
+                return a.sindex == b.sindex && (a.sindex >= Shards || a.it == b.it);
+            }
+            friend bool operator != (const const_iterator &a, const const_iterator &b)
+            {
+                return !(a == b);
+            }
+            const typename shard_map::hash_entry &operator *()const {return *it;}
+            const typename shard_map::hash_entry *operator ->()const {return &(*it);}
+            const_iterator &operator ++()
+            {
+                ++it;
+                settle ();
+                return *this;
+            }
+        };
+        typedef const_iterator iterator;
+
+        const_iterator begin()const {return const_iterator(this, 0);}
+        const_iterator end()const {return const_iterator(this, Shards);}
+
+        size_t count()const
+        {
+            size_t n = 0;
+            for (int i = 0; i < Shards; ++i)
+                n += maps[i].count ();
+            return n;
+        }
+        size_t size()const {return count ();}
+        bool contains(const K &key)const {return maps[shard_of (key)].contains (key);}
+        V value(const K &key, const V &defval = V())const
+        {
+            const shard_map &m = maps[shard_of (key)];
+            typename shard_map::const_iterator it = m.find (key);
+            return it == m.end () ? defval : it->value ();
+        }
+
+    private:
+        shard_map maps[Shards];
+    };
+};
+
+#include "ky_concurrent_hash_map.inl"
+#endif // ky_CONCURRENT_HASH_MAP_H
@@ -0,0 +1,133 @@
+#ifndef KY_CONCURRENT_HASH_MAP_INL
+#define KY_CONCURRENT_HASH_MAP_INL
+
+template <typename K, typename V, int Shards, typename Alloc>
+bool ky_concurrent_hash_map<K, V, Shards, Alloc>::find(const K &key, V &val)const
+{
+    const shard &s = shards[shard_of (key)];
+    s.lock.lockrd ();
+    typename shard_map::const_iterator it = s.map.find (key);
+    const bool has = it != s.map.end ();
+    if (has)
+        val = it->value ();
+    s.lock.unlock ();
+    return has;
+}
+
+template <typename K, typename V, int Shards, typename Alloc>
+bool ky_concurrent_hash_map<K, V, Shards, Alloc>::contains(const K &key)const
+{
+    const shard &s = shards[shard_of (key)];
+    s.lock.lockrd ();
+    const bool has = s.map.contains (key);
+    s.lock.unlock ();
+    return has;
+}
+
+template <typename K, typename V, int Shards, typename Alloc>
+V ky_concurrent_hash_map<K, V, Shards, Alloc>::value(const K &key, const V &defval)const
+{
+    V val = defval;
+    find (key, val);
+    return val;
+}
+
+template <typename K, typename V, int Shards, typename Alloc>
+bool ky_concurrent_hash_map<K, V, Shards, Alloc>::insert(const K &key, const V &val)
+{
+    shard &s = shards[shard_of (key)];
+    s.lock.lockwr ();
+    const size_t before = s.map.count ();
+    s.map.insert (key, val);
+    const bool inserted = s.map.count () != before;
+    s.lock.unlock ();
+    return inserted;
+}
+
+template <typename K, typename V, int Shards, typename Alloc>
+bool ky_concurrent_hash_map<K, V, Shards, Alloc>::upsert(const K &key, const V &val)
+{
+    shard &s = shards[shard_of (key)];
+    s.lock.lockwr ();
+    const size_t before = s.map.count ();
+    s.map.append (key, val);
+    const bool inserted = s.map.count () != before;
+    s.lock.unlock ();
+    return inserted;
+}
+
+template <typename K, typename V, int Shards, typename Alloc>
+template <typename Fn>
+bool ky_concurrent_hash_map<K, V, Shards, Alloc>::upsert(const K &key, Fn fn)
+{
+    shard &s = shards[shard_of (key)];
+    s.lock.lockwr ();
+    const size_t before = s.map.count ();
+    fn (s.map[key]);
+    const bool inserted = s.map.count () != before;
+    s.lock.unlock ();
+    return inserted;
+}
+
+template <typename K, typename V, int Shards, typename Alloc>
+bool ky_concurrent_hash_map<K, V, Shards, Alloc>::erase(const K &key)
+{
+    shard &s = shards[shard_of (key)];
+    s.lock.lockwr ();
+    const bool erased = s.map.erase (key) != 0;
+    s.lock.unlock ();
+    return erased;
+}
+
+template <typename K, typename V, int Shards, typename Alloc>
+void ky_concurrent_hash_map<K, V, Shards, Alloc>::reserve(size_t size)
+{
+    const size_t each = (size + Shards - 1) / Shards;
+    for (int i = 0; i < Shards; ++i)
+    {
+        shards[i].lock.lockwr ();
+        shards[i].map.reserve (each);
+        shards[i].lock.unlock ();
+    }
+}
+
+template <typename K, typename V, int Shards, typename Alloc>
+void ky_concurrent_hash_map<K, V, Shards, Alloc>::clear()
+{
+    for (int i = 0; i < Shards; ++i)
+    {
+        shards[i].lock.lockwr ();
+        shards[i].map.clear ();
+        shards[i].lock.unlock ();
+    }
+}
+
+template <typename K, typename V, int Shards, typename Alloc>
+size_t ky_concurrent_hash_map<K, V, Shards, Alloc>::count()const
+{
+    size_t n = 0;
+    for (int i = 0; i < Shards; ++i)
+    {
+        shards[i].lock.lockrd ();
+        n += shards[i].map.count ();
+        shards[i].lock.unlock ();
+    }
+    return n;
+}
+
+template <typename K, typename V, int Shards, typename Alloc>
+typename ky_concurrent_hash_map<K, V, Shards, Alloc>::snapshot
+ky_concurrent_hash_map<K, V, Shards, Alloc>::take()const
+{
+    snapshot snap;
+    // 按段序加锁，与单段写锁不会形成环路
+    for (int i = 0; i < Shards; ++i)
+        shards[i].lock.lockrd ();
+    for (int i = 0; i < Shards; ++i)
+        snap.maps[i] = shards[i].map;
+    for (int i = Shards - 1; i >= 0; --i)
+        shards[i].lock.unlock ();
+    return snap;
+}
+
+#endif // KY_CONCURRENT_HASH_MAP_INL
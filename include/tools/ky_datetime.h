@@ -26,6 +26,7 @@
 #include "ky_string.h"
 #include "ky_stream.h"
 #include "ky_variant.h"
+#include "ky_format.h"
 
 
 class ky_datetime
@@ -120,4 +121,16 @@ ky_streamt &operator >> (ky_streamt &out, ky_datetime &v);
 
 ky_variant &operator << (ky_variant &va, const ky_datetime &col);
 ky_variant &operator >> (ky_variant &va, ky_datetime &col);
+
+//! 输出为yyyy-MM-dd hh:mm:ss.zzz
+inline void ky_format_value(ky_format::writer &w, const ky_format::spec &sp, const ky_datetime &v)
+{
+    char buf[40];
+    ky_format::format_to (buf, "{:04}-{:02}-{:02} {:02}:{:02}:{:02}.{:03}",
+                          v.year (), v.month (), v.day (),
+                          v.hour (), v.minute (), v.second (), v.msec ());
+    ky_format::spec text = sp;
+    text.type = 0;
+    ky_format::value (w, text, (const char *)buf);
+}
 #endif // UTIME_H
@@ -0,0 +1,148 @@
+
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_dynbitset.h
+ * @brief    运行时确定长度的位集
+ *       1.以uint64数组存储，末尾字中超出长度的位始终为0
+ *       2.整块运算、计数和查找与ky_bitset的宽位特化共用__bitset__中的AVX2实现
+ *       3.find_first/find_next以tzcnt定位，each逐字清除最低位访问有效位
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ */
+#ifndef ky_DYNBITSET_H
+#define ky_DYNBITSET_H
+
+#include "ky_bitset.h"
+
+/*!
+ * @brief The ky_dynbitset class
+ * @class ky_dynbitset
+ * @note 两个位集之间的运算要求长度相同
+ */
+class ky_dynbitset
+{
+public:
+    static const size_t npos = size_t(-1);
+
+    explicit ky_dynbitset(size_t bits = 0, bool value = false);
+    ky_dynbitset(const ky_dynbitset &rhs);
+    ~ky_dynbitset();
+
+    ky_dynbitset &operator = (const ky_dynbitset &rhs);
+#if kyLanguage >= kyLanguage11
+    ky_dynbitset(ky_dynbitset &&rhs);
+    ky_dynbitset &operator = (ky_dynbitset &&rhs);
+#endif
+
+    //! 单个位的引用
+    class reference
+    {
+        friend class ky_dynbitset;
+        uint64 *word;
+        uint64 mask;
+        reference(uint64 *w, size_t bit):word(w + bit / 64), mask(uint64(1) << (bit % 64)){}
+    public:
+        reference &operator = (bool b){if (b) *word |= mask; else *word &= ~mask; return *this;}
+        reference &operator = (eBitsets b){return *this = (b != FALSE);}
+        operator bool() const {return (*word & mask) != 0;}
+        bool operator == (eBitsets b)const{return bool(*this) == (b != FALSE);}
+        bool operator != (eBitsets b)const{return bool(*this) != (b != FALSE);}
+    };
+
+public:
+    //! 位数
+    size_t size()const{return bits;}
+    bool is_empty()const{return bits == 0;}
+    //! 存储的字数
+    size_t words()const{return __bitset__::words (bits);}
+    uint64 *data(){return word;}
+    const uint64 *data()const{return word;}
+
+    //!
+    //! \brief resize 改变位数，新增的位置为value
+    //!
+    void resize(size_t bits, bool value = false);
+    //! 预留至少bits位的空间
+    void reserve(size_t bits);
+    //! 在末尾追加一位
+    void append(bool value);
+    //! 位数置0并释放空间
+    void clear();
+
+public:
+    reference operator [](size_t bit);
+    bool operator [](size_t bit)const{return test (bit);}
+    bool test(size_t bit)const;
+
+    void set();
+    void set(size_t bit);
+    void unset();
+    void unset(size_t bit);
+    void flip();
+    void flip(size_t bit);
+
+    bool any()const{return __bitset__::any (word, words ());}
+    bool none()const{return !any ();}
+    size_t count()const{return __bitset__::count (word, words ());}
+
+    //!
+    //! \brief find_first 第一个有效位的序号，没有时返回npos
+    //!
+    size_t find_first()const;
+    //!
+    //! \brief find_next bit之后的第一个有效位的序号，没有时返回npos
+    //!
+    size_t find_next(size_t bit)const;
+    //!
+    //! \brief each 从低到高以fn(size_t)访问每个有效位
+    //!
+    template <typename Fn>
+    void each(Fn fn)const{__bitset__::each (word, words (), fn);}
+
+public:
+    ky_dynbitset operator & (const ky_dynbitset &rhs)const;
+    ky_dynbitset operator | (const ky_dynbitset &rhs)const;
+    ky_dynbitset operator ^ (const ky_dynbitset &rhs)const;
+    ky_dynbitset operator ~ ()const;
+
+    ky_dynbitset &operator &= (const ky_dynbitset &rhs);
+    ky_dynbitset &operator |= (const ky_dynbitset &rhs);
+    ky_dynbitset &operator ^= (const ky_dynbitset &rhs);
+
+    ky_dynbitset operator << (size_t b)const;
+    ky_dynbitset operator >> (size_t b)const;
+    ky_dynbitset &operator <<= (size_t b);
+    ky_dynbitset &operator >>= (size_t b);
+
+    bool operator == (const ky_dynbitset &rhs)const;
+    bool operator != (const ky_dynbitset &rhs)const{return !this->operator == (rhs);}
+
+    //!
+    //! \brief  字符串格式互相转换
+    //!
+    ky_string to_string()const;
+    void form_string(const ky_string &s);
+
+    void swap(ky_dynbitset &b);
+    friend void ky_swap(ky_dynbitset &a, ky_dynbitset &b) {a.swap(b);}
+
+private:
+    void trim(){if (bits) word[words () - 1] &= __bitset__::tail_mask (bits);}
+
+    uint64 *word;
+    size_t bits;
+    size_t capacity;        ///< 已申请的字数
+};
+
+#include "ky_dynbitset.inl"
+#endif // ky_DYNBITSET_H
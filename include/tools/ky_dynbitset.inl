@@ -0,0 +1,276 @@
+#ifndef KY_DYNBITSET_INL
+#define KY_DYNBITSET_INL
+
+inline ky_dynbitset::ky_dynbitset(size_t n, bool value):
+    word(NULL), bits(0), capacity(0)
+{
+    resize (n, value);
+}
+
+inline ky_dynbitset::ky_dynbitset(const ky_dynbitset &rhs):
+    word(NULL), bits(0), capacity(0)
+{
+    *this = rhs;
+}
+
+inline ky_dynbitset::~ky_dynbitset()
+{
+    kyFree (word);
+}
+
+inline ky_dynbitset &ky_dynbitset::operator = (const ky_dynbitset &rhs)
+{
+    if (this == &rhs)
+        return *this;
+    reserve (rhs.bits);
+    bits = rhs.bits;
+    if (bits)
+        memcpy (word, rhs.word, words () * sizeof(uint64));
+    return *this;
+}
+
+#if kyLanguage >= kyLanguage11
+inline ky_dynbitset::ky_dynbitset(ky_dynbitset &&rhs):
+    word(rhs.word), bits(rhs.bits), capacity(rhs.capacity)
+{
+    rhs.word = NULL;
+    rhs.bits = 0;
+    rhs.capacity = 0;
+}
+
+inline ky_dynbitset &ky_dynbitset::operator = (ky_dynbitset &&rhs)
+{
+    swap (rhs);
+    return *this;
+}
+#endif
+
+inline void ky_dynbitset::reserve(size_t n)
+{
+    const size_t need = __bitset__::words (n);
+    if (need <= capacity)
+        return;
+    // 按1.5倍增长，逐位追加时摊还为常数
+    size_t cap = capacity + capacity / 2;
+    if (cap < need)
+        cap = need;
+    word = (uint64 *)kyRealloc (word, cap * sizeof(uint64));
+    capacity = cap;
+}
+
+inline void ky_dynbitset::resize(size_t n, bool value)
+{
+    const size_t old = bits;
+    if (n > old)
+    {
+        reserve (n);
+        const size_t from = words ();
+        memset (word + from, value ? 0xff : 0, (__bitset__::words (n) - from) * sizeof(uint64));
+        if (value && (old % __bitset__::WordBits))
+            word[from - 1] |= ~__bitset__::tail_mask (old);
+    }
+    bits = n;
+    trim ();
+}
+
+inline void ky_dynbitset::append(bool value)
+{
+    if (bits % __bitset__::WordBits == 0)
+    {
+        reserve (bits + 1);
+        word[bits / __bitset__::WordBits] = 0;
+    }
+    if (value)
+        word[bits / __bitset__::WordBits] |= uint64(1) << (bits % __bitset__::WordBits);
+    ++bits;
+}
+
+inline void ky_dynbitset::clear()
+{
+    kyFree (word);
+    word = NULL;
+    bits = 0;
+    capacity = 0;
+}
+
+inline ky_dynbitset::reference ky_dynbitset::operator [](size_t bit)
+{
+    kyASSERT(bit < bits, "The index is illegal");
+    return reference(word, bit);
+}
+
+inline bool ky_dynbitset::test(size_t bit)const
+{
+    kyASSERT(bit < bits, "The index is illegal");
+    return (word[bit / 64] >> (bit % 64)) & 1;
+}
+
+inline void ky_dynbitset::set()
+{
+    if (bits)
+        memset (word, 0xff, words () * sizeof(uint64));
+    trim ();
+}
+
+inline void ky_dynbitset::set(size_t bit)
+{
+    kyASSERT(bit < bits, "The index is illegal");
+    word[bit / 64] |= uint64(1) << (bit % 64);
+}
+
+inline void ky_dynbitset::unset()
+{
+    if (bits)
+        memset (word, 0, words () * sizeof(uint64));
+}
+
+inline void ky_dynbitset::unset(size_t bit)
+{
+    kyASSERT(bit < bits, "The index is illegal");
+    word[bit / 64] &= ~(uint64(1) << (bit % 64));
+}
+
+inline void ky_dynbitset::flip()
+{
+    __bitset__::bit_not (word, word, words ());
+    trim ();
+}
+
+inline void ky_dynbitset::flip(size_t bit)
+{
+    kyASSERT(bit < bits, "The index is illegal");
+    word[bit / 64] ^= uint64(1) << (bit % 64);
+}
+
+inline size_t ky_dynbitset::find_first()const
+{
+    const size_t i = __bitset__::find (word, words (), 0);
+    return i < bits ? i : npos;
+}
+
+inline size_t ky_dynbitset::find_next(size_t bit)const
+{
+    if (bit + 1 >= bits)
+        return npos;
+    const size_t i = __bitset__::find (word, words (), bit + 1);
+    return i < bits ? i : npos;
+}
+
+inline ky_dynbitset ky_dynbitset::operator & (const ky_dynbitset &rhs)const
+{
+    ky_dynbitset out(*this);
+    return out &= rhs;
+}
+
+inline ky_dynbitset ky_dynbitset::operator | (const ky_dynbitset &rhs)const
+{
+    ky_dynbitset out(*this);
+    return out |= rhs;
+}
+
+inline ky_dynbitset ky_dynbitset::operator ^ (const ky_dynbitset &rhs)const
+{
+    ky_dynbitset out(*this);
+    return out ^= rhs;
+}
+
+inline ky_dynbitset ky_dynbitset::operator ~ ()const
+{
+    ky_dynbitset out(*this);
+    out.flip ();
+    return out;
+}
+
+inline ky_dynbitset &ky_dynbitset::operator &= (const ky_dynbitset &rhs)
+{
+    kyASSERT(bits == rhs.bits, "The bitset sizes differ");
+    __bitset__::bit_and (word, word, rhs.word, words ());
+    return *this;
+}
+
+inline ky_dynbitset &ky_dynbitset::operator |= (const ky_dynbitset &rhs)
+{
+    kyASSERT(bits == rhs.bits, "The bitset sizes differ");
+    __bitset__::bit_or (word, word, rhs.word, words ());
+    return *this;
+}
+
+inline ky_dynbitset &ky_dynbitset::operator ^= (const ky_dynbitset &rhs)
+{
+    kyASSERT(bits == rhs.bits, "The bitset sizes differ");
+    __bitset__::bit_xor (word, word, rhs.word, words ());
+    return *this;
+}
+
+inline ky_dynbitset ky_dynbitset::operator << (size_t b)const
+{
+    ky_dynbitset out(*this);
+    return out <<= b;
+}
+
+inline ky_dynbitset ky_dynbitset::operator >> (size_t b)const
+{
+    ky_dynbitset out(*this);
+    return out >>= b;
+}
+
+inline ky_dynbitset &ky_dynbitset::operator <<= (size_t b)
+{
+    __bitset__::shift_left (word, words (), b);
+    trim ();
+    return *this;
+}
+
+inline ky_dynbitset &ky_dynbitset::operator >>= (size_t b)
+{
+    __bitset__::shift_right (word, words (), b);
+    return *this;
+}
+
+inline bool ky_dynbitset::operator == (const ky_dynbitset &rhs)const
+{
+    return bits == rhs.bits && __bitset__::equal (word, rhs.word, words ());
+}
+
+inline ky_string ky_dynbitset::to_string()const
+{
+    ky_string out("b");
+    if (bits == 0)
+        return out;
+    size_t i = bits - 1;
+    while (i > 0 && !test (i))
+        --i;
+    for (++i; i-- > 0; )
+        out.append (test (i) ? '1' : '0');
+    return out;
+}
+
+inline void ky_dynbitset::form_string(const ky_string &s)
+{
+    ky_string tmp(s);
+    if (tmp[0] == ky_char('b'))
+        tmp.remove(0,1);
+    else if (tmp.is_empty ())
+        return ;
+    const int n = tmp.count ();
+    resize (0);
+    resize (n);
+    for (int i = 0; i < n; ++i)
+        if (tmp[n - 1 - i] == ky_char('1'))
+            set (i);
+}
+
+inline void ky_dynbitset::swap(ky_dynbitset &b)
+{
+    uint64 *w = b.word;
+    b.word = word;
+    word = w;
+    const size_t n = b.bits;
+    b.bits = bits;
+    bits = n;
+    const size_t c = b.capacity;
+    b.capacity = capacity;
+    capacity = c;
+}
+
+#endif // KY_DYNBITSET_INL
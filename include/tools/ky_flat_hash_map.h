@@ -0,0 +1,346 @@
+
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_flat_hash_map.h
+ * @brief    开放寻址的平坦哈希表
+ *       1.键值直接存储在槽数组内，无每元素的堆分配
+ *       2.控制字节每次探测16个(SSE2)，槽数量为2的幂，无取模运算
+ *       3.接口与ky_hash_map兼容
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ */
+#ifndef ky_FLAT_HASH_MAP_H
+#define ky_FLAT_HASH_MAP_H
+
+#include "ky_define.h"
+#include "tools/ky_typeinfo.h"
+#include "tools/ky_memory.h"
+#include "tools/ky_algorlthm.h"
+
+//!
+//! \brief The _ky_flat_hash_map_ struct 平坦哈希表的内存头
+//! \note 内存布局: [头][控制字节 x capacity][槽 x capacity]
+//!       控制字节最高位为0时表示槽已占用，低7位为键散列的h2部分
+//!
+struct _ky_flat_hash_map_
+{
+    enum
+    {
+        GroupWidth = 16,            ///< 一次探测的控制字节数
+        MinCapacity = GroupWidth    ///< 最小槽数量
+    };
+    enum eCtrls
+    {
+        Ctrl_Empty = -128,          ///< 空槽
+        Ctrl_Deleted = -2           ///< 已删除槽
+    };
+
+    ky_ref ref;                     ///< 引用计数
+    size_t capacity;                ///< 槽数量(2的幂)
+    size_t count;                   ///< 元素数
+    size_t growth;                  ///< 不需要重新散列时还可插入的元素数
+
+    int8 *ctrls()const {return (int8 *)(this + 1);}
+
+    //! 最大使用率为 7/8
+    static size_t max_count(size_t cap){return cap - cap / 8;}
+    //! 返回能容纳n个元素的槽数量
+    static size_t normalize(size_t n)
+    {
+        size_t cap = MinCapacity;
+        while (max_count (cap) < n)
+            cap <<= 1;
+        return cap;
+    }
+    //! 槽数组相对控制字节起始的偏移
+    static size_t slot_offset(size_t cap, size_t align)
+    {
+        return (cap + align - 1) & ~(align - 1);
+    }
+
+    //! 组内控制字节等于h2的位掩码
+    static inline uint32 match(const int8 *g, int8 h2);
+    //! 组内空槽的位掩码
+    static inline uint32 match_empty(const int8 *g);
+    //! 组内空槽或已删除槽的位掩码
+    static inline uint32 match_free(const int8 *g);
+    //! 掩码中最低位的槽序号
+    static inline int lowest(uint32 mask){return __builtin_ctz (mask);}
+};
+
+template <typename K, typename V, typename Alloc = ky_alloc<void> >
+class ky_flat_hash_map : public Alloc
+{
+public:
+    struct hash_entry
+    {
+    public:
+        hash_entry(const K& k):_key(k), _value(){}
+        hash_entry(const K& k,const V& v):_key(k), _value(v){}
+        hash_entry(const hash_entry &rhs):_key(rhs._key), _value(rhs._value){}
+#if kyLanguage >= kyLanguage11
+        hash_entry(hash_entry &&rhs):_key(std::move(rhs._key)), _value(std::move(rhs._value)){}
+#endif
+
+        const K& key() const {return _key;}
+        const V& value() const {return _value;}
+        V& value()  {return _value;}
+        hash_entry& operator =(const V& nv){_value = nv; return *this;}
+
+    private:
+        K _key;
+        V _value;
+    };
+
+private:
+    typedef _ky_flat_hash_map_ header_t;
+    enum {npos = -1};
+
+    header_t *impl;
+
+    int8 *ctrls()const {return impl->ctrls ();}
+    hash_entry *slots()const
+    {
+        return (hash_entry *)(ctrls() + header_t::slot_offset (impl->capacity, alignof(hash_entry)));
+    }
+    //! 对ky_hash再做一次乘法混合，使恒等散列也能均匀分布到组
+    static uint64 hash_of(const K &k)
+    {
+        const uint64 h = (uint64)ky_hash(k) * 0x9E3779B97F4A7C15ull;
+        return h ^ (h >> 32);
+    }
+
+protected:
+    header_t *create(size_t cap);
+    void destroy();
+    void detach();
+    void rehash(size_t cap);
+
+    //! 查找key所在的槽，未找到返回npos
+    size_t lookup(const K &k)const;
+    //! 为散列值h取得一个可写入的槽并设置控制字节
+    size_t prepare(uint64 h);
+    //! 查找key，不存在时插入默认值，返回槽序号
+    size_t touch(const K &k, bool *inserted = 0);
+    void erase_slot(size_t i);
+
+public:
+    class opehmap_node;
+    class const_opehmap_node;
+    typedef opehmap_node iterator;
+    typedef const_opehmap_node const_iterator;
+
+    /// STL style
+public:
+    ky_flat_hash_map():impl(NULL){}
+    ky_flat_hash_map(const ky_flat_hash_map & rhs):impl(rhs.impl)
+    {
+        if (impl)
+            impl->ref.addref ();
+    }
+    explicit ky_flat_hash_map(size_t capacity):impl(NULL)
+    {
+        reserve (capacity);
+    }
+    ~ky_flat_hash_map()
+    {
+        destroy();
+    }
+
+    ky_flat_hash_map &operator = (const ky_flat_hash_map &rhs);
+
+    iterator begin();
+    const_iterator begin() const;
+    iterator end(void);
+    const_iterator end(void) const;
+
+    //!
+    //! \brief find 查找key并返回一个迭代器
+    //! \param key
+    //! \return
+    //!
+    iterator find(const K &key);
+    const_iterator find(const K &key) const;
+    //!
+    //! \brief at 返回key的值
+    //! \param key
+    //! \return
+    //!
+    V &at(const K &key){return operator [](key);}
+    const V &at(const K &key)const{return operator [](key);}
+    //!
+    //! \brief operator []
+    //! \param key
+    //! \return 返回指定key的值，不存在时插入默认值(const版本返回静态默认值)
+    //!
+    V &operator [](const K &key);
+    const V &operator [](const K &key)const;
+    //!
+    //! \brief insert 插入key并返回迭代器
+    //! \param key
+    //! \return
+    //!
+    iterator insert(const K& key);
+    //!
+    //! \brief insert 插入key，val并返回迭代器，key已存在时不修改值
+    //! \param key
+    //! \param val
+    //! \return
+    //!
+    iterator insert(const K& key, const V& val);
+
+    //!
+    //! \brief erase 擦除迭代器所指元素，返回下一个元素
+    //! \param pos
+    //! \return
+    //!
+    iterator erase(iterator pos);
+    iterator erase(const_iterator pos);
+    //!
+    //! \brief erase 擦除key，返回擦除的元素数
+    //! \param key
+    //! \return
+    //!
+    size_t erase(const K& key);
+
+    //!
+    //! \brief swap 交换两个map
+    //! \param rhs
+    //!
+    void swap(ky_flat_hash_map &rhs){header_t *tmp = impl; impl = rhs.impl; rhs.impl = tmp;}
+    friend void ky_swap (ky_flat_hash_map &a, ky_flat_hash_map &b){a.swap (b);}
+    //!
+    //! \brief clear 清空map
+    //!
+    void clear();
+    bool empty() const{return is_empty ();}
+    size_t size() const{return count();}
+
+#if kyLanguage >= kyLanguage11
+public:
+    ky_flat_hash_map(ky_flat_hash_map &&m):impl(m.impl){m.impl = NULL;}
+    ky_flat_hash_map& operator = (ky_flat_hash_map &&m)
+    {
+        if (this != &m)
+        {
+            destroy ();
+            impl = m.impl;
+            m.impl = NULL;
+        }
+        return *this;
+    }
+    const_iterator cbegin() const{return begin();}
+    const_iterator cend() const{return end();}
+#endif
+
+    // base
+public:
+    void append(const K& k, const V& v);
+    void append(const hash_entry& entry){append(entry.key (), entry.value ());}
+    bool contains(const K& k) const{return lookup (k) != (size_t)npos;}
+    bool contains(const hash_entry& entry) const{return contains(entry.key ());}
+    V value(const K& key)const;
+    void remove(const K& key){erase(key);}
+    void remove(const iterator& it){erase(it);}
+
+    //!
+    //! \brief reserve 分配能容纳size个元素的空间
+    //! \param size
+    //!
+    void reserve(size_t size);
+
+    bool is_empty() const {return count() == 0;}
+    bool is_null()const {return impl == NULL;}
+
+    size_t capacity()const{return impl ? impl->capacity : 0;}
+    size_t count()const{return impl ? impl->count : 0;}
+
+public:
+    class opehmap_node
+    {
+        friend class ky_flat_hash_map;
+    private:
+        ky_flat_hash_map* table;
+        size_t sindex;
+
+        opehmap_node(ky_flat_hash_map* tab, size_t index):table(tab), sindex(index){skip ();}
+        void skip()
+        {
+            const size_t cap = table->capacity ();
+            while (sindex < cap && table->ctrls ()[sindex] < 0)
+                ++sindex;
+        }
+    public:
+        opehmap_node():table(0), sindex(0){}
+
+        bool is_finished(void) const {return sindex >= table->capacity ();}
+        friend bool operator == (const opehmap_node& it1,const opehmap_node& it2)
+        {
+            return it1.sindex == it2.sindex;
+        }
+        friend bool operator!=(const opehmap_node& it1,const opehmap_node& it2)
+        {
+            return it1.sindex != it2.sindex;
+        }
+        hash_entry& operator*(void) const {return table->slots ()[sindex];}
+        hash_entry* operator->(void) const {return table->slots () + sindex;}
+        opehmap_node& operator++(void)
+        {
+            ++sindex;
+            skip ();
+            return *this;
+        }
+    };
+    class const_opehmap_node
+    {
+        friend class ky_flat_hash_map;
+    private:
+        const ky_flat_hash_map* table;
+        size_t sindex;
+
+        const_opehmap_node(const ky_flat_hash_map* tab, size_t index):table(tab), sindex(index){skip ();}
+        void skip()
+        {
+            const size_t cap = table->capacity ();
+            while (sindex < cap && table->ctrls ()[sindex] < 0)
+                ++sindex;
+        }
+    public:
+        const_opehmap_node():table(0), sindex(0){}
+        const_opehmap_node(const opehmap_node &it):table(it.table), sindex(it.sindex){}
+
+        bool is_finished(void) const {return sindex >= table->capacity ();}
+        friend bool operator==(const const_opehmap_node& it1,const const_opehmap_node& it2)
+        {
+            return it1.sindex == it2.sindex;
+        }
+        friend bool operator!=(const const_opehmap_node& it1,const const_opehmap_node& it2)
+        {
+            return it1.sindex != it2.sindex;
+        }
+        const hash_entry& operator*(void) const {return table->slots ()[sindex];}
+        const hash_entry* operator->(void) const {return table->slots () + sindex;}
+        const_opehmap_node& operator++(void)
+        {
+            ++sindex;
+            skip ();
+            return *this;
+        }
+    };
+
+    friend class opehmap_node;
+    friend class const_opehmap_node;
+};
+
+#include "ky_flat_hash_map.inl"
+#endif // ky_FLAT_HASH_MAP_H
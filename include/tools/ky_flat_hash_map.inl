@@ -0,0 +1,362 @@
+#ifndef KY_FLAT_HASH_MAP_INL
+#define KY_FLAT_HASH_MAP_INL
+
+inline uint32 _ky_flat_hash_map_::match(const int8 *g, int8 h2)
+{
+#ifdef kyHAS_SSE2
+    const __m128i ctrl = _mm_loadu_si128 ((const __m128i *)g);
+    return (uint32)_mm_movemask_epi8 (_mm_cmpeq_epi8 (_mm_set1_epi8 (h2), ctrl));
+#else
+    uint32 mask = 0;
+    for (int i = 0; i < GroupWidth; ++i)
+        mask |= (uint32)(g[i] == h2) << i;
+    return mask;
+#endif
+}
+
+inline uint32 _ky_flat_hash_map_::match_empty(const int8 *g)
+{
+    return match (g, (int8)Ctrl_Empty);
+}
+
+inline uint32 _ky_flat_hash_map_::match_free(const int8 *g)
+{
+#ifdef kyHAS_SSE2
+    // 空槽和已删除槽都小于-1
+    const __m128i ctrl = _mm_loadu_si128 ((const __m128i *)g);
+    return (uint32)_mm_movemask_epi8 (_mm_cmpgt_epi8 (_mm_set1_epi8 (-1), ctrl));
+#else
+    uint32 mask = 0;
+    for (int i = 0; i < GroupWidth; ++i)
+        mask |= (uint32)(g[i] < -1) << i;
+    return mask;
+#endif
+}
+
+template <typename K, typename V, typename Alloc>
+_ky_flat_hash_map_ *ky_flat_hash_map<K, V, Alloc>::create(size_t cap)
+{
+    const size_t bytes = sizeof(header_t) +
+            header_t::slot_offset (cap, alignof(hash_entry)) + sizeof(hash_entry) * cap;
+    header_t *nh = new (Alloc::alloc (bytes)) header_t;
+    nh->ref.set (ky_ref::refShareableDetach);
+    nh->capacity = cap;
+    nh->count = 0;
+    nh->growth = header_t::max_count (cap);
+    ky_mem()->zero (nh->ctrls (), cap, header_t::Ctrl_Empty);
+    return nh;
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_flat_hash_map<K, V, Alloc>::destroy()
+{
+    if (impl && impl->ref.lessref ())
+    {
+        const int8 *ctrl = ctrls ();
+        hash_entry *slot = slots ();
+        for (size_t i = 0; i < impl->capacity; ++i)
+            if (ctrl[i] >= 0)
+                slot[i].~hash_entry();
+        impl->~header_t();
+        Alloc::destroy (impl);
+    }
+    impl = NULL;
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_flat_hash_map<K, V, Alloc>::detach()
+{
+    if (impl == NULL)
+        impl = create (header_t::MinCapacity);
+    else if (impl->ref.is_shared () && impl->ref.has_detach ())
+    {
+        header_t *olds = impl;
+        header_t *news = create (olds->capacity);
+        hash_entry *os = slots ();
+
+        impl = news;
+        hash_entry *ns = slots ();
+        ky_mem()->copy (news->ctrls (), olds->ctrls (), olds->capacity);
+        for (size_t i = 0; i < olds->capacity; ++i)
+            if (olds->ctrls ()[i] >= 0)
+                new (ns + i) hash_entry(os[i]);
+        news->count = olds->count;
+        news->growth = olds->growth;
+
+        olds->ref.lessref ();
+    }
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_flat_hash_map<K, V, Alloc>::rehash(size_t cap)
+{
+    header_t *olds = impl;
+    hash_entry *os = slots ();
+
+    impl = create (cap);
+    hash_entry *ns = slots ();
+    for (size_t i = 0; i < olds->capacity; ++i)
+    {
+        if (olds->ctrls ()[i] < 0)
+            continue;
+        const size_t ni = prepare (hash_of (os[i].key ()));
+#if kyLanguage >= kyLanguage11
+        new (ns + ni) hash_entry(std::move(os[i]));
+#else
+        new (ns + ni) hash_entry(os[i]);
+#endif
+        os[i].~hash_entry();
+    }
+    olds->~header_t();
+    Alloc::destroy (olds);
+}
+
+template <typename K, typename V, typename Alloc>
+size_t ky_flat_hash_map<K, V, Alloc>::lookup(const K &k)const
+{
+    if (impl == NULL || impl->count == 0)
+        return (size_t)npos;
+
+    const uint64 h = hash_of (k);
+    const int8 h2 = (int8)(h & 0x7f);
+    const size_t gmask = impl->capacity / header_t::GroupWidth - 1;
+    const int8 *ctrl = ctrls ();
+    const hash_entry *slot = slots ();
+
+    size_t g = (h >> 7) & gmask;
+    for (size_t step = 1; ; ++step)
+    {
+        const int8 *grp = ctrl + g * header_t::GroupWidth;
+        for (uint32 m = header_t::match (grp, h2); m; m &= m - 1)
+        {
+            const size_t i = g * header_t::GroupWidth + header_t::lowest (m);
+            if (slot[i].key () == k)
+                return i;
+        }
+        if (header_t::match_empty (grp))
+            return (size_t)npos;
+        // 三角数步长，组数为2的幂时可遍历全部组
+        g = (g + step) & gmask;
+    }
+}
+
+template <typename K, typename V, typename Alloc>
+size_t ky_flat_hash_map<K, V, Alloc>::prepare(uint64 h)
+{
+    for (;;)
+    {
+        const size_t gmask = impl->capacity / header_t::GroupWidth - 1;
+        int8 *ctrl = ctrls ();
+        size_t g = (h >> 7) & gmask;
+        for (size_t step = 1; ; ++step)
+        {
+            const uint32 m = header_t::match_free (ctrl + g * header_t::GroupWidth);
+            if (m)
+            {
+                const size_t i = g * header_t::GroupWidth + header_t::lowest (m);
+                if (ctrl[i] == header_t::Ctrl_Empty)
+                {
+                    if (impl->growth == 0)
+                        break;
+                    --impl->growth;
+                }
+                ctrl[i] = (int8)(h & 0x7f);
+                ++impl->count;
+                return i;
+            }
+            g = (g + step) & gmask;
+        }
+
+        // 已删除槽较多时原尺寸重新散列以回收，否则扩容一倍
+        if (impl->count < header_t::max_count (impl->capacity) / 2)
+            rehash (impl->capacity);
+        else
+            rehash (impl->capacity << 1);
+    }
+}
+
+template <typename K, typename V, typename Alloc>
+size_t ky_flat_hash_map<K, V, Alloc>::touch(const K &k, bool *inserted)
+{
+    detach ();
+    size_t i = lookup (k);
+    if (inserted)
+        *inserted = i == (size_t)npos;
+    if (i == (size_t)npos)
+    {
+        i = prepare (hash_of (k));
+        new (slots () + i) hash_entry(k);
+    }
+    return i;
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_flat_hash_map<K, V, Alloc>::erase_slot(size_t i)
+{
+    int8 *ctrl = ctrls ();
+    slots ()[i].~hash_entry();
+    --impl->count;
+
+    // 组内仍有空槽时探测不会越过此组，可直接置空
+    if (header_t::match_empty (ctrl + (i & ~(size_t)(header_t::GroupWidth - 1))))
+    {
+        ctrl[i] = header_t::Ctrl_Empty;
+        ++impl->growth;
+    }
+    else
+        ctrl[i] = header_t::Ctrl_Deleted;
+}
+
+template <typename K, typename V, typename Alloc>
+ky_flat_hash_map<K, V, Alloc> &ky_flat_hash_map<K, V, Alloc>::operator = (const ky_flat_hash_map &rhs)
+{
+    if (impl != rhs.impl)
+    {
+        destroy ();
+        impl = rhs.impl;
+        if (impl)
+            impl->ref.addref ();
+    }
+    return *this;
+}
+
+template <typename K, typename V, typename Alloc>
+typename ky_flat_hash_map<K, V, Alloc>::iterator ky_flat_hash_map<K, V, Alloc>::begin()
+{
+    if (impl)
+        detach ();
+    return iterator(this, 0);
+}
+template <typename K, typename V, typename Alloc>
+typename ky_flat_hash_map<K, V, Alloc>::const_iterator ky_flat_hash_map<K, V, Alloc>::begin() const
+{
+    return const_iterator(this, 0);
+}
+template <typename K, typename V, typename Alloc>
+typename ky_flat_hash_map<K, V, Alloc>::iterator ky_flat_hash_map<K, V, Alloc>::end(void)
+{
+    if (impl)
+        detach ();
+    return iterator(this, capacity ());
+}
+template <typename K, typename V, typename Alloc>
+typename ky_flat_hash_map<K, V, Alloc>::const_iterator ky_flat_hash_map<K, V, Alloc>::end(void) const
+{
+    return const_iterator(this, capacity ());
+}
+
+template <typename K, typename V, typename Alloc>
+typename ky_flat_hash_map<K, V, Alloc>::iterator ky_flat_hash_map<K, V, Alloc>::find(const K &k)
+{
+    if (impl)
+        detach ();
+    const size_t i = lookup (k);
+    return iterator(this, i == (size_t)npos ? capacity () : i);
+}
+template <typename K, typename V, typename Alloc>
+typename ky_flat_hash_map<K, V, Alloc>::const_iterator ky_flat_hash_map<K, V, Alloc>::find(const K &k) const
+{
+    const size_t i = lookup (k);
+    return const_iterator(this, i == (size_t)npos ? capacity () : i);
+}
+
+template <typename K, typename V, typename Alloc>
+V &ky_flat_hash_map<K, V, Alloc>::operator [](const K &k)
+{
+    const size_t i = touch (k);
+    return slots ()[i].value ();
+}
+template <typename K, typename V, typename Alloc>
+const V &ky_flat_hash_map<K, V, Alloc>::operator [](const K &k)const
+{
+    static const V none = V();
+    const size_t i = lookup (k);
+    return i == (size_t)npos ? none : slots ()[i].value ();
+}
+
+template <typename K, typename V, typename Alloc>
+typename ky_flat_hash_map<K, V, Alloc>::iterator ky_flat_hash_map<K, V, Alloc>::insert(const K& k)
+{
+    return iterator(this, touch (k));
+}
+template <typename K, typename V, typename Alloc>
+typename ky_flat_hash_map<K, V, Alloc>::iterator ky_flat_hash_map<K, V, Alloc>::insert(const K& k, const V& val)
+{
+    bool inserted = false;
+    const size_t i = touch (k, &inserted);
+    if (inserted)
+        slots ()[i] = val;
+    return iterator(this, i);
+}
+template <typename K, typename V, typename Alloc>
+void ky_flat_hash_map<K, V, Alloc>::append(const K& k, const V& v)
+{
+    const size_t i = touch (k);
+    slots ()[i] = v;
+}
+
+template <typename K, typename V, typename Alloc>
+V ky_flat_hash_map<K, V, Alloc>::value(const K& k)const
+{
+    const size_t i = lookup (k);
+    return i == (size_t)npos ? V() : slots ()[i].value ();
+}
+
+template <typename K, typename V, typename Alloc>
+typename ky_flat_hash_map<K, V, Alloc>::iterator ky_flat_hash_map<K, V, Alloc>::erase(iterator pos)
+{
+    if (pos.table != this || pos.sindex >= capacity ())
+        return end ();
+    detach ();
+    erase_slot (pos.sindex);
+    return iterator(this, pos.sindex + 1);
+}
+template <typename K, typename V, typename Alloc>
+typename ky_flat_hash_map<K, V, Alloc>::iterator ky_flat_hash_map<K, V, Alloc>::erase(const_iterator pos)
+{
+    if (pos.table != this || pos.sindex >= capacity ())
+        return end ();
+    detach ();
+    erase_slot (pos.sindex);
+    return iterator(this, pos.sindex + 1);
+}
+template <typename K, typename V, typename Alloc>
+size_t ky_flat_hash_map<K, V, Alloc>::erase(const K& k)
+{
+    if (lookup (k) == (size_t)npos)
+        return 0;
+    detach ();
+    erase_slot (lookup (k));
+    return 1;
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_flat_hash_map<K, V, Alloc>::clear()
+{
+    if (impl == NULL)
+        return;
+    if (impl->ref.is_shared ())
+    {
+        destroy ();
+        return;
+    }
+    int8 *ctrl = ctrls ();
+    hash_entry *slot = slots ();
+    for (size_t i = 0; i < impl->capacity; ++i)
+        if (ctrl[i] >= 0)
+            slot[i].~hash_entry();
+    ky_mem()->zero (ctrl, impl->capacity, header_t::Ctrl_Empty);
+    impl->count = 0;
+    impl->growth = header_t::max_count (impl->capacity);
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_flat_hash_map<K, V, Alloc>::reserve(size_t size)
+{
+    const size_t cap = header_t::normalize (size);
+    detach ();
+    if (cap > impl->capacity)
+        rehash (cap);
+}
+
+#endif // KY_FLAT_HASH_MAP_INL
@@ -0,0 +1,181 @@
+
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_format.h
+ * @brief    类型安全的格式化输出
+ *       1.以{}为占位符，{:[填充][对齐][符号][#][0][宽度][.精度][类型]}指定格式，{{、}}输出括号
+ *       2.参数由可变模板按类型记录，不经过va_list，参数类型与格式不符时不会越界读取
+ *       3.ky_format_to、ky_formats宏在编译期检查格式串及占位符与参数的个数
+ *       4.直接写入ky_string、ky_u8string或栈上缓冲，中间只使用栈上的小缓冲
+ *       5.数字使用ky_number，浮点默认输出最短的可还原表示
+ *       6.其他类型重载ky_format_value后即可作为参数
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ */
+#ifndef ky_FORMAT_H
+#define ky_FORMAT_H
+
+#include "ky_define.h"
+#include "ky_number.h"
+#include "ky_u8string.h"
+#include <string>
+
+namespace ky_format
+{
+    //! 一个占位符的格式
+    struct spec
+    {
+        char fill;      ///< 填充字符，默认为空格
+        char align;     ///< '<'左对齐 '>'右对齐 '^'居中，0时数字右对齐，其余左对齐
+        char sign;      ///< '+'正数输出加号 ' '正数输出空格 '-'只输出负号
+        bool alt;       ///< '#' 输出0x、0o、0b前缀
+        bool zero;      ///< '0' 在符号及前缀之后补0
+        int width;
+        int precision;  ///< 没有指定时为-1
+        char type;      ///< b c d o x X e E f F g G s p，0为默认
+    };
+
+    /*!
+     * @brief The writer class 带缓冲的输出
+     * @class writer
+     *  缓冲写满时交给flush函数；没有flush函数时为固定缓冲，超出部分只计数
+     */
+    class writer
+    {
+    public:
+        typedef void (*flush_fn)(void *ctx, const char *s, size_t n);
+
+        writer(char *b, size_t cap, flush_fn f = NULL, void *c = NULL):
+            buf(b), cur(b), end(b + cap), flushed(0), fn(f), ctx(c){}
+
+        void put(char c)
+        {
+            if (kyUnLikely(cur == end))
+                drain ();
+            if (kyLikely(cur != end))
+                *cur++ = c;
+            else
+                ++flushed;
+        }
+        void write(const char *s, size_t n);
+        void fill(char c, size_t n);
+        //! 输出缓冲中的剩余内容
+        void flush(){drain ();}
+
+        //! 已输出的字符数，包括固定缓冲中被截断的部分
+        size_t total()const{return flushed + (size_t)(cur - buf);}
+        //! 固定缓冲中写入的字符数
+        size_t written()const{return (size_t)(cur - buf);}
+
+    private:
+        void drain();
+
+        char *buf;
+        char *cur;
+        char *end;
+        size_t flushed;
+        flush_fn fn;
+        void *ctx;
+    };
+
+    //! 参数，字符串只保存指针及长度
+    struct arg
+    {
+        enum eTypes
+        {
+            Bool,
+            Char,
+            Int,
+            UInt,
+            Float,
+            Real,
+            Str,        ///< UTF-8
+            Str16,      ///< UTF-16
+            Ptr,
+            Custom      ///< 由ky_format_value输出
+        };
+        typedef void (*custom_fn)(writer &, const spec &, const void *);
+
+        int type;
+        union
+        {
+            longlong i;
+            ulonglong u;
+            real r;
+            float f;
+            const void *p;
+            struct {const void *s; size_t n;} text;
+            struct {const void *obj; custom_fn fn;} custom;
+        };
+    };
+
+    //!
+    //! \brief vformat 按格式输出参数
+    //! \note 多余的占位符输出为空，多余的参数被忽略
+    //!
+    void vformat(writer &w, const char *fmt, const arg *args, int count);
+
+    //! 按spec输出单个值，用于实现ky_format_value
+    template <typename T>
+    void value(writer &w, const spec &sp, const T &v);
+
+    //! 追加到字符串
+    template <typename... A>
+    ky_u8string &format_to(ky_u8string &out, const char *fmt, const A &...a);
+    template <typename... A>
+    ky_string &format_to(ky_string &out, const char *fmt, const A &...a);
+    template <typename... A>
+    writer &format_to(writer &out, const char *fmt, const A &...a);
+    //!
+    //! \brief format_to 写入固定缓冲并以0结尾，超出部分截断
+    //! \return 完整输出需要的字符数，不含结尾的0，同snprintf
+    //!
+    template <typename... A>
+    size_t format_to(char *buf, size_t cap, const char *fmt, const A &...a);
+    template <size_t N, typename... A>
+    size_t format_to(char (&buf)[N], const char *fmt, const A &...a){return format_to (buf, N, fmt, a...);}
+
+    template <typename... A>
+    ky_u8string format(const char *fmt, const A &...a);
+
+    //!
+    //! \brief count 编译期计算占位符个数
+    //! \return 括号不匹配时返回-1
+    //!
+    constexpr int count(const char *s, int n = 0);
+
+    //! 以下为编译期检查的实现
+    template <typename... A>
+    std::integral_constant<int, sizeof...(A)> _arity_(const A &...);
+
+    template <int Holders, int Args>
+    inline void _check_()
+    {
+        static_assert(Holders >= 0, "ky_format: 格式串的括号不匹配");
+        static_assert(Holders < 0 || Holders == Args, "ky_format: 占位符与参数的个数不一致");
+    }
+}
+
+//! 编译期检查格式串的format_to，fmt须为字符串常量
+#define ky_format_to(out, fmt, ...) \
+    (ky_format::_check_<ky_format::count (fmt), \
+                        decltype(ky_format::_arity_ (__VA_ARGS__))::value>(), \
+     ky_format::format_to (out, fmt, ##__VA_ARGS__))
+//! 编译期检查格式串的format，返回ky_u8string
+#define ky_formats(fmt, ...) \
+    (ky_format::_check_<ky_format::count (fmt), \
+                        decltype(ky_format::_arity_ (__VA_ARGS__))::value>(), \
+     ky_format::format (fmt, ##__VA_ARGS__))
+
+#include "ky_format.inl"
+#endif // ky_FORMAT_H
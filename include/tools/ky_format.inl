@@ -0,0 +1,571 @@
+#ifndef KY_FORMAT_INL
+#define KY_FORMAT_INL
+
+namespace ky_format {
+
+inline void writer::drain()
+{
+    if (fn && cur != buf)
+    {
+        fn (ctx, buf, (size_t)(cur - buf));
+        flushed += (size_t)(cur - buf);
+        cur = buf;
+    }
+}
+
+inline void writer::write(const char *s, size_t n)
+{
+    while (n > 0)
+    {
+        if (cur == end)
+        {
+            drain ();
+            if (cur == end)
+            {
+                // 固定缓冲已满
+                flushed += n;
+                return;
+            }
+        }
+        const size_t k = (size_t)(end - cur) < n ? (size_t)(end - cur) : n;
+        memcpy (cur, s, k);
+        cur += k;
+        s += k;
+        n -= k;
+    }
+}
+
+inline void writer::fill(char c, size_t n)
+{
+    while (n > 0)
+    {
+        if (cur == end)
+        {
+            drain ();
+            if (cur == end)
+            {
+                flushed += n;
+                return;
+            }
+        }
+        const size_t k = (size_t)(end - cur) < n ? (size_t)(end - cur) : n;
+        memset (cur, c, k);
+        cur += k;
+        n -= k;
+    }
+}
+
+constexpr int _close_(const char *s, int n);
+
+constexpr int count(const char *s, int n)
+{
+    return *s == 0 ? n :
+           (*s == '{' && s[1] == '{') ? count (s + 2, n) :
+           (*s == '}' && s[1] == '}') ? count (s + 2, n) :
+           *s == '{' ? _close_ (s + 1, n) :
+           *s == '}' ? -1 :
+           count (s + 1, n);
+}
+
+//! 在占位符内，找到}后继续计数
+constexpr int _close_(const char *s, int n)
+{
+    return *s == 0 || *s == '{' ? -1 :
+           *s == '}' ? count (s + 1, n + 1) :
+           _close_ (s + 1, n);
+}
+
+// 参数的构造，按类型区分
+
+inline arg _arg_(bool v){arg a; a.type = arg::Bool; a.i = v; return a;}
+inline arg _arg_(char v){arg a; a.type = arg::Char; a.i = v; return a;}
+inline arg _arg_(signed char v){arg a; a.type = arg::Int; a.i = v; return a;}
+inline arg _arg_(short v){arg a; a.type = arg::Int; a.i = v; return a;}
+inline arg _arg_(int v){arg a; a.type = arg::Int; a.i = v; return a;}
+inline arg _arg_(long v){arg a; a.type = arg::Int; a.i = v; return a;}
+inline arg _arg_(long long v){arg a; a.type = arg::Int; a.i = v; return a;}
+inline arg _arg_(unsigned char v){arg a; a.type = arg::UInt; a.u = v; return a;}
+inline arg _arg_(unsigned short v){arg a; a.type = arg::UInt; a.u = v; return a;}
+inline arg _arg_(unsigned int v){arg a; a.type = arg::UInt; a.u = v; return a;}
+inline arg _arg_(unsigned long v){arg a; a.type = arg::UInt; a.u = v; return a;}
+inline arg _arg_(unsigned long long v){arg a; a.type = arg::UInt; a.u = v; return a;}
+inline arg _arg_(float v){arg a; a.type = arg::Float; a.f = v; return a;}
+inline arg _arg_(double v){arg a; a.type = arg::Real; a.r = v; return a;}
+inline arg _arg_(long double v){arg a; a.type = arg::Real; a.r = (real)v; return a;}
+
+inline arg _text_(const void *s, size_t n, int type)
+{
+    arg a;
+    a.type = type;
+    a.text.s = s;
+    a.text.n = n;
+    return a;
+}
+
+inline arg _arg_(const char *s){return s ? _text_(s, strlen (s), arg::Str) : _text_("(null)", 6, arg::Str);}
+inline arg _arg_(char *s){return _arg_ ((const char *)s);}
+inline arg _arg_(const std::string &s){return _text_(s.data (), s.size (), arg::Str);}
+inline arg _arg_(const ky_u8string &s){return _text_(s.data (), s.size (), arg::Str);}
+inline arg _arg_(const ky_u8stringview &s){return _text_(s.data (), s.length (), arg::Str);}
+inline arg _arg_(const ky_stringview &s){return _text_(s.data (), s.length (), arg::Str16);}
+inline arg _arg_(const ky_string &s){return _arg_ (s.view ());}
+
+inline arg _arg_(const void *p){arg a; a.type = arg::Ptr; a.p = p; return a;}
+
+template <typename T>
+void _custom_(writer &w, const spec &sp, const void *obj)
+{
+    ky_format_value (w, sp, *(const T *)obj);
+}
+
+//! 没有对应重载的类型：枚举按整数，指针按地址，其余调用ky_format_value
+template <typename T,
+          bool Enum = std::is_enum<T>::value,
+          bool Pointer = std::is_pointer<T>::value>
+struct _maker_
+{
+    static arg make(const T &v)
+    {
+        arg a;
+        a.type = arg::Custom;
+        a.custom.obj = &v;
+        a.custom.fn = &_custom_<T>;
+        return a;
+    }
+};
+
+template <typename T>
+struct _maker_<T, true, false>
+{
+    static arg make(const T &v){return _arg_ ((longlong)v);}
+};
+
+template <typename T>
+struct _maker_<T, false, true>
+{
+    static arg make(const T &v){return _arg_ ((const void *)v);}
+};
+
+template <typename T>
+inline arg _arg_(const T &v){return _maker_<T>::make (v);}
+
+// 输出
+
+//! UTF-8的码点数
+inline size_t _chars_(const char *s, size_t n)
+{
+    size_t c = 0;
+    for (size_t i = 0; i < n; ++i)
+        c += ((uint8)s[i] & 0xc0) != 0x80;
+    return c;
+}
+
+//! 前k个码点的字节数
+inline size_t _prefix_(const char *s, size_t n, size_t k)
+{
+    size_t i = 0;
+    for (; i < n; ++i)
+        if (((uint8)s[i] & 0xc0) != 0x80 && k-- == 0)
+            break;
+    return i;
+}
+
+//! 按宽度及对齐输出，prefix为符号及进制前缀，chars为body的显示宽度
+inline void _pad_(writer &w, const spec &sp, const char *prefix, size_t np,
+                  const char *body, size_t nb, size_t chars, bool numeric)
+{
+    const size_t used = np + chars;
+    const size_t pad = sp.width > 0 && (size_t)sp.width > used ? (size_t)sp.width - used : 0;
+    if (pad == 0)
+    {
+        w.write (prefix, np);
+        w.write (body, nb);
+        return;
+    }
+    if (numeric && sp.zero && sp.align == 0)
+    {
+        w.write (prefix, np);
+        w.fill ('0', pad);
+        w.write (body, nb);
+        return;
+    }
+    const char align = sp.align ? sp.align : (numeric ? '>' : '<');
+    const size_t left = align == '>' ? pad : (align == '^' ? pad / 2 : 0);
+    w.fill (sp.fill, left);
+    w.write (prefix, np);
+    w.write (body, nb);
+    w.fill (sp.fill, pad - left);
+}
+
+inline void _integer_(writer &w, const spec &sp, ulonglong v, bool neg)
+{
+    char prefix[4];
+    size_t np = 0;
+    if (neg)
+        prefix[np++] = '-';
+    else if (sp.sign == '+' || sp.sign == ' ')
+        prefix[np++] = sp.sign;
+
+    int radix = 10;
+    switch (sp.type)
+    {
+    case 'x': case 'X': radix = 16; break;
+    case 'o': radix = 8; break;
+    case 'b': radix = 2; break;
+    default: break;
+    }
+    if (sp.alt && radix != 10)
+    {
+        prefix[np++] = '0';
+        prefix[np++] = sp.type;
+    }
+
+    char body[ky_number::IntegerSize];
+    const size_t nb = (size_t)ky_number::format (v, body, radix);
+    if (sp.type == 'X')
+        for (size_t i = 0; i < nb; ++i)
+            if (body[i] >= 'a')
+                body[i] -= 'a' - 'A';
+    _pad_ (w, sp, prefix, np, body, nb, nb, true);
+}
+
+inline void _signed_(writer &w, const spec &sp, longlong v)
+{
+    if (sp.type == 'c')
+    {
+        const char c = (char)v;
+        _pad_ (w, sp, NULL, 0, &c, 1, 1, false);
+        return;
+    }
+    _integer_ (w, sp, v < 0 ? (ulonglong)0 - (ulonglong)v : (ulonglong)v, v < 0);
+}
+
+template <typename F>
+void _real_(writer &w, const spec &sp, F v)
+{
+    char body[ky_number::RealSize + 352];
+    size_t nb = 0;
+    if (sp.type == 0 && sp.precision < 0)
+        nb = (size_t)ky_number::format (v, body);
+    else if ((sp.type == 'f' || sp.type == 'F') &&
+             (nb = (size_t)ky_number::format_fixed (v, body, sp.precision < 0 ? 6 : sp.precision)) > 0)
+        ;
+    else
+    {
+        // 指定精度或形式时由snprintf输出
+        char fmt[8];
+        int k = 0;
+        fmt[k++] = '%';
+        fmt[k++] = '.';
+        fmt[k++] = '*';
+        fmt[k++] = sp.type ? sp.type : 'g';
+        fmt[k] = 0;
+        const int prec = sp.precision < 0 ? 6 : (sp.precision > 64 ? 64 : sp.precision);
+        const int r = snprintf (body, sizeof(body), fmt, prec, (double)v);
+        nb = r < 0 ? 0 : ((size_t)r < sizeof(body) ? (size_t)r : sizeof(body) - 1);
+    }
+    const char *digits = body;
+    char prefix[1];
+    size_t np = 0;
+    if (nb > 0 && body[0] == '-')
+    {
+        prefix[np++] = '-';
+        ++digits;
+        --nb;
+    }
+    else if (sp.sign == '+' || sp.sign == ' ')
+        prefix[np++] = sp.sign;
+    _pad_ (w, sp, prefix, np, digits, nb, nb, true);
+}
+
+inline void _string_(writer &w, const spec &sp, const char *s, size_t n)
+{
+    if (sp.precision >= 0)
+        n = _prefix_ (s, n, (size_t)sp.precision);
+    if (sp.width <= 0)
+    {
+        w.write (s, n);
+        return;
+    }
+    _pad_ (w, sp, NULL, 0, s, n, _chars_ (s, n), false);
+}
+
+inline void _string16_(writer &w, const spec &sp, const uint16 *s, size_t n)
+{
+    size_t chars = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (sp.precision >= 0 && chars == (size_t)sp.precision)
+        {
+            n = i;
+            break;
+        }
+        chars += (s[i] & 0xfc00) != 0xdc00;
+    }
+    const size_t pad = sp.width > 0 && (size_t)sp.width > chars ? (size_t)sp.width - chars : 0;
+    const char align = sp.align ? sp.align : '<';
+    const size_t left = align == '>' ? pad : (align == '^' ? pad / 2 : 0);
+    w.fill (sp.fill, left);
+    // 分块转换为UTF-8，代理对不跨块
+    uint8 buf[64 * 3];
+    while (n > 0)
+    {
+        size_t k = n < 64 ? n : 64;
+        if (k < n && (s[k - 1] & 0xfc00) == 0xd800)
+            --k;
+        const size_t m = ky_utf::utf16_to_utf8 (s, k, buf, true);
+        w.write ((const char *)buf, m);
+        s += k;
+        n -= k;
+    }
+    w.fill (sp.fill, pad - left);
+}
+
+inline void _pointer_(writer &w, const spec &sp, const void *p)
+{
+    char body[2 + 16];
+    body[0] = '0';
+    body[1] = 'x';
+    const size_t nb = 2 + (size_t)ky_number::format ((ulonglong)(uintptr_t)p, body + 2, 16);
+    _pad_ (w, sp, NULL, 0, body, nb, nb, true);
+}
+
+inline void _format_arg_(writer &w, const spec &sp, const arg &a)
+{
+    switch (a.type)
+    {
+    case arg::Bool:
+        if (sp.type && sp.type != 's')
+            _integer_ (w, sp, (ulonglong)a.i, false);
+        else
+            _string_ (w, sp, a.i ? "true" : "false", a.i ? 4 : 5);
+        break;
+    case arg::Char:
+        if (sp.type && sp.type != 'c')
+            _signed_ (w, sp, a.i);
+        else
+        {
+            const char c = (char)a.i;
+            _pad_ (w, sp, NULL, 0, &c, 1, 1, false);
+        }
+        break;
+    case arg::Int:
+        _signed_ (w, sp, a.i);
+        break;
+    case arg::UInt:
+        if (sp.type == 'c')
+            _signed_ (w, sp, (longlong)a.u);
+        else
+            _integer_ (w, sp, a.u, false);
+        break;
+    case arg::Float:
+        _real_ (w, sp, a.f);
+        break;
+    case arg::Real:
+        _real_ (w, sp, a.r);
+        break;
+    case arg::Str:
+        _string_ (w, sp, (const char *)a.text.s, a.text.n);
+        break;
+    case arg::Str16:
+        _string16_ (w, sp, (const uint16 *)a.text.s, a.text.n);
+        break;
+    case arg::Ptr:
+        _pointer_ (w, sp, a.p);
+        break;
+    case arg::Custom:
+        a.custom.fn (w, sp, a.custom.obj);
+        break;
+    default:
+        break;
+    }
+}
+
+inline int _number_(const char *&s)
+{
+    int v = 0;
+    while (*s >= '0' && *s <= '9')
+        v = v * 10 + (*s++ - '0');
+    return v;
+}
+
+//! 解析{:...}中冒号之后的部分，返回}之后的位置
+inline const char *_parse_spec_(const char *s, spec &sp)
+{
+    if (s[0] && s[0] != '}' && (s[1] == '<' || s[1] == '>' || s[1] == '^'))
+    {
+        sp.fill = s[0];
+        sp.align = s[1];
+        s += 2;
+    }
+    else if (s[0] == '<' || s[0] == '>' || s[0] == '^')
+        sp.align = *s++;
+    if (*s == '+' || *s == '-' || *s == ' ')
+        sp.sign = *s++;
+    if (*s == '#')
+    {
+        sp.alt = true;
+        ++s;
+    }
+    if (*s == '0')
+    {
+        sp.zero = true;
+        ++s;
+    }
+    sp.width = _number_ (s);
+    if (*s == '.')
+    {
+        ++s;
+        sp.precision = _number_ (s);
+    }
+    if (*s && *s != '}')
+        sp.type = *s++;
+    // 忽略无法识别的部分
+    while (*s && *s != '}')
+        ++s;
+    return *s ? s + 1 : s;
+}
+
+inline void vformat(writer &w, const char *fmt, const arg *args, int count)
+{
+    int next = 0;
+    const char *run = fmt;
+    for (const char *s = fmt; *s; )
+    {
+        if (*s != '{' && *s != '}')
+        {
+            ++s;
+            continue;
+        }
+        w.write (run, (size_t)(s - run));
+        if (s[0] == s[1])
+        {
+            // {{ 及 }}
+            w.put (*s);
+            s += 2;
+            run = s;
+            continue;
+        }
+        if (*s == '}')
+        {
+            w.put (*s++);
+            run = s;
+            continue;
+        }
+
+        spec sp = {' ', 0, '-', false, false, 0, -1, 0};
+        ++s;
+        if (*s == ':')
+            s = _parse_spec_ (s + 1, sp);
+        else
+        {
+            while (*s && *s != '}')
+                ++s;
+            if (*s)
+                ++s;
+        }
+        if (next < count)
+            _format_arg_ (w, sp, args[next]);
+        ++next;
+        run = s;
+    }
+    w.write (run, strlen (run));
+}
+
+template <typename T>
+void value(writer &w, const spec &sp, const T &v)
+{
+    const arg a = _arg_ (v);
+    _format_arg_ (w, sp, a);
+}
+
+//! 参数数组，没有参数时也需要一个元素
+template <typename... A>
+struct _args_
+{
+    explicit _args_(const A &...a):items{_arg_ (a)...}{}
+    arg items[sizeof...(A) > 0 ? sizeof...(A) : 1];
+};
+
+template <>
+struct _args_<>
+{
+    arg items[1];
+};
+
+inline void _flush_u8_(void *ctx, const char *s, size_t n)
+{
+    ((ky_u8string *)ctx)->append (s, (int)n);
+}
+
+struct _wide_
+{
+    ky_string *out;
+    ky_utf8_decoder decoder;
+};
+
+inline void _flush_wide_(void *ctx, const char *s, size_t n)
+{
+    _wide_ *d = (_wide_ *)ctx;
+    uint16 buf[256 + 2];
+    size_t m = d->decoder.feed ((const uint8 *)s, n, buf);
+    if (m == ky_utf::error)
+    {
+        // 非法数据按替换字符输出
+        d->decoder.reset ();
+        m = ky_utf::utf8_to_utf16 ((const uint8 *)s, n, buf, true);
+    }
+    d->out->append ((const ky_char *)buf, (int)m);
+}
+
+template <typename... A>
+writer &format_to(writer &out, const char *fmt, const A &...a)
+{
+    _args_<A...> list(a...);
+    vformat (out, fmt, list.items, (int)sizeof...(A));
+    return out;
+}
+
+template <typename... A>
+ky_u8string &format_to(ky_u8string &out, const char *fmt, const A &...a)
+{
+    char buf[256];
+    writer w(buf, sizeof(buf), &_flush_u8_, &out);
+    format_to (w, fmt, a...);
+    w.flush ();
+    return out;
+}
+
+template <typename... A>
+ky_string &format_to(ky_string &out, const char *fmt, const A &...a)
+{
+    char buf[256];
+    _wide_ ctx;
+    ctx.out = &out;
+    writer w(buf, sizeof(buf), &_flush_wide_, &ctx);
+    format_to (w, fmt, a...);
+    w.flush ();
+    return out;
+}
+
+template <typename... A>
+size_t format_to(char *buf, size_t cap, const char *fmt, const A &...a)
+{
+    writer w(buf, cap > 0 ? cap - 1 : 0);
+    format_to (w, fmt, a...);
+    if (cap > 0)
+        buf[w.written ()] = 0;
+    return w.total ();
+}
+
+template <typename... A>
+ky_u8string format(const char *fmt, const A &...a)
+{
+    ky_u8string out;
+    format_to (out, fmt, a...);
+    return out;
+}
+
+}
+
+#endif // KY_FORMAT_INL
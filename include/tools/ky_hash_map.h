@@ -18,6 +18,8 @@
  *    Date    |  Version  |  Author  |   Description
  * 2012/01/02 | 1.0.0.1   | kunyang  | 创建文件
  * 2012/01/10 | 1.0.1.0   | kunyang  | 加入引用的可共享属性
+ * 2026/10/18 | 1.0.2.0   | kunyang  | 大表扩容改为增量迁移，单次操作只迁移有限个桶
+ * 2026/10/18 | 1.0.2.1   | kunyang  | 节点及桶数组按大小归还分配器，可使用ky_recycle_alloc回收节点
  */
 #ifndef ky_hash_map_H
 #define ky_hash_map_H
@@ -34,6 +36,15 @@ struct _ky_hash_map_
     size_t bcapacity;           ///< 桶储备空间
     size_t ecount;              ///< 桶内元素数
     size_t ecountmax;           ///< 桶能承受的最大元素数
+    _ky_hash_map_ *rehash;      ///< 增量迁移中的旧桶(头)，无迁移时为NULL
+    size_t rindex;              ///< 旧桶中下一个待迁移的序号
+
+    enum
+    {
+        IncrementalMin = 1024,  ///< 桶数不小于此值时扩容使用增量迁移
+        RehashStep = 8,         ///< 每次写操作最多迁移的非空旧桶数
+        RehashVisit = 64        ///< 每次写操作最多扫描的旧桶数
+    };
 
     static float sMaxUsageRate;  ///< 桶的最大使用率
     static float sGrowRate;      ///< 桶的增长率
@@ -99,13 +110,37 @@ private:
         if (h) --h;
         return h;
     }
+    hash_bucket *old_buckets()const {return (hash_bucket *)(header()->rehash + 1);}
+    size_t old_capacity()const {return header()->rehash->bcapacity;}
+    bool is_rehashing()const {return !is_null () && header()->rehash != NULL;}
+    //! 迭代的桶范围: 新桶数组之后接着迁移中的旧桶数组
+    size_t bucket_span()const {return is_rehashing () ? capacity () + old_capacity () : capacity ();}
+    hash_bucket *bucket(size_t i)const
+    {
+        return i < capacity () ? buckets + i : old_buckets () + (i - capacity ());
+    }
+
 protected:
     void grow(size_t newsize);
 
+    //! 将旧桶i的全部元素移到新桶数组
+    void migrate(size_t i);
+    //! 迁移有限个旧桶，迁移完成时释放旧桶
+    void rehash_step(size_t step = _ky_hash_map_::RehashStep);
+    //! 一次迁移完剩余的旧桶
+    void rehash_finish();
+    //! 写操作前调用，先迁移key所在的旧桶，返回key在新桶数组中的序号
+    size_t settle(const K &k);
+    //! 只读查找，同时查找新旧桶数组，index返回bucket()序号
+    const bucket_item *lookup(const K &k, size_t *index = NULL)const;
+    void release(hash_bucket *b, size_t cap);
+
     void detach();
 
     hash_bucket *create(size_t mins = 4);
     void destroy();
+    //! 容量为cap的表头加桶数组的字节数
+    static size_t table_size(size_t cap) {return sizeof(_ky_hash_map_) + sizeof(hash_bucket) * cap;}
 
     bucket_item *newitem(const K& k, const V &v)
     {
@@ -116,7 +151,7 @@ protected:
     void freeitem(bucket_item *item)
     {
         item->~bucket_item();
-        Alloc::destroy (item);
+        Alloc::destroy (item, sizeof(bucket_item));
     }
 
 public:
@@ -322,15 +357,11 @@ public:
 
     private:
         opehmap_node(ky_hash_map* tab)
-            :table(tab), bindex(0), bitem(table->buckets[bindex].first)
+            :table(tab), bindex(0), bitem(NULL)
         {
-            while(bitem == NULL)
-            {
+            const size_t span = table->bucket_span ();
+            while (bindex < span && (bitem = table->bucket (bindex)->first) == NULL)
                 ++bindex;
-                if(bindex == table->capacity ())
-                    break;
-                bitem = table->buckets[bindex].first;
-            }
         }
         opehmap_node(ky_hash_map* tab, size_t index, bucket_item* item)
             :table(tab), bindex(index), bitem(item){}
@@ -338,7 +369,7 @@ public:
     public:
         bool is_finished(void) const
         {
-            return bindex >= table->capacity ();
+            return bindex >= table->bucket_span ();
         }
         friend bool operator == (const opehmap_node& it1,const opehmap_node& it2)
         {
@@ -359,13 +390,9 @@ public:
         opehmap_node& operator++(void)
         {
             bitem = bitem->next;
-            while (bitem == 0)
-            {
-                ++bindex;
-                if(bindex == table->capacity ())
-                    break;
-                bitem = table->buckets[bindex].first;
-            }
+            const size_t span = table->bucket_span ();
+            while (bitem == NULL && ++bindex < span)
+                bitem = table->bucket (bindex)->first;
             return *this;
         }
     };
@@ -375,21 +402,17 @@ public:
     private:
         const ky_hash_map* table;
         size_t bindex;
-        bucket_item* bitem;
+        const bucket_item* bitem;
 
     public:
         const_opehmap_node(void) :table(0), bindex(0), bitem(0){}
     private:
         const_opehmap_node(const ky_hash_map* tab)
-            :table(tab), bindex(0), bitem(table->buckets[bindex].first)
+            :table(tab), bindex(0), bitem(NULL)
         {
-            while (bitem==0)
-            {
+            const size_t span = table->bucket_span ();
+            while (bindex < span && (bitem = table->bucket (bindex)->first) == NULL)
                 ++bindex;
-                if(bindex == table->capacity())
-                    break;
-                bitem = table->buckets[bindex].first;
-            }
         }
         const_opehmap_node(const ky_hash_map* tab,size_t index,const bucket_item* item) // Elementwise constructor
             :table(tab), bindex(index), bitem(item){}
@@ -397,7 +420,7 @@ public:
     public:
         bool is_finished(void) const
         {
-            return bindex >= table->capacity();
+            return bindex >= table->bucket_span ();
         }
         friend bool operator==(const const_opehmap_node& it1,const const_opehmap_node& it2)
         {
@@ -418,14 +441,9 @@ public:
         const_opehmap_node& operator++(void)
         {
             bitem = bitem->next;
-
-            while(bitem == NULL)
-            {
-                ++bindex;
-                if(bindex == table->capacity())
-                    break;
-                bitem = table->buckets[bindex].first;
-            }
+            const size_t span = table->bucket_span ();
+            while (bitem == NULL && ++bindex < span)
+                bitem = table->bucket (bindex)->first;
             return *this;
         }
     };
@@ -24,7 +24,7 @@ void ky_hash_map<K, V, Alloc>::insert(const K& k, const V& val);
 #endif
 {
     detach ();
-    const size_t index = ky_hash_map(k) % capacity ();
+    const size_t index = settle (k);
 
     bucket_item* pred = NULL;
     bucket_item* item = buckets[index].first;
@@ -68,7 +68,7 @@ template <typename K, typename V, typename Alloc>
 V& ky_hash_map<K, V, Alloc>::operator[](const K& k)
 {
     detach ();
-    const size_t index = ky_hash(k) % capacity ();
+    const size_t index = settle (k);
 
     bucket_item* pred = NULL;
     bucket_item* item = buckets[index].first;
@@ -123,17 +123,9 @@ template <typename K, typename V, typename Alloc >
 ky_list<V> ky_hash_map<K, V, Alloc>::values(const K &k) const
 {
     ky_list<V> ov;
-    if (is_null ())
-        return ov;
-    const size_t index = ky_hash_map(k) % capacity ();
-
-    const bucket_item* item = buckets[index].first;
-    while(item != NULL)
-    {
-        if (item->key () == k)
-            ov.append (item->value ());
-        item = item->next;
-    }
+    const bucket_item* item = lookup (k);
+    if (item != NULL)
+        ov.append (item->value ());
 
     return ov;
 }
@@ -144,7 +136,7 @@ template <typename K, typename V, typename Alloc>
 void ky_hash_map<K, V, Alloc>::append(const hash_entry& entry)
 {
     detach ();
-    const size_t index = ky_hash(entry.key ()) % capacity ();
+    const size_t index = settle (entry.key ());
 
     bucket_item* pred=0;
     bucket_item* item = buckets[index].first;
@@ -176,7 +168,7 @@ template <typename K, typename V, typename Alloc>
 void ky_hash_map<K, V, Alloc>::remove(const K& k)
 {
     detach ();
-    const size_t index = ky_hash(k) % capacity ();
+    const size_t index = settle (k);
 
     bucket_item* pred=0;
     bucket_item* item = buckets[index].first;
@@ -201,15 +193,7 @@ void ky_hash_map<K, V, Alloc>::remove(const K& k)
 template <typename K, typename V, typename Alloc>
 bool ky_hash_map<K, V, Alloc>::contains(const K& k) const
 {
-    if (is_null())
-        return false;
-    const size_t index = ky_hash(k) % capacity ();
-
-    const bucket_item* item = buckets[index].first;
-    while (item != NULL && item->key() != k)
-        item = item->next;
-
-    return item != NULL;
+    return lookup (k) != NULL;
 }
 
 template <typename K, typename V, typename Alloc>
@@ -221,12 +205,7 @@ bool ky_hash_map<K, V, Alloc>::contains(const hash_entry& entry) const
 template <typename K, typename V, typename Alloc>
 const typename ky_hash_map<K, V, Alloc>::hash_entry& ky_hash_map<K, V, Alloc>::search(const K& k) const
 {
-    detach ();
-    const size_t index = ky_hash_map(k) % capacity ();
-
-    const bucket_item* item = buckets[index].first;
-    while (item != NULL && item->key () != k)
-        item = item->next;
+    const bucket_item* item = lookup (k);
 
     //if(item == NULL)
     //    throw EntryNotFoundError(findSource);
@@ -238,7 +217,7 @@ template <typename K, typename V, typename Alloc>
 typename ky_hash_map<K, V, Alloc>::hash_entry&  ky_hash_map<K, V, Alloc>::search(const K& k)
 {
     detach ();
-    const size_t index = ky_hash_map(k) % capacity ();
+    const size_t index = settle (k);
 
     bucket_item* item = buckets[index].first;
     while (item != NULL && item->key () != k)
@@ -265,20 +244,20 @@ typename ky_hash_map<K, V, Alloc>::const_iterator ky_hash_map<K, V, Alloc>::begi
 template <typename K, typename V, typename Alloc>
 typename ky_hash_map<K, V, Alloc>::iterator ky_hash_map<K, V, Alloc>::end(void)
 {
-    return iterator(this, capacity (), 0);
+    return iterator(this, bucket_span (), 0);
 }
 
 template <typename K, typename V, typename Alloc>
 typename ky_hash_map<K, V, Alloc>::const_iterator ky_hash_map<K, V, Alloc>::end(void) const
 {
-    return const_iterator(this,capacity (), 0);
+    return const_iterator(this, bucket_span (), 0);
 }
 
 template <typename K, typename V, typename Alloc>
 typename ky_hash_map<K, V, Alloc>::iterator ky_hash_map<K, V, Alloc>::find(const K& k)
 {
     detach ();
-    const size_t index = ky_hash_map(k) % capacity ();
+    const size_t index = settle (k);
 
     bucket_item* item = buckets[index].first;
     while(item != NULL && item->key () != k)
@@ -287,7 +266,7 @@ typename ky_hash_map<K, V, Alloc>::iterator ky_hash_map<K, V, Alloc>::find(const
     if(item != NULL)
         return iterator(this, index, item);
 
-    return iterator(this, capacity (), 0);
+    return end ();
 }
 
 #if kyLanguage >= kyLanguage11
@@ -295,7 +274,7 @@ template <typename K, typename V, typename Alloc>
 V &ky_hash_map<K, V, Alloc>::operator []( K &&k)
 {
     detach ();
-    const size_t index = ky_hash_map(k) % capacity ();
+    const size_t index = settle (k);
 
     bucket_item* pred = NULL;
     bucket_item* item = buckets[index].first;
@@ -324,17 +303,13 @@ V &ky_hash_map<K, V, Alloc>::operator []( K &&k)
 template <typename K, typename V, typename Alloc>
 typename ky_hash_map<K, V, Alloc>::const_iterator ky_hash_map<K, V, Alloc>::find(const K& k) const
 {
-    detach ();
-    const size_t index = ky_hash_map(k) % capacity ();
-
-    const bucket_item* item = buckets[index].first;
-    while(item != NULL && item->key () != k)
-        item = item->next;
+    size_t index = 0;
+    const bucket_item* item = lookup (k, &index);
 
     if(item != NULL)
         return const_iterator(this, index, item);
 
-    return const_iterator(this, capacity (), 0);
+    return end ();
 }
 #endif
 
@@ -346,10 +321,11 @@ typename ky_hash_map<K, V, Alloc>::iterator ky_hash_map<K, V, Alloc>::erase(cons
     detach ();
     iterator nit = it;
     ++nit;
-    if(it.table == this && it.bindex < capacity () && it.bitem != NULL)
+    if(it.table == this && it.bindex < bucket_span () && it.bitem != NULL)
     {
+        hash_bucket *b = bucket (it.bindex);
         bucket_item* pred = NULL;
-        bucket_item* item = buckets[it.bindex].first;
+        bucket_item* item = b->first;
         while (item != NULL && item != it.bitem)
         {
             pred = item;
@@ -359,7 +335,7 @@ typename ky_hash_map<K, V, Alloc>::iterator ky_hash_map<K, V, Alloc>::erase(cons
         if(pred != NULL)
             pred->next = item->next;
         else
-            buckets[it.bindex].first = item->next;
+            b->first = item->next;
 
         freeitem (item);
         --header ()->ecount;
@@ -380,10 +356,11 @@ void ky_hash_map<K, V, Alloc>::erase(iterator pos)
     iterator nit = it;
     ++nit;
 #endif
-    if(it.table == this && it.bindex < capacity () && it.bitem != NULL)
+    if(it.table == this && it.bindex < bucket_span () && it.bitem != NULL)
     {
+        hash_bucket *b = bucket (it.bindex);
         bucket_item* pred = NULL;
-        bucket_item* item = buckets[it.bindex].first;
+        bucket_item* item = b->first;
         while (item != NULL && item != it.bitem)
         {
             pred = item;
@@ -393,7 +370,7 @@ void ky_hash_map<K, V, Alloc>::erase(iterator pos)
         if(pred != NULL)
             pred->next = item->next;
         else
-            buckets[it.bindex].first = item->next;
+            b->first = item->next;
 
         freeitem (item);
         --header ()->ecount;
@@ -405,9 +382,9 @@ void ky_hash_map<K, V, Alloc>::erase(iterator pos)
 template <typename K, typename V, typename Alloc>
 size_t ky_hash_map<K, V, Alloc>::erase(const K& key)
 {
-    const size_t idx = ky_hash_map (key) % capacity ();
+    const size_t before = count ();
     remove(key);
-    return idx;
+    return before - count ();
 }
 template <typename K, typename V, typename Alloc>
 #if kyLanguage >= kyLanguage11
@@ -432,10 +409,11 @@ template <typename K, typename V, typename Alloc>
 void ky_hash_map<K, V, Alloc>::remove(const iterator& it)
 {
     detach ();
-    if(it.table == this && it.bindex < capacity () && it.bitem != NULL)
+    if(it.table == this && it.bindex < bucket_span () && it.bitem != NULL)
     {
+        hash_bucket *b = bucket (it.bindex);
         bucket_item* pred = NULL;
-        bucket_item* item = buckets[it.bindex].first;
+        bucket_item* item = b->first;
         while (item != NULL && item != it.bitem)
         {
             pred = item;
@@ -445,7 +423,7 @@ void ky_hash_map<K, V, Alloc>::remove(const iterator& it)
         if(pred != NULL)
             pred->next = item->next;
         else
-            buckets[it.bindex].first = item->next;
+            b->first = item->next;
 
         freeitem (item);
         --header ()->ecount;
@@ -455,10 +433,11 @@ template <typename K, typename V, typename Alloc>
 void ky_hash_map<K, V, Alloc>::remove(const const_iterator& it)
 {
     detach ();
-    if(it.table == this && it.bindex < capacity () && it.bitem != NULL)
+    if(it.table == this && it.bindex < bucket_span () && it.bitem != NULL)
     {
+        hash_bucket *b = bucket (it.bindex);
         bucket_item* pred = NULL;
-        bucket_item* item = buckets[it.bindex].first;
+        bucket_item* item = b->first;
         while (item != NULL && item != it.bitem)
         {
             pred = item;
@@ -468,25 +447,38 @@ void ky_hash_map<K, V, Alloc>::remove(const const_iterator& it)
         if(pred != NULL)
             pred->next = item->next;
         else
-            buckets[it.bindex].first = item->next;
+            b->first = item->next;
 
         freeitem (item);
         --header ()->ecount;
     }
 }
 template <typename K, typename V, typename Alloc>
-void ky_hash_map<K, V, Alloc>::clear()
+void ky_hash_map<K, V, Alloc>::release(hash_bucket *b, size_t cap)
 {
-    detach ();
-    for(size_t i = 0; i < count ();++i)
+    for(size_t i = 0; i < cap; ++i)
     {
-        while(buckets[i].first != NULL)
+        while(b[i].first != NULL)
         {
-            bucket_item* next = buckets[i].first->next;
-            freeitem (buckets[i].first);
-            buckets[i].first = next;
+            bucket_item* next = b[i].first->next;
+            freeitem (b[i].first);
+            b[i].first = next;
         }
     }
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_hash_map<K, V, Alloc>::clear()
+{
+    detach ();
+    release (buckets, capacity ());
+    if (is_rehashing ())
+    {
+        release (old_buckets (), old_capacity ());
+        Alloc::destroy (header ()->rehash, table_size (old_capacity ()));
+        header ()->rehash = NULL;
+        header ()->rindex = 0;
+    }
 
     header ()->ecount = 0;
 }
@@ -501,23 +493,24 @@ void ky_hash_map<K, V, Alloc>::detach()
         olds.d = header();
         olds.e = buckets;
 
+        // 复制到单一桶数组，新表不继承迁移状态；旧表仍被共享，不能修改
+        const size_t span = bucket_span ();
         news.d = (_ky_hash_map_*)Alloc::alloc(sizeof(_ky_hash_map_)+sizeof(hash_bucket)*capacity ());
         news.d->bcapacity = olds.d->bcapacity;
         news.d->ecount = olds.d->ecount;
         news.d->ecountmax = olds.d->ecountmax;
+        news.d->rehash = NULL;
+        news.d->rindex = 0;
         news.d->ref.set (ky_ref::refShareableDetach);
 
         news.e = (hash_bucket*)(news.d+1);
         ky_mem()->zero (news.e, sizeof(hash_bucket) *capacity ());
-        for(size_t i = 0; i < capacity (); ++i)
+        for(size_t i = 0; i < span; ++i)
         {
-            while (olds.e[i].first != NULL)
+            for (const bucket_item* item = bucket (i)->first; item != NULL; item = item->next)
             {
-                bucket_item* item = olds.e[i].first;
-                olds.e[i].first = item->next;
-
                 bucket_item *nitem = newitem(item->key (), item->value ());
-                const size_t nbi = ky_hash(item->key ()) % capacity ();
+                const size_t nbi = ky_hash(item->key ()) % news.d->bcapacity;
                 nitem->next = news.e[nbi].first;
                 news.e[nbi].first = nitem;
             }
@@ -538,6 +531,8 @@ typename ky_hash_map<K, V, Alloc>::hash_bucket *ky_hash_map<K, V, Alloc>::create
     news.d->bcapacity = mins;
     news.d->ecount = 0;
     news.d->ecountmax = mins * news.d->sMaxUsageRate;
+    news.d->rehash = NULL;
+    news.d->rindex = 0;
     news.d->ref.set (ky_ref::refShareableDetach);
 
     news.e = (hash_bucket*)(news.d+1);
@@ -550,23 +545,115 @@ void ky_hash_map<K, V, Alloc>::destroy()
 {
     if (!is_null() && header()->lessref ())
     {
-        for(size_t i = 0; i < capacity(); ++i)
+        release (buckets, capacity ());
+        if (is_rehashing ())
         {
-            while(buckets[i].first != NULL)
-            {
-                bucket_item* next = buckets[i].first->next;
-                freeitem (buckets[i].first);
-                buckets[i].first = next;
-            }
+            release (old_buckets (), old_capacity ());
+            Alloc::destroy (header ()->rehash, table_size (old_capacity ()));
         }
 
-        Alloc::destroy (header());
+        Alloc::destroy (header(), table_size (capacity ()));
     }
     buckets = (hash_bucket*)_ky_hash_map_::null ();
 }
+
+template <typename K, typename V, typename Alloc>
+void ky_hash_map<K, V, Alloc>::migrate(size_t i)
+{
+    hash_bucket *ob = old_buckets () + i;
+    while (ob->first != NULL)
+    {
+        bucket_item* item = ob->first;
+        ob->first = item->next;
+
+        const size_t nbi = ky_hash(item->key ()) % capacity ();
+        item->next = buckets[nbi].first;
+        buckets[nbi].first = item;
+    }
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_hash_map<K, V, Alloc>::rehash_step(size_t step)
+{
+    _ky_hash_map_ *h = header ();
+    const size_t ocap = h->rehash->bcapacity;
+    hash_bucket *ob = old_buckets ();
+
+    // 连续的空旧桶也要限制扫描数，否则一次操作仍可能扫描整个旧桶
+    for (size_t visit = 0; step > 0 && h->rindex < ocap &&
+         visit < (size_t)_ky_hash_map_::RehashVisit; ++visit, ++h->rindex)
+    {
+        if (ob[h->rindex].first != NULL)
+        {
+            migrate (h->rindex);
+            --step;
+        }
+    }
+
+    if (h->rindex >= ocap)
+    {
+        Alloc::destroy (h->rehash, table_size (ocap));
+        h->rehash = NULL;
+        h->rindex = 0;
+    }
+}
+
+template <typename K, typename V, typename Alloc>
+void ky_hash_map<K, V, Alloc>::rehash_finish()
+{
+    _ky_hash_map_ *h = header ();
+    for (size_t i = h->rindex; i < h->rehash->bcapacity; ++i)
+        migrate (i);
+    h->rindex = h->rehash->bcapacity;
+    rehash_step (0);
+}
+
+template <typename K, typename V, typename Alloc>
+size_t ky_hash_map<K, V, Alloc>::settle(const K &k)
+{
+    const uint64 hv = ky_hash(k);
+    if (is_rehashing ())
+    {
+        migrate (hv % old_capacity ());
+        rehash_step ();
+    }
+    return hv % capacity ();
+}
+
+template <typename K, typename V, typename Alloc>
+const typename ky_hash_map<K, V, Alloc>::bucket_item *
+ky_hash_map<K, V, Alloc>::lookup(const K &k, size_t *index)const
+{
+    if (is_null ())
+        return NULL;
+
+    const uint64 hv = ky_hash(k);
+    size_t bi = hv % capacity ();
+    const bucket_item* item = buckets[bi].first;
+    while (item != NULL && item->key () != k)
+        item = item->next;
+
+    if (item == NULL && is_rehashing ())
+    {
+        const size_t oi = hv % old_capacity ();
+        bi = capacity () + oi;
+        item = old_buckets ()[oi].first;
+        while (item != NULL && item->key () != k)
+            item = item->next;
+    }
+
+    if (index != NULL)
+        *index = bi;
+    return item;
+}
+
 template <typename K, typename V, typename Alloc>
 void ky_hash_map<K, V, Alloc>::grow(size_t newsize)
 {
+    // 上一次迁移未完成时先迁移完，保证最多只有一个旧桶数组
+    if (is_rehashing ())
+        rehash_finish ();
+
     struct{_ky_hash_map_*d; hash_bucket* e;} news;
     struct{_ky_hash_map_*d; hash_bucket* e;} olds;
     olds.d = header();
@@ -576,6 +663,21 @@ void ky_hash_map<K, V, Alloc>::grow(size_t newsize)
     news.e = (hash_bucket*)(news.d+1);
     ky_mem()->zero (news.e, sizeof(hash_bucket) * newsize);
 
+    news.d->ref.set (ky_ref::refShareableDetach);
+    news.d->bcapacity = newsize;
+    news.d->ecount = olds.d->ecount;
+    news.d->ecountmax = (size_t)(newsize* olds.d->sMaxUsageRate);
+    news.d->rehash = NULL;
+    news.d->rindex = 0;
+
+    // 大表保留旧桶，由之后的写操作逐步迁移
+    if (capacity () >= (size_t)_ky_hash_map_::IncrementalMin)
+    {
+        news.d->rehash = olds.d;
+        buckets = news.e;
+        return ;
+    }
+
     for(size_t i = 0; i < capacity (); ++i)
     {
         while(olds.e[i].first != NULL)
@@ -590,12 +692,8 @@ void ky_hash_map<K, V, Alloc>::grow(size_t newsize)
         }
     }
 
-    news.d->ref.set (ky_ref::refShareableDetach);
-    news.d->bcapacity = newsize;
-    news.d->ecount = olds.d->ecount;
-    news.d->ecountmax = (size_t)(newsize* olds.d->sMaxUsageRate);
     buckets = news.e;
-    Alloc::destroy (olds.d);
+    Alloc::destroy (olds.d, table_size (olds.d->bcapacity));
 }
 
 #endif // ky_hash_map_INL
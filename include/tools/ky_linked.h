@@ -9,13 +9,15 @@
  *
  * @author   kunyang
  * @email    kunyang.yk@gmail.com
- * @version  1.0.0.1
+ * @version  1.0.1.2
  * @date     2018/03/09
  * @license  GNU General Public License (GPL)
  *
  * Change History :
  *    Date    |  Version  |  Author  |   Description
  * 2018/03/09 | 1.0.0.1   | kunyang  | 创建文件
+ * 2026/10/18 | 1.0.1.1   | kunyang  | 加入右值添加、emplace就地构造及移动构造
+ * 2026/10/18 | 1.0.1.2   | kunyang  | 节点按大小归还分配器，可使用ky_recycle_alloc回收节点
  */
 
 #ifndef KY_LINKED_H
@@ -166,12 +168,27 @@ public:
     // C++11
 #if kyLanguage >= kyLanguage11
 public:
-    explicit ky_linked(const ky_linked<T, Alloc> &&rhs);
+    ky_linked(ky_linked<T, Alloc> &&rhs);
     ky_linked(const std::initializer_list<T> & il);
     ky_linked<T, Alloc>& operator = (ky_linked<T, Alloc> &&rhs);
 
-    void push_front( T &&x ){prepend(x);}
-    void push_back( T &&x ){append(x);}
+    void push_front( T &&x ){emplace_front(std::move (x));}
+    void push_back( T &&x ){emplace_back(std::move (x));}
+    void prepend(T &&x){emplace_front(std::move (x));}
+    void append(T &&x){emplace_back(std::move (x));}
+
+    //!
+    //! \brief emplace 在itr之前以args就地构造元素
+    //! \param itr
+    //! \param args
+    //! \return 返回指向构造元素的迭代器
+    //!
+    template <typename ... Args>
+    iterator emplace(const_iterator itr, Args &&...args);
+    template <typename ... Args>
+    T &emplace_back(Args &&...args);
+    template <typename ... Args>
+    T &emplace_front(Args &&...args);
 
     void splice(const_iterator pos, ky_linked<T, Alloc>&& x);
     void splice(const_iterator pos, ky_linked<T, Alloc>& x);
@@ -376,6 +393,12 @@ private:
 
 private:
     list_node *newnode(const T &);
+#if kyLanguage >= kyLanguage11
+    template <typename ... Args>
+    list_node *emplacenode(Args &&...args);
+#endif
+    //! 将n链接到pos之前
+    void linknode(list_node *pos, list_node *n);
     void freenode(list_node *n);
     void free(struct _ky_linked_ *n);
     void copy();
@@ -21,8 +21,7 @@ void ky_linked<T, Alloc>::free(_ky_linked_ *x)
         current= current->next;
         freenode(node);
     }
-    if (end != current)
-        this->destroy((T*)x);
+    this->destroy((T*)x, sizeof(_ky_linked_));
 }
 template< typename T , typename Alloc>
 typename ky_linked<T, Alloc>::list_node *ky_linked<T, Alloc>::newnode(const T &d)
@@ -37,19 +36,38 @@ typename ky_linked<T, Alloc>::list_node *ky_linked<T, Alloc>::newnode(const T &d
     return n;
 }
 template< typename T , typename Alloc>
+void ky_linked<T, Alloc>::linknode(list_node *pos, list_node *n)
+{
+    n->next = pos;
+    n->prev = pos->prev;
+    pos->prev->next = n;
+    pos->prev = n;
+    ++header()->count;
+}
+template< typename T , typename Alloc>
 void ky_linked<T, Alloc>::freenode(list_node *n)
 {
     if (!ky_is_type(T))
         n->data.~T();
-    this->destroy((T*)n);
+    this->destroy((T*)n, sizeof(list_node));
 }
 // C++11
 #if kyLanguage >= kyLanguage11
 template< typename T , typename Alloc>
-ky_linked<T, Alloc>::ky_linked(const ky_linked<T, Alloc> &&rhs):
-    impl((_ky_linked_*)_ky_linked_::null())
+template <typename ... Args>
+typename ky_linked<T, Alloc>::list_node *ky_linked<T, Alloc>::emplacenode(Args &&...args)
+{
+    list_node *n = (list_node*)this->alloc(sizeof(list_node));
+    n->next = NULL;
+    n->prev = NULL;
+    new (&n->data) T(std::forward<Args>(args)...);
+    return n;
+}
+template< typename T , typename Alloc>
+ky_linked<T, Alloc>::ky_linked(ky_linked<T, Alloc> &&rhs):
+    impl(rhs.impl)
 {
-    *this = rhs;
+    rhs.impl = (_ky_linked_*)_ky_linked_::null();
 }
 template< typename T , typename Alloc>
 ky_linked<T, Alloc>& ky_linked<T, Alloc>::operator = (ky_linked<T, Alloc> &&rhs)
@@ -327,8 +345,36 @@ void ky_linked<T, Alloc>::merge(ky_linked& x)
 template< typename T , typename Alloc>
 typename ky_linked<T, Alloc>::iterator ky_linked<T, Alloc>::insert(const_iterator itr, T &&x )
 {
-    size_t pos = itr - begin();
-    return insert(pos, x);
+    return emplace(itr, std::move (x));
+}
+template< typename T , typename Alloc>
+template <typename ... Args>
+typename ky_linked<T, Alloc>::iterator ky_linked<T, Alloc>::emplace(const_iterator itr, Args &&...args)
+{
+    int inx = itr - cbegin();
+    detach();
+
+    list_node *m = emplacenode(std::forward<Args>(args)...);
+    linknode((begin()+inx).ope, m);
+    return m;
+}
+template< typename T , typename Alloc>
+template <typename ... Args>
+T &ky_linked<T, Alloc>::emplace_back(Args &&...args)
+{
+    detach();
+    list_node *m = emplacenode(std::forward<Args>(args)...);
+    linknode(list, m);
+    return m->data;
+}
+template< typename T , typename Alloc>
+template <typename ... Args>
+T &ky_linked<T, Alloc>::emplace_front(Args &&...args)
+{
+    detach();
+    list_node *m = emplacenode(std::forward<Args>(args)...);
+    linknode(list->next, m);
+    return m->data;
 }
 template< typename T , typename Alloc>
 void ky_linked<T, Alloc>::splice(const_iterator pos, ky_linked&& x)
@@ -563,7 +609,6 @@ void ky_linked<T, Alloc>::prepend(const T& val)
 {
     detach();
     list_node *nnode = newnode(val);
-    nnode->data = val;
     nnode->next = list->next;
     nnode->prev = list;
     nnode->next->prev = list->next = nnode;
@@ -8,10 +8,11 @@
  *       2.内部算法使用ky_memory::heap
  *       3.支持引用计数和写时拷贝
  *       4.采用连续地址指针模式实现快速链表遍历
+ *       5.声明内联存放的可重定位小元素直接存放在内存块中，默认为指针存放
  *
  * @author   kunyang
  * @email    kunyang.yk@gmail.com
- * @version  1.2.1.1
+ * @version  1.2.3.1
  * @date     2010/05/08
  * @license  GNU General Public License (GPL)
  *
@@ -24,6 +25,8 @@
  * 2017/06/12 | 1.1.0.1   | kunyang  | 将原有指针型链表修改为ky_linked类，采样连续地址指针模式
  * 2018/02/27 | 1.2.0.1   | kunyang  | 将连续地址指针思想重构并移入ky_memory::heap
  * 2018/03/18 | 1.2.1.1   | kunyang  | 将模板对象分为可构造来优化速度
+ * 2026/10/18 | 1.2.2.1   | kunyang  | 加入右值添加、emplace就地构造及移动构造
+ * 2026/10/18 | 1.2.3.1   | kunyang  | 加入元素内联存放策略，可重定位的小对象直接存放在内存块中
  */
 
 #ifndef KY_LIST
@@ -38,6 +41,21 @@
 #include <list>
 #endif
 
+//! 内联存放的元素字节上限
+#ifndef kyListInlineSize
+#define kyListInlineSize 64
+#endif
+
+//!
+//! \brief The ky_list_inline struct 元素类型是否内联存放在ky_list的内存块中
+//! \note 默认为指针存放，和预编译库中的ky_list<T>布局一致；
+//!       与库交换的ky_list<T>(如ky_list<ky_string>)不可声明内联存放
+//!
+template <typename T>
+struct ky_list_inline : public false_type_t { };
+#define kyDeclareListInline(...) \
+    template<>struct ky_list_inline< __VA_ARGS__ >: public true_type_t { }
+
 template <typename T>
 class ky_list : protected ky_memory::heap
 {
@@ -46,9 +64,20 @@ class ky_list : protected ky_memory::heap
     typedef Layout::header_t LayoutHeader;
     enum {not_construct = ky_is_type(Type)};
     enum {sizeOf = sizeof(Type)};
-    struct node_t : Layout::node_t
+    //! 内联存放时元素直接位于内存块中，每个元素占用stride个heap节点
+    enum {in_place = not_construct || (ky_list_inline<Type>::value &&
+                                       sizeOf <= kyListInlineSize &&
+                                       alignof(Type) <= Layout::NodeSize &&
+                                       is_relocatable<Type>::value)};
+    enum {stride = in_place ? (sizeOf + Layout::NodeSize - 1) / Layout::NodeSize : 1};
+    struct node_t
     {
-        Type &v(){return *(Type*)(not_construct ? this : value);}
+        union
+        {
+            void *value;                  ///< 指针存放时为元素地址
+            Layout::node_t slot[stride];  ///< 内联存放时为元素本身
+        };
+        Type &v(){return *(Type*)(in_place ? (void*)this : value);}
     };
 
     // base
@@ -87,7 +116,7 @@ public:
     //! \brief count 返回元素数量
     //! \return
     //!
-    inline size_t count()const{return Layout::count();}
+    inline size_t count()const{return Layout::count() / stride;}
 
     //!
     //! \brief prepend 前置添加元素
@@ -229,6 +258,46 @@ public:
     //!
     friend void ky_swap(ky_list &a, ky_list &b){a.swap(b);}
 
+    // C++11
+#if kyLanguage >= kyLanguage11
+public:
+    ky_list(ky_list &&rhs);
+    ky_list& operator = (ky_list &&rhs);
+
+    //!
+    //! \brief prepend 前置添加元素，元素移动构造
+    //! \param val
+    //!
+    void prepend(Type &&val);
+    //!
+    //! \brief append 后置添加元素，元素移动构造
+    //! \param val
+    //!
+    void append(Type &&val);
+    //!
+    //! \brief insert 根据位置插入元素，元素移动构造
+    //! \param pos
+    //! \param val
+    //!
+    void insert(int pos, Type &&val);
+
+    //!
+    //! \brief emplace 在pos位置以args就地构造元素
+    //! \param pos
+    //! \param args
+    //! \return 返回构造的元素
+    //!
+    template <typename ... Args>
+    Type &emplace(int pos, Args &&...args);
+    template <typename ... Args>
+    Type &emplace_back(Args &&...args){return emplace (INT_MAX, std::forward<Args>(args)...);}
+    template <typename ... Args>
+    Type &emplace_front(Args &&...args){return emplace (0, std::forward<Args>(args)...);}
+
+    inline void push_front(Type &&x){prepend(std::move (x));}
+    inline void push_back(Type &&x){append(std::move (x));}
+#endif
+
 // STL
 #ifdef kyHasSTL
     class const_iterator;
@@ -349,7 +418,7 @@ public:
     //! \param rhs
     //! \return
     //!
-    ky_list<Type>& operator = (const std::list<Type> &rhs);
+    ky_list& operator = (const std::list<Type> &rhs);
 
     inline bool empty() const {return is_empty();}
     inline size_t size() const {return count();}
@@ -404,7 +473,7 @@ public:
     //! \brief pop_front 在头和尾删掉一个元素
     //!
     inline void pop_front(){remove(0);}
-    inline void pop_back(){remove(size());}
+    inline void pop_back(){remove(int(size()) - 1);}
     //!
     //! \brief assign 赋值
     //! \param itr
@@ -418,6 +487,9 @@ public:
 #endif
 
 protected:
+    void*   __storage(node_t *n);
+    node_t* __slot(int pos);
+    node_t* __grow(int pos);
     void    __construct(node_t *n, const Type &p);
     void    __destruct(node_t *n);
     void    __destruct(node_t *from, node_t *to);
@@ -425,21 +497,45 @@ protected:
     void    __detach_helper();
     void    __destroy_helper();
     node_t* __detach_insert(int i, int c);
+    node_t* __begin()const {return (node_t *)Layout::begin ();}
+    node_t* __end()const {return (node_t *)Layout::end ();}
 };
 
 #include "ky_typeinfo.h"
 
+//! 返回节点中元素的未构造空间
+template <typename T>
+void *ky_list<T>::__storage(node_t *n)
+{
+    if (in_place)
+        return n;
+    n->value = kyMalloc(sizeOf);
+    return n->value;
+}
+//! 在pos位置腾出一个未构造的节点，共享时先分离
+template <typename T>
+typename ky_list<T>::node_t *ky_list<T>::__slot(int pos)
+{
+    if (Layout::refer ().is_shared ())
+        return __detach_insert (pos, 1);
+    return __grow (pos);
+}
+//! 在pos位置插入stride个heap节点，heap的prepend和insert每次只增加一个节点
+template <typename T>
+typename ky_list<T>::node_t *ky_list<T>::__grow(int pos)
+{
+    if (pos >= (int)count ())
+        return (node_t *)Layout::append (stride);
+    if (pos < 0)
+        pos = 0;
+    for (int k = 0; k < stride; ++k)
+        Layout::insert (pos * stride, 1);
+    return __begin () + pos;
+}
 template <typename T>
 void ky_list<T>::__construct(node_t *n, const Type &p)
 {
-    if (not_construct)
-        new (n) Type(p);
-    else
-    {
-        Type *vd = (Type*)kyMalloc(sizeOf);
-        new (vd) Type(p);
-        n->value = vd;
-    }
+    new (__storage (n)) Type(p);
 }
 template <typename T>
 void ky_list<T>::__destruct(node_t *n)
@@ -448,6 +544,8 @@ void ky_list<T>::__destruct(node_t *n)
     {
 
     }
+    else if (in_place)
+        n->v().~Type();
     else
     {
         ((Type*)n->value)->~Type();
@@ -479,7 +577,7 @@ void ky_list<T>::__destroy_helper()
 {
     if (!is_null () && lessref ())
     {
-        __destruct ((node_t*)Layout::begin (), (node_t*)Layout::end ());
+        __destruct (__begin (), __end ());
         Layout::destroy ();
     }
 }
@@ -517,8 +615,7 @@ ky_list<T>& ky_list<T>::operator = (const ky_list<T> &rhs)
         else
         {
             node_t *n = __detach_insert (0, rhs.count ());
-            __copy(n, (node_t *)Layout::end(),
-                   (node_t *)rhs.Layout::begin());
+            __copy(n, __end (), rhs.__begin ());
         }
     }
     return *this;
@@ -532,9 +629,9 @@ bool ky_list<T>::operator ==(const ky_list<T> &rhs) const
     if (count() != rhs.count())
         return false;
 
-    node_t *i = (node_t *)Layout::begin();
-    node_t *e = (node_t *)Layout::end();
-    node_t *ri = (node_t *)rhs.Layout::begin();
+    node_t *i = __begin ();
+    node_t *e = __end ();
+    node_t *ri = rhs.__begin ();
     for (; i != e; ++i, ++ri)
     {
         if (i->v() != ri->v())
@@ -551,32 +648,13 @@ bool ky_list<T>::operator !=(const ky_list<T> &rhs) const
 template <typename T>
 void ky_list<T>::prepend(const T& val)
 {
-    if (Layout::refer ().is_shared ())
-    {
-        node_t *n = __detach_insert (0, 1);
-        __construct(n, val);
-    }
-    else
-    {
-        node_t *n = (node_t *)Layout::prepend (1);
-        __construct(n, val);
-    }
+    __construct(__slot (0), val);
 }
 
 template <typename T>
 void ky_list<T>::append(const T& val)
 {
-    if (Layout::refer ().is_shared ())
-    {
-        node_t *n = __detach_insert(INT_MAX, 1);
-        __construct(n, val);
-    }
-    else
-    {
-        node_t *n = (node_t*)Layout::append(1);
-        __construct(n, val);
-    }
-
+    __construct(__slot (INT_MAX), val);
 }
 template <typename T>
 void ky_list<T>::append(const ky_list<T>& val)
@@ -587,16 +665,7 @@ void ky_list<T>::append(const ky_list<T>& val)
 template <typename T>
 void ky_list<T>::insert(int pos, const T& val)
 {
-    if (Layout::refer ().is_shared ())
-    {
-        node_t *n = __detach_insert(pos, 1);
-        __construct(n, val);
-    }
-    else
-    {
-        node_t *n = (node_t*)Layout::insert(pos, 1);
-        __construct(n, val);
-    }
+    __construct(__slot (pos), val);
 }
 
 template <typename T>
@@ -605,7 +674,7 @@ void ky_list<T>::replace(int i, const T &val)
     if (i >=0 && i < count())
     {
         __detach_helper ();
-        ((node_t*)Layout::at(i))->v() = val;
+        __begin ()[i].v() = val;
     }
 }
 
@@ -615,7 +684,15 @@ void ky_list<T>:: move(int inx, int to)
     if (inx >= 0 && inx < count() && to >= 0 && to < count())
     {
         __detach_helper ();
-        Layout::move(inx, 1, to);
+        if (stride == 1)
+            Layout::move(inx, 1, to);
+        else
+        {
+            // heap::move每次只移动一个节点，内联元素按位取出后重新插入
+            node_t tmp = __begin ()[inx];
+            Layout::remove(inx * stride, stride);
+            *__grow (to) = tmp;
+        }
     }
 }
 
@@ -625,9 +702,8 @@ void ky_list<T>::remove(int pos)
     if (pos >= 0 && pos < (int)count ())
     {
         __detach_helper ();
-        node_t *n = (node_t*)Layout::at(pos);
-        __destruct(n);
-        Layout::remove(pos, 1);
+        __destruct(__begin () + pos);
+        Layout::remove(pos * stride, stride);
     }
 }
 
@@ -637,11 +713,12 @@ void ky_list<T>::swap(int i, int j)
     if (i >=0 && i < (int)count() && j >= 0 && j < (int)count())
     {
         __detach_helper ();
-        node_t *ni = (node_t *)Layout::begin() + i;
-        node_t *nj = (node_t *)Layout::begin() + j;
-        node_t *tmp = ni;
+        // 节点为元素指针或可按位重定位的元素，直接交换节点内容
+        node_t *ni = __begin () + i;
+        node_t *nj = __begin () + j;
+        node_t tmp = *ni;
         *ni = *nj;
-        *nj = *tmp;
+        *nj = tmp;
     }
 }
 
@@ -657,7 +734,7 @@ int ky_list<T>::find(const T &t) const
     if (is_empty() || is_null())
         return -1;
 
-    node_t *b = (node_t *)Layout::begin();
+    node_t *b = __begin ();
     for (int i = 0; i < (int)count(); ++i)
     {
         if (b[i].v() == t)
@@ -671,14 +748,14 @@ T& ky_list<T>::first()
 {
     kyASSERT(!is_empty (), "is empty");
     __detach_helper ();
-    return ((node_t *)Layout::begin())->v();
+    return __begin ()->v();
 }
 
 template <typename T>
 const T& ky_list<T>::first() const
 {
     kyASSERT(!is_empty (), "is empty");
-    return ((node_t *)Layout::begin())->v();
+    return __begin ()->v();
 }
 
 template <typename T>
@@ -686,21 +763,21 @@ T& ky_list<T>::last()
 {
     kyASSERT(!is_empty (), "is empty");
     __detach_helper ();
-    return ((node_t *)(Layout::end()-1))->v();
+    return (__end () - 1)->v();
 }
 
 template <typename T>
 const T& ky_list<T>::last() const
 {
     kyASSERT(!is_empty (), "is empty");
-    return ((node_t *)(Layout::end()-1))->v();
+    return (__end () - 1)->v();
 }
 
 template <typename T>
 T ky_list<T>::value(int i) const
 {
     if (i >= 0 && i < count ())
-        return ((node_t *)Layout::at(i))->v();
+        return __begin ()[i].v();
     return T();
 }
 
@@ -708,14 +785,14 @@ template <typename T>
 const T &ky_list<T>::at(int i) const
 {
     kyASSERT(!is_empty (), "is empty");
-    return ((node_t *)Layout::at(i))->v();
+    return __begin ()[i].v();
 }
 
 template <typename T>
 const T &ky_list<T>::operator[](int i) const
 {
     kyASSERT(!is_empty (), "is empty");
-    return ((node_t *)Layout::at(i))->v();
+    return __begin ()[i].v();
 }
 
 template <typename T>
@@ -723,7 +800,7 @@ T &ky_list<T>::operator[](int i)
 {
     kyASSERT(!is_empty (), "is empty");
     __detach_helper ();
-    return ((node_t *)Layout::at(i))->v();
+    return __begin ()[i].v();
 }
 
 template <typename T>
@@ -731,8 +808,9 @@ void ky_list<T>::clear()
 {
     if (!count ())
         return ;
-    __detach_helper ();
-    __destruct((node_t*)Layout::begin (), (node_t*)Layout::end ());
+    // 共享时只释放引用，不需要先分离再析构
+    __destroy_helper ();
+    header = Layout::null ();
 }
 
 template <typename T>
@@ -746,12 +824,12 @@ void ky_list<T>::swap(ky_list<T> &rhs)
 template <typename T>
 void ky_list<T>::reserve(size_t s)
 {
-    if (Layout::capacity () < s)
+    if (Layout::capacity () < s * stride)
     {
         if (Layout::refer ().is_shared ())
             __detach_helper ();
 
-        Layout::reserve(s);
+        Layout::reserve(s * stride);
     }
 }
 
@@ -769,24 +847,29 @@ template <typename T>
 typename ky_list<T>::node_t *ky_list<T>::__detach_insert(int i, int c)
 {
     const bool the_copy = !is_empty ();
-    node_t *n = (node_t *)Layout::begin();
-    ky_memory::heap::header_t *oldh = Layout::detach(&i, c);
+    node_t *n = __begin ();
+    if (i < 0)
+        i = 0;
+    else if (i > (int)count ())
+        i = (int)count ();
+    int at = i * stride;
+    ky_memory::heap::header_t *oldh = Layout::detach(&at, c * stride);
+    i = at / stride;
 
     if (the_copy)
     {
-        __copy((node_t *)(Layout::begin()), (node_t *)(Layout::begin() + i), n);
-        __copy((node_t *)(Layout::begin() + i + c), (node_t *)(Layout::end()),
-                  n + i);
+        __copy(__begin (), __begin () + i, n);
+        __copy(__begin () + i + c, __end (), n + i);
     }
 
     Layout old(oldh);
-    if (!old.is_null () && !old.refer ().lessref ())
+    if (!old.is_null () && old.refer ().lessref ())
     {
         __destruct((node_t*)old.begin(), (node_t*)old.end ());
         old.destroy ();
     }
 
-    return (node_t *)(Layout::begin() + i);
+    return __begin () + i;
 }
 
 template <typename T>
@@ -823,6 +906,53 @@ ky_list<T> &ky_list<T>::operator << (const ky_list<T> &rhs)
     return *this += rhs;
 }
 
+#if kyLanguage >= kyLanguage11
+template <typename T>
+ky_list<T>::ky_list(ky_list &&rhs):
+    Layout()
+{
+    header = rhs.header;
+    rhs.header = rhs.null ();
+}
+
+template <typename T>
+ky_list<T>& ky_list<T>::operator = (ky_list<T> &&rhs)
+{
+    if (header != rhs.header)
+    {
+        __destroy_helper ();
+        header = rhs.header;
+        rhs.header = rhs.null ();
+    }
+    return *this;
+}
+
+template <typename T>
+void ky_list<T>::prepend(T &&val)
+{
+    new (__storage (__slot (0))) Type(std::move (val));
+}
+
+template <typename T>
+void ky_list<T>::append(T &&val)
+{
+    new (__storage (__slot (INT_MAX))) Type(std::move (val));
+}
+
+template <typename T>
+void ky_list<T>::insert(int pos, T &&val)
+{
+    new (__storage (__slot (pos))) Type(std::move (val));
+}
+
+template <typename T>
+template <typename ... Args>
+T &ky_list<T>::emplace(int pos, Args &&...args)
+{
+    return *new (__storage (__slot (pos))) Type(std::forward<Args>(args)...);
+}
+#endif
+
 #ifdef kyHasSTL
 template <typename T>
 ky_list<T>::ky_list(const std::initializer_list<T> & il):
@@ -878,25 +1008,25 @@ void ky_list<T>::reverse()
 template <typename T>
 typename ky_list<T>::iterator ky_list<T>::begin()
 {
-    return iterator((node_t*)Layout::begin());
+    return iterator(__begin ());
 }
 
 template <typename T>
 typename ky_list<T>::const_iterator ky_list<T>::begin() const
 {
-    return const_iterator((node_t*)Layout::begin());
+    return const_iterator(__begin ());
 }
 
 template <typename T>
 typename ky_list<T>::iterator ky_list<T>::end()
 {
-    return iterator((node_t*)Layout::end());
+    return iterator(__end ());
 }
 
 template <typename T>
 typename ky_list<T>::const_iterator ky_list<T>::end() const
 {
-    return const_iterator((node_t*)Layout::end());
+    return const_iterator(__end ());
 }
 
 template <typename T>
@@ -908,7 +1038,7 @@ void ky_list<T>::assign(int inx, const T &x)
 template <typename T>
 typename ky_list<T>::iterator ky_list<T>::erase(const_iterator itr)
 {
-    if (itr.ope >= Layout::begin() && itr.ope < Layout::end())
+    if (itr.ope >= __begin () && itr.ope < __end ())
     {
         if (Layout::refer ().is_shared ())
         {
@@ -917,8 +1047,10 @@ typename ky_list<T>::iterator ky_list<T>::erase(const_iterator itr)
             itr = begin();
             itr += pos;
         }
+        const int pos = int(itr.ope - __begin ());
         __destruct(itr.ope);
-        return iterator((node_t*)Layout::erase (itr.ope));
+        Layout::remove(pos * stride, stride);
+        return iterator(__begin () + pos);
     }
     return iterator();
 }
@@ -926,13 +1058,13 @@ typename ky_list<T>::iterator ky_list<T>::erase(const_iterator itr)
 template <typename T>
 typename ky_list<T>::iterator ky_list<T>::erase(const_iterator start, const_iterator end)
 {
-    if ((start.ope >= Layout::begin() && start.ope < Layout::end()) &&
-        (end.ope >= Layout::begin() && end.ope < Layout::end()))
+    if ((start.ope >= __begin () && start.ope < __end ()) &&
+        (end.ope >= start.ope && end.ope <= __end ()))
     {
         if (Layout::refer().is_shared())
         {
-            int offsetb = int(start.ope - (node_t*)(Layout::begin()));
-            int offsete = int(end.ope - (node_t*)(Layout::begin()));
+            int offsetb = int(start.ope - __begin ());
+            int offsete = int(end.ope - __begin ());
             __detach_helper ();
             start = begin() + offsetb;
             end = begin() + offsete;
@@ -940,7 +1072,7 @@ typename ky_list<T>::iterator ky_list<T>::erase(const_iterator start, const_iter
 
         __destruct(start.ope, end.ope);
         int pos = start - begin();
-        Layout::remove(pos, end - start);
+        Layout::remove(pos * stride, (end - start) * stride);
         return begin() + pos;
     }
     return iterator();
@@ -950,5 +1082,9 @@ typename ky_list<T>::iterator ky_list<T>::erase(const_iterator start, const_iter
 
 #include "ky_list.inl"
 
+//! 对象只保存内存块指针，可按位重定位
+template <typename T>
+struct is_relocatable<ky_list<T> >: public true_type_t { };
+
 #endif // ky_LIST
 
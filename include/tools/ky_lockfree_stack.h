@@ -0,0 +1,174 @@
+
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_lockfree_stack.h
+ * @brief    无锁侵入式栈及节点回收分配器
+ *       1.ky_lockfree_stack 为Treiber栈，栈顶为带标签的指针，标签防止ABA
+ *       2.ky_recycle_pool 为按大小分级的全局回收池，线程间共享
+ *       3.ky_recycle_alloc 为容器的节点分配器，容器内有限长度的回收链表，
+ *         超出部分可交给全局回收池
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ */
+#ifndef ky_LOCKFREE_STACK_H
+#define ky_LOCKFREE_STACK_H
+
+#include "ky_define.h"
+#include "ky_atomic.h"
+#include "tools/ky_memory.h"
+
+//! 侵入式节点，入栈的对象需要以此为首个成员或基类
+struct ky_lockfree_node
+{
+    ky_lockfree_node *next;
+};
+
+//!
+//! \brief The ky_lockfree_stack class
+//! \note
+//!   1.栈顶为64位原子量，低48位为节点地址，高16位为修改标签
+//!   2.pop会读取栈顶节点的next，节点在栈的生命期内必须保持可读，
+//!     即节点只能交还给不会归还系统的小块内存或对象池
+//!
+template <typename T = ky_lockfree_node>
+class ky_lockfree_stack
+{
+    kyCompilerAssert(atomic_has<8>::has);
+    kyCompilerAssert(sizeof(void*) <= 8);
+
+    enum
+    {
+        PointerBits = 48
+    };
+    static uint64 pointer_mask() {return ((uint64)1 << PointerBits) - 1;}
+    static T *pointer(uint64 h) {return (T*)(uintptr)(h & pointer_mask ());}
+    static uint64 tag(uint64 h) {return h >> PointerBits;}
+    static uint64 pack(const void *p, uint64 t)
+    {
+        return ((uint64)(uintptr)p & pointer_mask ()) | (t << PointerBits);
+    }
+
+    ky_atomic<uint64> head;
+    ky_atomic<int> total;
+
+    ky_lockfree_stack(const ky_lockfree_stack &) = delete;
+    ky_lockfree_stack &operator = (const ky_lockfree_stack &) = delete;
+
+public:
+    ky_lockfree_stack():head(0), total(0){}
+    ~ky_lockfree_stack(){}
+
+    //!
+    //! \brief push 将节点压入栈顶
+    //! \param n
+    //!
+    void push(T *n) {push (n, n, 1);}
+    //!
+    //! \brief push 将first到last已链接好的count个节点一次压入栈顶
+    //! \param first
+    //! \param last
+    //! \param count
+    //!
+    void push(T *first, T *last, int count);
+    //!
+    //! \brief pop 弹出栈顶节点
+    //! \return 栈为空时返回NULL
+    //!
+    T *pop();
+    //!
+    //! \brief take 一次取走全部节点
+    //! \return 以next链接的节点链表
+    //!
+    T *take();
+
+    bool is_empty() {return pointer (head.load (Fence_Acquire)) == NULL;}
+    //! 节点数，并发修改时为近似值
+    int count() {return total.load (Fence_Relaxed);}
+};
+
+//!
+//! \brief The ky_recycle_pool class 全局回收池，按Granule字节对齐分级
+//! \note 池中内存只在trim时释放，trim须在没有其他线程访问池时调用
+//!
+struct ky_recycle_pool
+{
+    enum
+    {
+        Granule = 16,
+        Classes = 32,
+        MaxSize = Granule * Classes
+    };
+
+    //! 分级后的内存大小，超出MaxSize的内存不回收
+    static size_t rounded(size_t size) {return (size + Granule - 1) & ~(size_t)(Granule - 1);}
+    static bool is_pooled(size_t size) {return size > 0 && size <= MaxSize;}
+
+    static ky_lockfree_stack<> &stack(size_t size)
+    {
+        static ky_lockfree_stack<> pools[Classes];
+        return pools[rounded (size) / Granule - 1];
+    }
+
+    static void *alloc(size_t size)
+    {
+        void *mem = stack (size).pop ();
+        return mem ? mem : kyMalloc (rounded (size));
+    }
+    static void destroy(void *mem, size_t size)
+    {
+        stack (size).push ((ky_lockfree_node*)mem);
+    }
+    //! 释放池中全部内存
+    static void trim();
+};
+
+//!
+//! \brief The ky_recycle_alloc class 节点回收分配器
+//! \note
+//!   1.接口与ky_alloc相同，容器以destroy(mem, size)归还的节点进入回收链表
+//!   2.回收链表只缓存一种大小的节点，最多Capacity个
+//!   3.Shared为真时，回收链表已满或未命中的节点与全局回收池交换
+//!   4.回收链表属于容器对象，拷贝容器时不拷贝回收链表
+//!
+template <typename T, int Capacity = 64, bool Shared = false>
+struct ky_recycle_alloc
+{
+    ky_recycle_alloc():cache(NULL), cached(0), slot(0){}
+    ky_recycle_alloc(const ky_recycle_alloc &):cache(NULL), cached(0), slot(0){}
+    ~ky_recycle_alloc() {release ();}
+
+    ky_recycle_alloc &operator = (const ky_recycle_alloc &) {return *this;}
+
+    T* alloc(size_t size);
+    T* realloc(T* mem, size_t size)
+    {
+        return (T*)::kyRealloc((void*)mem, size);
+    }
+    //! 未知大小的内存不回收
+    void destroy(void *mem)
+    {
+        kyFree (mem);
+    }
+    void destroy(void *mem, size_t size);
+
+    //! 释放回收链表中的节点
+    void release();
+
+private:
+    ky_lockfree_node *cache;
+    int cached;
+    size_t slot;
+};
+
+#include "ky_lockfree_stack.inl"
+#endif // ky_LOCKFREE_STACK_H
@@ -0,0 +1,136 @@
+#ifndef KY_LOCKFREE_STACK_INL
+#define KY_LOCKFREE_STACK_INL
+
+template <typename T>
+void ky_lockfree_stack<T>::push(T *first, T *last, int count)
+{
+    uint64 old = head.load (Fence_Acquire);
+    for (;;)
+    {
+        last->next = pointer (old);
+        // 每次修改栈顶都递增标签，其他线程持有的旧栈顶值不会再比较成功
+        if (head.compare_exchange (old, pack (first, tag (old) + 1)))
+            break;
+        old = head.load (Fence_Acquire);
+    }
+    total.fetch_add (count);
+}
+
+template <typename T>
+T *ky_lockfree_stack<T>::pop()
+{
+    uint64 old = head.load (Fence_Acquire);
+    for (;;)
+    {
+        T *n = pointer (old);
+        if (n == NULL)
+            return NULL;
+        // n可能已被其他线程弹出，此时读到的next无效，但标签已变，交换必然失败
+        const uint64 nv = pack (n->next, tag (old) + 1);
+        if (head.compare_exchange (old, nv))
+        {
+            total.fetch_add (-1);
+            return n;
+        }
+        old = head.load (Fence_Acquire);
+    }
+}
+
+template <typename T>
+T *ky_lockfree_stack<T>::take()
+{
+    uint64 old = head.load (Fence_Acquire);
+    for (;;)
+    {
+        T *n = pointer (old);
+        if (n == NULL)
+            return NULL;
+        if (head.compare_exchange (old, pack (NULL, tag (old) + 1)))
+        {
+            int c = 0;
+            for (ky_lockfree_node *i = n; i; i = i->next)
+                ++c;
+            total.fetch_add (-c);
+            return n;
+        }
+        old = head.load (Fence_Acquire);
+    }
+}
+
+inline void ky_recycle_pool::trim()
+{
+    for (int i = 0; i < Classes; ++i)
+    {
+        ky_lockfree_node *n = stack ((i + 1) * Granule).take ();
+        while (n)
+        {
+            ky_lockfree_node *next = n->next;
+            kyFree (n);
+            n = next;
+        }
+    }
+}
+
+template <typename T, int Capacity, bool Shared>
+T *ky_recycle_alloc<T, Capacity, Shared>::alloc(size_t size)
+{
+    if (!ky_recycle_pool::is_pooled (size))
+        return (T*)kyMalloc (size);
+
+    // 可回收的内存按分级大小申请，归还后可被同级的任意请求复用
+    size = ky_recycle_pool::rounded (size);
+    if (cache && slot == size)
+    {
+        ky_lockfree_node *n = cache;
+        cache = n->next;
+        --cached;
+        return (T*)n;
+    }
+    if (Shared)
+        return (T*)ky_recycle_pool::alloc (size);
+    return (T*)kyMalloc (size);
+}
+
+template <typename T, int Capacity, bool Shared>
+void ky_recycle_alloc<T, Capacity, Shared>::destroy(void *mem, size_t size)
+{
+    if (mem == NULL)
+        return;
+    if (!ky_recycle_pool::is_pooled (size))
+    {
+        kyFree (mem);
+        return;
+    }
+
+    size = ky_recycle_pool::rounded (size);
+    if (cached == 0)
+        slot = size;
+    if (slot == size && cached < Capacity)
+    {
+        ky_lockfree_node *n = (ky_lockfree_node*)mem;
+        n->next = cache;
+        cache = n;
+        ++cached;
+    }
+    else if (Shared)
+        ky_recycle_pool::destroy (mem, size);
+    else
+        kyFree (mem);
+}
+
+template <typename T, int Capacity, bool Shared>
+void ky_recycle_alloc<T, Capacity, Shared>::release()
+{
+    while (cache)
+    {
+        ky_lockfree_node *n = cache;
+        cache = n->next;
+        if (Shared)
+            ky_recycle_pool::destroy (n, slot);
+        else
+            kyFree (n);
+    }
+    cached = 0;
+}
+
+#endif // KY_LOCKFREE_STACK_INL
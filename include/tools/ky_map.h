@@ -9,7 +9,7 @@
  *
  * @author   kunyang
  * @email    kunyang.yk@gmail.com
- * @version  1.0.2.3
+ * @version  1.0.4.0
  * @date     2010/05/02
  * @license  GNU General Public License (GPL)
  *
@@ -20,6 +20,8 @@
  * 2014/08/10 | 1.0.2.0   | kunyang  | 加入对象引用计数，同时加入C++11支持
  * 2015/03/06 | 1.0.2.2   | kunyang  | 修改将头信息和实际类数据分开
  * 2016/06/29 | 1.0.2.3   | kunyang  | 修改引用计数的可复制对象
+ * 2026/10/18 | 1.0.3.0   | kunyang  | 查找改为从根节点二分下降，加入比较器及边界查找
+ * 2026/10/18 | 1.0.4.0   | kunyang  | 加入有序批量构建及线性时间的集合运算
  */
 #ifndef ky_MAP
 #define ky_MAP
@@ -29,9 +31,10 @@
 #include "ky_mapdata.h"
 #include <map>
 
-template <typename K, typename V, typename Alloc = ky_mapalloc >
+template <typename K, typename V, typename Alloc = ky_mapalloc, typename Compare = ky_less<K> >
 class ky_map : Alloc
 {
+    typedef ky_mapdata<K, V, Alloc, Compare> data_t;
 public:
     class opemap_node;
     class const_opemap_node;
@@ -41,7 +44,7 @@ public:
     /// STL style
 public:
     ky_map();
-    ky_map(const ky_map<K, V, Alloc> &m);
+    ky_map(const ky_map<K, V, Alloc, Compare> &m);
     ~ky_map();
 
     //!
@@ -83,7 +86,7 @@ public:
     //! \param rhs
     //! \return
     //!
-    ky_map<K, V, Alloc> &operator = (const ky_map<K, V, Alloc> &rhs);
+    ky_map<K, V, Alloc, Compare> &operator = (const ky_map<K, V, Alloc, Compare> &rhs);
 
     //!
     //! \brief at 返回key的值
@@ -119,8 +122,8 @@ public:
     //! \brief swap 交换两个map
     //! \param rhs
     //!
-    void swap(ky_map<K, V, Alloc> &rhs);
-    friend void ky_swap(ky_map<K, V, Alloc> &a, ky_map<K, V, Alloc> &b) {a.swap(b);}
+    void swap(ky_map<K, V, Alloc, Compare> &rhs);
+    friend void ky_swap(ky_map<K, V, Alloc, Compare> &a, ky_map<K, V, Alloc, Compare> &b) {a.swap(b);}
     //!
     //! \brief clear 清空map
     //!
@@ -141,13 +144,34 @@ public:
     //! \return
     //!
     iterator find(const K &key);
+    //!
+    //! \brief lower_bound 返回第一个不排在key之前的迭代器
+    //! \param key
+    //! \return
+    //!
+    iterator lower_bound(const K &key);
+    const_iterator lower_bound(const K &key) const;
+    //!
+    //! \brief upper_bound 返回第一个排在key之后的迭代器
+    //! \param key
+    //! \return
+    //!
+    iterator upper_bound(const K &key);
+    const_iterator upper_bound(const K &key) const;
+    //!
+    //! \brief equal_range 返回等于key的迭代器范围[lower_bound, upper_bound)
+    //! \param key
+    //! \return
+    //!
+    std::pair<iterator, iterator> equal_range(const K &key);
+    std::pair<const_iterator, const_iterator> equal_range(const K &key) const;
 
     /// C++ 11
     #if kyLanguage >= kyLanguage11
 public:
-    ky_map(ky_map<K, V, Alloc> &&m);
+    ky_map(ky_map<K, V, Alloc, Compare> &&m);
     ky_map(std::initializer_list<std::pair<K,V> > list);
-    //ky_map<K, V, Alloc>& operator = (ky_map<K, V, Alloc> &&m) ;
+    //ky_map<K, V, Alloc, Compare>& operator = (ky_map<K, V, Alloc, Compare> &&m) ;
     const_iterator cbegin() const;
     const_iterator cend() const;
 
@@ -164,6 +188,35 @@ public:
 public :
     explicit ky_map(const std::map<K, V> &m);
 
+    //!
+    //! \brief from_sorted 从按键升序排列的[first, last)建立map，元素为std::pair<K, V>
+    //! \param first
+    //! \param last
+    //! \return
+    //! \note O(n)建立平衡树，不做旋转；相邻的相同键保留最后一个值
+    //!
+    template <typename Iter>
+    static ky_map from_sorted(Iter first, Iter last);
+
+    //!
+    //! \brief merge 并集，两个map都有的键取本map的值
+    //! \param rhs
+    //! \return
+    //!
+    ky_map merge(const ky_map &rhs) const;
+    //!
+    //! \brief intersect 交集，取本map的值
+    //! \param rhs
+    //! \return
+    //!
+    ky_map intersect(const ky_map &rhs) const;
+    //!
+    //! \brief difference 差集，本map有而rhs没有的键
+    //! \param rhs
+    //! \return
+    //!
+    ky_map difference(const ky_map &rhs) const;
+
     //!
     //! \brief to_std
     //! \return 和stl模板进行转换
@@ -182,13 +235,13 @@ public :
     //! \param rhs
     //! \return 返回两个map是否相等
     //!
-    bool operator==(const ky_map<K, V, Alloc> &rhs) const;
+    bool operator==(const ky_map<K, V, Alloc, Compare> &rhs) const;
     //!
     //! \brief operator !=
     //! \param rhs
     //! \return 返回两个map是否不相等
     //!
-    bool operator!=(const ky_map<K, V, Alloc> &rhs) const { return !(*this == rhs); }
+    bool operator!=(const ky_map<K, V, Alloc, Compare> &rhs) const { return !(*this == rhs); }
 
     //!
     //! \brief value
@@ -304,7 +357,7 @@ public:
 
         int operator -(const opemap_node &rhs)const
         {
-            ky_map<K, V, Alloc>::opemap_node *take = (ky_map<K, V, Alloc>::opemap_node*)this;
+            ky_map<K, V, Alloc, Compare>::opemap_node *take = (ky_map<K, V, Alloc, Compare>::opemap_node*)this;
             int retval = 0;
             ky_nodemap<K, V> * nt = ope;
             forever (ope != NULL && ope != rhs.ope)
@@ -388,7 +441,7 @@ public:
 
         int operator -(const const_opemap_node &rhs)const
         {
-            ky_map<K, V, Alloc>::const_opemap_node *take = (ky_map<K, V, Alloc>::const_opemap_node*)this;
+            ky_map<K, V, Alloc, Compare>::const_opemap_node *take = (ky_map<K, V, Alloc, Compare>::const_opemap_node*)this;
             int retval = 0;
             ky_nodemap<K, V> * nt = ope;
             forever (ope != NULL && ope != rhs.ope)
@@ -455,23 +508,31 @@ protected:
     void detach();
 private:
     void copy();
+
+    //! 有序输入源，提供 done()、key()、value()、next()
+    template <typename Iter>
+    struct sorted_source;
+    struct merge_source;
+    //! 先计数再从输入源建立平衡树
+    template <typename Src>
+    static ky_map build(const Src &src);
 private:
-    ky_mapdata<K, V, Alloc> *impl;
+    ky_mapdata<K, V, Alloc, Compare> *impl;
 };
 
 #include "ky_map.inl"
 /*template <typename K, typename V, typename Alloc>
-ky_map<K, V, Alloc>& ky_map<K, V, Alloc>::operator = (ky_map<K, V, Alloc> &&m)
+ky_map<K, V, Alloc, Compare>& ky_map<K, V, Alloc, Compare>::operator = (ky_map<K, V, Alloc, Compare> &&m)
 {
     if (!this->is_null () && impl->lessref())
     {
         impl->destroy();
-        impl = (ky_mapdata<K, V, Alloc> *)ky_mapdata<K, V, Alloc>::null ();
+        impl = (ky_mapdata<K, V, Alloc, Compare> *)ky_mapdata<K, V, Alloc, Compare>::null ();
     }
     if (m.is_null ())
         return *this;
     impl = m.impl;
-    m.impl = (ky_mapdata<K, V, Alloc> *)ky_mapdata<K, V, Alloc>::null ();
+    m.impl = (ky_mapdata<K, V, Alloc, Compare> *)ky_mapdata<K, V, Alloc, Compare>::null ();
     return *this;
 }*/
 #endif // ky_MAP
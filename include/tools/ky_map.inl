@@ -133,6 +133,7 @@ void ky_treedata::destroy_rebalance(ky_treebase *z, Alloc &al)
                 if (rb_is_red(w))
                 {
                     rb_set_black(w);
+                    rb_set_red(x_parent);
                     right_rotate(x_parent);
                     w = x_parent->lchild;
                 }
@@ -204,15 +205,15 @@ void ky_treedata::destroy(ky_treebase *x, Alloc &al)
 }
 
 
-template <typename K, typename V, typename Alloc>
-ky_map<K, V, Alloc>::ky_map():
-    impl((ky_mapdata<K, V, Alloc> *)ky_mapdata<K, V, Alloc>::null ())
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_map<K, V, Alloc, Compare>::ky_map():
+    impl((ky_mapdata<K, V, Alloc, Compare> *)ky_mapdata<K, V, Alloc, Compare>::null ())
 {
 }
 
-template <typename K, typename V, typename Alloc>
-ky_map<K, V, Alloc>::ky_map(const ky_map<K, V, Alloc> &m):
-    impl((ky_mapdata<K, V, Alloc> *)ky_mapdata<K, V, Alloc>::null ())
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_map<K, V, Alloc, Compare>::ky_map(const ky_map<K, V, Alloc, Compare> &m):
+    impl((ky_mapdata<K, V, Alloc, Compare> *)ky_mapdata<K, V, Alloc, Compare>::null ())
 {
     if (!is_null() && impl->lessref())
         impl->destroy();
@@ -224,24 +225,24 @@ ky_map<K, V, Alloc>::ky_map(const ky_map<K, V, Alloc> &m):
     else
         detach();
 }
-template <typename K, typename V, typename Alloc>
-ky_map<K, V, Alloc>::~ky_map()
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_map<K, V, Alloc, Compare>::~ky_map()
 {
     if (!is_null() && impl->lessref())
         impl->destroy();
     impl = NULL;
 }
-template <typename K, typename V, typename Alloc>
-void ky_map<K, V, Alloc>::detach()
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_map<K, V, Alloc, Compare>::detach()
 {
     if (!is_null() && impl->has_detach() && impl->is_shared())
         copy();
 }
-template <typename K, typename V, typename Alloc>
-void ky_map<K, V, Alloc>::copy()
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_map<K, V, Alloc, Compare>::copy()
 {
-    ky_mapdata<K, V, Alloc> *tmp = impl;
-    impl = ky_mapdata<K, V, Alloc>::create();
+    ky_mapdata<K, V, Alloc, Compare> *tmp = impl;
+    impl = ky_mapdata<K, V, Alloc, Compare>::create();
 
     for (size_t i = 0; i < tmp->count; ++i)
     {
@@ -252,32 +253,32 @@ void ky_map<K, V, Alloc>::copy()
         tmp->destroy();
 }
 
-template <typename K, typename V, typename Alloc>
-typename ky_map<K, V, Alloc>::iterator ky_map<K, V, Alloc>::begin()
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_map<K, V, Alloc, Compare>::iterator ky_map<K, V, Alloc, Compare>::begin()
 {
     detach();
     return iterator(impl->begin());
 }
-template <typename K, typename V, typename Alloc>
-typename ky_map<K, V, Alloc>::const_iterator ky_map<K, V, Alloc>::begin() const
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_map<K, V, Alloc, Compare>::const_iterator ky_map<K, V, Alloc, Compare>::begin() const
 {
     return const_iterator(impl->begin());
 }
-template <typename K, typename V, typename Alloc>
-typename ky_map<K, V, Alloc>::iterator ky_map<K, V, Alloc>::end()
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_map<K, V, Alloc, Compare>::iterator ky_map<K, V, Alloc, Compare>::end()
 {
     detach();
     return iterator(impl->end());
 }
 
-template <typename K, typename V, typename Alloc>
-typename ky_map<K, V, Alloc>::const_iterator ky_map<K, V, Alloc>::end() const
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_map<K, V, Alloc, Compare>::const_iterator ky_map<K, V, Alloc, Compare>::end() const
 {
     return const_iterator(impl->end());
 }
 #if kyLanguage < kyLanguage11
-template <typename K, typename V, typename Alloc>
-void ky_map<K, V, Alloc>::erase(iterator pos)
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_map<K, V, Alloc, Compare>::erase(iterator pos)
 {
     if (is_null() || pos == iterator(impl->end()))
         return ;
@@ -285,8 +286,8 @@ void ky_map<K, V, Alloc>::erase(iterator pos)
     impl->delnode(node);
 }
 
-template <typename K, typename V, typename Alloc>
-void ky_map<K, V, Alloc>::erase(iterator first, iterator last)
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_map<K, V, Alloc, Compare>::erase(iterator first, iterator last)
 {
     if (is_null())
         return ;
@@ -296,16 +297,11 @@ void ky_map<K, V, Alloc>::erase(iterator first, iterator last)
         ++first;
     }
 }
-template <typename K, typename V, typename Alloc>
-typename ky_map<K, V, Alloc>::const_iterator ky_map<K, V, Alloc>::find(const K &key)const
-{
-    return const_iterator(impl->find(key));
-}
-template <typename K, typename V, typename Alloc>
-void ky_map<K, V, Alloc>::insert(const K& key, const V& val)
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_map<K, V, Alloc, Compare>::insert(const K& key, const V& val)
 {
     if (is_null())
-        impl = ky_mapdata<K, V, Alloc>::create();
+        impl = ky_mapdata<K, V, Alloc, Compare>::create();
 
     ky_nodemap<K, V> *node = impl->root();
     ky_nodemap<K, V> *y = d->end();
@@ -333,22 +329,22 @@ void ky_map<K, V, Alloc>::insert(const K& key, const V& val)
     //return iterator(z);
 }
 #endif
-template <typename K, typename V, typename Alloc>
-ky_map<K, V, Alloc> &ky_map<K, V, Alloc>::operator = (const ky_map<K, V, Alloc> &rhs)
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_map<K, V, Alloc, Compare> &ky_map<K, V, Alloc, Compare>::operator = (const ky_map<K, V, Alloc, Compare> &rhs)
 {
     if (impl != rhs.impl)
     {
-        ky_map<K, V, Alloc> tmp(rhs);
+        ky_map<K, V, Alloc, Compare> tmp(rhs);
         tmp.swap(*this);
     }
     return *this;
 }
 
-template <typename K, typename V, typename Alloc>
-V &ky_map<K, V, Alloc>::operator [](const K &key)
+template <typename K, typename V, typename Alloc, typename Compare>
+V &ky_map<K, V, Alloc, Compare>::operator [](const K &key)
 {
     if (is_null())
-        impl = ky_mapdata<K, V, Alloc>::create();
+        impl = ky_mapdata<K, V, Alloc, Compare>::create();
 
     detach();
     ky_nodemap<K, V> *node = impl->find(key);
@@ -357,38 +353,38 @@ V &ky_map<K, V, Alloc>::operator [](const K &key)
     return node->value;
 }
 
-template <typename K, typename V, typename Alloc>
-bool ky_map<K, V, Alloc>::empty() const
+template <typename K, typename V, typename Alloc, typename Compare>
+bool ky_map<K, V, Alloc, Compare>::empty() const
 {
     return is_empty();
 }
-template <typename K, typename V, typename Alloc>
-size_t ky_map<K, V, Alloc>::size() const
+template <typename K, typename V, typename Alloc, typename Compare>
+size_t ky_map<K, V, Alloc, Compare>::size() const
 {
     return count();
 }
 
-template <typename K, typename V, typename Alloc>
-V &ky_map<K, V, Alloc>::at(const K &key)
+template <typename K, typename V, typename Alloc, typename Compare>
+V &ky_map<K, V, Alloc, Compare>::at(const K &key)
 {
     return operator [](key);
 }
-template <typename K, typename V, typename Alloc>
-const V &ky_map<K, V, Alloc>::at(const K &key)const
+template <typename K, typename V, typename Alloc, typename Compare>
+const V &ky_map<K, V, Alloc, Compare>::at(const K &key)const
 {
     return operator [](key);
 }
 
-template <typename K, typename V, typename Alloc>
-typename ky_map<K, V, Alloc>::iterator ky_map<K, V, Alloc>::insert(const K& key)
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_map<K, V, Alloc, Compare>::iterator ky_map<K, V, Alloc, Compare>::insert(const K& key)
 {
     return this->insert(key, V());
 }
-template <typename K, typename V, typename Alloc>
-typename ky_map<K, V, Alloc>::iterator ky_map<K, V, Alloc>::insert(iterator pos, const K& key)
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_map<K, V, Alloc, Compare>::iterator ky_map<K, V, Alloc, Compare>::insert(iterator pos, const K& key)
 {
     if (is_null())
-        impl = ky_mapdata<K, V, Alloc>::create();
+        impl = ky_mapdata<K, V, Alloc, Compare>::create();
 
     if (pos == end())
     {
@@ -397,7 +393,7 @@ typename ky_map<K, V, Alloc>::iterator ky_map<K, V, Alloc>::insert(iterator pos,
         {
             while (node->rchild != NULL)
                 node = (ky_nodemap<K, V> *)node->rchild;
-            if (key < node->key)
+            if (data_t::less(key, node->key))
                 return this->insert(key);
 
             ky_nodemap<K, V> *z = impl->newnode(key, V(), node, false);
@@ -408,12 +404,12 @@ typename ky_map<K, V, Alloc>::iterator ky_map<K, V, Alloc>::insert(iterator pos,
     else
     {
         ky_nodemap<K, V>  *next = (ky_nodemap<K, V> *)pos.ope;
-        if (next->key < key)
+        if (data_t::less(next->key, key))
             return this->insert(key);
 
         if (pos == begin())
         {
-            if (next->key < key)
+            if (data_t::less(next->key, key))
                 return iterator(next);
             ky_nodemap<K, V> *z = impl->create(key, V(), begin().ope, true);
             return iterator(z);
@@ -421,10 +417,10 @@ typename ky_map<K, V, Alloc>::iterator ky_map<K, V, Alloc>::insert(iterator pos,
         else
         {
             ky_nodemap<K, V> *prev = (ky_nodemap<K, V>*)pos.ope->prev();
-            if (key < prev->key)
+            if (data_t::less(key, prev->key))
                 return this->insert(key);
 
-            if (next->key < key)
+            if (data_t::less(next->key, key))
                 return iterator(next);
 
             if (prev->rchild == NULL)
@@ -441,11 +437,11 @@ typename ky_map<K, V, Alloc>::iterator ky_map<K, V, Alloc>::insert(iterator pos,
         }
     }
 }
-template <typename K, typename V, typename Alloc>
-typename ky_map<K, V, Alloc>::iterator ky_map<K, V, Alloc>::insert(const K& key, const V& val)
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_map<K, V, Alloc, Compare>::iterator ky_map<K, V, Alloc, Compare>::insert(const K& key, const V& val)
 {
     if (is_null())
-        impl = ky_mapdata<K, V, Alloc>::create();
+        impl = ky_mapdata<K, V, Alloc, Compare>::create();
 
     detach();
     ky_nodemap<K, V> *node = impl->root();
@@ -455,7 +451,7 @@ typename ky_map<K, V, Alloc>::iterator ky_map<K, V, Alloc>::insert(const K& key,
     while (node != NULL)
     {
         y = node;
-        if (!(node->key < key))
+        if (!data_t::less(node->key, key))
         {
             lastnode = node;
             left = true;
@@ -465,7 +461,7 @@ typename ky_map<K, V, Alloc>::iterator ky_map<K, V, Alloc>::insert(const K& key,
             node = node->right();
         }
     }
-    if (lastnode &&  !(key < lastnode->key))
+    if (lastnode && !data_t::less(key, lastnode->key))
     {
         lastnode->value = val;
         return iterator(lastnode);
@@ -474,58 +470,101 @@ typename ky_map<K, V, Alloc>::iterator ky_map<K, V, Alloc>::insert(const K& key,
     return iterator(z);
 }
 
-template <typename K, typename V, typename Alloc>
-void ky_map<K, V, Alloc>::swap(ky_map<K, V, Alloc> &rhs)
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_map<K, V, Alloc, Compare>::swap(ky_map<K, V, Alloc, Compare> &rhs)
 {
-    ky_mapdata<K, V, Alloc> *tmp = impl;
+    ky_mapdata<K, V, Alloc, Compare> *tmp = impl;
     impl = rhs.impl;
     rhs.impl = tmp;
 }
-template <typename K, typename V, typename Alloc>
-void ky_map<K, V, Alloc>::clear()
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_map<K, V, Alloc, Compare>::clear()
 {
-    *this = ky_map<K, V, Alloc>();
+    *this = ky_map<K, V, Alloc, Compare>();
 }
-template <typename K, typename V, typename Alloc>
-typename ky_map<K, V, Alloc>::iterator ky_map<K, V, Alloc>::find(const K &key)
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_map<K, V, Alloc, Compare>::iterator ky_map<K, V, Alloc, Compare>::find(const K &key)
 {
     ky_nodemap<K, V> *node = impl->find(key);
     return iterator(node ? node : impl->end());
 }
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_map<K, V, Alloc, Compare>::const_iterator ky_map<K, V, Alloc, Compare>::find(const K &key)const
+{
+    const ky_nodemap<K, V> *node = impl->find(key);
+    return const_iterator(node ? node : impl->end());
+}
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_map<K, V, Alloc, Compare>::iterator ky_map<K, V, Alloc, Compare>::lower_bound(const K &key)
+{
+    detach();
+    return iterator(impl->lower_bound(key));
+}
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_map<K, V, Alloc, Compare>::const_iterator ky_map<K, V, Alloc, Compare>::lower_bound(const K &key)const
+{
+    return const_iterator(impl->lower_bound(key));
+}
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_map<K, V, Alloc, Compare>::iterator ky_map<K, V, Alloc, Compare>::upper_bound(const K &key)
+{
+    detach();
+    return iterator(impl->upper_bound(key));
+}
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_map<K, V, Alloc, Compare>::const_iterator ky_map<K, V, Alloc, Compare>::upper_bound(const K &key)const
+{
+    return const_iterator(impl->upper_bound(key));
+}
+template <typename K, typename V, typename Alloc, typename Compare>
+std::pair<typename ky_map<K, V, Alloc, Compare>::iterator, typename ky_map<K, V, Alloc, Compare>::iterator>
+ky_map<K, V, Alloc, Compare>::equal_range(const K &key)
+{
+    detach();
+    return std::pair<iterator, iterator>(iterator(impl->lower_bound(key)),
+                                         iterator(impl->upper_bound(key)));
+}
+template <typename K, typename V, typename Alloc, typename Compare>
+std::pair<typename ky_map<K, V, Alloc, Compare>::const_iterator, typename ky_map<K, V, Alloc, Compare>::const_iterator>
+ky_map<K, V, Alloc, Compare>::equal_range(const K &key)const
+{
+    return std::pair<const_iterator, const_iterator>(const_iterator(impl->lower_bound(key)),
+                                                     const_iterator(impl->upper_bound(key)));
+}
 
 /// C++ 11
 #if kyLanguage >= kyLanguage11
-template <typename K, typename V, typename Alloc>
-ky_map<K, V, Alloc>::ky_map(ky_map<K, V, Alloc> &&m):
-    impl((ky_mapdata<K, V, Alloc> *)ky_mapdata<K, V, Alloc>::null ())
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_map<K, V, Alloc, Compare>::ky_map(ky_map<K, V, Alloc, Compare> &&m):
+    impl((ky_mapdata<K, V, Alloc, Compare> *)ky_mapdata<K, V, Alloc, Compare>::null ())
 {
     impl = m.impl;
-    m.clear();
+    m.impl = (ky_mapdata<K, V, Alloc, Compare> *)ky_mapdata<K, V, Alloc, Compare>::null ();
 }
-template <typename K, typename V, typename Alloc>
-ky_map<K, V, Alloc>::ky_map(std::initializer_list<std::pair<K,V> > list):
-    impl((ky_mapdata<K, V, Alloc> *)ky_mapdata<K, V, Alloc>::null ())
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_map<K, V, Alloc, Compare>::ky_map(std::initializer_list<std::pair<K,V> > list):
+    impl((ky_mapdata<K, V, Alloc, Compare> *)ky_mapdata<K, V, Alloc, Compare>::null ())
 {
     for (typename std::initializer_list<std::pair<K, V> >::const_iterator it = list.begin();
          it != list.end(); ++it)
         append(it->first, it->second);
 }
-template <typename K, typename V, typename Alloc>
-typename ky_map<K, V, Alloc>::const_iterator ky_map<K, V, Alloc>::cbegin() const
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_map<K, V, Alloc, Compare>::const_iterator ky_map<K, V, Alloc, Compare>::cbegin() const
 {
     return const_iterator(impl->begin());
 }
-template <typename K, typename V, typename Alloc>
-typename ky_map<K, V, Alloc>::const_iterator ky_map<K, V, Alloc>::cend() const
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_map<K, V, Alloc, Compare>::const_iterator ky_map<K, V, Alloc, Compare>::cend() const
 {
     return const_iterator(impl->end());
 }
 
-template <typename K, typename V, typename Alloc>
-V &ky_map<K, V, Alloc>::operator []( K &&key)
+template <typename K, typename V, typename Alloc, typename Compare>
+V &ky_map<K, V, Alloc, Compare>::operator []( K &&key)
 {
     if (is_null())
-        impl = ky_mapdata<K, V, Alloc>::create();
+        impl = ky_mapdata<K, V, Alloc, Compare>::create();
 
     detach();
     ky_nodemap<K, V> *node = impl->find(key);
@@ -533,8 +572,8 @@ V &ky_map<K, V, Alloc>::operator []( K &&key)
         return *insert(key);
     return node->value;
 }
-template <typename K, typename V, typename Alloc>
-typename ky_map<K, V, Alloc>::iterator ky_map<K, V, Alloc>::erase(const_iterator pos)
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_map<K, V, Alloc, Compare>::iterator ky_map<K, V, Alloc, Compare>::erase(const_iterator pos)
 {
     if (is_null() || pos == iterator(impl->end()))
         return pos;
@@ -544,8 +583,8 @@ typename ky_map<K, V, Alloc>::iterator ky_map<K, V, Alloc>::erase(const_iterator
     impl->delnode(node);
     return pos;
 }
-template <typename K, typename V, typename Alloc>
-typename ky_map<K, V, Alloc>::iterator ky_map<K, V, Alloc>::erase(iterator pos)
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_map<K, V, Alloc, Compare>::iterator ky_map<K, V, Alloc, Compare>::erase(iterator pos)
 {
     if (is_null() || pos == iterator(impl->end()))
         return pos;
@@ -556,16 +595,161 @@ typename ky_map<K, V, Alloc>::iterator ky_map<K, V, Alloc>::erase(iterator pos)
     return pos;
 }
 #endif
-template <typename K, typename V, typename Alloc>
-ky_map<K, V, Alloc>::ky_map(const std::map<K, V> &m):
-    impl((ky_mapdata<K, V, Alloc> *)ky_mapdata<K, V, Alloc>::null ())
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_map<K, V, Alloc, Compare>::ky_map(const std::map<K, V> &m):
+    impl((ky_mapdata<K, V, Alloc, Compare> *)ky_mapdata<K, V, Alloc, Compare>::null ())
 {
-    impl = ky_mapdata<K, V, Alloc>::create();
+    impl = ky_mapdata<K, V, Alloc, Compare>::create();
     form(m);
 }
 
-template <typename K, typename V, typename Alloc>
-std::map<K, V> &ky_map<K, V, Alloc>::to_std()
+template <typename K, typename V, typename Alloc, typename Compare>
+template <typename Iter>
+struct ky_map<K, V, Alloc, Compare>::sorted_source
+{
+    Iter cur;
+    Iter last;
+    Iter end;
+
+    sorted_source(Iter f, Iter e):cur(f), last(f), end(e){settle();}
+    //! last 指向与cur相同键的最后一个元素
+    void settle()
+    {
+        if (cur == end)
+            return ;
+        last = cur;
+        Iter nx = cur;
+        for (++nx; nx != end && !data_t::less(last->first, nx->first); ++nx)
+            last = nx;
+    }
+    bool done()const {return cur == end;}
+    const K &key()const {return cur->first;}
+    const V &value()const {return last->second;}
+    void next()
+    {
+        cur = last;
+        ++cur;
+        settle();
+    }
+};
+
+template <typename K, typename V, typename Alloc, typename Compare>
+struct ky_map<K, V, Alloc, Compare>::merge_source
+{
+    enum eModes {Union, Intersect, Difference};
+
+    const_iterator a, aend;
+    const_iterator b, bend;
+    eModes mode;
+    bool froma;         ///< 当前元素取自a
+    bool bothab;        ///< 当前元素a和b的键相同
+
+    merge_source(const ky_map &x, const ky_map &y, eModes m):
+        a(x.begin()), aend(x.end()), b(y.begin()), bend(y.end()), mode(m)
+    {
+        settle();
+    }
+    void settle()
+    {
+        forever (true)
+        {
+            const bool ha = a != aend;
+            const bool hb = b != bend;
+            froma = true;
+            bothab = false;
+            if (!ha)
+            {
+                if (mode == Union && hb)
+                    froma = false;
+                return ;
+            }
+            if (!hb)
+            {
+                if (mode == Intersect)
+                    a = aend;
+                return ;
+            }
+            if (data_t::less(a.key(), b.key()))
+            {
+                if (mode != Intersect)
+                    return ;
+                ++a;
+            }
+            else if (data_t::less(b.key(), a.key()))
+            {
+                if (mode == Union)
+                {
+                    froma = false;
+                    return ;
+                }
+                ++b;
+            }
+            else
+            {
+                bothab = true;
+                if (mode != Difference)
+                    return ;
+                ++a;
+                ++b;
+            }
+        }
+    }
+    bool done()const {return a == aend && (mode != Union || b == bend);}
+    const K &key()const {return froma ? a.key() : b.key();}
+    const V &value()const {return froma ? a.value() : b.value();}
+    void next()
+    {
+        if (froma)
+            ++a;
+        if (!froma || bothab)
+            ++b;
+        settle();
+    }
+};
+
+template <typename K, typename V, typename Alloc, typename Compare>
+template <typename Src>
+ky_map<K, V, Alloc, Compare> ky_map<K, V, Alloc, Compare>::build(const Src &src)
+{
+    size_t n = 0;
+    for (Src c = src; !c.done(); c.next())
+        ++n;
+
+    ky_map<K, V, Alloc, Compare> out;
+    if (n > 0)
+    {
+        Src c = src;
+        out.impl = ky_mapdata<K, V, Alloc, Compare>::create();
+        out.impl->build(c, n);
+    }
+    return out;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+template <typename Iter>
+ky_map<K, V, Alloc, Compare> ky_map<K, V, Alloc, Compare>::from_sorted(Iter first, Iter last)
+{
+    return build(sorted_source<Iter>(first, last));
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_map<K, V, Alloc, Compare> ky_map<K, V, Alloc, Compare>::merge(const ky_map &rhs) const
+{
+    return build(merge_source(*this, rhs, merge_source::Union));
+}
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_map<K, V, Alloc, Compare> ky_map<K, V, Alloc, Compare>::intersect(const ky_map &rhs) const
+{
+    return build(merge_source(*this, rhs, merge_source::Intersect));
+}
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_map<K, V, Alloc, Compare> ky_map<K, V, Alloc, Compare>::difference(const ky_map &rhs) const
+{
+    return build(merge_source(*this, rhs, merge_source::Difference));
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+std::map<K, V> &ky_map<K, V, Alloc, Compare>::to_std()
 {
     std::map<K, V> map;
     const_iterator it = end();
@@ -573,25 +757,25 @@ std::map<K, V> &ky_map<K, V, Alloc>::to_std()
         map.insert(map.end(), std::pair<K, V>(it.key(), it.value()));
     return map;
 }
-template <typename K, typename V, typename Alloc>
-void ky_map<K, V, Alloc>::form(std::map<K, V> &m)
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_map<K, V, Alloc, Compare>::form(std::map<K, V> &m)
 {
     detach ();
     clear();
     if (is_null())
-        impl = ky_mapdata<K, V, Alloc>::create();
+        impl = ky_mapdata<K, V, Alloc, Compare>::create();
     for (typename std::map<K, V>::const_iterator it = m.begin(); it != m.end(); ++it)
         this->insert((*it).first, (*it).second);
 }
 
-template <typename K, typename V, typename Alloc>
-const V ky_map<K, V, Alloc>::operator [](const K &key)const
+template <typename K, typename V, typename Alloc, typename Compare>
+const V ky_map<K, V, Alloc, Compare>::operator [](const K &key)const
 {
     return value(key);
 }
 
-template <typename K, typename V, typename Alloc>
-bool ky_map<K, V, Alloc>::operator== (const ky_map<K, V, Alloc> &rhs) const
+template <typename K, typename V, typename Alloc, typename Compare>
+bool ky_map<K, V, Alloc, Compare>::operator== (const ky_map<K, V, Alloc, Compare> &rhs) const
 {
     if (size() != rhs.size())
         return false;
@@ -611,40 +795,40 @@ bool ky_map<K, V, Alloc>::operator== (const ky_map<K, V, Alloc> &rhs) const
     return true;
 }
 
-template <typename K, typename V, typename Alloc>
-V ky_map<K, V, Alloc>::value(const K& key)
+template <typename K, typename V, typename Alloc, typename Compare>
+V ky_map<K, V, Alloc, Compare>::value(const K& key)
 {
     ky_nodemap<K, V> *node = impl->find(key);
     return node ? node->value : V();
 }
 
-template <typename K, typename V, typename Alloc>
-void ky_map<K, V, Alloc>::append(const K& key, const V& val)
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_map<K, V, Alloc, Compare>::append(const K& key, const V& val)
 {
     this->insert(key, val);
 }
 
-template <typename K, typename V, typename Alloc>
-void ky_map<K, V, Alloc>::remove(const K& key)
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_map<K, V, Alloc, Compare>::remove(const K& key)
 {
     detach();
     while (ky_nodemap<K, V> *node = impl->find(key))
         impl->delnode(node);
 }
 
-template <typename K, typename V, typename Alloc>
-void ky_map<K, V, Alloc>::remove()
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_map<K, V, Alloc, Compare>::remove()
 {
     detach ();
     clear();
 }
 
 #if kyLanguage >= kyLanguage11
-template <typename K, typename V, typename Alloc>
-void ky_map<K, V, Alloc>::insert(const_iterator pos, const K &key, const V &value)
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_map<K, V, Alloc, Compare>::insert(const_iterator pos, const K &key, const V &value)
 {
     if (is_null())
-        impl = ky_mapdata<K, V, Alloc>::create();
+        impl = ky_mapdata<K, V, Alloc, Compare>::create();
     if (pos == end())
     {
         ky_nodemap<K, V> *node = (ky_nodemap<K, V> *)pos.ope->lchild;
@@ -652,7 +836,7 @@ void ky_map<K, V, Alloc>::insert(const_iterator pos, const K &key, const V &valu
         {
             while (node->rchild != NULL)
                 node = (ky_nodemap<K, V> *)node->rchild;
-            if (key < node->key)
+            if (data_t::less(key, node->key))
             {
                 this->insert(key, value);
                 return ;
@@ -666,7 +850,7 @@ void ky_map<K, V, Alloc>::insert(const_iterator pos, const K &key, const V &valu
     else
     {
         ky_nodemap<K, V>  *next = (ky_nodemap<K, V> *)pos.ope;
-        if (next->key < key)
+        if (data_t::less(next->key, key))
         {
             this->insert(key, value);
             return ;
@@ -674,7 +858,7 @@ void ky_map<K, V, Alloc>::insert(const_iterator pos, const K &key, const V &valu
 
         if (pos == begin())
         {
-            if (next->key < key)
+            if (data_t::less(next->key, key))
             {
                 next->value = value;
                 return ;
@@ -685,13 +869,13 @@ void ky_map<K, V, Alloc>::insert(const_iterator pos, const K &key, const V &valu
         else
         {
             ky_nodemap<K, V> *prev = (ky_nodemap<K, V>*)pos.ope->prev();
-            if (key < prev->key)
+            if (data_t::less(key, prev->key))
             {
                  this->insert(key, value);
                 return ;
             }
 
-            if (next->key < key)
+            if (data_t::less(next->key, key))
             {
                 next->value = value;
                 return ;
@@ -713,14 +897,14 @@ void ky_map<K, V, Alloc>::insert(const_iterator pos, const K &key, const V &valu
 }
 #endif
 
-template <typename K, typename V, typename Alloc>
-bool ky_map<K, V, Alloc>::contains(const K &key) const
+template <typename K, typename V, typename Alloc, typename Compare>
+bool ky_map<K, V, Alloc, Compare>::contains(const K &key) const
 {
     return impl->find(key) != NULL;
 }
 
-template <typename K, typename V, typename Alloc>
-const K ky_map<K, V, Alloc>::key(const V &value) const
+template <typename K, typename V, typename Alloc, typename Compare>
+const K ky_map<K, V, Alloc, Compare>::key(const V &value) const
 {
     const_iterator i = begin();
     while (i != end())
@@ -733,17 +917,18 @@ const K ky_map<K, V, Alloc>::key(const V &value) const
     return K();
 }
 
-template <typename K, typename V, typename Alloc>
-const V ky_map<K, V, Alloc>::value(const K &key) const
+template <typename K, typename V, typename Alloc, typename Compare>
+const V ky_map<K, V, Alloc, Compare>::value(const K &key) const
 {
     ky_nodemap<K, V> *node = impl->find(key);
     return node ? node->value : V();
 }
 
-template <typename K, typename V, typename Alloc>
-ky_list<K> ky_map<K, V, Alloc>::keys() const
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_list<K> ky_map<K, V, Alloc, Compare>::keys() const
 {
     ky_list<K> res;
+    res.reserve(count());
     const_iterator i = begin();
     while (i != end())
     {
@@ -752,8 +937,8 @@ ky_list<K> ky_map<K, V, Alloc>::keys() const
     }
     return res;
 }
-template <typename K, typename V, typename Alloc>
-ky_list<K> ky_map<K, V, Alloc>::keys(const V &value) const
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_list<K> ky_map<K, V, Alloc, Compare>::keys(const V &value) const
 {
     ky_list<K> res;
     const_iterator i = begin();
@@ -766,10 +951,11 @@ ky_list<K> ky_map<K, V, Alloc>::keys(const V &value) const
     return res;
 }
 
-template <typename K, typename V, typename Alloc>
-ky_list<V> ky_map<K, V, Alloc>::values() const
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_list<V> ky_map<K, V, Alloc, Compare>::values() const
 {
     ky_list<V> res;
+    res.reserve(count());
     const_iterator i = begin();
     while (i != end())
     {
@@ -778,8 +964,8 @@ ky_list<V> ky_map<K, V, Alloc>::values() const
     }
     return res;
 }
-template <typename K, typename V, typename Alloc>
-ky_list<V> ky_map<K, V, Alloc>::values(const K &key) const
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_list<V> ky_map<K, V, Alloc, Compare>::values(const K &key) const
 {
     ky_list<V> res;
     const_iterator i = begin();
@@ -792,42 +978,42 @@ ky_list<V> ky_map<K, V, Alloc>::values(const K &key) const
     return res;
 }
 
-template <typename K, typename V, typename Alloc>
-V &ky_map<K, V, Alloc>::first()
+template <typename K, typename V, typename Alloc, typename Compare>
+V &ky_map<K, V, Alloc, Compare>::first()
 {
     return *begin();
 }
-template <typename K, typename V, typename Alloc>
-const V &ky_map<K, V, Alloc>::first()const
+template <typename K, typename V, typename Alloc, typename Compare>
+const V &ky_map<K, V, Alloc, Compare>::first()const
 {
     return *cbegin();
 }
 
-template <typename K, typename V, typename Alloc>
-V &ky_map<K, V, Alloc>::last()
+template <typename K, typename V, typename Alloc, typename Compare>
+V &ky_map<K, V, Alloc, Compare>::last()
 {
     return *(--end());
 }
-template <typename K, typename V, typename Alloc>
-const V &ky_map<K, V, Alloc>::last()const
+template <typename K, typename V, typename Alloc, typename Compare>
+const V &ky_map<K, V, Alloc, Compare>::last()const
 {
     return *(--cend());
 }
 
 
-template <typename K, typename V, typename Alloc>
-size_t ky_map<K, V, Alloc>::count()const
+template <typename K, typename V, typename Alloc, typename Compare>
+size_t ky_map<K, V, Alloc, Compare>::count()const
 {
     return impl->count;
 }
-template <typename K, typename V, typename Alloc>
-bool ky_map<K, V, Alloc>::is_empty()const
+template <typename K, typename V, typename Alloc, typename Compare>
+bool ky_map<K, V, Alloc, Compare>::is_empty()const
 {
     return impl->count == 0;
 }
-template <typename K, typename V, typename Alloc>
-bool ky_map<K, V, Alloc>::is_null()const
+template <typename K, typename V, typename Alloc, typename Compare>
+bool ky_map<K, V, Alloc, Compare>::is_null()const
 {
-    return ky_mapdata<K, V, Alloc>::is_null((intptr)impl) ;
+    return ky_mapdata<K, V, Alloc, Compare>::is_null((intptr)impl) ;
 }
 #endif // ky_MAP_INL
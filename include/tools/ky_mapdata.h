@@ -4,6 +4,7 @@
 #include "ky_define.h"
 #include "ky_typeinfo.h"
 #include "ky_memory.h"
+#include "ky_algorlthm.h"
 
 #define rb_parent(r)   ((r)->parent)
 #define rb_color(r) ((r)->color)
@@ -90,7 +91,8 @@ struct ky_treedata : ky_ref
 
  };
 
-template <typename KeyT, typename ValT, typename Alloc = ky_mapalloc >
+template <typename KeyT, typename ValT, typename Alloc = ky_mapalloc,
+          typename Compare = ky_less<KeyT> >
 struct ky_mapdata : public ky_treedata
 {
     typedef ky_nodemap<KeyT, ValT> node;
@@ -103,13 +105,50 @@ struct ky_mapdata : public ky_treedata
     inline const_node *begin() const { if (root()) return (const_node*)most_left; return end();}
     inline node *begin() { if (root()) return (node *)most_left; return end();}
 
+    //! 键比较，a排在b之前时返回true
+    static inline bool less(const KeyT &a, const KeyT &b) {return Compare()(a, b);}
+
+    //! 第一个不排在key之前的节点，没有时返回end()
+    node *lower_bound(const KeyT &key)const
+    {
+        node *tn = root();
+        node *lb = (node *)end();
+        while (tn != NULL)
+        {
+            if (!less(tn->key, key))
+            {
+                lb = tn;
+                tn = tn->left();
+            }
+            else
+                tn = tn->right();
+        }
+        return lb;
+    }
+    //! 第一个排在key之后的节点，没有时返回end()
+    node *upper_bound(const KeyT &key)const
+    {
+        node *tn = root();
+        node *ub = (node *)end();
+        while (tn != NULL)
+        {
+            if (less(key, tn->key))
+            {
+                ub = tn;
+                tn = tn->left();
+            }
+            else
+                tn = tn->right();
+        }
+        return ub;
+    }
+    //! 从根节点二分下降查找key，没有时返回0
     node *find (const KeyT &key)const
     {
-        node* tn = (node*)begin();
-
-        forever (tn != end() && tn->key != key)
-            tn = tn->next ();
-        return tn == end() ? 0 : tn;
+        node *lb = lower_bound(key);
+        if (lb == end() || less(key, lb->key))
+            return 0;
+        return lb;
     }
 
     node *newnode(const KeyT &k, const ValT &v, node *parent = 0, bool left = false)
@@ -134,6 +173,51 @@ struct ky_mapdata : public ky_treedata
         destroy_rebalance<Alloc>(z, staticAlloc);
     }
 
+    //!
+    //! \brief build 按中序从src取n个键值，直接建立平衡的红黑树，不做旋转
+    //! \note 中位数为根递归建立，只有最深一层的节点为红色，数据必须为空
+    //!       src 提供 key()、value()、next()
+    //!
+    template <typename Src>
+    void build(Src &src, size_t n)
+    {
+        int red = 0;
+        for (size_t m = n; m > 1; m >>= 1)
+            ++red;
+        node *rot = build(src, n, 0, red);
+        header.lchild = rot;
+        most_left = &header;
+        if (rot)
+        {
+            rot->parent = &header;
+            while (most_left->lchild)
+                most_left = most_left->lchild;
+        }
+    }
+    template <typename Src>
+    node *build(Src &src, size_t n, int depth, int red)
+    {
+        if (n == 0)
+            return 0;
+        const size_t nl = (n - 1) / 2;
+        node *l = build(src, nl, depth + 1, red);
+        node *x = newnode(src.key(), src.value());
+        src.next();
+        node *r = build(src, n - 1 - nl, depth + 1, red);
+
+        x->lchild = l;
+        x->rchild = r;
+        if (l)
+            rb_set_parent(l, x);
+        if (r)
+            rb_set_parent(r, x);
+        if (depth > 0 && depth == red)
+            rb_set_red(x);
+        else
+            rb_set_black(x);
+        return x;
+    }
+
     static ky_mapdata *create()
     {
         return (ky_mapdata *)ky_treedata::create_data<Alloc>(staticAlloc);
@@ -150,8 +234,8 @@ struct ky_mapdata : public ky_treedata
 
     static Alloc staticAlloc;
 };
-template <typename KeyT, typename ValT, typename Alloc >
-Alloc ky_mapdata<KeyT, ValT, Alloc>::staticAlloc;
+template <typename KeyT, typename ValT, typename Alloc, typename Compare>
+Alloc ky_mapdata<KeyT, ValT, Alloc, Compare>::staticAlloc;
 
 // hash map
 
@@ -9,7 +9,7 @@
  *
  * @author   kunyang
  * @email    kunyang.yk@gmail.com
- * @version  1.0.1.1
+ * @version  1.0.1.2
  * @date     2013/05/01
  * @license  GNU General Public License (GPL)
  *
@@ -19,6 +19,7 @@
  * 2014/01/10 | 1.0.0.2   | kunyang  | 加入快速评估加速指令的选择
  * 2014/02/20 | 1.0.1.0   | kunyang  | 建立ky_alloc
  * 2018/03/10 | 1.0.1.1   | kunyang  | 加入内存增长计算
+ * 2026/10/18 | 1.0.1.2   | kunyang  | ky_alloc加入带大小的destroy
  *
  */
 
@@ -53,6 +54,11 @@ struct ky_alloc
     {
         kyFree (mem);
     }
+    //! 带大小的归还，节点回收分配器据此分级缓存
+    static void destroy(void *mem, size_t )
+    {
+        kyFree (mem);
+    }
 };
 
 template <typename T>
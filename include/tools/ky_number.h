@@ -0,0 +1,72 @@
+
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_number.h
+ * @brief    数字与文本的快速转换
+ *       1.浮点输出使用Grisu2，输出能精确还原的最短数字
+ *       2.浮点解析使用Eisel-Lemire算法，19位以上有效数字或无法判定舍入时转用strtod
+ *       3.十进制整数解析每次检查并转换8个字符(SWAR)，输出每次查表写2位
+ *       4.ky_stringview、ky_u8string的数字转换使用本模块
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.2
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ * 2026/10/18 | 1.0.0.2   | kunyang  | 增加format_fixed定点输出
+ */
+#ifndef ky_NUMBER_H
+#define ky_NUMBER_H
+
+#include "ky_define.h"
+#include <limits>
+
+#if ((kyArchitecture & kyArch_X86) == kyArch_X86) || \
+    (defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__))
+#define kyNumberSwar 1
+#endif
+
+namespace ky_number
+{
+    //! 输出缓冲至少需要的字节数
+    enum
+    {
+        IntegerSize = 66,   ///< 2进制的64位数及符号
+        RealSize = 32
+    };
+
+    //!
+    //! \brief format 输出为文本，不写结尾的0
+    //! \param radix 2到36
+    //! \return 写出的字符数
+    //!
+    int format(longlong v, char *out, int radix = 10);
+    int format(ulonglong v, char *out, int radix = 10);
+    //! 最短的可还原表示，绝对值小于1e-4或不小于1e15(float为1e6)时使用科学计数法
+    int format(real v, char *out);
+    int format(float v, char *out);
+    //!
+    //! \brief format_fixed 保留precision位小数，结果同printf的%.*f
+    //! \return 写出的字符数；precision大于9、非有限数或v * 10^precision不小于9e18时返回0
+    //!
+    int format_fixed(real v, char *out, int precision);
+
+    //!
+    //! \brief parse 从文本解析，不跳过空白
+    //! \return 使用的字符数，没有数字或整数溢出时返回0
+    //!
+    int parse(const char *s, int n, longlong &v, int radix = 10);
+    int parse(const char *s, int n, ulonglong &v, int radix = 10);
+    //! 接受[+-]digits[.digits][e[+-]digits]及inf、infinity、nan
+    int parse(const char *s, int n, real &v);
+    int parse(const char *s, int n, float &v);
+}
+
+#include "ky_number.inl"
+#endif // ky_NUMBER_H
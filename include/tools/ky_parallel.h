@@ -0,0 +1,143 @@
+
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_parallel.h
+ * @brief    带执行策略的区间算法
+ *       1.seq为顺序执行，simd为可向量化的写法(裸指针区间)，par为线程池并行
+ *       2.算法接受裸指针和ky_vector、ky_array等容器的迭代器
+ *       3.par未指定粒度时，先在调用线程计时处理一小段，按单元素耗时划分任务
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ */
+#ifndef ky_PARALLEL_H
+#define ky_PARALLEL_H
+
+#include "ky_define.h"
+#include "ky_thread_pool.h"
+#include "tools/ky_algorlthm.h"
+
+#if kyCompiler == kyCompiler_GNUC
+#define kySimdLoop _Pragma("GCC ivdep")
+#elif kyCompiler == kyCompiler_CLANG
+#define kySimdLoop _Pragma("clang loop vectorize(enable)")
+#else
+#define kySimdLoop
+#endif
+
+namespace ky_parallel
+{
+    enum
+    {
+        ProbeSize = 256,            ///< 自动粒度时在调用线程计时处理的元素数
+        TaskNs = 50000,             ///< 每个任务的目标耗时(纳秒)
+        MinGrain = 64,              ///< 每个任务的最少元素数
+        OverSplit = 4,              ///< 每个线程平均的任务数，用于负载均衡
+        SimdLanes = 8,              ///< simd归约的独立累加器数
+        SimdBlock = 16,             ///< simd查找时无分支求值的块长度
+        FindStep = 1024             ///< 并行查找时检查提前结束的间隔
+    };
+
+    //! 顺序执行
+    struct sequential_policy {};
+    //! 向量化执行，归约要求运算满足结合律和交换律，查找要求谓词无副作用
+    struct simd_policy {};
+    //! 线程池并行，块内使用simd策略
+    struct parallel_policy
+    {
+        ky_thread_pool *pool;       ///< NULL为进程共享的线程池
+        intptr grain;               ///< 每个任务的元素数，0为自动
+
+        explicit parallel_policy(ky_thread_pool *p = NULL, intptr g = 0):pool(p), grain(g){}
+        ky_thread_pool &executor() const {return pool ? *pool : ky_thread_pool::global ();}
+    };
+
+    static const sequential_policy seq = sequential_policy ();
+    static const simd_policy simd = simd_policy ();
+    static const parallel_policy par = parallel_policy ();
+
+    //!
+    //! \brief for_each 对区间内每个元素调用fn
+    //!
+    template <typename It, typename Fn>
+    void for_each(sequential_policy, It first, It last, Fn fn);
+    template <typename It, typename Fn>
+    void for_each(simd_policy, It first, It last, Fn fn);
+    template <typename It, typename Fn>
+    void for_each(const parallel_policy &policy, It first, It last, Fn fn);
+
+    //!
+    //! \brief transform 将op(*first)写到out，返回输出的结束位置
+    //!
+    template <typename It, typename Out, typename Op>
+    Out transform(sequential_policy, It first, It last, Out out, Op op);
+    template <typename It, typename Out, typename Op>
+    Out transform(simd_policy, It first, It last, Out out, Op op);
+    template <typename It, typename Out, typename Op>
+    Out transform(const parallel_policy &policy, It first, It last, Out out, Op op);
+
+    //!
+    //! \brief reduce 以op归约区间，init参与一次
+    //! \note simd、par策略会改变运算次序，op须满足结合律和交换律
+    //!
+    template <typename It, typename V, typename Op>
+    V reduce(sequential_policy, It first, It last, V init, Op op);
+    template <typename It, typename V, typename Op>
+    V reduce(simd_policy, It first, It last, V init, Op op);
+    template <typename It, typename V, typename Op>
+    V reduce(const parallel_policy &policy, It first, It last, V init, Op op);
+
+    //!
+    //! \brief inclusive_scan 前缀归约，out[i] = op(in[0..i])，out可与first相同
+    //! \note par策略要求op满足结合律；前缀有依赖，simd策略与顺序执行相同
+    //!
+    template <typename It, typename Out, typename Op>
+    Out inclusive_scan(sequential_policy, It first, It last, Out out, Op op);
+    template <typename It, typename Out, typename Op>
+    Out inclusive_scan(simd_policy, It first, It last, Out out, Op op);
+    template <typename It, typename Out, typename Op>
+    Out inclusive_scan(const parallel_policy &policy, It first, It last, Out out, Op op);
+
+    //!
+    //! \brief find_if 返回第一个满足pred的位置，没有时返回last
+    //!
+    template <typename It, typename Pred>
+    It find_if(sequential_policy, It first, It last, Pred pred);
+    template <typename It, typename Pred>
+    It find_if(simd_policy, It first, It last, Pred pred);
+    template <typename It, typename Pred>
+    It find_if(const parallel_policy &policy, It first, It last, Pred pred);
+
+    //!
+    //! \brief count_if 满足pred的元素数
+    //!
+    template <typename It, typename Pred>
+    size_t count_if(sequential_policy, It first, It last, Pred pred);
+    template <typename It, typename Pred>
+    size_t count_if(simd_policy, It first, It last, Pred pred);
+    template <typename It, typename Pred>
+    size_t count_if(const parallel_policy &policy, It first, It last, Pred pred);
+
+    //!
+    //! \brief partition 满足pred的元素移到前面(不稳定)，返回分界位置
+    //! \note 元素交换依赖数据，simd策略与顺序执行相同
+    //!
+    template <typename It, typename Pred>
+    It partition(sequential_policy, It first, It last, Pred pred);
+    template <typename It, typename Pred>
+    It partition(simd_policy, It first, It last, Pred pred);
+    template <typename It, typename Pred>
+    It partition(const parallel_policy &policy, It first, It last, Pred pred);
+}
+
+#include "ky_parallel.inl"
+#endif // ky_PARALLEL_H
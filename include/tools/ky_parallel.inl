@@ -0,0 +1,742 @@
+#ifndef KY_PARALLEL_INL
+#define KY_PARALLEL_INL
+
+namespace ky_parallel {
+
+//! 单调时钟(纳秒)，用于自动粒度
+inline uint64 _now_ns_()
+{
+#ifdef kyHasClockGetTime
+    timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (uint64)ts.tv_sec * 1000000000ull + (uint64)ts.tv_nsec;
+#else
+    return (uint64)clock () * (1000000000ull / CLOCKS_PER_SEC);
+#endif
+}
+
+//! 任务划分，[0, begin)已在调用线程处理
+struct _plan_
+{
+    intptr begin;
+    intptr chunk;
+    int tasks;
+};
+
+//!
+//! \brief _plan_of_ 划分n个元素
+//! \param probe probe(lo, hi)在调用线程顺序处理[lo, hi)，只在自动粒度时调用
+//! \param consumed probe处理过的元素是否不再需要并行处理
+//!
+template <typename Probe>
+_plan_ _plan_of_(const parallel_policy &policy, intptr n, Probe &probe, bool consumed = true)
+{
+    _plan_ plan;
+    plan.begin = 0;
+    plan.chunk = n;
+    plan.tasks = 0;
+
+    intptr grain = policy.grain;
+    if (grain <= 0)
+    {
+        // 按单元素耗时取粒度，使每个任务约TaskNs，调度开销可以忽略
+        const intptr m = n < (intptr)ProbeSize ? n : (intptr)ProbeSize;
+        const uint64 t0 = _now_ns_ ();
+        probe (0, m);
+        const uint64 dt = _now_ns_ () - t0;
+        if (consumed)
+            plan.begin = m;
+        grain = dt > 0 ? (intptr)((uint64)TaskNs * (uint64)m / dt) : n;
+    }
+    if (grain < (intptr)MinGrain)
+        grain = MinGrain;
+
+    const intptr rest = n - plan.begin;
+    if (rest <= 0)
+        return plan;
+
+    const int concurrency = policy.executor ().concurrency ();
+    intptr tasks = rest / grain;
+    if (tasks < 1 || concurrency == 1)
+        tasks = 1;
+    if (tasks > (intptr)concurrency * OverSplit)
+        tasks = (intptr)concurrency * OverSplit;
+    plan.chunk = (rest + tasks - 1) / tasks;
+    plan.tasks = (int)((rest + plan.chunk - 1) / plan.chunk);
+    return plan;
+}
+
+//! 以job.run(lo, hi, i)执行plan中的第i个任务
+template <typename Job>
+struct _driver_
+{
+    Job *job;
+    _plan_ plan;
+    intptr n;
+
+    static void task(void *arg, int i)
+    {
+        _driver_ *d = (_driver_ *)arg;
+        const intptr lo = d->plan.begin + (intptr)i * d->plan.chunk;
+        const intptr hi = lo + d->plan.chunk < d->n ? lo + d->plan.chunk : d->n;
+        d->job->run (lo, hi, i);
+    }
+};
+
+template <typename Job>
+void _dispatch_(const parallel_policy &policy, intptr n, const _plan_ &plan, Job &job)
+{
+    if (plan.tasks <= 0)
+        return;
+    _driver_<Job> d;
+    d.job = &job;
+    d.plan = plan;
+    d.n = n;
+    policy.executor ().run (_driver_<Job>::task, &d, plan.tasks);
+}
+
+// for_each
+
+template <typename It, typename Fn>
+inline void _simd_for_each_(It first, It last, Fn &fn)
+{
+    for (; first != last; ++first)
+        fn (*first);
+}
+template <typename T, typename Fn>
+inline void _simd_for_each_(T *first, T *last, Fn &fn)
+{
+    const intptr n = last - first;
+    kySimdLoop
+    for (intptr i = 0; i < n; ++i)
+        fn (first[i]);
+}
+
+template <typename It, typename Fn>
+struct _for_each_job_
+{
+    It first;
+    Fn fn;
+    void operator ()(intptr lo, intptr hi) {_simd_for_each_ (first + lo, first + hi, fn);}
+    void run(intptr lo, intptr hi, int ) {(*this)(lo, hi);}
+};
+
+template <typename It, typename Fn>
+void for_each(sequential_policy, It first, It last, Fn fn)
+{
+    for (; first != last; ++first)
+        fn (*first);
+}
+
+template <typename It, typename Fn>
+void for_each(simd_policy, It first, It last, Fn fn)
+{
+    _simd_for_each_ (first, last, fn);
+}
+
+template <typename It, typename Fn>
+void for_each(const parallel_policy &policy, It first, It last, Fn fn)
+{
+    const intptr n = last - first;
+    _for_each_job_<It, Fn> job = {first, fn};
+    const _plan_ plan = _plan_of_ (policy, n, job);
+    _dispatch_ (policy, n, plan, job);
+}
+
+// transform
+
+template <typename It, typename Out, typename Op>
+inline Out _simd_transform_(It first, It last, Out out, Op &op)
+{
+    for (; first != last; ++first, ++out)
+        *out = op (*first);
+    return out;
+}
+template <typename T, typename U, typename Op>
+inline U *_simd_transform_(T *first, T *last, U *out, Op &op)
+{
+    const intptr n = last - first;
+    kySimdLoop
+    for (intptr i = 0; i < n; ++i)
+        out[i] = op (first[i]);
+    return out + n;
+}
+
+template <typename It, typename Out, typename Op>
+struct _transform_job_
+{
+    It first;
+    Out out;
+    Op op;
+    void operator ()(intptr lo, intptr hi) {_simd_transform_ (first + lo, first + hi, out + lo, op);}
+    void run(intptr lo, intptr hi, int ) {(*this)(lo, hi);}
+};
+
+template <typename It, typename Out, typename Op>
+Out transform(sequential_policy, It first, It last, Out out, Op op)
+{
+    for (; first != last; ++first, ++out)
+        *out = op (*first);
+    return out;
+}
+
+template <typename It, typename Out, typename Op>
+Out transform(simd_policy, It first, It last, Out out, Op op)
+{
+    return _simd_transform_ (first, last, out, op);
+}
+
+template <typename It, typename Out, typename Op>
+Out transform(const parallel_policy &policy, It first, It last, Out out, Op op)
+{
+    const intptr n = last - first;
+    _transform_job_<It, Out, Op> job = {first, out, op};
+    const _plan_ plan = _plan_of_ (policy, n, job);
+    _dispatch_ (policy, n, plan, job);
+    return out + n;
+}
+
+// reduce
+
+template <typename It, typename V, typename Op>
+inline V _simd_reduce_(It first, It last, V init, Op &op)
+{
+    for (; first != last; ++first)
+        init = op (init, *first);
+    return init;
+}
+template <typename T, typename V, typename Op>
+V _simd_reduce_(T *first, T *last, V init, Op &op)
+{
+    const intptr n = last - first;
+    if (n < 2 * (intptr)SimdLanes)
+        return _simd_reduce_<T *, V, Op> (first, last, init, op);
+
+    // 多个独立累加器消除相邻迭代间的依赖，编译器可以映射到向量寄存器
+    V acc[SimdLanes] = {V(first[0]), V(first[1]), V(first[2]), V(first[3]),
+                        V(first[4]), V(first[5]), V(first[6]), V(first[7])};
+    intptr i = SimdLanes;
+    for (; i + SimdLanes <= n; i += SimdLanes)
+    {
+        kySimdLoop
+        for (int k = 0; k < SimdLanes; ++k)
+            acc[k] = op (acc[k], first[i + k]);
+    }
+    for (int w = SimdLanes / 2; w > 0; w /= 2)
+        for (int k = 0; k < w; ++k)
+            acc[k] = op (acc[k], acc[k + w]);
+
+    init = op (init, acc[0]);
+    for (; i < n; ++i)
+        init = op (init, first[i]);
+    return init;
+}
+
+//! 非空区间的归约，以首元素为初值
+template <typename It, typename V, typename Op>
+inline V _reduce_part_(It first, intptr count, Op &op)
+{
+    It next = first;
+    ++next;
+    return _simd_reduce_ (next, first + count, V(*first), op);
+}
+
+template <typename It, typename V, typename Op>
+struct _reduce_job_
+{
+    It first;
+    Op op;
+    V *head;        ///< 调用线程计时处理的部分
+    V *part;        ///< 每个任务的部分结果
+    void operator ()(intptr lo, intptr hi)
+    {
+        if (lo < hi)
+            new (head) V(_reduce_part_<It, V, Op> (first + lo, hi - lo, op));
+    }
+    void run(intptr lo, intptr hi, int i)
+    {
+        new (part + i) V(_reduce_part_<It, V, Op> (first + lo, hi - lo, op));
+    }
+};
+
+template <typename It, typename V, typename Op>
+V reduce(sequential_policy, It first, It last, V init, Op op)
+{
+    for (; first != last; ++first)
+        init = op (init, *first);
+    return init;
+}
+
+template <typename It, typename V, typename Op>
+V reduce(simd_policy, It first, It last, V init, Op op)
+{
+    return _simd_reduce_ (first, last, init, op);
+}
+
+template <typename It, typename V, typename Op>
+V reduce(const parallel_policy &policy, It first, It last, V init, Op op)
+{
+    const intptr n = last - first;
+    if (n <= 0)
+        return init;
+
+    V *head = (V*)kyMalloc (sizeof(V));
+    _reduce_job_<It, V, Op> job = {first, op, head, NULL};
+    const _plan_ plan = _plan_of_ (policy, n, job);
+    if (plan.begin > 0)
+    {
+        init = op (init, *head);
+        head->~V();
+    }
+    kyFree (head);
+
+    if (plan.tasks > 0)
+    {
+        job.part = (V*)kyMalloc (sizeof(V) * plan.tasks);
+        _dispatch_ (policy, n, plan, job);
+        // 部分结果按区间次序合并
+        for (int i = 0; i < plan.tasks; ++i)
+        {
+            init = op (init, job.part[i]);
+            job.part[i].~V();
+        }
+        kyFree (job.part);
+    }
+    return init;
+}
+
+// inclusive_scan
+
+//! 顺序前缀归约，carry非空时作为区间之前的累计值
+template <typename It, typename Out, typename Op, typename V>
+Out _scan_(It first, It last, Out out, Op &op, const V *carry)
+{
+    if (first == last)
+        return out;
+    V acc(carry ? op (*carry, *first) : V(*first));
+    *out = acc;
+    for (++first, ++out; first != last; ++first, ++out)
+    {
+        acc = op (acc, *first);
+        *out = acc;
+    }
+    return out;
+}
+
+//! 非空区间的顺序归约，保持次序，只要求结合律
+template <typename It, typename V, typename Op>
+V _fold_(It first, It last, Op &op)
+{
+    V acc(*first);
+    for (++first; first != last; ++first)
+        acc = op (acc, *first);
+    return acc;
+}
+
+template <typename It, typename Out, typename Op, typename V>
+struct _scan_job_
+{
+    It first;
+    Out out;
+    Op op;
+    V *part;            ///< 第一遍为每块的归约，之后改为每块之前的累计值
+    bool has_head;      ///< 调用线程已处理区间开头，第一块也有累计值
+    bool second;
+
+    void operator ()(intptr lo, intptr hi)
+    {
+        _scan_ (first + lo, first + hi, out + lo, op, (const V *)NULL);
+    }
+    void run(intptr lo, intptr hi, int i)
+    {
+        if (!second)
+            new (part + i) V(_fold_<It, V, Op> (first + lo, first + hi, op));
+        else
+            _scan_ (first + lo, first + hi, out + lo, op, (i > 0 || has_head) ? part + i : (const V *)NULL);
+    }
+};
+
+template <typename It, typename Out, typename Op, typename V>
+Out _parallel_scan_(const parallel_policy &policy, It first, It last, Out out, Op &op, V *)
+{
+    const intptr n = last - first;
+    _scan_job_<It, Out, Op, V> job = {first, out, op, NULL, false, false};
+    const _plan_ plan = _plan_of_ (policy, n, job);
+    if (plan.tasks <= 0)
+        return out + n;
+
+    // 各块先归约，再顺序求块前累计值，最后各块带累计值扫描
+    job.part = (V*)kyMalloc (sizeof(V) * plan.tasks);
+    job.has_head = plan.begin > 0;
+    _dispatch_ (policy, n, plan, job);
+
+    Out tail = out + (plan.begin - 1);
+    V carry(job.has_head ? V(*tail) : V(job.part[0]));
+    for (int i = job.has_head ? 0 : 1; i < plan.tasks; ++i)
+    {
+        V sum(job.part[i]);
+        job.part[i] = carry;
+        carry = op (carry, sum);
+    }
+    job.second = true;
+    _dispatch_ (policy, n, plan, job);
+
+    for (int i = 0; i < plan.tasks; ++i)
+        job.part[i].~V();
+    kyFree (job.part);
+    return out + n;
+}
+
+template <typename It, typename Out, typename Op, typename V>
+inline Out _sequential_scan_(It first, It last, Out out, Op &op, V *)
+{
+    return _scan_ (first, last, out, op, (const V *)NULL);
+}
+
+template <typename It, typename Out, typename Op>
+Out inclusive_scan(sequential_policy, It first, It last, Out out, Op op)
+{
+    if (first == last)
+        return out;
+    return _sequential_scan_ (first, last, out, op, &*first);
+}
+
+template <typename It, typename Out, typename Op>
+Out inclusive_scan(simd_policy, It first, It last, Out out, Op op)
+{
+    return inclusive_scan (seq, first, last, out, op);
+}
+
+template <typename It, typename Out, typename Op>
+Out inclusive_scan(const parallel_policy &policy, It first, It last, Out out, Op op)
+{
+    if (first == last)
+        return out;
+    return _parallel_scan_ (policy, first, last, out, op, &*first);
+}
+
+// find_if
+
+template <typename It, typename Pred>
+inline It _simd_find_if_(It first, It last, Pred &pred)
+{
+    for (; first != last; ++first)
+        if (pred (*first))
+            break;
+    return first;
+}
+template <typename T, typename Pred>
+T *_simd_find_if_(T *first, T *last, Pred &pred)
+{
+    // 整块无分支求值成位掩码，块内有命中时再定位
+    for (; last - first >= (intptr)SimdBlock; first += SimdBlock)
+    {
+        uint mask = 0;
+        for (int k = 0; k < SimdBlock; ++k)
+            mask |= (uint)(pred (first[k]) ? 1 : 0) << k;
+        if (mask)
+        {
+            int k = 0;
+            while (!(mask & (1u << k)))
+                ++k;
+            return first + k;
+        }
+    }
+    for (; first != last; ++first)
+        if (pred (*first))
+            break;
+    return first;
+}
+
+template <typename It, typename Pred>
+struct _find_job_
+{
+    It first;
+    Pred pred;
+    ky_atomic<int64> found;     ///< 已找到的最小位置，未找到为n
+
+    _find_job_(It f, Pred p, intptr n):first(f), pred(p){found = n;}
+
+    //! 更新为更小的命中位置
+    void hit(intptr pos)
+    {
+        for (int64 cur = found.load (Fence_Acquire); pos < cur; cur = found.load (Fence_Acquire))
+            if (found.compare_exchange (cur, pos))
+                break;
+    }
+    void operator ()(intptr lo, intptr hi) {run (lo, hi, 0);}
+    void run(intptr lo, intptr hi, int )
+    {
+        // 分段查找，前面的块已命中时放弃剩余部分
+        for (intptr s = lo; s < hi; s += FindStep)
+        {
+            if (found.load (Fence_Acquire) <= s)
+                return;
+            const intptr e = s + FindStep < hi ? s + FindStep : hi;
+            It base = first + s;
+            It end = first + e;
+            It at = _simd_find_if_ (base, end, pred);
+            if (at != end)
+            {
+                hit (s + (at - base));
+                return;
+            }
+        }
+    }
+};
+
+template <typename It, typename Pred>
+It find_if(sequential_policy, It first, It last, Pred pred)
+{
+    for (; first != last; ++first)
+        if (pred (*first))
+            break;
+    return first;
+}
+
+template <typename It, typename Pred>
+It find_if(simd_policy, It first, It last, Pred pred)
+{
+    return _simd_find_if_ (first, last, pred);
+}
+
+template <typename It, typename Pred>
+It find_if(const parallel_policy &policy, It first, It last, Pred pred)
+{
+    const intptr n = last - first;
+    _find_job_<It, Pred> job(first, pred, n);
+    const _plan_ plan = _plan_of_ (policy, n, job);
+    if (job.found.load (Fence_Acquire) == n)
+        _dispatch_ (policy, n, plan, job);
+    return first + (intptr)job.found.load (Fence_Acquire);
+}
+
+// count_if
+
+template <typename It, typename Pred>
+inline size_t _simd_count_if_(It first, It last, Pred &pred)
+{
+    size_t c = 0;
+    for (; first != last; ++first)
+        if (pred (*first))
+            ++c;
+    return c;
+}
+template <typename T, typename Pred>
+inline size_t _simd_count_if_(T *first, T *last, Pred &pred)
+{
+    const intptr n = last - first;
+    size_t c = 0;
+    kySimdLoop
+    for (intptr i = 0; i < n; ++i)
+        c += pred (first[i]) ? 1 : 0;
+    return c;
+}
+
+template <typename It, typename Pred>
+struct _count_job_
+{
+    It first;
+    Pred pred;
+    size_t head;
+    size_t *part;
+    void operator ()(intptr lo, intptr hi) {head = _simd_count_if_ (first + lo, first + hi, pred);}
+    void run(intptr lo, intptr hi, int i) {part[i] = _simd_count_if_ (first + lo, first + hi, pred);}
+};
+
+template <typename It, typename Pred>
+size_t count_if(sequential_policy, It first, It last, Pred pred)
+{
+    size_t c = 0;
+    for (; first != last; ++first)
+        if (pred (*first))
+            ++c;
+    return c;
+}
+
+template <typename It, typename Pred>
+size_t count_if(simd_policy, It first, It last, Pred pred)
+{
+    return _simd_count_if_ (first, last, pred);
+}
+
+template <typename It, typename Pred>
+size_t count_if(const parallel_policy &policy, It first, It last, Pred pred)
+{
+    const intptr n = last - first;
+    _count_job_<It, Pred> job = {first, pred, 0, NULL};
+    const _plan_ plan = _plan_of_ (policy, n, job);
+    size_t c = job.head;
+    if (plan.tasks > 0)
+    {
+        job.part = (size_t*)kyMalloc (sizeof(size_t) * plan.tasks);
+        _dispatch_ (policy, n, plan, job);
+        for (int i = 0; i < plan.tasks; ++i)
+            c += job.part[i];
+        kyFree (job.part);
+    }
+    return c;
+}
+
+// partition
+
+template <typename It, typename Pred>
+It _partition_(It first, It last, Pred &pred)
+{
+    for (;;)
+    {
+        for (;; ++first)
+        {
+            if (first == last)
+                return first;
+            if (!pred (*first))
+                break;
+        }
+        for (;;)
+        {
+            --last;
+            if (first == last)
+                return first;
+            if (pred (*last))
+                break;
+        }
+        __sort__::exchange (*first, *last);
+        ++first;
+    }
+}
+
+//!
+//! \brief The _partition_job_ struct 并行划分
+//! \note 各块先就地划分并统计满足个数t，总数为T；[0,T)中不满足的元素与
+//!       [T,n)中满足的元素个数相同，按次序一一交换即完成划分
+//!
+template <typename It, typename Pred>
+struct _partition_job_
+{
+    It first;
+    Pred pred;
+    intptr total;
+    intptr *trues;          ///< 每块满足的个数
+    // 错位区间：每块一个，按块次序编号，fc、tc为之前的累计长度
+    intptr *fb, *fe, *fc;
+    intptr *tb, *te, *tc;
+    int chunks;
+    intptr per;             ///< 交换阶段每个任务的交换数
+    bool second;
+
+    _partition_job_(It f, Pred p):first(f), pred(p), second(false){}
+    void operator ()(intptr lo, intptr hi) {_simd_count_if_ (first + lo, first + hi, pred);}
+
+    static int locate(const intptr *c, int chunks, intptr k)
+    {
+        int i = 0;
+        while (i + 1 < chunks && c[i + 1] <= k)
+            ++i;
+        return i;
+    }
+    void exchange_range(intptr a, intptr b)
+    {
+        int fi = locate (fc, chunks, a);
+        int ti = locate (tc, chunks, a);
+        intptr fp = fb[fi] + (a - fc[fi]);
+        intptr tp = tb[ti] + (a - tc[ti]);
+        for (intptr k = a; k < b; ++k, ++fp, ++tp)
+        {
+            while (fp >= fe[fi])
+                fp = fb[++fi];
+            while (tp >= te[ti])
+                tp = tb[++ti];
+            __sort__::exchange (*(first + fp), *(first + tp));
+        }
+    }
+    void run(intptr lo, intptr hi, int i)
+    {
+        if (!second)
+        {
+            const It b = first + lo;
+            trues[i] = _partition_ (b, first + hi, pred) - b;
+        }
+        else
+        {
+            const intptr a = (intptr)i * per;
+            const intptr e = a + per < fc[chunks] ? a + per : fc[chunks];
+            if (a < e)
+                exchange_range (a, e);
+        }
+    }
+};
+
+template <typename It, typename Pred>
+It partition(sequential_policy, It first, It last, Pred pred)
+{
+    return _partition_ (first, last, pred);
+}
+
+template <typename It, typename Pred>
+It partition(simd_policy, It first, It last, Pred pred)
+{
+    return _partition_ (first, last, pred);
+}
+
+template <typename It, typename Pred>
+It partition(const parallel_policy &policy, It first, It last, Pred pred)
+{
+    const intptr n = last - first;
+    _partition_job_<It, Pred> job(first, pred);
+    // 计时只统计不移动，所有元素都参与分块划分
+    const _plan_ plan = _plan_of_ (policy, n, job, false);
+    if (plan.tasks <= 1)
+        return _partition_ (first, last, pred);
+
+    const int chunks = plan.tasks;
+    intptr *mem = (intptr*)kyMalloc (sizeof(intptr) * (7 * chunks + 2));
+    job.chunks = chunks;
+    job.trues = mem;
+    job.fb = mem + chunks;
+    job.fe = job.fb + chunks;
+    job.tb = job.fe + chunks;
+    job.te = job.tb + chunks;
+    job.fc = job.te + chunks;
+    job.tc = job.fc + chunks + 1;
+    _dispatch_ (policy, n, plan, job);
+
+    job.total = 0;
+    for (int i = 0; i < chunks; ++i)
+        job.total += job.trues[i];
+
+    const intptr T = job.total;
+    intptr fsum = 0;
+    intptr tsum = 0;
+    for (int i = 0; i < chunks; ++i)
+    {
+        const intptr lo = (intptr)i * plan.chunk;
+        const intptr hi = lo + plan.chunk < n ? lo + plan.chunk : n;
+        const intptr mid = lo + job.trues[i];
+        // [0,T)内不满足的部分，[T,n)内满足的部分
+        job.fb[i] = mid;
+        job.fe[i] = ky_max (mid, ky_min (hi, T));
+        job.tb[i] = ky_max (lo, T);
+        job.te[i] = ky_max (job.tb[i], mid);
+        job.fc[i] = fsum;
+        job.tc[i] = tsum;
+        fsum += job.fe[i] - job.fb[i];
+        tsum += job.te[i] - job.tb[i];
+    }
+    job.fc[chunks] = fsum;
+
+    if (fsum > 0)
+    {
+        const int tasks = chunks;
+        job.per = (fsum + tasks - 1) / tasks;
+        job.second = true;
+        _plan_ swap_plan = plan;
+        swap_plan.tasks = (int)((fsum + job.per - 1) / job.per);
+        _dispatch_ (policy, n, swap_plan, job);
+    }
+    kyFree (mem);
+    return first + T;
+}
+
+}
+
+#endif // KY_PARALLEL_INL
@@ -29,6 +29,7 @@
 #include "ky_ptr.h"
 #include "ky_map.h"
 #include "ky_uuid.h"
+#include "ky_atom.h"
 
  static const char* const aParserExtHeader = "+";
  static const char* const aParserSplitBegin = "[";
@@ -391,6 +392,12 @@ typedef enum
          return (*this).value();
      }
  }tMemerValues;
+ /*!
+  * @brief tParserAtomMemers 以原子串为键的成员
+  *  成员名只驻留一次，之后的查找只比较编号
+  */
+ typedef ky_map<ky_atom, tParserDatas> tParserAtomMemers;
+
  /*!
   * @brief The tParserMemers struct 解析器获取的成员
   * @struct tParserMemers
@@ -425,6 +432,15 @@ typedef enum
          return fack->end();
      }
 
+     //! 转为以原子串为键的成员，重复读取同名成员时使用
+     tParserAtomMemers atoms()const
+     {
+         tParserAtomMemers out;
+         for (ky_map<ky_string, tParserDatas>::const_iterator it = begin(); it != end(); ++it)
+             out.insert (ky_atom(it.key()), it.value());
+         return out;
+     }
+
  private:
      ky_map<ky_string, tParserDatas>::iterator op_value;
  }tParserMemers;
@@ -0,0 +1,263 @@
+
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_persistent_map.h
+ * @brief    持久化(不可变、结构共享)有序映射
+ *       1.AVL树，节点发布后不再修改，修改时只复制根到目标的路径
+ *       2.拷贝(快照)代价为O(1)，每次修改新建O(log n)个节点
+ *       3.节点引用计数为原子操作，旧版本可交给其他线程只读持有
+ *       4.适用于版本化配置和撤销历史
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ */
+#ifndef ky_PERSISTENT_MAP_H
+#define ky_PERSISTENT_MAP_H
+
+#include "ky_define.h"
+#include "ky_atomic.h"
+#include "tools/ky_memory.h"
+#include "tools/ky_algorlthm.h"
+#include "tools/ky_list.h"
+
+//!
+//! \brief The ky_persistent_map class
+//! \note 同一个对象不能同时被多个线程修改；线程间以值传递版本，
+//!       每个线程持有自己的拷贝即可安全读取
+//!
+template <typename K, typename V, typename Alloc = ky_alloc<void>, typename Compare = ky_less<K> >
+class ky_persistent_map : public Alloc
+{
+public:
+    enum
+    {
+        MaxHeight = 96             ///< AVL树高上限(1.44*log2(n)，n < 2^64)
+    };
+
+private:
+    //! 不可变节点，ref为引用此节点的父节点和版本数
+    struct node_t
+    {
+        ky_atomic<int> ref;
+        int height;
+        node_t *left;
+        node_t *right;
+        K key;
+        V val;
+    };
+
+    node_t *root;
+    size_t total;
+
+    static bool less(const K &a, const K &b) {return Compare()(a, b);}
+    static int height(const node_t *n) {return n ? n->height : 0;}
+    static node_t *retain(node_t *n) {if (n) n->ref++; return n;}
+
+    //! 以下函数的节点参数均为借用，返回值为新引用
+    node_t *make(const K &key, const V &val, node_t *l, node_t *r);
+    node_t *balance(const K &key, const V &val, node_t *l, node_t *r);
+    node_t *insert(node_t *n, const K &key, const V &val, bool &added);
+    node_t *erase(node_t *n, const K &key, bool &removed);
+    node_t *erase_min(node_t *n, const node_t *&min);
+    void release(node_t *n);
+
+public:
+    class const_iterator;
+    typedef const_iterator iterator;
+
+    /// STL style
+public:
+    ky_persistent_map():root(NULL), total(0){}
+    //! O(1)快照，只增加根节点引用
+    ky_persistent_map(const ky_persistent_map &rhs):root(retain (rhs.root)), total(rhs.total){}
+    ~ky_persistent_map()
+    {
+        release (root);
+    }
+
+    ky_persistent_map &operator = (const ky_persistent_map &rhs);
+
+    const_iterator begin() const;
+    const_iterator end() const {return const_iterator();}
+
+    //!
+    //! \brief find 查找key并返回一个迭代器
+    //! \param key
+    //! \return
+    //!
+    const_iterator find(const K &key) const;
+    //!
+    //! \brief lower_bound 返回第一个不排在key之前的迭代器
+    //! \param key
+    //! \return
+    //!
+    const_iterator lower_bound(const K &key) const;
+    //!
+    //! \brief upper_bound 返回第一个排在key之后的迭代器
+    //! \param key
+    //! \return
+    //!
+    const_iterator upper_bound(const K &key) const;
+
+    //!
+    //! \brief insert 插入key，val，key已存在时修改其值
+    //! \param key
+    //! \param val
+    //! \return 是否为新插入
+    //! \note 只复制根到key的路径，其他版本不受影响
+    //!
+    bool insert(const K& key, const V& val);
+    //!
+    //! \brief erase 擦除key，返回擦除的元素数
+    //! \param key
+    //! \return
+    //!
+    size_t erase(const K& key);
+
+    const V operator [](const K &key)const {return value (key);}
+
+    void swap(ky_persistent_map &rhs)
+    {
+        node_t *tn = root; root = rhs.root; rhs.root = tn;
+        size_t tc = total; total = rhs.total; rhs.total = tc;
+    }
+    friend void ky_swap(ky_persistent_map &a, ky_persistent_map &b) {a.swap (b);}
+    void clear();
+    bool empty() const {return is_empty ();}
+    size_t size() const {return count ();}
+
+#if kyLanguage >= kyLanguage11
+public:
+    ky_persistent_map(ky_persistent_map &&m):root(m.root), total(m.total)
+    {
+        m.root = NULL;
+        m.total = 0;
+    }
+    ky_persistent_map& operator = (ky_persistent_map &&m)
+    {
+        if (this != &m)
+        {
+            release (root);
+            root = m.root;
+            total = m.total;
+            m.root = NULL;
+            m.total = 0;
+        }
+        return *this;
+    }
+    const_iterator cbegin() const {return begin ();}
+    const_iterator cend() const {return end ();}
+#endif
+
+    // base
+public:
+    //!
+    //! \brief with 返回插入key，val后的新版本，本版本不变
+    //! \param key
+    //! \param val
+    //! \return
+    //!
+    ky_persistent_map with(const K& key, const V& val) const
+    {
+        ky_persistent_map out(*this);
+        out.insert (key, val);
+        return out;
+    }
+    //!
+    //! \brief without 返回擦除key后的新版本，本版本不变
+    //! \param key
+    //! \return
+    //!
+    ky_persistent_map without(const K& key) const
+    {
+        ky_persistent_map out(*this);
+        out.erase (key);
+        return out;
+    }
+
+    void append(const K& key, const V& val) {insert (key, val);}
+    void remove(const K& key) {erase (key);}
+    bool contains(const K &key) const {return find (key) != end ();}
+    V value(const K &key, const V &defval = V()) const;
+
+    //!
+    //! \brief keys
+    //! \return 返回map的全部key
+    //!
+    ky_list<K> keys() const;
+    //!
+    //! \brief values
+    //! \return 返回map的全部值
+    //!
+    ky_list<V> values() const;
+
+    size_t count()const {return total;}
+    bool is_empty()const {return total == 0;}
+    //!
+    //! \brief is_same 两个版本是否共享同一棵树(未分叉的快照)
+    //! \param rhs
+    //! \return
+    //!
+    bool is_same(const ky_persistent_map &rhs)const {return root == rhs.root;}
+
+public:
+    //! 中序迭代器，栈中为尚未访问的祖先节点，栈顶为当前节点
+    class const_iterator
+    {
+        friend class ky_persistent_map;
+    private:
+        const node_t *path[MaxHeight];
+        int depth;
+
+        void descend(const node_t *n)
+        {
+            for (; n; n = n->left)
+                path[depth++] = n;
+        }
+    public:
+        const_iterator():depth(0){}
+        const_iterator(const const_iterator &rhs):depth(rhs.depth)
+        {
+            for (int i = 0; i < depth; ++i)
+                path[i] = rhs.path[i];
+        }
+        const_iterator &operator = (const const_iterator &rhs)
+        {
+            depth = rhs.depth;
+            for (int i = 0; i < depth; ++i)
+                path[i] = rhs.path[i];
+            return *this;
+        }
+
+        const K &key() const { return path[depth - 1]->key; }
+        const V &value() const { return path[depth - 1]->val; }
+        const V &operator*() const { return value (); }
+        const V *operator->() const { return &value (); }
+        bool operator==(const const_iterator &o) const
+        {
+            return depth == o.depth && (depth == 0 || path[depth - 1] == o.path[depth - 1]);
+        }
+        bool operator!=(const const_iterator &o) const { return !(*this == o); }
+
+        const_iterator& operator++()
+        {
+            const node_t *n = path[--depth];
+            descend (n->right);
+            return *this;
+        }
+        const_iterator operator++(int){const_iterator tn = *this; ++*this; return tn;}
+    };
+    friend class const_iterator;
+};
+
+#include "ky_persistent_map.inl"
+#endif // ky_PERSISTENT_MAP_H
@@ -0,0 +1,293 @@
+#ifndef KY_PERSISTENT_MAP_INL
+#define KY_PERSISTENT_MAP_INL
+
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_persistent_map<K, V, Alloc, Compare>::node_t *
+ky_persistent_map<K, V, Alloc, Compare>::make(const K &key, const V &val, node_t *l, node_t *r)
+{
+    node_t *n = (node_t *)Alloc::alloc (sizeof(node_t));
+    new (&n->ref) ky_atomic<int>(1);
+    n->height = ky_max (height (l), height (r)) + 1;
+    n->left = retain (l);
+    n->right = retain (r);
+    new (&n->key) K(key);
+    new (&n->val) V(val);
+    return n;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_persistent_map<K, V, Alloc, Compare>::release(node_t *n)
+{
+    // 子树可能仍被其他版本引用，只有引用归零的节点才向下释放
+    // 后置递减返回原值，减与判断为同一次原子操作
+    while (n && n->ref-- == 1)
+    {
+        node_t *r = n->right;
+        release (n->left);
+        n->key.~K();
+        n->val.~V();
+        Alloc::destroy (n);
+        n = r;
+    }
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_persistent_map<K, V, Alloc, Compare>::node_t *
+ky_persistent_map<K, V, Alloc, Compare>::balance(const K &key, const V &val, node_t *l, node_t *r)
+{
+    const int hl = height (l);
+    const int hr = height (r);
+    if (hl > hr + 1)
+    {
+        if (height (l->left) >= height (l->right))
+        {
+            node_t *nr = make (key, val, l->right, r);
+            node_t *out = make (l->key, l->val, l->left, nr);
+            release (nr);
+            return out;
+        }
+        node_t *lr = l->right;
+        node_t *nl = make (l->key, l->val, l->left, lr->left);
+        node_t *nr = make (key, val, lr->right, r);
+        node_t *out = make (lr->key, lr->val, nl, nr);
+        release (nl);
+        release (nr);
+        return out;
+    }
+    if (hr > hl + 1)
+    {
+        if (height (r->right) >= height (r->left))
+        {
+            node_t *nl = make (key, val, l, r->left);
+            node_t *out = make (r->key, r->val, nl, r->right);
+            release (nl);
+            return out;
+        }
+        node_t *rl = r->left;
+        node_t *nl = make (key, val, l, rl->left);
+        node_t *nr = make (r->key, r->val, rl->right, r->right);
+        node_t *out = make (rl->key, rl->val, nl, nr);
+        release (nl);
+        release (nr);
+        return out;
+    }
+    return make (key, val, l, r);
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_persistent_map<K, V, Alloc, Compare>::node_t *
+ky_persistent_map<K, V, Alloc, Compare>::insert(node_t *n, const K &key, const V &val, bool &added)
+{
+    if (n == NULL)
+    {
+        added = true;
+        return make (key, val, NULL, NULL);
+    }
+
+    node_t *sub = NULL;
+    node_t *out = NULL;
+    if (less (key, n->key))
+    {
+        sub = insert (n->left, key, val, added);
+        out = balance (n->key, n->val, sub, n->right);
+    }
+    else if (less (n->key, key))
+    {
+        sub = insert (n->right, key, val, added);
+        out = balance (n->key, n->val, n->left, sub);
+    }
+    else
+        return make (n->key, val, n->left, n->right);
+
+    release (sub);
+    return out;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_persistent_map<K, V, Alloc, Compare>::node_t *
+ky_persistent_map<K, V, Alloc, Compare>::erase_min(node_t *n, const node_t *&min)
+{
+    if (n->left == NULL)
+    {
+        min = n;
+        return retain (n->right);
+    }
+    node_t *sub = erase_min (n->left, min);
+    node_t *out = balance (n->key, n->val, sub, n->right);
+    release (sub);
+    return out;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_persistent_map<K, V, Alloc, Compare>::node_t *
+ky_persistent_map<K, V, Alloc, Compare>::erase(node_t *n, const K &key, bool &removed)
+{
+    if (n == NULL)
+        return NULL;
+
+    node_t *sub = NULL;
+    node_t *out = NULL;
+    if (less (key, n->key))
+    {
+        sub = erase (n->left, key, removed);
+        if (removed)
+            out = balance (n->key, n->val, sub, n->right);
+    }
+    else if (less (n->key, key))
+    {
+        sub = erase (n->right, key, removed);
+        if (removed)
+            out = balance (n->key, n->val, n->left, sub);
+    }
+    else
+    {
+        removed = true;
+        if (n->left == NULL)
+            return retain (n->right);
+        if (n->right == NULL)
+            return retain (n->left);
+        // 以右子树最小节点替换，该节点仍由n->right持有
+        const node_t *min = NULL;
+        sub = erase_min (n->right, min);
+        out = balance (min->key, min->val, n->left, sub);
+    }
+
+    release (sub);
+    return out;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_persistent_map<K, V, Alloc, Compare> &
+ky_persistent_map<K, V, Alloc, Compare>::operator = (const ky_persistent_map &rhs)
+{
+    node_t *nr = retain (rhs.root);
+    release (root);
+    root = nr;
+    total = rhs.total;
+    return *this;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_persistent_map<K, V, Alloc, Compare>::const_iterator
+ky_persistent_map<K, V, Alloc, Compare>::begin() const
+{
+    const_iterator it;
+    it.descend (root);
+    return it;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_persistent_map<K, V, Alloc, Compare>::const_iterator
+ky_persistent_map<K, V, Alloc, Compare>::lower_bound(const K &key) const
+{
+    const_iterator it;
+    for (const node_t *n = root; n; )
+    {
+        if (!less (n->key, key))
+        {
+            it.path[it.depth++] = n;
+            n = n->left;
+        }
+        else
+            n = n->right;
+    }
+    return it;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_persistent_map<K, V, Alloc, Compare>::const_iterator
+ky_persistent_map<K, V, Alloc, Compare>::upper_bound(const K &key) const
+{
+    const_iterator it;
+    for (const node_t *n = root; n; )
+    {
+        if (less (key, n->key))
+        {
+            it.path[it.depth++] = n;
+            n = n->left;
+        }
+        else
+            n = n->right;
+    }
+    return it;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+typename ky_persistent_map<K, V, Alloc, Compare>::const_iterator
+ky_persistent_map<K, V, Alloc, Compare>::find(const K &key) const
+{
+    const_iterator it = lower_bound (key);
+    if (it != end () && less (key, it.key ()))
+        return end ();
+    return it;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+bool ky_persistent_map<K, V, Alloc, Compare>::insert(const K &key, const V &val)
+{
+    bool added = false;
+    node_t *nr = insert (root, key, val, added);
+    release (root);
+    root = nr;
+    if (added)
+        ++total;
+    return added;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+size_t ky_persistent_map<K, V, Alloc, Compare>::erase(const K &key)
+{
+    bool removed = false;
+    node_t *nr = erase (root, key, removed);
+    if (!removed)
+        return 0;
+    release (root);
+    root = nr;
+    --total;
+    return 1;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+void ky_persistent_map<K, V, Alloc, Compare>::clear()
+{
+    release (root);
+    root = NULL;
+    total = 0;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+V ky_persistent_map<K, V, Alloc, Compare>::value(const K &key, const V &defval) const
+{
+    for (const node_t *n = root; n; )
+    {
+        if (less (key, n->key))
+            n = n->left;
+        else if (less (n->key, key))
+            n = n->right;
+        else
+            return n->val;
+    }
+    return defval;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_list<K> ky_persistent_map<K, V, Alloc, Compare>::keys() const
+{
+    ky_list<K> res;
+    res.reserve (count ());
+    for (const_iterator it = begin (); it != end (); ++it)
+        res.append (it.key ());
+    return res;
+}
+
+template <typename K, typename V, typename Alloc, typename Compare>
+ky_list<V> ky_persistent_map<K, V, Alloc, Compare>::values() const
+{
+    ky_list<V> res;
+    res.reserve (count ());
+    for (const_iterator it = begin (); it != end (); ++it)
+        res.append (it.value ());
+    return res;
+}
+
+#endif // KY_PERSISTENT_MAP_INL
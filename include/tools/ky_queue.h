@@ -10,7 +10,7 @@
  *
  * @author   kunyang
  * @email    kunyang.yk@gmail.com
- * @version  1.0.0.1
+ * @version  1.0.2.0
  * @date     2012/01/02
  * @license  GNU General Public License (GPL)
  *
@@ -18,6 +18,7 @@
  *    Date    |  Version  |  Author  |   Description
  * 2012/01/02 | 1.0.0.1   | kunyang  | 创建文件
  * 2012/01/10 | 1.0.1.0   | kunyang  | 加入引用的可共享属性
+ * 2026/10/18 | 1.0.2.0   | kunyang  | 右值入队改为移动，加入emplace
  */
 #ifndef ky_QUEUE
 #define ky_QUEUE
@@ -48,12 +49,18 @@ public:
 
     void push(const T& val) {sequence.push_back (val);}
 #if kyLanguage >= kyLanguage11
-    void push(T && v){sequence.push_back (v);}
+    void push(T && v){sequence.push_back (std::move (v));}
+    template <typename ... Args>
+    T &emplace(Args &&...args){return sequence.emplace_back (std::forward<Args>(args)...);}
 #endif
 
     void remove() {sequence.pop_front ();}
     void clear() {sequence.clear ();}
+#if kyLanguage >= kyLanguage11
+    T pop() {T out = std::move (sequence.front ()); remove (); return out;}
+#else
     T pop() {T out = sequence.front (); remove (); return out;}
+#endif
     size_t size()const {return sequence.size ();}
     size_t count()const {return size();}
 
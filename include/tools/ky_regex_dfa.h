@@ -0,0 +1,133 @@
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_regex_dfa.h
+ * @brief    惰性DFA正则表达式引擎
+ *       ky_regex_dfa 单个模式，ky_regex_set 多个模式一次扫描
+ *       1.模式编译为按UTF-8字节跳转的Thompson NFA，匹配时按需构造DFA状态(惰性DFA)，
+ *         时间与文本长度成线性关系，没有回溯
+ *       2.DFA状态缓存超过预算且频繁清空时，本次匹配转为NFA并行模拟，仍为线性时间
+ *       3.查找取最左的匹配，多个分支按书写顺序优先(同Perl)；先正向找到结束位置，
+ *         再以反向DFA找起始位置
+ *       4.模式以字面串开头时，用ky_search::find(SSE2/AVX2)跳到候选位置
+ *       5.ky_string先转为UTF-8再匹配
+ *       6.ky_regex由预编译库实现，布局不变，可由其模式构造ky_regex_dfa
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ */
+
+#ifndef KY_REGEX_DFA_H
+#define KY_REGEX_DFA_H
+
+#include "ky_regex.h"
+#include "ky_u8string.h"
+#include "ky_search.h"
+#include "ky_thread.h"
+
+/*!
+ * 语法: . [] [^] | () (?:) * + ? {n} {n,} {n,m} 及非贪婪的 *? +? ?? {n,m}?
+ *       ^ $ \A \z \b \B \d \D \w \W \s \S \t \n \r \f \v \xHH \x{H..} \uHHHH
+ *       (?i) (?s) (?i:...) i为ASCII忽略大小写，s为.匹配换行
+ *       不支持反向引用及环视
+ */
+namespace __regex__ {
+struct regex;
+struct regex_set;
+}
+
+class ky_regex_dfa
+{
+public:
+    explicit ky_regex_dfa(const ky_string &re);
+    //! UTF-8的模式
+    explicit ky_regex_dfa(const char *re);
+    //! 取ky_regex的模式重新编译
+    explicit ky_regex_dfa(const ky_regex &re);
+    ~ky_regex_dfa();
+
+    ky_regex_dfa(const ky_regex_dfa &) = delete;
+    void operator = (const ky_regex_dfa &) = delete;
+
+    const ky_string& regex() const;
+    //! 模式有语法错误时为false，此时不匹配任何文本
+    bool is_valid()const;
+
+    //! 整个文本匹配时返回1，否则返回0
+    int match(const ky_string &str) const;
+    //! 依次查找不重叠的匹配，返回匹配数，reustl不为空时追加匹配的文本
+    int search(const ky_string &str, ky_string_list *reustl = 0) const;
+    //! 以匹配为分隔符分割，返回段数，reustl不为空时追加各段；空匹配不分割
+    int split(const ky_string &str, ky_string_list *reustl = 0)const;
+
+    //! UTF-8文本
+    int match(const ky_u8stringview &str) const;
+    int match(const char *str) const{return match (ky_u8stringview(str));}
+    int search(const ky_u8stringview &str, ky_u8string_list *reustl = 0) const;
+    int search(const char *str, ky_u8string_list *reustl = 0) const{return search (ky_u8stringview(str), reustl);}
+    int split(const ky_u8stringview &str, ky_u8string_list *reustl = 0)const;
+    int split(const char *str, ky_u8string_list *reustl = 0)const{return split (ky_u8stringview(str), reustl);}
+
+    //!
+    //! \brief find 在[from, n)中查找最左的匹配
+    //! \param pos 匹配的起始位置
+    //! \param len 匹配的字节数
+    //! \return 没有匹配时返回false
+    //!
+    bool find(const char *s, size_t n, size_t from, size_t &pos, size_t &len)const;
+    //! 是否含有匹配，只做正向扫描
+    bool contains(const char *s, size_t n)const;
+    bool contains(const ky_u8stringview &str)const{return contains (str.data (), str.length ());}
+
+private:
+    __regex__::regex *impl;
+};
+
+/*!
+ * @brief The ky_regex_set class 多个模式一次扫描
+ * @class ky_regex_set
+ *  全部模式合并为一个自动机，扫描一遍文本即得到在文本中任意位置有匹配的模式
+ *  append全部模式后compile，compile后可多线程共用
+ */
+class ky_regex_set
+{
+public:
+    ky_regex_set();
+    ~ky_regex_set();
+
+    ky_regex_set(const ky_regex_set &) = delete;
+    void operator = (const ky_regex_set &) = delete;
+
+    //! 加入模式，返回编号；模式有语法错误时返回-1
+    int append(const ky_string &re);
+    int append(const char *re);
+    //! 编译全部模式，之后append需重新编译
+    bool compile();
+    void clear();
+    int count()const;
+
+    //!
+    //! \brief match 查找在文本中有匹配的模式
+    //! \param ids 不为空时按编号升序写入有匹配的模式
+    //! \return 有匹配的模式数
+    //!
+    int match(const ky_string &str, ky_vector<int> *ids = 0)const;
+    int match(const ky_u8stringview &str, ky_vector<int> *ids = 0)const;
+    int match(const char *str, ky_vector<int> *ids = 0)const{return match (ky_u8stringview(str), ids);}
+    //! 是否有任一模式匹配，找到第一个即返回
+    bool contains(const ky_u8stringview &str)const;
+
+private:
+    __regex__::regex_set *impl;
+};
+
+#include "ky_regex_dfa.inl"
+#endif // KY_REGEX_DFA_H
@@ -0,0 +1,2194 @@
+#ifndef KY_REGEX_DFA_INL
+#define KY_REGEX_DFA_INL
+
+namespace __regex__
+{
+    //! 只用于POD的增长数组
+    template <typename T>
+    struct buffer
+    {
+        T *d;
+        int n;
+        int cap;
+
+        buffer():d(NULL), n(0), cap(0){}
+        ~buffer(){kyFree (d);}
+
+        T &operator [](int i){return d[i];}
+        const T &operator [](int i)const{return d[i];}
+        void reserve(int m)
+        {
+            if (m <= cap)
+                return;
+            cap = m < cap * 2 ? cap * 2 : (m < 16 ? 16 : m);
+            d = (T *)kyRealloc (d, (size_t)cap * sizeof(T));
+        }
+        void resize(int m){reserve (m); n = m;}
+        void push(const T &v){if (n == cap) reserve (n + 1); d[n++] = v;}
+        void clear(){n = 0;}
+        void release(){kyFree (d); d = NULL; n = cap = 0;}
+        size_t bytes()const{return (size_t)cap * sizeof(T);}
+
+    private:
+        buffer(const buffer &);
+        buffer &operator = (const buffer &);
+    };
+
+    //! 有序的稀疏集合，清空为O(1)，保持加入的顺序
+    struct sparse
+    {
+        uint32 *dense;
+        uint32 *index;
+        int n;
+        int cap;
+
+        sparse():dense(NULL), index(NULL), n(0), cap(0){}
+        ~sparse(){kyFree (dense); kyFree (index);}
+        void init(int c)
+        {
+            if (c <= cap)
+                return;
+            kyFree (dense);
+            kyFree (index);
+            dense = (uint32 *)kyMalloc ((size_t)c * sizeof(uint32));
+            index = (uint32 *)calloc ((size_t)c, sizeof(uint32));
+            cap = c;
+            n = 0;
+        }
+        bool has(uint32 v)const{const uint32 i = index[v]; return i < (uint32)n && dense[i] == v;}
+        void add(uint32 v){index[v] = (uint32)n; dense[n++] = v;}
+        void clear(){n = 0;}
+
+    private:
+        sparse(const sparse &);
+        sparse &operator = (const sparse &);
+    };
+
+    inline bool is_word(int c)
+    {
+        return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') ||
+               (c >= 'a' && c <= 'z') || c == '_';
+    }
+
+    // ------------------------------------------------------------------
+    // 语法树
+    // ------------------------------------------------------------------
+    enum eNodes
+    {
+        Node_Empty,
+        Node_Class,     ///< 码点区间的集合，单个字符为只有一个码点的集合
+        Node_Concat,
+        Node_Alter,
+        Node_Repeat,
+        Node_Assert
+    };
+    enum eAsserts
+    {
+        Assert_BeginText,
+        Assert_EndText,
+        Assert_Word,
+        Assert_NotWord
+    };
+    enum eFlags
+    {
+        Flag_ICase = 1,
+        Flag_DotAll = 2
+    };
+    enum {MaxCodePoint = 0x10FFFF, MaxRepeat = 1000, MaxInsts = 1 << 20};
+
+    struct range
+    {
+        uint32 lo;
+        uint32 hi;
+    };
+
+    struct node
+    {
+        uint8 kind;
+        uint8 greedy;
+        uint8 what;     ///< eAsserts
+        int32 a;        ///< Class: 区间起始  Repeat: 最少次数
+        int32 b;        ///< Class: 区间个数  Repeat: 最多次数，-1为不限
+        int32 child;    ///< 第一个子节点
+        int32 next;     ///< 下一个兄弟节点
+    };
+
+    struct tree
+    {
+        buffer<node> nodes;
+        buffer<range> ranges;
+        bool has_word;
+
+        tree():has_word(false){}
+
+        int32 add(uint8 kind)
+        {
+            node v;
+            memset (&v, 0, sizeof(v));
+            v.kind = kind;
+            v.child = -1;
+            v.next = -1;
+            nodes.push (v);
+            return nodes.n - 1;
+        }
+        //! 子节点按顺序链接，只有一个子节点时直接返回它
+        int32 join(uint8 kind, const buffer<int32> &items, int from)
+        {
+            if (items.n - from == 1)
+                return items[from];
+            const int32 p = add (kind);
+            int32 prev = -1;
+            for (int i = from; i < items.n; ++i)
+            {
+                if (prev < 0)
+                    nodes[p].child = items[i];
+                else
+                    nodes[prev].next = items[i];
+                prev = items[i];
+            }
+            return p;
+        }
+    };
+
+    //! 排序、合并区间，可选取反及ASCII大小写折叠
+    inline void normalize(buffer<range> &rs, bool negate, bool icase)
+    {
+        if (icase)
+        {
+            const int n = rs.n;
+            for (int i = 0; i < n; ++i)
+            {
+                const range r = rs[i];
+                const uint32 lo = r.lo < 'a' ? 'a' : r.lo, hi = r.hi > 'z' ? 'z' : r.hi;
+                if (lo <= hi)
+                {
+                    range u = {lo - 32, hi - 32};
+                    rs.push (u);
+                }
+                const uint32 ul = r.lo < 'A' ? 'A' : r.lo, uh = r.hi > 'Z' ? 'Z' : r.hi;
+                if (ul <= uh)
+                {
+                    range u = {ul + 32, uh + 32};
+                    rs.push (u);
+                }
+            }
+        }
+        // 区间个数很少，插入排序即可
+        for (int i = 1; i < rs.n; ++i)
+        {
+            const range v = rs[i];
+            int j = i;
+            for (; j > 0 && rs[j - 1].lo > v.lo; --j)
+                rs[j] = rs[j - 1];
+            rs[j] = v;
+        }
+        int w = 0;
+        for (int i = 0; i < rs.n; ++i)
+        {
+            if (w > 0 && rs[i].lo <= rs[w - 1].hi + 1)
+            {
+                if (rs[i].hi > rs[w - 1].hi)
+                    rs[w - 1].hi = rs[i].hi;
+            }
+            else
+                rs[w++] = rs[i];
+        }
+        rs.n = w;
+        if (negate)
+        {
+            buffer<range> out;
+            uint32 at = 0;
+            for (int i = 0; i < rs.n; ++i)
+            {
+                if (rs[i].lo > at)
+                {
+                    range r = {at, rs[i].lo - 1};
+                    out.push (r);
+                }
+                at = rs[i].hi + 1;
+            }
+            if (at <= MaxCodePoint)
+            {
+                range r = {at, MaxCodePoint};
+                out.push (r);
+            }
+            rs.resize (out.n);
+            if (out.n)
+                memcpy (rs.d, out.d, out.n * sizeof(range));
+        }
+    }
+
+    // ------------------------------------------------------------------
+    // 解析
+    // ------------------------------------------------------------------
+    struct parser
+    {
+        tree &t;
+        const char *p;
+        const char *end;
+        const char *error;
+
+        parser(tree &tr, const char *s, size_t n):t(tr), p(s), end(s + n), error(NULL){}
+
+        bool more()const{return p < end;}
+        bool fail(const char *e){if (!error) error = e; return false;}
+
+        //! 解码一个UTF-8字符，非法序列按单个字节处理
+        uint32 rune()
+        {
+            const uint8 c = (uint8)*p++;
+            if (c < 0x80 || p >= end)
+                return c;
+            int need = c >= 0xf0 ? 3 : (c >= 0xe0 ? 2 : (c >= 0xc0 ? 1 : 0));
+            if (need == 0 || end - p < need)
+                return c;
+            uint32 v = c & (0x3f >> need);
+            for (int i = 0; i < need; ++i)
+            {
+                if (((uint8)p[i] & 0xc0) != 0x80)
+                    return c;
+                v = (v << 6) | ((uint8)p[i] & 0x3f);
+            }
+            p += need;
+            return v;
+        }
+
+        int32 cls(buffer<range> &rs, bool negate, int flags)
+        {
+            normalize (rs, negate, (flags & Flag_ICase) != 0);
+            const int32 id = t.add (Node_Class);
+            t.nodes[id].a = t.ranges.n;
+            t.nodes[id].b = rs.n;
+            for (int i = 0; i < rs.n; ++i)
+                t.ranges.push (rs[i]);
+            return id;
+        }
+        int32 literal(uint32 c, int flags)
+        {
+            buffer<range> rs;
+            range r = {c, c};
+            rs.push (r);
+            return cls (rs, false, flags);
+        }
+
+        static void add_range(buffer<range> &rs, uint32 lo, uint32 hi)
+        {
+            range r = {lo, hi};
+            rs.push (r);
+        }
+        //! \d \w \s 及其取反加入到rs，返回是否为这类转义
+        static bool perl_class(char c, buffer<range> &rs)
+        {
+            buffer<range> tmp;
+            const char l = c | 0x20;
+            if (l == 'd')
+                add_range (tmp, '0', '9');
+            else if (l == 'w')
+            {
+                add_range (tmp, '0', '9');
+                add_range (tmp, 'A', 'Z');
+                add_range (tmp, '_', '_');
+                add_range (tmp, 'a', 'z');
+            }
+            else if (l == 's')
+            {
+                add_range (tmp, '\t', '\r');
+                add_range (tmp, ' ', ' ');
+            }
+            else
+                return false;
+            normalize (tmp, c != l, false);
+            for (int i = 0; i < tmp.n; ++i)
+                rs.push (tmp[i]);
+            return true;
+        }
+
+        int hex(int digits, uint32 &v)
+        {
+            v = 0;
+            int i = 0;
+            for (; i < digits && p < end; ++i, ++p)
+            {
+                const char c = *p;
+                int d;
+                if (c >= '0' && c <= '9')
+                    d = c - '0';
+                else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+                    d = (c | 0x20) - 'a' + 10;
+                else
+                    break;
+                v = (v << 4) | (uint32)d;
+                if (v > MaxCodePoint)
+                    return -1;
+            }
+            return i;
+        }
+
+        //! 单个字符的转义，p指向反斜杠之后
+        bool escape_char(uint32 &c)
+        {
+            if (!more ())
+                return fail ("trailing backslash");
+            const char e = *p++;
+            switch (e)
+            {
+            case 't': c = '\t'; return true;
+            case 'n': c = '\n'; return true;
+            case 'r': c = '\r'; return true;
+            case 'f': c = '\f'; return true;
+            case 'v': c = '\v'; return true;
+            case '0': c = 0; return true;
+            case 'x':
+                if (more () && *p == '{')
+                {
+                    ++p;
+                    if (hex (8, c) <= 0 || !more () || *p != '}')
+                        return fail ("invalid \\x{...}");
+                    ++p;
+                    return true;
+                }
+                if (hex (2, c) != 2)
+                    return fail ("invalid \\x escape");
+                return true;
+            case 'u':
+                if (hex (4, c) != 4)
+                    return fail ("invalid \\u escape");
+                return true;
+            default:
+                if ((e >= 'a' && e <= 'z') || (e >= 'A' && e <= 'Z') || (e >= '0' && e <= '9'))
+                    return fail ("unknown escape");
+                --p;
+                c = rune ();
+                return true;
+            }
+        }
+
+        int32 bracket(int flags)
+        {
+            // p指向'['之后
+            bool negate = false;
+            if (more () && *p == '^')
+            {
+                negate = true;
+                ++p;
+            }
+            buffer<range> rs;
+            bool first = true;
+            while (more () && (*p != ']' || first))
+            {
+                first = false;
+                uint32 lo;
+                if (*p == '\\')
+                {
+                    ++p;
+                    if (more () && perl_class (*p, rs))
+                    {
+                        ++p;
+                        continue;
+                    }
+                    if (!escape_char (lo))
+                        return -1;
+                }
+                else
+                    lo = rune ();
+                uint32 hi = lo;
+                if (end - p >= 2 && *p == '-' && p[1] != ']')
+                {
+                    ++p;
+                    if (*p == '\\')
+                    {
+                        ++p;
+                        if (!escape_char (hi))
+                            return -1;
+                    }
+                    else
+                        hi = rune ();
+                    if (hi < lo)
+                        return fail ("invalid range in class"), -1;
+                }
+                add_range (rs, lo, hi);
+            }
+            if (!more ())
+                return fail ("missing ]"), -1;
+            ++p;
+            return cls (rs, negate, flags);
+        }
+
+        int32 dot(int flags)
+        {
+            buffer<range> rs;
+            if (flags & Flag_DotAll)
+                add_range (rs, 0, MaxCodePoint);
+            else
+            {
+                add_range (rs, 0, '\n' - 1);
+                add_range (rs, '\n' + 1, MaxCodePoint);
+            }
+            return cls (rs, false, 0);
+        }
+
+        int32 assertion(uint8 what)
+        {
+            const int32 id = t.add (Node_Assert);
+            t.nodes[id].what = what;
+            if (what == Assert_Word || what == Assert_NotWord)
+                t.has_word = true;
+            return id;
+        }
+
+        //! 解析(?flags)或(?flags:，p指向'?'之后；返回1为作用到组尾的标志，2为带冒号的组
+        int group_flags(int &flags)
+        {
+            int f = flags;
+            bool on = true;
+            while (more ())
+            {
+                const char c = *p++;
+                if (c == 'i')
+                    f = on ? (f | Flag_ICase) : (f & ~Flag_ICase);
+                else if (c == 's')
+                    f = on ? (f | Flag_DotAll) : (f & ~Flag_DotAll);
+                else if (c == '-' && on)
+                    on = false;
+                else if (c == ')')
+                {
+                    flags = f;
+                    return 1;
+                }
+                else if (c == ':')
+                {
+                    flags = f;
+                    return 2;
+                }
+                else
+                    break;
+            }
+            return fail ("unsupported group"), 0;
+        }
+
+        int32 atom(int &flags)
+        {
+            const char c = *p;
+            switch (c)
+            {
+            case '(':
+            {
+                ++p;
+                int inner = flags;
+                if (more () && *p == '?')
+                {
+                    ++p;
+                    const int k = group_flags (inner);
+                    if (k == 0)
+                        return -1;
+                    if (k == 1)
+                    {
+                        // (?i) 作用到所在组的结尾
+                        flags = inner;
+                        return t.add (Node_Empty);
+                    }
+                }
+                const int32 r = alter (inner);
+                if (r < 0)
+                    return -1;
+                if (!more () || *p != ')')
+                    return fail ("missing )"), -1;
+                ++p;
+                return r;
+            }
+            case '[':
+                ++p;
+                return bracket (flags);
+            case '.':
+                ++p;
+                return dot (flags);
+            case '^':
+                ++p;
+                return assertion (Assert_BeginText);
+            case '$':
+                ++p;
+                return assertion (Assert_EndText);
+            case '\\':
+            {
+                ++p;
+                if (!more ())
+                    return fail ("trailing backslash"), -1;
+                const char e = *p;
+                switch (e)
+                {
+                case 'A': ++p; return assertion (Assert_BeginText);
+                case 'z': ++p; return assertion (Assert_EndText);
+                case 'b': ++p; return assertion (Assert_Word);
+                case 'B': ++p; return assertion (Assert_NotWord);
+                default: break;
+                }
+                buffer<range> rs;
+                if (perl_class (e, rs))
+                {
+                    ++p;
+                    return cls (rs, false, 0);
+                }
+                uint32 v;
+                if (!escape_char (v))
+                    return -1;
+                return literal (v, flags);
+            }
+            case '*': case '+': case '?':
+                return fail ("missing argument to repetition operator"), -1;
+            case '{':
+            {
+                int lo, hi;
+                if (counted (lo, hi))
+                    return fail ("missing argument to repetition operator"), -1;
+                if (error)
+                    return -1;
+                ++p;
+                return literal ('{', flags);
+            }
+            default:
+                return literal (rune (), flags);
+            }
+        }
+
+        bool number(int &v)
+        {
+            const char *b = p;
+            v = 0;
+            while (more () && *p >= '0' && *p <= '9')
+            {
+                v = v * 10 + (*p++ - '0');
+                if (v > MaxRepeat)
+                    return fail ("repetition count too large");
+            }
+            return p != b;
+        }
+
+        //! {n} {n,} {n,m}，不是合法的计数时把'{'当作字面字符
+        bool counted(int &lo, int &hi)
+        {
+            const char *save = p;
+            ++p;
+            if (!number (lo))
+            {
+                p = save;
+                return false;
+            }
+            hi = lo;
+            if (more () && *p == ',')
+            {
+                ++p;
+                if (more () && *p == '}')
+                    hi = -1;
+                else if (!number (hi))
+                {
+                    p = save;
+                    return false;
+                }
+            }
+            if (!more () || *p != '}')
+            {
+                p = save;
+                return false;
+            }
+            ++p;
+            return true;
+        }
+
+        int32 quantified(int &flags)
+        {
+            int32 a = atom (flags);
+            if (a < 0)
+                return -1;
+            while (more ())
+            {
+                int lo, hi;
+                const char c = *p;
+                if (c == '*')
+                {
+                    lo = 0; hi = -1; ++p;
+                }
+                else if (c == '+')
+                {
+                    lo = 1; hi = -1; ++p;
+                }
+                else if (c == '?')
+                {
+                    lo = 0; hi = 1; ++p;
+                }
+                else if (c == '{')
+                {
+                    if (!counted (lo, hi))
+                    {
+                        if (error)
+                            return -1;
+                        break;
+                    }
+                    if (hi >= 0 && hi < lo)
+                        return fail ("invalid repetition count"), -1;
+                }
+                else
+                    break;
+                if (t.nodes[a].kind == Node_Assert)
+                    return fail ("nothing to repeat"), -1;
+                const int32 r = t.add (Node_Repeat);
+                t.nodes[r].child = a;
+                t.nodes[r].a = lo;
+                t.nodes[r].b = hi;
+                t.nodes[r].greedy = 1;
+                if (more () && *p == '?')
+                {
+                    t.nodes[r].greedy = 0;
+                    ++p;
+                }
+                a = r;
+            }
+            return a;
+        }
+
+        int32 concat(int &flags)
+        {
+            buffer<int32> items;
+            while (more () && *p != '|' && *p != ')')
+            {
+                const int32 a = quantified (flags);
+                if (a < 0)
+                    return -1;
+                items.push (a);
+            }
+            if (items.n == 0)
+                return t.add (Node_Empty);
+            return t.join (Node_Concat, items, 0);
+        }
+
+        int32 alter(int flags)
+        {
+            buffer<int32> items;
+            for (;;)
+            {
+                const int32 a = concat (flags);
+                if (a < 0)
+                    return -1;
+                items.push (a);
+                if (!more () || *p != '|')
+                    break;
+                ++p;
+            }
+            return t.join (Node_Alter, items, 0);
+        }
+
+        int32 parse()
+        {
+            const int32 r = alter (0);
+            if (r >= 0 && more ())
+                return fail ("unmatched )"), -1;
+            return error ? -1 : r;
+        }
+    };
+
+    // ------------------------------------------------------------------
+    // 编译为字节程序
+    // ------------------------------------------------------------------
+    enum eOps
+    {
+        Op_Fail,
+        Op_Byte,    ///< [lo, hi] 跳到out
+        Op_Split,   ///< out优先于out1
+        Op_Nop,
+        Op_Assert,
+        Op_Match    ///< out1为模式编号
+    };
+
+    struct inst
+    {
+        uint8 op;
+        uint8 lo;
+        uint8 hi;
+        uint8 what;
+        uint32 out;
+        uint32 out1;
+    };
+
+    struct program
+    {
+        buffer<inst> insts;
+        uint32 start;       ///< 锚定的起点
+        uint32 ustart;      ///< 非锚定的起点，前面是最低优先级的任意字节循环
+        uint8 classes[256]; ///< 字节类别，类别内的字节对全部指令等价
+        uint8 reps[256];    ///< 每个类别的代表字节
+        int nclass;
+        int patterns;
+        bool has_word;
+
+        program():start(0), ustart(0), nclass(0), patterns(0), has_word(false){}
+
+        //! 计算字节类别，有\b时单词字符的边界也作为类别边界
+        void classify()
+        {
+            uint8 edge[257];
+            memset (edge, 0, sizeof(edge));
+            for (int i = 0; i < insts.n; ++i)
+            {
+                if (insts[i].op != Op_Byte)
+                    continue;
+                edge[insts[i].lo] = 1;
+                edge[insts[i].hi + 1] = 1;
+            }
+            if (has_word)
+            {
+                const uint8 w[] = {'0', '9' + 1, 'A', 'Z' + 1, '_', '_' + 1, 'a', 'z' + 1};
+                for (size_t i = 0; i < sizeof(w); ++i)
+                    edge[w[i]] = 1;
+            }
+            int c = 0;
+            for (int b = 0; b < 256; ++b)
+            {
+                if (b > 0 && edge[b])
+                    ++c;
+                classes[b] = (uint8)c;
+                if (b == 0 || edge[b])
+                    reps[c] = (uint8)b;
+            }
+            nclass = c + 1;
+        }
+    };
+
+    //! Thompson构造，未连接的出口以链表串在out/out1中
+    struct compiler
+    {
+        program &pg;
+        const tree &t;
+        bool reversed;
+        bool overflow;
+
+        struct frag
+        {
+            uint32 begin;
+            uint32 head;    ///< 出口链表，(指令 << 1) | 是否为out1，0为空
+            uint32 tail;
+        };
+
+        compiler(program &p, const tree &tr, bool rev):pg(p), t(tr), reversed(rev), overflow(false)
+        {
+            if (pg.insts.n == 0)
+                emit (Op_Fail);     // 0号指令不作为出口，出口链表以0结尾
+        }
+
+        uint32 emit(uint8 op, uint8 lo = 0, uint8 hi = 0)
+        {
+            if (pg.insts.n >= MaxInsts)
+                overflow = true;
+            inst v;
+            v.op = op;
+            v.lo = lo;
+            v.hi = hi;
+            v.what = 0;
+            v.out = 0;
+            v.out1 = 0;
+            pg.insts.push (v);
+            return (uint32)pg.insts.n - 1;
+        }
+        uint32 &slot(uint32 code){return (code & 1) ? pg.insts[code >> 1].out1 : pg.insts[code >> 1].out;}
+        void patch(uint32 head, uint32 to)
+        {
+            while (head)
+            {
+                uint32 &s = slot (head);
+                head = s;
+                s = to;
+            }
+        }
+        frag single(uint32 pc, bool second = false)
+        {
+            frag f;
+            f.begin = pc;
+            f.head = f.tail = (pc << 1) | (second ? 1 : 0);
+            return f;
+        }
+        frag join_holes(frag a, const frag &b)
+        {
+            if (!a.head)
+            {
+                a.head = b.head;
+                a.tail = b.tail;
+            }
+            else if (b.head)
+            {
+                slot (a.tail) = b.head;
+                a.tail = b.tail;
+            }
+            return a;
+        }
+        frag cat(const frag &a, const frag &b)
+        {
+            patch (a.head, b.begin);
+            frag f = b;
+            f.begin = a.begin;
+            return f;
+        }
+        frag alt(const frag &a, const frag &b)
+        {
+            const uint32 s = emit (Op_Split);
+            pg.insts[s].out = a.begin;
+            pg.insts[s].out1 = b.begin;
+            frag f = join_holes (a, b);
+            f.begin = s;
+            return f;
+        }
+        frag quest(const frag &a, bool greedy)
+        {
+            const uint32 s = emit (Op_Split);
+            frag f;
+            if (greedy)
+            {
+                pg.insts[s].out = a.begin;
+                f = join_holes (single (s, true), a);
+            }
+            else
+            {
+                pg.insts[s].out1 = a.begin;
+                f = join_holes (single (s, false), a);
+            }
+            f.begin = s;
+            return f;
+        }
+        frag star(const frag &a, bool greedy)
+        {
+            const uint32 s = emit (Op_Split);
+            patch (a.head, s);
+            if (greedy)
+            {
+                pg.insts[s].out = a.begin;
+                return single (s, true);
+            }
+            pg.insts[s].out1 = a.begin;
+            return single (s, false);
+        }
+        frag plus(const frag &a, bool greedy)
+        {
+            frag s = star (a, greedy);
+            s.begin = a.begin;
+            return s;
+        }
+        frag empty(){return single (emit (Op_Nop));}
+
+        //! 一个字节序列，反向时从末字节开始
+        frag sequence(const uint8 *lo, const uint8 *hi, int n)
+        {
+            frag f;
+            for (int i = 0; i < n; ++i)
+            {
+                const int k = reversed ? n - 1 - i : i;
+                const frag b = single (emit (Op_Byte, lo[k], hi[k]));
+                f = i == 0 ? b : cat (f, b);
+            }
+            return f;
+        }
+
+        static int encode(uint32 c, uint8 *o)
+        {
+            if (c < 0x80)
+            {
+                o[0] = (uint8)c;
+                return 1;
+            }
+            if (c < 0x800)
+            {
+                o[0] = (uint8)(0xc0 | (c >> 6));
+                o[1] = (uint8)(0x80 | (c & 0x3f));
+                return 2;
+            }
+            if (c < 0x10000)
+            {
+                o[0] = (uint8)(0xe0 | (c >> 12));
+                o[1] = (uint8)(0x80 | ((c >> 6) & 0x3f));
+                o[2] = (uint8)(0x80 | (c & 0x3f));
+                return 3;
+            }
+            o[0] = (uint8)(0xf0 | (c >> 18));
+            o[1] = (uint8)(0x80 | ((c >> 12) & 0x3f));
+            o[2] = (uint8)(0x80 | ((c >> 6) & 0x3f));
+            o[3] = (uint8)(0x80 | (c & 0x3f));
+            return 4;
+        }
+
+        //! 码点区间拆成若干字节区间序列，每个序列的各字节独立取值
+        void utf8_ranges(uint32 lo, uint32 hi, frag &f, bool &has)
+        {
+            if (lo > hi)
+                return;
+            // 代理项不能编码为UTF-8
+            if (lo < 0xd800 && hi > 0xdfff)
+            {
+                utf8_ranges (lo, 0xd7ff, f, has);
+                utf8_ranges (0xe000, hi, f, has);
+                return;
+            }
+            if (lo >= 0xd800 && lo <= 0xdfff)
+                lo = 0xe000;
+            if (hi >= 0xd800 && hi <= 0xdfff)
+                hi = 0xd7ff;
+            if (lo > hi)
+                return;
+            static const uint32 limits[] = {0x7f, 0x7ff, 0xffff};
+            for (int i = 0; i < 3; ++i)
+            {
+                if (lo <= limits[i] && hi > limits[i])
+                {
+                    utf8_ranges (lo, limits[i], f, has);
+                    utf8_ranges (limits[i] + 1, hi, f, has);
+                    return;
+                }
+            }
+            if (hi >= 0x80)
+            {
+                for (int i = 1; i < 4; ++i)
+                {
+                    const uint32 m = (1u << (6 * i)) - 1;
+                    if ((lo & ~m) != (hi & ~m))
+                    {
+                        if ((lo & m) != 0)
+                        {
+                            utf8_ranges (lo, lo | m, f, has);
+                            utf8_ranges ((lo | m) + 1, hi, f, has);
+                            return;
+                        }
+                        if ((hi & m) != m)
+                        {
+                            utf8_ranges (lo, (hi & ~m) - 1, f, has);
+                            utf8_ranges (hi & ~m, hi, f, has);
+                            return;
+                        }
+                    }
+                }
+            }
+            uint8 a[4], b[4];
+            const int n = encode (lo, a);
+            encode (hi, b);
+            const frag s = sequence (a, b, n);
+            f = has ? alt (f, s) : s;
+            has = true;
+        }
+
+        frag compile_class(const node &v)
+        {
+            frag f;
+            bool has = false;
+            // ASCII区间直接为单字节，其余按UTF-8拆分
+            for (int i = 0; i < v.b; ++i)
+            {
+                const range &r = t.ranges[v.a + i];
+                utf8_ranges (r.lo, r.hi, f, has);
+            }
+            if (!has)
+                return single (emit (Op_Fail));
+            return f;
+        }
+
+        frag compile(int32 id)
+        {
+            const node &v = t.nodes[id];
+            if (overflow)
+                return empty ();
+            switch (v.kind)
+            {
+            case Node_Empty:
+                return empty ();
+            case Node_Class:
+                return compile_class (v);
+            case Node_Assert:
+            {
+                uint8 what = v.what;
+                if (reversed && what == Assert_BeginText)
+                    what = Assert_EndText;
+                else if (reversed && what == Assert_EndText)
+                    what = Assert_BeginText;
+                const uint32 pc = emit (Op_Assert);
+                pg.insts[pc].what = what;
+                return single (pc);
+            }
+            case Node_Concat:
+            {
+                frag f;
+                bool has = false;
+                if (!reversed)
+                {
+                    for (int32 c = v.child; c >= 0; c = t.nodes[c].next)
+                    {
+                        const frag x = compile (c);
+                        f = has ? cat (f, x) : x;
+                        has = true;
+                    }
+                }
+                else
+                {
+                    // 反向时子节点逆序连接
+                    buffer<int32> items;
+                    for (int32 c = v.child; c >= 0; c = t.nodes[c].next)
+                        items.push (c);
+                    for (int i = items.n - 1; i >= 0; --i)
+                    {
+                        const frag x = compile (items[i]);
+                        f = has ? cat (f, x) : x;
+                        has = true;
+                    }
+                }
+                return f;
+            }
+            case Node_Alter:
+            {
+                // 右结合，保持书写顺序的优先级
+                buffer<int32> items;
+                for (int32 c = v.child; c >= 0; c = t.nodes[c].next)
+                    items.push (c);
+                frag f = compile (items[items.n - 1]);
+                for (int i = items.n - 2; i >= 0; --i)
+                    f = alt (compile (items[i]), f);
+                return f;
+            }
+            case Node_Repeat:
+            {
+                const bool g = v.greedy != 0;
+                const int lo = v.a, hi = v.b;
+                if (hi == 0)
+                    return empty ();
+                frag f;
+                bool has = false;
+                for (int i = 0; i < lo - (hi < 0 ? 1 : 0); ++i)
+                {
+                    const frag x = compile (v.child);
+                    f = has ? cat (f, x) : x;
+                    has = true;
+                }
+                frag tail;
+                if (hi < 0)
+                    tail = lo > 0 ? plus (compile (v.child), g) : star (compile (v.child), g);
+                else if (hi > lo)
+                {
+                    // x{0,k} 展开为 (x(x(x)?)?)?
+                    tail = quest (compile (v.child), g);
+                    for (int i = 1; i < hi - lo; ++i)
+                        tail = quest (cat (compile (v.child), tail), g);
+                }
+                else
+                    return has ? f : empty ();
+                return has ? cat (f, tail) : tail;
+            }
+            }
+            return empty ();
+        }
+
+        //! 编译一个模式，出口连接到Match
+        uint32 pattern(int32 root, int id)
+        {
+            const frag f = compile (root);
+            const uint32 m = emit (Op_Match);
+            pg.insts[m].out1 = (uint32)id;
+            patch (f.head, m);
+            return f.begin;
+        }
+
+        //! 全部起点完成后加入非锚定的循环
+        void finish(uint32 start)
+        {
+            pg.start = start;
+            const uint32 loop = emit (Op_Split);
+            const uint32 any = emit (Op_Byte, 0x00, 0xff);
+            pg.insts[loop].out = start;
+            pg.insts[loop].out1 = any;
+            pg.insts[any].out = loop;
+            pg.ustart = loop;
+            pg.classify ();
+        }
+    };
+
+    // ------------------------------------------------------------------
+    // 惰性DFA
+    // ------------------------------------------------------------------
+    enum
+    {
+        State_Unknown = -1,
+        State_Dead = -2,
+        State_GaveUp = -3,
+
+        Flag_Matched = 1,   ///< 进入本状态的字节之前有匹配结束
+        Flag_PrevWord = 2,  ///< 前一个字节是单词字符
+        Flag_Edge = 4       ///< 位于文本开头(反向为结尾)
+    };
+
+    //! 断言求值时的上下文
+    struct context
+    {
+        bool edge_before;   ///< 当前位置是文本开头
+        bool edge_after;    ///< 当前位置是文本结尾
+        bool word_before;
+        bool word_after;
+        bool known_after;   ///< 后一个字节是否已知
+    };
+
+    //! 从pc出发的ε闭包按优先级顺序加入q；后一个字节未知时，依赖它的断言原样保留
+    inline void closure(const program &pg, uint32 pc, const context &cx,
+                        sparse &q, buffer<uint32> &stack)
+    {
+        stack.clear ();
+        stack.push (pc);
+        while (stack.n)
+        {
+            const uint32 at = stack[--stack.n];
+            if (at == 0 || q.has (at))
+                continue;
+            const inst &in = pg.insts[at];
+            switch (in.op)
+            {
+            case Op_Nop:
+                q.add (at);
+                stack.push (in.out);
+                break;
+            case Op_Split:
+                q.add (at);
+                stack.push (in.out1);
+                stack.push (in.out);
+                break;
+            case Op_Assert:
+            {
+                bool ok;
+                if (in.what == Assert_BeginText)
+                    ok = cx.edge_before;
+                else if (!cx.known_after)
+                {
+                    q.add (at);     // 留待下一个字节
+                    break;
+                }
+                else if (in.what == Assert_EndText)
+                    ok = cx.edge_after;
+                else
+                    ok = (cx.word_before != cx.word_after) == (in.what == Assert_Word);
+                q.add (at);
+                if (ok)
+                    stack.push (in.out);
+                break;
+            }
+            default:
+                q.add (at);
+                break;
+            }
+        }
+    }
+
+    struct dfa
+    {
+        struct state
+        {
+            int32 begin;    ///< 在pool中的指令
+            int32 count;
+            uint32 flags;
+            int32 mbegin;   ///< 在mids中的模式编号
+            int32 mcount;
+        };
+
+        const program *pg;
+        bool longest;       ///< 不在匹配后截断低优先级的线程
+        size_t budget;
+
+        buffer<uint32> pool;
+        buffer<state> states;
+        buffer<int32> trans;
+        buffer<int32> mids;
+        buffer<int32> table;    ///< 状态的开放寻址散列
+        int32 starts[16];
+        int32 loop;             ///< 非锚定、不在开头的起始状态，用于前缀跳跃
+        size_t used;
+        size_t mark;            ///< 上次清空缓存时的扫描位置
+        int resets;
+
+        // 构造状态的工作区
+        sparse q;
+        sparse nq;
+        buffer<uint32> stack;
+        buffer<uint32> key;
+        buffer<int32> ids;
+
+        dfa():pg(NULL), longest(false), budget(2u << 20), used(0), mark(0), resets(0)
+        {
+            loop = State_Unknown;
+            for (int i = 0; i < 16; ++i)
+                starts[i] = State_Unknown;
+        }
+
+        void init(const program *p, bool lg)
+        {
+            pg = p;
+            longest = lg;
+            q.init (p->insts.n);
+            nq.init (p->insts.n);
+            reset ();
+        }
+
+        void reset()
+        {
+            pool.clear ();
+            states.clear ();
+            trans.clear ();
+            mids.clear ();
+            table.resize (1024);
+            for (int i = 0; i < table.n; ++i)
+                table[i] = -1;
+            for (int i = 0; i < 16; ++i)
+                starts[i] = State_Unknown;
+            loop = State_Unknown;
+            used = 0;
+        }
+
+        void begin_scan(){resets = 0; mark = 0;}
+
+        //! 同样的线程在多模式时可能带不同的匹配编号，编号也参与散列及比较
+        static uint64 hash(const uint32 *s, int n, const int32 *m, int mn, uint32 flags)
+        {
+            const uint64 h = __hash_::WY (s, (size_t)n * sizeof(uint32));
+            return __hash_::mix (mn ? __hash_::WY (m, (size_t)mn * sizeof(int32), h) : h, flags + 1);
+        }
+
+        //! 查找或加入状态，key为有序的指令列表
+        int32 intern(uint32 flags)
+        {
+            const uint64 h = hash (key.d, key.n, ids.d, ids.n, flags);
+            const int32 mask = table.n - 1;
+            int32 i = (int32)h & mask;
+            for (; table[i] >= 0; i = (i + 1) & mask)
+            {
+                const state &s = states[table[i]];
+                if (s.flags == flags && s.count == key.n && s.mcount == ids.n &&
+                        (key.n == 0 || memcmp (pool.d + s.begin, key.d, key.n * sizeof(uint32)) == 0) &&
+                        (ids.n == 0 || memcmp (mids.d + s.mbegin, ids.d, ids.n * sizeof(int32)) == 0))
+                    return table[i];
+            }
+            state s;
+            s.begin = pool.n;
+            s.count = key.n;
+            s.flags = flags;
+            s.mbegin = mids.n;
+            s.mcount = ids.n;
+            for (int k = 0; k < key.n; ++k)
+                pool.push (key[k]);
+            for (int k = 0; k < ids.n; ++k)
+                mids.push (ids[k]);
+            states.push (s);
+            const int32 id = states.n - 1;
+            const int32 base = trans.n;
+            trans.resize (base + pg->nclass);
+            for (int k = 0; k < pg->nclass; ++k)
+                trans[base + k] = State_Unknown;
+            used += sizeof(state) + (key.n + ids.n + pg->nclass) * sizeof(int32) + 2 * sizeof(int32);
+            table[i] = id;
+            if (states.n * 2 > table.n)
+                rehash ();
+            return id;
+        }
+
+        void rehash()
+        {
+            table.resize (table.n * 2);
+            const int32 mask = table.n - 1;
+            for (int i = 0; i < table.n; ++i)
+                table[i] = -1;
+            for (int32 s = 0; s < states.n; ++s)
+            {
+                const state &v = states[s];
+                int32 i = (int32)hash (pool.d + v.begin, v.count, mids.d + v.mbegin, v.mcount, v.flags) & mask;
+                while (table[i] >= 0)
+                    i = (i + 1) & mask;
+                table[i] = s;
+            }
+        }
+
+        //! q中保留的叶子指令(字节、匹配、待定的断言)作为状态的内容
+        void leaves(const sparse &set)
+        {
+            key.clear ();
+            for (int i = 0; i < set.n; ++i)
+            {
+                const uint8 op = pg->insts[set.dense[i]].op;
+                if (op == Op_Byte || op == Op_Match || op == Op_Assert)
+                    key.push (set.dense[i]);
+            }
+        }
+
+        int32 start(bool anchored, bool edge, bool word)
+        {
+            const int k = (anchored ? 1 : 0) | (edge ? 2 : 0) | (word && pg->has_word ? 4 : 0);
+            if (starts[k] != State_Unknown)
+                return starts[k];
+            context cx = {edge, false, word, false, false};
+            q.clear ();
+            closure (*pg, anchored ? pg->start : pg->ustart, cx, q, stack);
+            leaves (q);
+            ids.clear ();
+            uint32 flags = (edge ? Flag_Edge : 0) | (word && pg->has_word ? Flag_PrevWord : 0);
+            starts[k] = intern (flags);
+            return starts[k];
+        }
+
+        //!
+        //! \brief step 计算状态在字节类别c(或文本结束)上的后继
+        //! \param eot 文本结束，此时只求匹配，edge表示是否为真正的文本边界
+        //! \return 后继状态；eot时返回是否匹配
+        //!
+        int32 step(int32 sid, int c, bool eot, bool edge, bool word_after)
+        {
+            const state s = states[sid];
+            const int b = eot ? -1 : pg->reps[c];
+            context cx;
+            cx.edge_before = (s.flags & Flag_Edge) != 0;
+            cx.edge_after = eot && edge;
+            cx.word_before = (s.flags & Flag_PrevWord) != 0;
+            cx.word_after = eot ? word_after : is_word (b);
+            cx.known_after = true;
+
+            // 展开待定的断言
+            q.clear ();
+            for (int i = 0; i < s.count; ++i)
+            {
+                const uint32 pc = pool[s.begin + i];
+                if (pg->insts[pc].op == Op_Assert)
+                    closure (*pg, pc, cx, q, stack);
+                else if (!q.has (pc))
+                    q.add (pc);
+            }
+
+            context nx = {false, false, b >= 0 && is_word (b), false, false};
+            nq.clear ();
+            ids.clear ();
+            bool matched = false;
+            for (int i = 0; i < q.n; ++i)
+            {
+                const inst &in = pg->insts[q.dense[i]];
+                if (in.op == Op_Match)
+                {
+                    matched = true;
+                    ids.push ((int32)in.out1);
+                    if (!longest)
+                        break;      // 低优先级的线程被截断
+                }
+                else if (in.op == Op_Byte && b >= in.lo && b <= in.hi)
+                    closure (*pg, in.out, nx, nq, stack);
+            }
+            if (eot)
+                return matched ? 1 : 0;
+
+            leaves (nq);
+            if (key.n == 0 && !matched)
+                return State_Dead;
+            const uint32 flags = (matched ? Flag_Matched : 0) |
+                    (pg->has_word && nx.word_before ? Flag_PrevWord : 0);
+            return intern (flags);
+        }
+
+        //! 计算并缓存转移，缓存超出预算时清空后重建当前状态
+        int32 next(int32 &sid, int c, size_t pos)
+        {
+            if (used > budget)
+            {
+                // 清空后前进太少说明状态数爆炸，交给NFA
+                if (resets > 0 && pos - mark < (size_t)states.n * 10)
+                    return State_GaveUp;
+                ++resets;
+                mark = pos;
+                const state s = states[sid];
+                buffer<uint32> saved;
+                buffer<int32> savedids;
+                for (int i = 0; i < s.count; ++i)
+                    saved.push (pool[s.begin + i]);
+                for (int i = 0; i < s.mcount; ++i)
+                    savedids.push (mids[s.mbegin + i]);
+                reset ();
+                key.clear ();
+                for (int i = 0; i < saved.n; ++i)
+                    key.push (saved[i]);
+                ids.clear ();
+                for (int i = 0; i < savedids.n; ++i)
+                    ids.push (savedids[i]);
+                sid = intern (s.flags);
+            }
+            const int32 t = step (sid, c, false, false, false);
+            trans[sid * pg->nclass + c] = t;
+            return t;
+        }
+
+        bool eot(int32 sid, bool edge, bool word_after)
+        {
+            return step (sid, 0, true, edge, word_after) != 0;
+        }
+        //! eot时的模式编号，在step之后读取ids
+        const buffer<int32> &eot_ids(int32 sid, bool edge, bool word_after)
+        {
+            step (sid, 0, true, edge, word_after);
+            return ids;
+        }
+    };
+
+    // ------------------------------------------------------------------
+    // NFA并行模拟(Pike VM)，DFA放弃时使用
+    // ------------------------------------------------------------------
+    struct pike
+    {
+        const program &pg;
+        const uint8 *text;
+        size_t n;
+        sparse a, b;
+        buffer<size_t> capa, capb;  ///< 线程的起始位置
+        buffer<uint32> stack;
+        buffer<size_t> stackcap;
+
+        pike(const program &p, const uint8 *s, size_t len):pg(p), text(s), n(len)
+        {
+            a.init (pg.insts.n);
+            b.init (pg.insts.n);
+            capa.resize (pg.insts.n);
+            capb.resize (pg.insts.n);
+        }
+
+        context at(size_t i)const
+        {
+            context cx;
+            cx.edge_before = i == 0;
+            cx.edge_after = i == n;
+            cx.word_before = i > 0 && is_word (text[i - 1]);
+            cx.word_after = i < n && is_word (text[i]);
+            cx.known_after = true;
+            return cx;
+        }
+
+        void add(sparse &q, buffer<size_t> &cap, uint32 pc, size_t from, const context &cx)
+        {
+            stack.clear ();
+            stackcap.clear ();
+            stack.push (pc);
+            stackcap.push (from);
+            while (stack.n)
+            {
+                const uint32 p = stack[--stack.n];
+                const size_t f = stackcap[--stackcap.n];
+                if (p == 0 || q.has (p))
+                    continue;
+                q.add (p);
+                cap[p] = f;
+                const inst &in = pg.insts[p];
+                if (in.op == Op_Nop)
+                {
+                    stack.push (in.out);
+                    stackcap.push (f);
+                }
+                else if (in.op == Op_Split)
+                {
+                    stack.push (in.out1);
+                    stackcap.push (f);
+                    stack.push (in.out);
+                    stackcap.push (f);
+                }
+                else if (in.op == Op_Assert)
+                {
+                    bool ok;
+                    if (in.what == Assert_BeginText)
+                        ok = cx.edge_before;
+                    else if (in.what == Assert_EndText)
+                        ok = cx.edge_after;
+                    else
+                        ok = (cx.word_before != cx.word_after) == (in.what == Assert_Word);
+                    if (ok)
+                    {
+                        stack.push (in.out);
+                        stackcap.push (f);
+                    }
+                }
+            }
+        }
+
+        //!
+        //! \brief run 从pos开始模拟
+        //! \param anchored 只从pos开始
+        //! \param longest 不截断低优先级线程，记录最后的匹配
+        //! \param hits 不为空时记录全部匹配的模式编号，不截断
+        //! \return 是否匹配，[s, e)为匹配的范围
+        //!
+        bool run(size_t pos, bool anchored, bool longest, uint8 *hits, size_t &s, size_t &e)
+        {
+            sparse *cl = &a, *nl = &b;
+            buffer<size_t> *cc = &capa, *nc = &capb;
+            bool matched = false;
+            cl->clear ();
+            for (size_t i = pos; ; ++i)
+            {
+                const context cx = at (i);
+                // 最左优先时有匹配后不再开始新的线程
+                if ((!matched || hits) && (!anchored || i == pos))
+                    add (*cl, *cc, pg.start, i, cx);
+                if (cl->n == 0 && (anchored || matched))
+                    break;
+                nl->clear ();
+                const int byte = i < n ? text[i] : -1;
+                const context nx = at (i < n ? i + 1 : n);
+                for (int k = 0; k < cl->n; ++k)
+                {
+                    const uint32 p = cl->dense[k];
+                    const inst &in = pg.insts[p];
+                    if (in.op == Op_Match)
+                    {
+                        if (hits)
+                        {
+                            hits[in.out1] = 1;
+                            matched = true;
+                            continue;
+                        }
+                        if (!longest || !matched || i > e)
+                        {
+                            s = (*cc)[p];
+                            e = i;
+                        }
+                        matched = true;
+                        if (!longest)
+                            break;      // 截断低优先级的线程
+                    }
+                    else if (in.op == Op_Byte && byte >= in.lo && byte <= in.hi)
+                        add (*nl, *nc, in.out, (*cc)[p], nx);
+                }
+                if (i >= n)
+                    break;
+                sparse *t = cl; cl = nl; nl = t;
+                buffer<size_t> *tc = cc; cc = nc; nc = tc;
+            }
+            return matched;
+        }
+    };
+
+    //! 语法树开头的字面串，用于前缀跳跃
+    inline void literal_prefix(const tree &t, int32 root, buffer<char> &out)
+    {
+        int32 id = root;
+        if (t.nodes[id].kind == Node_Concat)
+            id = t.nodes[id].child;
+        for (; id >= 0; id = t.nodes[id].next)
+        {
+            const node &v = t.nodes[id];
+            if (v.kind != Node_Class || v.b != 1 || t.ranges[v.a].lo != t.ranges[v.a].hi)
+                break;
+            uint8 u[4];
+            const int k = compiler::encode (t.ranges[v.a].lo, u);
+            for (int i = 0; i < k; ++i)
+                out.push ((char)u[i]);
+            if (root == id)
+                break;
+        }
+    }
+
+    //! UTF-16转为UTF-8，短文本使用栈上缓冲
+    struct utf8
+    {
+        char buf[512];
+        char *s;
+        size_t n;
+
+        explicit utf8(const ky_string &v):s(buf), n(0)
+        {
+            const ky_stringview sv = v.view ();
+            const size_t len = sv.length ();
+            if (len * 3 > sizeof(buf))
+                s = (char *)kyMalloc (len * 3);
+            if (len)
+                n = ky_utf::utf16_to_utf8 (sv.data (), len, (uint8 *)s, true);
+        }
+        ~utf8()
+        {
+            if (s != buf)
+                kyFree (s);
+        }
+    };
+
+    inline ky_string to_utf16(const char *s, size_t n)
+    {
+        if (n == 0)
+            return ky_string();
+        uint16 buf[256];
+        uint16 *u = n <= 256 ? buf : (uint16 *)kyMalloc (n * sizeof(uint16));
+        const size_t w = ky_utf::utf8_to_utf16 ((const uint8 *)s, n, u, true);
+        ky_string out((const ky_char *)u, (int)w);
+        if (u != buf)
+            kyFree (u);
+        return out;
+    }
+
+    //! 多线程同时匹配时，取不到共享缓存的线程使用临时缓存
+    struct cache
+    {
+        ky_rwlock lock;
+        dfa fwd;        ///< 正向，最左优先
+        dfa full;       ///< 正向，整体匹配
+        dfa rev;        ///< 反向，最长
+    };
+}
+
+namespace __regex__ {
+struct regex
+{
+    ky_string pattern;
+    bool valid;
+    __regex__::program fwd;
+    __regex__::program rev;
+    __regex__::buffer<char> prefix;
+    __regex__::cache shared;
+
+    regex():valid(false){}
+
+    void build(const char *s, size_t n)
+    {
+        __regex__::tree t;
+        __regex__::parser ps(t, s, n);
+        const int32 root = ps.parse ();
+        if (root < 0)
+            return;
+        fwd.has_word = rev.has_word = t.has_word;
+        __regex__::compiler cf(fwd, t, false);
+        cf.finish (cf.pattern (root, 0));
+        __regex__::compiler cr(rev, t, true);
+        cr.finish (cr.pattern (root, 0));
+        if (cf.overflow || cr.overflow)
+            return;
+        fwd.patterns = rev.patterns = 1;
+        if (!t.has_word)
+            __regex__::literal_prefix (t, root, prefix);
+        valid = true;
+        init (shared);
+    }
+
+    void init(__regex__::cache &c)const
+    {
+        c.fwd.init (&fwd, false);
+        c.full.init (&fwd, true);
+        c.rev.init (&rev, true);
+    }
+
+    //! 正向最左优先扫描，返回匹配的结束位置，-1为没有匹配
+    intptr scan(__regex__::dfa &d, const uint8 *s, size_t n, size_t pos, bool stop_first)const
+    {
+        using namespace __regex__;
+        d.begin_scan ();
+        int32 st = d.start (false, pos == 0, pos > 0 && is_word (s[pos - 1]));
+        intptr last = -1;
+        size_t i = pos;
+        const uint8 *cls = fwd.classes;
+        for (; i < n; ++i)
+        {
+            if (prefix.n && (d.states[st].flags & Flag_Matched) == 0)
+            {
+                if (d.loop == State_Unknown)
+                    d.loop = d.start (false, false, false);
+                if (st == d.loop || st == d.starts[2])
+                {
+                    // 只剩非锚定循环的线程，跳到下一个前缀
+                    const intptr at = ky_search::find ((const char *)s + i, n - i, prefix.d, (size_t)prefix.n);
+                    if (at < 0)
+                        return last;
+                    if (at > 0)
+                    {
+                        i += (size_t)at;
+                        st = d.loop;
+                    }
+                }
+            }
+            const int c = cls[s[i]];
+            int32 t = d.trans[st * fwd.nclass + c];
+            if (t == State_Unknown)
+                t = d.next (st, c, i);
+            if (t < 0)
+            {
+                if (t == State_GaveUp)
+                    return -2;
+                return last;
+            }
+            st = t;
+            if (d.states[st].flags & Flag_Matched)
+            {
+                last = (intptr)i;
+                if (stop_first)
+                    return last;
+            }
+        }
+        if (d.eot (st, true, false))
+            last = (intptr)n;
+        return last;
+    }
+
+    //! 反向最长扫描，从e向前到pos，返回匹配的起始位置
+    intptr rscan(__regex__::dfa &d, const uint8 *s, size_t n, size_t pos, size_t e)const
+    {
+        using namespace __regex__;
+        d.begin_scan ();
+        int32 st = d.start (true, e == n, e < n && is_word (s[e]));
+        intptr first = -1;
+        size_t i = e;
+        const uint8 *cls = rev.classes;
+        for (; i > pos; --i)
+        {
+            const int c = cls[s[i - 1]];
+            int32 t = d.trans[st * rev.nclass + c];
+            if (t == State_Unknown)
+                t = d.next (st, c, e - i);
+            if (t < 0)
+            {
+                if (t == State_GaveUp)
+                    return -2;
+                return first;
+            }
+            st = t;
+            if (d.states[st].flags & Flag_Matched)
+                first = (intptr)i;
+        }
+        if (d.eot (st, pos == 0, pos > 0 && is_word (s[pos - 1])))
+            first = (intptr)pos;
+        return first;
+    }
+
+    bool find(__regex__::cache &c, const uint8 *s, size_t n, size_t from, size_t &ms, size_t &me)const
+    {
+        const intptr e = scan (c.fwd, s, n, from, false);
+        if (e == -1)
+            return false;
+        if (e >= 0)
+        {
+            const intptr b = rscan (c.rev, s, n, from, (size_t)e);
+            if (b >= 0)
+            {
+                ms = (size_t)b;
+                me = (size_t)e;
+                return true;
+            }
+        }
+        __regex__::pike vm(fwd, s, n);
+        return vm.run (from, false, false, NULL, ms, me);
+    }
+
+    bool whole(__regex__::cache &c, const uint8 *s, size_t n)const
+    {
+        using namespace __regex__;
+        dfa &d = c.full;
+        d.begin_scan ();
+        int32 st = d.start (true, true, false);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const int cl = fwd.classes[s[i]];
+            int32 t = d.trans[st * fwd.nclass + cl];
+            if (t == State_Unknown)
+                t = d.next (st, cl, i);
+            if (t == State_Dead)
+                return false;
+            if (t == State_GaveUp)
+            {
+                pike vm(fwd, s, n);
+                size_t ms = 0, me = 0;
+                return vm.run (0, true, true, NULL, ms, me) && me == n;
+            }
+            st = t;
+        }
+        return d.eot (st, true, false);
+    }
+
+    //! 取共享缓存，被其他线程占用时使用临时缓存
+    template <typename Fn>
+    void with(Fn fn)const
+    {
+        __regex__::cache &c = const_cast<__regex__::cache &>(shared);
+        if (c.lock.trylockwr (0))
+        {
+            fn (c);
+            c.lock.unlock ();
+            return;
+        }
+        __regex__::cache tmp;
+        init (tmp);
+        fn (tmp);
+    }
+};
+
+struct regex_set
+{
+    __regex__::buffer<char> patterns;   ///< 以0分隔的UTF-8模式
+    int count;
+    bool compiled;
+    __regex__::program prog;
+    ky_rwlock lock;
+    __regex__::dfa shared;
+
+    regex_set():count(0), compiled(false){}
+
+    //! 扫描全部文本，hits[i]为1表示第i个模式有匹配；any时找到一个即返回
+    int scan(__regex__::dfa &d, const uint8 *s, size_t n, uint8 *hits, bool any)const
+    {
+        using namespace __regex__;
+        d.begin_scan ();
+        int found = 0;
+        int32 st = d.start (false, true, false);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const int c = prog.classes[s[i]];
+            int32 t = d.trans[st * prog.nclass + c];
+            if (t == State_Unknown)
+                t = d.next (st, c, i);
+            if (t == State_GaveUp)
+            {
+                pike vm(prog, s, n);
+                memset (hits, 0, (size_t)count);
+                size_t ms = 0, me = 0;
+                vm.run (0, false, true, hits, ms, me);
+                found = 0;
+                for (int k = 0; k < count; ++k)
+                    found += hits[k];
+                return found;
+            }
+            st = t;
+            const dfa::state &v = d.states[st];
+            if (v.mcount)
+            {
+                for (int k = 0; k < v.mcount; ++k)
+                {
+                    const int32 id = d.mids[v.mbegin + k];
+                    if (!hits[id])
+                    {
+                        hits[id] = 1;
+                        ++found;
+                    }
+                }
+                if (any || found == count)
+                    return found;
+            }
+        }
+        const buffer<int32> &last = d.eot_ids (st, true, false);
+        for (int k = 0; k < last.n; ++k)
+        {
+            if (!hits[last[k]])
+            {
+                hits[last[k]] = 1;
+                ++found;
+            }
+        }
+        return found;
+    }
+
+    int run(const uint8 *s, size_t n, uint8 *hits, bool any)const
+    {
+        memset (hits, 0, (size_t)count);
+        if (!compiled || count == 0)
+            return 0;
+        regex_set *self = const_cast<regex_set *>(this);
+        if (self->lock.trylockwr (0))
+        {
+            const int r = scan (self->shared, s, n, hits, any);
+            self->lock.unlock ();
+            return r;
+        }
+        __regex__::dfa tmp;
+        tmp.init (&prog, true);
+        return scan (tmp, s, n, hits, any);
+    }
+};
+}
+
+inline ky_regex_dfa::ky_regex_dfa(const ky_string &re):
+    impl(new __regex__::regex)
+{
+    impl->pattern = re;
+    const __regex__::utf8 u(re);
+    impl->build (u.s, u.n);
+}
+
+inline ky_regex_dfa::ky_regex_dfa(const char *re):
+    impl(new __regex__::regex)
+{
+    const size_t n = re ? strlen (re) : 0;
+    impl->pattern = __regex__::to_utf16 (re, n);
+    impl->build (re, n);
+}
+
+inline ky_regex_dfa::ky_regex_dfa(const ky_regex &re):
+    impl(new __regex__::regex)
+{
+    impl->pattern = re.regex ();
+    const __regex__::utf8 u(impl->pattern);
+    impl->build (u.s, u.n);
+}
+
+inline ky_regex_dfa::~ky_regex_dfa()
+{
+    delete impl;
+}
+
+inline const ky_string &ky_regex_dfa::regex() const
+{
+    return impl->pattern;
+}
+
+inline bool ky_regex_dfa::is_valid() const
+{
+    return impl->valid;
+}
+
+inline bool ky_regex_dfa::find(const char *s, size_t n, size_t from, size_t &pos, size_t &len) const
+{
+    if (!impl->valid || from > n)
+        return false;
+    bool ok = false;
+    size_t b = 0, e = 0;
+    impl->with ([&](__regex__::cache &c){ok = impl->find (c, (const uint8 *)s, n, from, b, e);});
+    if (ok)
+    {
+        pos = b;
+        len = e - b;
+    }
+    return ok;
+}
+
+inline bool ky_regex_dfa::contains(const char *s, size_t n) const
+{
+    if (!impl->valid)
+        return false;
+    bool ok = false;
+    impl->with ([&](__regex__::cache &c)
+    {
+        const intptr e = impl->scan (c.fwd, (const uint8 *)s, n, 0, true);
+        if (e == -2)
+        {
+            __regex__::pike vm(impl->fwd, (const uint8 *)s, n);
+            size_t ms = 0, me = 0;
+            ok = vm.run (0, false, false, NULL, ms, me);
+        }
+        else
+            ok = e >= 0;
+    });
+    return ok;
+}
+
+inline int ky_regex_dfa::match(const ky_u8stringview &str) const
+{
+    if (!impl->valid)
+        return 0;
+    bool ok = false;
+    impl->with ([&](__regex__::cache &c){ok = impl->whole (c, (const uint8 *)str.data (), str.length ());});
+    return ok ? 1 : 0;
+}
+
+inline int ky_regex_dfa::match(const ky_string &str) const
+{
+    const __regex__::utf8 u(str);
+    return match (ky_u8stringview(u.s, (int)u.n));
+}
+
+namespace __regex__
+{
+    //!
+    //! \brief each 依次报告不重叠的匹配，空匹配紧接上一个匹配时跳过一个字符
+    //! \param fn 以(起始, 结束)调用
+    //!
+    template <typename Fn>
+    int each(const ky_regex_dfa &re, const char *s, size_t n, Fn fn)
+    {
+        int times = 0;
+        size_t from = 0;
+        intptr prev = -1;
+        size_t b, len;
+        while (from <= n && re.find (s, n, from, b, len))
+        {
+            if (len == 0 && (intptr)b == prev)
+            {
+                // 跳过一个UTF-8字符
+                ++from;
+                while (from < n && ((uint8)s[from] & 0xc0) == 0x80)
+                    ++from;
+                continue;
+            }
+            fn (b, b + len);
+            ++times;
+            prev = (intptr)(b + len);
+            from = b + len;
+        }
+        return times;
+    }
+}
+
+inline int ky_regex_dfa::search(const ky_u8stringview &str, ky_u8string_list *reustl) const
+{
+    const char *s = str.data ();
+    return __regex__::each (*this, s, str.length (), [&](size_t b, size_t e)
+    {
+        if (reustl)
+            reustl->append (ky_u8string(s + b, (int)(e - b)));
+    });
+}
+
+inline int ky_regex_dfa::search(const ky_string &str, ky_string_list *reustl) const
+{
+    const __regex__::utf8 u(str);
+    const char *s = u.s;
+    return __regex__::each (*this, s, u.n, [&](size_t b, size_t e)
+    {
+        if (reustl)
+            reustl->append (__regex__::to_utf16 (s + b, e - b));
+    });
+}
+
+inline int ky_regex_dfa::split(const ky_u8stringview &str, ky_u8string_list *reustl) const
+{
+    const char *s = str.data ();
+    size_t last = 0;
+    int pieces = 1;
+    __regex__::each (*this, s, str.length (), [&](size_t b, size_t e)
+    {
+        if (e == b)
+            return;
+        if (reustl)
+            reustl->append (ky_u8string(s + last, (int)(b - last)));
+        last = e;
+        ++pieces;
+    });
+    if (reustl)
+        reustl->append (ky_u8string(s + last, (int)(str.length () - last)));
+    return pieces;
+}
+
+inline int ky_regex_dfa::split(const ky_string &str, ky_string_list *reustl) const
+{
+    const __regex__::utf8 u(str);
+    const char *s = u.s;
+    size_t last = 0;
+    int pieces = 1;
+    __regex__::each (*this, s, u.n, [&](size_t b, size_t e)
+    {
+        if (e == b)
+            return;
+        if (reustl)
+            reustl->append (__regex__::to_utf16 (s + last, b - last));
+        last = e;
+        ++pieces;
+    });
+    if (reustl)
+        reustl->append (__regex__::to_utf16 (s + last, u.n - last));
+    return pieces;
+}
+
+inline ky_regex_set::ky_regex_set():
+    impl(new __regex__::regex_set)
+{
+}
+
+inline ky_regex_set::~ky_regex_set()
+{
+    delete impl;
+}
+
+inline int ky_regex_set::append(const char *re)
+{
+    const size_t n = re ? strlen (re) : 0;
+    // 先单独解析以检查语法
+    __regex__::tree t;
+    __regex__::parser ps(t, re, n);
+    if (ps.parse () < 0)
+        return -1;
+    for (size_t i = 0; i < n; ++i)
+        impl->patterns.push (re[i]);
+    impl->patterns.push ('\0');
+    impl->compiled = false;
+    return impl->count++;
+}
+
+inline int ky_regex_set::append(const ky_string &re)
+{
+    const __regex__::utf8 u(re);
+    __regex__::buffer<char> z;
+    for (size_t i = 0; i < u.n; ++i)
+        z.push (u.s[i]);
+    z.push ('\0');
+    return append (z.d);
+}
+
+inline bool ky_regex_set::compile()
+{
+    using namespace __regex__;
+    program &pg = impl->prog;
+    pg.insts.release ();
+    impl->compiled = false;
+    if (impl->count == 0)
+        return false;
+
+    tree t;
+    buffer<int32> roots;
+    const char *s = impl->patterns.d;
+    for (int i = 0; i < impl->count; ++i)
+    {
+        const size_t n = strlen (s);
+        parser ps(t, s, n);
+        roots.push (ps.parse ());
+        s += n + 1;
+    }
+    pg.has_word = t.has_word;
+    compiler cp(pg, t, false);
+    // 各模式以Split串联，Match带模式编号
+    uint32 start = cp.pattern (roots[roots.n - 1], roots.n - 1);
+    for (int i = roots.n - 2; i >= 0; --i)
+    {
+        const uint32 b = cp.pattern (roots[i], i);
+        const uint32 sp = cp.emit (Op_Split);
+        pg.insts[sp].out = b;
+        pg.insts[sp].out1 = start;
+        start = sp;
+    }
+    cp.finish (start);
+    if (cp.overflow)
+        return false;
+    pg.patterns = impl->count;
+    impl->shared.init (&pg, true);
+    impl->compiled = true;
+    return true;
+}
+
+inline void ky_regex_set::clear()
+{
+    impl->patterns.release ();
+    impl->prog.insts.release ();
+    impl->count = 0;
+    impl->compiled = false;
+}
+
+inline int ky_regex_set::count() const
+{
+    return impl->count;
+}
+
+inline int ky_regex_set::match(const ky_u8stringview &str, ky_vector<int> *ids) const
+{
+    uint8 local[64];
+    uint8 *hits = impl->count <= 64 ? local : (uint8 *)kyMalloc ((size_t)impl->count);
+    const int found = impl->run ((const uint8 *)str.data (), str.length (), hits, false);
+    if (ids)
+    {
+        for (int i = 0; i < impl->count && found; ++i)
+            if (hits[i])
+                ids->append (i);
+    }
+    if (hits != local)
+        kyFree (hits);
+    return found;
+}
+
+inline int ky_regex_set::match(const ky_string &str, ky_vector<int> *ids) const
+{
+    const __regex__::utf8 u(str);
+    return match (ky_u8stringview(u.s, (int)u.n), ids);
+}
+
+inline bool ky_regex_set::contains(const ky_u8stringview &str) const
+{
+    uint8 local[64];
+    uint8 *hits = impl->count <= 64 ? local : (uint8 *)kyMalloc ((size_t)impl->count);
+    const int found = impl->run ((const uint8 *)str.data (), str.length (), hits, true);
+    if (hits != local)
+        kyFree (hits);
+    return found > 0;
+}
+
+#endif // KY_REGEX_DFA_INL
@@ -0,0 +1,126 @@
+
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_search.h
+ * @brief    子串查找及多模式匹配
+ *       1.ky_search::find 以首尾字符过滤候选位置，SSE2每次16字节、AVX2每次32字节，
+ *         候选位置再逐个比较；首次使用时按ky_cpu::has选择指令集
+ *       2.候选比较的代价超过扫描长度的比例时转为Two-Way算法，最坏情况仍为线性
+ *       3.ky_aho_corasick 将多个模式编译为按字节类别跳转的自动机，一次扫描找出全部匹配
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ */
+#ifndef ky_SEARCH_H
+#define ky_SEARCH_H
+
+#include "ky_define.h"
+#include "ky_cpu.h"
+
+#if ((kyArchitecture & kyArch_X86) == kyArch_X86)
+#  if (kyCompiler == kyCompiler_GNUC) || (kyCompiler == kyCompiler_CLANG)
+#    define kySearchSimd 1
+#    define kySearchTarget(isa) __attribute__((target(isa)))
+#  elif kyCompiler == kyCompiler_MSVC
+#    define kySearchSimd 1
+#    define kySearchTarget(isa)
+#  endif
+#endif
+#ifdef kySearchSimd
+#include <immintrin.h>
+#endif
+
+namespace ky_search
+{
+    //!
+    //! \brief find 在h[0, n)中查找needle[0, m)
+    //! \return 第一次出现的位置，没有时返回-1；m为0时返回0
+    //!
+    intptr find(const char *h, size_t n, const char *needle, size_t m);
+    intptr find(const uint16 *h, size_t n, const uint16 *needle, size_t m);
+    //! 查找单个字符
+    intptr find(const char *h, size_t n, char c);
+    intptr find(const uint16 *h, size_t n, uint16 c);
+}
+
+/*!
+ * @brief The ky_aho_corasick class 多模式匹配
+ * @class ky_aho_corasick
+ *  先append全部模式，compile后查找；compile后的对象只读，可多线程共用
+ *  按字节匹配，用于UTF-8及二进制数据
+ */
+class ky_aho_corasick
+{
+public:
+    struct match
+    {
+        int pattern;    ///< append返回的编号
+        intptr pos;     ///< 匹配的起始位置
+        int length;
+    };
+
+public:
+    ky_aho_corasick();
+    ~ky_aho_corasick();
+
+    //! 加入模式，返回编号；空模式被忽略并返回-1
+    int append(const char *s, int len = -1);
+    //! 编译自动机，之后append需重新编译
+    void compile();
+    void clear();
+
+    bool is_compiled()const{return delta != NULL;}
+    int count()const{return patterns;}
+    //! 自动机的状态数
+    int states()const{return nstate;}
+
+    //!
+    //! \brief find 查找结束位置最靠前的匹配，同一位置结束时取最长的
+    //! \return 没有匹配时返回false
+    //!
+    bool find(const char *text, size_t n, match &m)const;
+    bool contains(const char *text, size_t n)const{match m;return find (text, n, m);}
+    //!
+    //! \brief each 按结束位置依次报告全部匹配（包括重叠的）
+    //! \param fn 以const match &调用，返回false时停止
+    //! \return 报告的匹配数
+    //!
+    template <typename Fn>
+    size_t each(const char *text, size_t n, Fn fn)const;
+
+private:
+    ky_aho_corasick(const ky_aho_corasick &);
+    ky_aho_corasick &operator = (const ky_aho_corasick &);
+
+    void release();
+
+    // 编译前的模式
+    char *bytes;
+    size_t nbytes;
+    size_t capbytes;
+    int *offset;         ///< 第i个模式的起始为offset[i]，共patterns + 1项
+    int patterns;
+    int cappatterns;
+
+    // 编译后的自动机
+    uint8 classes[256];  ///< 字节到类别，未出现在模式中的字节为0
+    int nclass;
+    int nstate;
+    int32 *delta;        ///< nstate * nclass 的跳转表
+    int32 *report;       ///< 状态对应的第一个有输出的状态，没有为-1
+    int32 *out;          ///< 状态结束的第一个模式
+    int32 *outlink;      ///< 后缀链上下一个有输出的状态
+    int32 *same;         ///< 同一状态结束的下一个模式
+};
+
+#include "ky_search.inl"
+#endif // ky_SEARCH_H
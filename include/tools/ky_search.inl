@@ -0,0 +1,587 @@
+#ifndef KY_SEARCH_INL
+#define KY_SEARCH_INL
+
+namespace ky_search {
+
+enum
+{
+    //! 开始时允许的候选比较量（按needle长度计）
+    CreditNeedles = 16,
+    //! 每扫描一个单元增加的候选比较量
+    CreditPerUnit = 2
+};
+
+enum eLevels
+{
+    Level_Scalar = 0,
+    Level_SSE2,
+    Level_AVX2
+};
+
+inline int _ctz_(uint32 w)
+{
+#if (kyCompiler == kyCompiler_GNUC) || (kyCompiler == kyCompiler_CLANG)
+    return __builtin_ctz (w);
+#else
+    int n = 0;
+    while (!(w & 1))
+    {
+        w >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+inline eLevels _select_()
+{
+#ifdef kySearchSimd
+    ky_cpu cpu;
+    if (cpu.has (CPU_AVX2))
+        return Level_AVX2;
+    if (cpu.has (CPU_SSE2))
+        return Level_SSE2;
+#endif
+    return Level_Scalar;
+}
+
+//! 首次使用时选择，之后不变
+inline eLevels _level_()
+{
+    static const eLevels level = _select_ ();
+    return level;
+}
+
+template <typename T>
+inline intptr _find_char_(const T *h, size_t n, T c)
+{
+    for (size_t i = 0; i < n; ++i)
+        if (h[i] == c)
+            return (intptr)i;
+    return -1;
+}
+
+#ifdef kySearchSimd
+kySearchTarget("sse2")
+inline intptr _find_char16_sse2_(const uint16 *h, size_t n, uint16 c)
+{
+    const __m128i v = _mm_set1_epi16 ((short)c);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const uint32 mask = _mm_movemask_epi8 (_mm_cmpeq_epi16 (_mm_loadu_si128 ((const __m128i *)(h + i)), v));
+        if (mask)
+            return (intptr)(i + (_ctz_ (mask) >> 1));
+    }
+    const intptr r = _find_char_ (h + i, n - i, c);
+    return r < 0 ? -1 : (intptr)i + r;
+}
+
+kySearchTarget("avx2")
+inline intptr _find_char16_avx2_(const uint16 *h, size_t n, uint16 c)
+{
+    const __m256i v = _mm256_set1_epi16 ((short)c);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const uint32 mask = _mm256_movemask_epi8 (_mm256_cmpeq_epi16 (_mm256_loadu_si256 ((const __m256i *)(h + i)), v));
+        if (mask)
+            return (intptr)(i + (_ctz_ (mask) >> 1));
+    }
+    const intptr r = _find_char_ (h + i, n - i, c);
+    return r < 0 ? -1 : (intptr)i + r;
+}
+#endif
+
+inline intptr find(const char *h, size_t n, char c)
+{
+    const char *at = (const char *)memchr (h, c, n);
+    return at ? (intptr)(at - h) : -1;
+}
+
+inline intptr find(const uint16 *h, size_t n, uint16 c)
+{
+#ifdef kySearchSimd
+    switch (_level_ ())
+    {
+    case Level_AVX2:
+        return _find_char16_avx2_ (h, n, c);
+    case Level_SSE2:
+        return _find_char16_sse2_ (h, n, c);
+    default:
+        break;
+    }
+#endif
+    return _find_char_ (h, n, c);
+}
+
+//! 最大后缀，less为真时按<排序，否则按>排序
+template <typename T>
+intptr _max_suffix_(const T *x, size_t m, bool less, size_t &period)
+{
+    intptr ms = -1;
+    size_t j = 0;
+    size_t k = 1;
+    size_t p = 1;
+    while (j + k < m)
+    {
+        const T a = x[j + k];
+        const T b = x[ms + (intptr)k];
+        if (less ? a < b : b < a)
+        {
+            j += k;
+            k = 1;
+            p = j - ms;
+        }
+        else if (a == b)
+        {
+            if (k != p)
+                ++k;
+            else
+            {
+                j += p;
+                k = 1;
+            }
+        }
+        else
+        {
+            ms = (intptr)j++;
+            k = p = 1;
+        }
+    }
+    period = p;
+    return ms;
+}
+
+//!
+//! \brief _two_way_ Crochemore-Perrin Two-Way算法，O(n + m)时间，O(1)空间
+//!
+template <typename T>
+intptr _two_way_(const T *h, size_t n, const T *x, size_t m)
+{
+    if (m == 0)
+        return 0;
+    if (m > n)
+        return -1;
+
+    // 关键分解：两种次序下的最大后缀取靠后的
+    size_t p1, p2;
+    const intptr s1 = _max_suffix_ (x, m, true, p1);
+    const intptr s2 = _max_suffix_ (x, m, false, p2);
+    const intptr ell = s1 > s2 ? s1 : s2;
+    size_t period = s1 > s2 ? p1 : p2;
+    const intptr suffix = ell + 1;
+
+    if (memcmp (x, x + period, (size_t)suffix * sizeof(T)) == 0)
+    {
+        // 周期性的needle：记住已匹配的前缀
+        intptr memory = 0;
+        for (size_t j = 0; j + m <= n; )
+        {
+            intptr i = suffix > memory ? suffix : memory;
+            while (i < (intptr)m && x[i] == h[i + j])
+                ++i;
+            if (i >= (intptr)m)
+            {
+                i = suffix - 1;
+                while (i >= memory && x[i] == h[i + j])
+                    --i;
+                if (i < memory)
+                    return (intptr)j;
+                j += period;
+                memory = (intptr)(m - period);
+            }
+            else
+            {
+                j += i - suffix + 1;
+                memory = 0;
+            }
+        }
+    }
+    else
+    {
+        const size_t lm = (size_t)suffix > m - suffix ? (size_t)suffix : m - suffix;
+        period = lm + 1;
+        for (size_t j = 0; j + m <= n; )
+        {
+            intptr i = suffix;
+            while (i < (intptr)m && x[i] == h[i + j])
+                ++i;
+            if (i >= (intptr)m)
+            {
+                i = suffix - 1;
+                while (i >= 0 && x[i] == h[i + j])
+                    --i;
+                if (i < 0)
+                    return (intptr)j;
+                j += period;
+            }
+            else
+                j += i - suffix + 1;
+        }
+    }
+    return -1;
+}
+
+//!
+//! \brief _scan_ 过滤扫描的结果
+//!  Found 找到，位置为at；Exhausted 候选比较超出额度，从at继续用Two-Way；
+//!  Tail 剩余不足一块，从at继续
+//!
+enum eScans
+{
+    Found,
+    Exhausted,
+    Tail
+};
+
+template <typename T>
+eScans _scan_scalar_(const T *h, size_t n, const T *x, size_t m, size_t &at)
+{
+    intptr credit = (intptr)m * CreditNeedles;
+    const T first = x[0];
+    const T last = x[m - 1];
+    for (size_t i = at; i + m <= n; ++i)
+    {
+        credit += CreditPerUnit;
+        if (h[i] != first || h[i + m - 1] != last)
+            continue;
+        if (memcmp (h + i + 1, x + 1, (m - 2) * sizeof(T)) == 0)
+        {
+            at = i;
+            return Found;
+        }
+        credit -= (intptr)m;
+        if (credit < 0)
+        {
+            at = i + 1;
+            return Exhausted;
+        }
+    }
+    at = n;
+    return Tail;
+}
+
+#ifdef kySearchSimd
+template <typename T>
+kySearchTarget("sse2")
+eScans _scan_sse2_(const T *h, size_t n, const T *x, size_t m, size_t &at)
+{
+    const size_t lanes = 16 / sizeof(T);
+    const __m128i first = sizeof(T) == 1 ? _mm_set1_epi8 ((char)x[0]) : _mm_set1_epi16 ((short)x[0]);
+    const __m128i last = sizeof(T) == 1 ? _mm_set1_epi8 ((char)x[m - 1]) : _mm_set1_epi16 ((short)x[m - 1]);
+    intptr credit = (intptr)m * CreditNeedles;
+    size_t i = at;
+    for (; i + m - 1 + lanes <= n; i += lanes)
+    {
+        const __m128i a = _mm_loadu_si128 ((const __m128i *)(h + i));
+        const __m128i b = _mm_loadu_si128 ((const __m128i *)(h + i + m - 1));
+        const __m128i eq = sizeof(T) == 1 ?
+                    _mm_and_si128 (_mm_cmpeq_epi8 (a, first), _mm_cmpeq_epi8 (b, last)) :
+                    _mm_and_si128 (_mm_cmpeq_epi16 (a, first), _mm_cmpeq_epi16 (b, last));
+        uint32 mask = (uint32)_mm_movemask_epi8 (eq);
+        credit += lanes * CreditPerUnit;
+        while (mask)
+        {
+            const size_t c = i + (_ctz_ (mask) / sizeof(T));
+            if (memcmp (h + c + 1, x + 1, (m - 2) * sizeof(T)) == 0)
+            {
+                at = c;
+                return Found;
+            }
+            credit -= (intptr)m;
+            if (credit < 0)
+            {
+                at = c + 1;
+                return Exhausted;
+            }
+            // 16位时每个单元占两位
+            mask &= mask - 1;
+            if (sizeof(T) == 2)
+                mask &= mask - 1;
+        }
+    }
+    at = i;
+    return Tail;
+}
+
+template <typename T>
+kySearchTarget("avx2")
+eScans _scan_avx2_(const T *h, size_t n, const T *x, size_t m, size_t &at)
+{
+    const size_t lanes = 32 / sizeof(T);
+    const __m256i first = sizeof(T) == 1 ? _mm256_set1_epi8 ((char)x[0]) : _mm256_set1_epi16 ((short)x[0]);
+    const __m256i last = sizeof(T) == 1 ? _mm256_set1_epi8 ((char)x[m - 1]) : _mm256_set1_epi16 ((short)x[m - 1]);
+    intptr credit = (intptr)m * CreditNeedles;
+    size_t i = at;
+    for (; i + m - 1 + lanes <= n; i += lanes)
+    {
+        const __m256i a = _mm256_loadu_si256 ((const __m256i *)(h + i));
+        const __m256i b = _mm256_loadu_si256 ((const __m256i *)(h + i + m - 1));
+        const __m256i eq = sizeof(T) == 1 ?
+                    _mm256_and_si256 (_mm256_cmpeq_epi8 (a, first), _mm256_cmpeq_epi8 (b, last)) :
+                    _mm256_and_si256 (_mm256_cmpeq_epi16 (a, first), _mm256_cmpeq_epi16 (b, last));
+        uint32 mask = (uint32)_mm256_movemask_epi8 (eq);
+        credit += lanes * CreditPerUnit;
+        while (mask)
+        {
+            const size_t c = i + (_ctz_ (mask) / sizeof(T));
+            if (memcmp (h + c + 1, x + 1, (m - 2) * sizeof(T)) == 0)
+            {
+                at = c;
+                return Found;
+            }
+            credit -= (intptr)m;
+            if (credit < 0)
+            {
+                at = c + 1;
+                return Exhausted;
+            }
+            mask &= mask - 1;
+            if (sizeof(T) == 2)
+                mask &= mask - 1;
+        }
+    }
+    at = i;
+    return Tail;
+}
+#endif
+
+template <typename T>
+intptr _find_(const T *h, size_t n, const T *x, size_t m)
+{
+    if (m == 0)
+        return 0;
+    if (m > n)
+        return -1;
+    if (m == 1)
+        return find (h, n, x[0]);
+
+    size_t at = 0;
+    eScans r;
+#ifdef kySearchSimd
+    switch (_level_ ())
+    {
+    case Level_AVX2:
+        r = _scan_avx2_ (h, n, x, m, at);
+        break;
+    case Level_SSE2:
+        r = _scan_sse2_ (h, n, x, m, at);
+        break;
+    default:
+        r = _scan_scalar_ (h, n, x, m, at);
+        break;
+    }
+#else
+    r = _scan_scalar_ (h, n, x, m, at);
+#endif
+    if (r == Found)
+        return (intptr)at;
+    // 过滤失效或剩余不足一块时，余下部分用Two-Way保证线性
+    const intptr t = _two_way_ (h + at, n - at, x, m);
+    return t < 0 ? -1 : (intptr)at + t;
+}
+
+inline intptr find(const char *h, size_t n, const char *needle, size_t m)
+{
+    return _find_ (h, n, needle, m);
+}
+
+inline intptr find(const uint16 *h, size_t n, const uint16 *needle, size_t m)
+{
+    return _find_ (h, n, needle, m);
+}
+
+}
+
+inline ky_aho_corasick::ky_aho_corasick():
+    bytes(NULL), nbytes(0), capbytes(0), offset(NULL), patterns(0), cappatterns(0),
+    nclass(0), nstate(0), delta(NULL), report(NULL), out(NULL), outlink(NULL), same(NULL)
+{
+}
+
+inline ky_aho_corasick::~ky_aho_corasick()
+{
+    clear ();
+}
+
+inline void ky_aho_corasick::release()
+{
+    kyFree (delta);
+    kyFree (report);
+    kyFree (out);
+    kyFree (outlink);
+    kyFree (same);
+    delta = report = out = outlink = same = NULL;
+    nstate = 0;
+    nclass = 0;
+}
+
+inline void ky_aho_corasick::clear()
+{
+    release ();
+    kyFree (bytes);
+    kyFree (offset);
+    bytes = NULL;
+    offset = NULL;
+    nbytes = capbytes = 0;
+    patterns = cappatterns = 0;
+}
+
+inline int ky_aho_corasick::append(const char *s, int len)
+{
+    if (s == NULL)
+        return -1;
+    if (len < 0)
+        len = (int)strlen (s);
+    if (len == 0)
+        return -1;
+    release ();
+
+    if (nbytes + len > capbytes)
+    {
+        capbytes = (nbytes + len) * 2;
+        bytes = (char *)kyRealloc (bytes, capbytes);
+    }
+    if (patterns + 2 > cappatterns)
+    {
+        cappatterns = (patterns + 2) * 2;
+        offset = (int *)kyRealloc (offset, cappatterns * sizeof(int));
+    }
+    memcpy (bytes + nbytes, s, len);
+    offset[patterns] = (int)nbytes;
+    nbytes += len;
+    offset[patterns + 1] = (int)nbytes;
+    return patterns++;
+}
+
+inline void ky_aho_corasick::compile()
+{
+    release ();
+    if (patterns == 0)
+        return;
+
+    // 模式中出现的每个字节一个类别，其余字节共用类别0
+    memset (classes, 0, sizeof(classes));
+    nclass = 1;
+    for (size_t i = 0; i < nbytes; ++i)
+    {
+        uint8 &c = classes[(uint8)bytes[i]];
+        if (c == 0)
+            c = (uint8)nclass++;
+    }
+
+    // 建立字典树，0为根，跳转0表示没有边（根不会是其他状态的子节点）
+    const size_t maxstate = nbytes + 1;
+    delta = (int32 *)kyMalloc (maxstate * nclass * sizeof(int32));
+    memset (delta, 0, maxstate * nclass * sizeof(int32));
+    out = (int32 *)kyMalloc (maxstate * sizeof(int32));
+    same = (int32 *)kyMalloc (patterns * sizeof(int32));
+    for (size_t i = 0; i < maxstate; ++i)
+        out[i] = -1;
+    nstate = 1;
+    for (int p = 0; p < patterns; ++p)
+    {
+        int32 s = 0;
+        for (int i = offset[p]; i < offset[p + 1]; ++i)
+        {
+            int32 &next = delta[s * nclass + classes[(uint8)bytes[i]]];
+            if (next == 0)
+                next = nstate++;
+            s = next;
+        }
+        same[p] = out[s];
+        out[s] = p;
+    }
+
+    // 按层遍历，缺少的边用失败状态的边补齐，得到完整的自动机
+    int32 *fail = (int32 *)kyMalloc (nstate * sizeof(int32));
+    int32 *queue = (int32 *)kyMalloc (nstate * sizeof(int32));
+    outlink = (int32 *)kyMalloc (nstate * sizeof(int32));
+    report = (int32 *)kyMalloc (nstate * sizeof(int32));
+    int head = 0;
+    int tail = 0;
+    fail[0] = 0;
+    outlink[0] = -1;
+    report[0] = -1;
+    for (int c = 0; c < nclass; ++c)
+    {
+        const int32 t = delta[c];
+        if (t)
+        {
+            fail[t] = 0;
+            outlink[t] = -1;
+            report[t] = out[t] >= 0 ? t : -1;
+            queue[tail++] = t;
+        }
+    }
+    while (head < tail)
+    {
+        const int32 s = queue[head++];
+        for (int c = 0; c < nclass; ++c)
+        {
+            int32 &t = delta[s * nclass + c];
+            const int32 f = delta[fail[s] * nclass + c];
+            if (t == 0)
+            {
+                t = f;
+                continue;
+            }
+            fail[t] = f;
+            outlink[t] = report[f];
+            report[t] = out[t] >= 0 ? t : outlink[t];
+            queue[tail++] = t;
+        }
+    }
+    kyFree (fail);
+    kyFree (queue);
+}
+
+template <typename Fn>
+size_t ky_aho_corasick::each(const char *text, size_t n, Fn fn)const
+{
+    if (delta == NULL)
+        return 0;
+    size_t found = 0;
+    int32 s = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        s = delta[s * nclass + classes[(uint8)text[i]]];
+        for (int32 t = report[s]; t >= 0; t = outlink[t])
+        {
+            for (int32 p = out[t]; p >= 0; p = same[p])
+            {
+                match m;
+                m.pattern = p;
+                m.length = offset[p + 1] - offset[p];
+                m.pos = (intptr)(i + 1) - m.length;
+                ++found;
+                if (!fn (m))
+                    return found;
+            }
+        }
+    }
+    return found;
+}
+
+inline bool ky_aho_corasick::find(const char *text, size_t n, match &m)const
+{
+    if (delta == NULL)
+        return false;
+    int32 s = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        s = delta[s * nclass + classes[(uint8)text[i]]];
+        const int32 t = report[s];
+        if (t < 0)
+            continue;
+        // 后缀链上第一个有输出的状态最深，即最长的模式
+        m.pattern = out[t];
+        m.length = offset[m.pattern + 1] - offset[m.pattern];
+        m.pos = (intptr)(i + 1) - m.length;
+        return true;
+    }
+    return false;
+}
+
+#endif // KY_SEARCH_INL
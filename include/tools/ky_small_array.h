@@ -0,0 +1,432 @@
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_small_array.h
+ * @brief    带内联小缓冲的模板数组类(支持C++11)
+ *       ky_small_array 接口与ky_array一致
+ *       1.模板参数N指定内联缓冲的元素数，元素不超过N时不分配内存块
+ *       2.超出后移入ky_memory::array内存块，并支持引用计数和写时拷贝
+ *       3.ky_array的布局与预编译库一致，内联缓冲只在此类中提供
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ */
+
+#ifndef KY_SMALL_ARRAY_H
+#define KY_SMALL_ARRAY_H
+
+#include "ky_array.h"
+
+//!
+//! \brief The ky_small_inline struct ky_array的内联小缓冲
+//! \note used 小于0时数据位于ky_memory::array内存块中，
+//!       元素在缓冲内按位移动，和ky_memory::array的要求一致
+//!
+template <typename T, int N>
+struct ky_small_inline
+{
+    int used;
+    union
+    {
+        uint8 bytes[N * sizeof(T)];
+        uint64 align;
+    };
+
+    ky_small_inline():used(0){}
+
+    inline bool on_inline()const{return used >= 0;}
+    inline int inline_count()const{return used;}
+    inline void inline_set(int c){used = c;}
+    inline T *inline_data()const{return (T*)bytes;}
+
+    //! 在i位置腾出c个未构造的元素
+    T *inline_insert(int i, int c)
+    {
+        i = i < 0 ? 0 : (i > used ? used : i);
+        T *b = inline_data ();
+        ky_mem()->move (b + i + c, b + i, (used - i) * sizeof(T));
+        used += c;
+        return b + i;
+    }
+    //! 删除i位置开始c个已析构的元素
+    void inline_remove(int i, int c)
+    {
+        T *b = inline_data ();
+        ky_mem()->move (b + i, b + i + c, (used - i - c) * sizeof(T));
+        used -= c;
+    }
+    //! 将from开始的n个元素移动到to位置
+    void inline_move(int from, int n, int to)
+    {
+        if (from < 0 || n <= 0 || to < 0 || from == to ||
+                from + n > used || to + n > used)
+            return ;
+        uint8 tmp[N * sizeof(T)];
+        T *b = inline_data ();
+        ky_mem()->copy (tmp, b + from, n * sizeof(T));
+        if (from < to)
+            ky_mem()->move (b + from, b + from + n, (to - from) * sizeof(T));
+        else
+            ky_mem()->move (b + to + n, b + to, (from - to) * sizeof(T));
+        ky_mem()->copy (b + to, tmp, n * sizeof(T));
+    }
+};
+
+/*!
+ * @brief The ky_small_array class
+ * @class ky_small_array
+ * @note 索引使用参考
+ *       1.只是访问对象则使用at，更快速
+ *       2.需要改变时可采用[]会进行分离，较at慢
+ *       3.也可采样data访问指针型,需要自行处理内存越界,较at更快速
+ *       4.N 为内联缓冲的元素数，内联时拷贝为逐元素复制
+ */
+template<typename T, int N>
+class ky_small_array : protected ky_memory::array, protected ky_small_inline<T, N>
+{
+    kyCompilerAssert(N > 0);
+public:
+    typedef T Type ;
+    typedef ky_memory::array Layout;
+    typedef ky_small_inline<T, N> Inline;
+    typedef Layout::header_t LayoutHeader;
+    enum {not_construct = ky_is_type(T)};
+    enum {sizeOf = sizeof(Type)};
+    enum {inline_size = N};
+
+    // C++11
+#if kyLanguage >= kyLanguage11
+public:
+    ky_small_array(ky_small_array&& rhs);
+    ky_small_array& operator =(ky_small_array&& rhs);
+    ky_small_array(const std::initializer_list<Type> & il);
+
+    //!
+    //! \brief prepend append insert 右值版本，元素移动构造
+    //! \param c
+    //! \return
+    //! \note 当内部有数据时并且也被引用此时会将数据分离
+    //!
+    ky_small_array &prepend(Type &&c);
+    ky_small_array &append(Type &&c);
+    ky_small_array &insert(int i, Type &&c);
+
+    //!
+    //! \brief emplace 在i位置以args就地构造元素
+    //! \param i
+    //! \param args
+    //! \return 返回构造的元素
+    //! \note 当内部有数据时并且也被引用此时会将数据分离
+    //!
+    template <typename ... Args>
+    Type &emplace(int i, Args &&...args);
+    template <typename ... Args>
+    Type &emplace_back(Args &&...args){return emplace (INT_MAX, std::forward<Args>(args)...);}
+    template <typename ... Args>
+    Type &emplace_front(Args &&...args){return emplace (0, std::forward<Args>(args)...);}
+#endif
+
+public:
+    ky_small_array();
+    //!
+    //! \brief ky_small_array 根据默认储备大小构造函数
+    //! \param size 储备空间
+    //!
+    explicit ky_small_array(size_t size );
+    //!
+    //! \brief ky_small_array 默认引用构造函数
+    //! \param ref
+    //!
+    ky_small_array(const ky_small_array &ref);
+    //!
+    //! \brief ky_small_array 根据数据构造函数
+    //! \param buf
+    //! \param len
+    //!
+    ky_small_array(const Type *buf, size_t len);
+    //!
+    //! \brief ky_small_array 从不同内联缓冲大小的数组构造
+    //! \param rhs
+    //!
+    template <int M>
+    ky_small_array(const ky_small_array<T, M> &rhs):
+        Layout()
+    {
+        append (rhs.data (), rhs.size ());
+    }
+    //!
+    //! \brief ky_small_array 从ky_array构造，元素逐个复制
+    //! \param rhs
+    //!
+    explicit ky_small_array(const ky_array<T> &rhs):
+        Layout()
+    {
+        append (rhs.data (), rhs.size ());
+    }
+    //!
+    //! \brief array 复制为ky_array，用于和ky_array接口交换数据
+    //! \return
+    //!
+    ky_array<T> array()const {return ky_array<T>(data (), size ());}
+    virtual ~ky_small_array();
+
+    //!
+    //! \brief capacity 返回当前储备空间大小
+    //! \return
+    //!
+    inline size_t capacity() const
+    {return Inline::on_inline () ? (size_t)N : Layout::capacity ();}
+
+    //!
+    //! \brief size 返回当前数据的大小
+    //! \return
+    //!
+    inline size_t size()const
+    {return Inline::on_inline () ? (size_t)Inline::inline_count () : Layout::count ();}
+    //!
+    //! \brief bytecount 返回当前字节数
+    //! \return
+    //!
+    inline size_t bytecount()const{return size () * sizeOf;}
+    //!
+    //! \brief is_empty 返回当前数组是否是空数据
+    //! \return
+    //!
+    inline bool is_empty() const
+    {return Inline::on_inline () ? Inline::inline_count () == 0 : Layout::is_empty ();}
+    inline bool is_null()const
+    {return Inline::on_inline () ? Inline::inline_count () == 0 : Layout::is_null ();}
+    //!
+    //! \brief is_inline 返回数据是否位于内联缓冲
+    //! \return
+    //!
+    inline bool is_inline()const{return Inline::on_inline ();}
+
+    //!
+    //! \brief reserve 分配储备空间
+    //! \param size
+    //! \note 已经储备则进行内存从新分配
+    //!
+    void reserve(size_t size);
+    //!
+    //! \brief resize 申请数据空间
+    //! \param s
+    //! \note 当内部有数据时并且也被引用此时会将数据分离
+    //!
+    void resize(size_t s);
+    void resize(size_t s, const Type &v);
+
+    //!
+    //! \brief shrink 收缩储备空间到合适位置,返回收缩的空间
+    //! \return
+    //!
+    //size_t shrink();
+
+    operator Type *() const;
+    operator void *() const;
+    operator Type *() ;
+    operator void *() ;
+
+    //!
+    //! \brief data 返回当前数据指针
+    //! \return
+    //! \note 当内部有数据时并且也被引用此时会将数据分离
+    //!
+    Type *data();
+    //!
+    //! \brief data 返回当前数据指针
+    //! \return
+    //! \note const 禁止内部执行分离，因为外部只是使用
+    //!
+    Type * data() const;
+    //!
+    //! \brief offset 返回inx数据指针
+    //! \param inx
+    //! \return
+    //! \note 当内部有数据时并且也被引用此时会将数据分离
+    //!
+    Type *offset(int inx);
+    //!
+    //! \brief offset 返回inx数据指针
+    //! \param inx
+    //! \return
+    //! \note const 禁止内部执行分离，因为外部只是使用
+    //!
+    Type *offset(int inx)const;
+    //!
+    //! \brief clear 清除空间
+    //! \note 当内部有数据时并且也被引用此时会将数据分离
+    //!
+    void clear();
+    //!
+    //! \brief fill 填充空间为c
+    //! \param c
+    //! \param len
+    //! \note 当内部有数据时并且也被引用此时会将数据分离
+    //!
+    void fill(const Type &c, size_t len, int pos = 0);
+    //!
+    //! \brief at 返回i的位置数组元素
+    //! \param i
+    //! \return
+    //!
+    Type at(int i);
+    //!
+    //! \brief at 返回i的位置数组元素
+    //! \param i
+    //! \return
+    //!
+    const Type at(int i)const;
+
+    //!
+    //! \brief operator [] 重载数组访问下标
+    //! \param i
+    //! \return
+    //! \note 当内部有数据时并且也被引用此时会将数据分离
+    //!
+    Type &operator[](int i);
+    //!
+    //! \brief operator [] 重载数组访问下标
+    //! \param i
+    //! \return
+    //! \note const 禁止内部执行分离，因为外部只是使用
+    //!
+    const Type &operator[](int i)const;
+
+    //!
+    //! \brief prepend 在最前面添加元素
+    //! \param c
+    //! \return
+    //! \note 当内部有数据时并且也被引用此时会将数据分离
+    //!
+    ky_small_array &prepend(const Type &c);
+    ky_small_array &prepend(const Type *s, int len);
+    ky_small_array &prepend(const ky_small_array &a);
+    //!
+    //! \brief append 在尾部附加元素
+    //! \param c
+    //! \return
+    //! \note 当内部有数据时并且也被引用此时会将数据分离
+    //!
+    ky_small_array &append(const Type &c);
+    ky_small_array &append(const Type *s, size_t len);
+    ky_small_array &append(const ky_small_array &a);
+    //!
+    //! \brief insert 在指定i位置插入元素
+    //! \param i
+    //! \param c
+    //! \return
+    //! \note 当内部有数据时并且也被引用此时会将数据分离
+    //!
+    ky_small_array &insert(int i, const Type &c);
+    ky_small_array &insert(int i, const Type *s, size_t len);
+    ky_small_array &insert(int i, const ky_small_array &a);
+    //!
+    //! \brief remove 在指定位置删除len长度的元素
+    //! \param index
+    //! \param len
+    //! \return
+    //! \note 当内部有数据时并且也被引用此时会将数据分离
+    //!
+    void remove(int index, size_t len = 1);
+
+    //!
+    //! \brief find 查找 c 第一个出现的位置
+    //! \param c
+    //! \param i 开始搜索位置
+    //! \return
+    //!
+    int find(const Type &c, int i = 0)const;
+
+    //!
+    //! \brief replace 将指定位置的len长度元素替换为alen长度的s数据
+    //! \param index
+    //! \param len
+    //! \param s
+    //! \param alen
+    //! \return
+    //! \note 当内部有数据时并且也被引用此时会将数据分离
+    //!
+    ky_small_array &replace(int index, const Type &c);
+    ky_small_array &replace(int index, size_t len, const Type *s, size_t alen);
+    ky_small_array &replace(int index, size_t len, const ky_small_array &s);
+
+    //!
+    //! \brief move 将指定位置的len长度元素移动到to位置
+    //! \param from
+    //! \param n
+    //! \param to
+    //! \return
+    //! \note 当内部有数据时并且也被引用此时会将数据分离
+    //!
+    ky_small_array &move(int from, size_t n, int to);
+    ky_small_array &move(int from, int to);
+
+    //!
+    //! \brief operator = 默认赋值函数
+    //! \return
+    //!
+    ky_small_array &operator =(const ky_small_array &);
+
+    //!
+    //! \brief extract  (count 负数时根据pos位置向前取，此时顺序不为逆)
+    //! \param pos
+    //! \param count
+    //! \return
+    //!
+    ky_small_array extract(int pos, int count)const;
+    inline ky_small_array mid(int pos, int count)const
+    {return extract(pos, count);}
+    //!
+    //! \brief extract 根据pos位置将后面的全部提取
+    //! \param pos
+    //! \return
+    //!
+    ky_small_array extract(int pos)const;
+    //!
+    //! \brief start  从开头提取count个字符
+    //! \param count
+    //! \return
+    //!
+    ky_small_array start(int count)const;
+    //!
+    //! \brief ending  从结尾提取count个字符，此时不为逆
+    //! \param count
+    //! \return
+    //!
+    ky_small_array ending(int count)const;
+
+    //!
+    //! \brief swap  交换两个对象的数据
+    //! \param rhs
+    //!
+    void swap(ky_small_array &rhs);
+    friend void ky_swap(ky_small_array &a, ky_small_array &b) {a.swap(b);}
+
+protected:
+    void  __detach_helper();
+    T *__detach_insert(int i, int c);
+    T *__slot(int i, int c = 1);
+    T *__begin()const;
+    T *__spill(size_t need, int i = 0, int c = 0);
+    void __destroy_helper();
+};
+
+#include "ky_small_array.inl"
+
+//! 对象只保存内存块指针或按位移动的内联元素，可按位重定位
+template<typename T, int N>
+struct is_relocatable<ky_small_array<T, N> >: public true_type_t { };
+
+template<typename T, int N>
+inline uint64 ky_hash(const ky_small_array<T, N> &a){return __hash_::WY(a.data (), a.bytecount ());}
+
+#endif // KY_SMALL_ARRAY_H
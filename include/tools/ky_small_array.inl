@@ -0,0 +1,655 @@
+
+
+
+template <typename T, int N>
+T* ky_small_array<T, N>::__detach_insert(int i, int c)
+{
+    const bool the_copy = !is_empty ();
+
+    T *n = (T*)Layout::begin ();
+    LayoutHeader *oldh = Layout::detach(&i, c, sizeOf);
+
+    if (the_copy)
+    {
+        T* b = (T*)Layout::begin ();
+        T* e = (T*)Layout::end();
+
+        T* cur = b;
+        T* t = n;
+        T* to = (b+(i));
+        while(cur != to)
+        {
+            if (not_construct)
+                *cur = *t;
+            else
+                new (cur) T(*t);
+            cur ++;
+            t  ++;
+        }
+
+        cur = (b + (i +c));
+        to = e;
+        t = n + i;
+        while(cur != to)
+        {
+            if (not_construct)
+                *cur = *t;
+            else
+                new (cur) T(*t);
+            cur ++;
+            t ++;
+        }
+    }
+
+    Layout old(oldh);
+    if (!old.is_null() && old.lessref ())
+    {
+        T * cur = (T*)old.begin();
+        T * e = (T*)old.end ();
+        for (; cur != e; ++cur)
+        {
+            if (not_construct)
+                ;
+            else
+                (cur)->~T();
+        }
+        old.destroy ();
+    }
+
+    return (T*)Layout::at (i);
+}
+
+//! 在i位置腾出c个未构造的元素，内联缓冲不足时移入内存块，共享时先分离
+template <typename T, int N>
+T* ky_small_array<T, N>::__slot(int i, int c)
+{
+    if (Inline::on_inline ())
+    {
+        if (Inline::inline_count () + c <= N)
+            return Inline::inline_insert (i, c);
+        return __spill (Inline::inline_count () + c, i, c);
+    }
+    if (refer ().is_shared ())
+        return __detach_insert (i, c);
+    if (i <= 0)
+        return (T*)Layout::prepend (c);
+    if (i >= (int)size ())
+        return (T*)Layout::append (c);
+    return (T*)Layout::insert (i, c);
+}
+
+//! 返回元素的开始地址
+template <typename T, int N>
+T* ky_small_array<T, N>::__begin()const
+{
+    if (Inline::on_inline ())
+        return Inline::inline_data ();
+    return (T*)((Layout*)this)->begin ();
+}
+
+//! 将内联缓冲的元素按位移入容量不小于need的内存块，并在i位置留出c个未构造的元素
+template <typename T, int N>
+T* ky_small_array<T, N>::__spill(size_t need, int i, int c)
+{
+    const int n = Inline::inline_count ();
+    T *src = Inline::inline_data ();
+    i = i < 0 ? 0 : (i > n ? n : i);
+
+    Layout::reserve (ky_max (need, (size_t)N * 2), sizeOf);
+    T *b = (T*)Layout::append (n + c);
+    ky_mem()->copy (b, src, i * sizeOf);
+    ky_mem()->copy (b + i + c, src + i, (n - i) * sizeOf);
+    Inline::inline_set (-1);
+    return b + i;
+}
+
+template <typename T, int N>
+void ky_small_array<T, N>::__destroy_helper()
+{
+    if (Inline::on_inline ())
+    {
+        T* cur = Inline::inline_data ();
+        T* e = cur + Inline::inline_count ();
+        for (; cur != e; ++cur)
+        {
+            if (not_construct)
+                ;
+            else
+                (cur)->~T();
+        }
+        Inline::inline_set (0);
+        return ;
+    }
+
+    if (!Layout::is_null() && lessref ())
+    {
+        T* cur = (T*)Layout::begin();
+        T* e = (T*)Layout::end ();
+        for (; cur != e; ++cur)
+        {
+            if (not_construct)
+                ;
+            else
+                (cur)->~T();
+        }
+        Layout::destroy ();
+    }
+    // 有内联缓冲时回到内联状态
+    if (N > 0)
+    {
+        header = Layout::null ();
+        Inline::inline_set (0);
+    }
+}
+
+template<typename T, int N>
+void ky_small_array<T, N>::__detach_helper ()
+{
+    if (Inline::on_inline ())
+        return ;
+    if (refer ().is_shared ())
+    {
+        if (!Layout::is_null () && refer ().has_detach ())
+            __detach_insert (0, 0);
+    }
+}
+
+template<typename T, int N>
+ky_small_array<T, N>::ky_small_array():
+    Layout()
+{
+}
+
+template<typename T, int N>
+ky_small_array<T, N>::ky_small_array(size_t size):
+    Layout()
+{
+    reserve(size);
+}
+
+template<typename T, int N>
+ky_small_array<T, N>::ky_small_array(const ky_small_array<T, N> &rhs):
+    Layout()
+{
+    *this = rhs;
+}
+
+template<typename T, int N>
+ky_small_array<T, N>::ky_small_array(const Type *buf, size_t len):
+    Layout()
+{
+    append(buf, len);
+}
+
+template<typename T, int N>
+ky_small_array<T, N>::~ky_small_array()
+{
+    __destroy_helper();
+}
+
+template<typename T, int N>
+void ky_small_array<T, N>::reserve(size_t size)
+{
+    if (Inline::on_inline ())
+    {
+        if (size > (size_t)N)
+            __spill (size);
+        return ;
+    }
+    Layout::reserve (size, sizeOf);
+}
+
+template<typename T, int N>
+void ky_small_array<T, N>::resize(size_t s)
+{
+    if (Inline::on_inline ())
+    {
+        if (s <= (size_t)N)
+        {
+            Inline::inline_set ((int)s);
+            return ;
+        }
+        __spill (s);
+    }
+    __detach_helper ();
+    Layout::resize (s, sizeOf);
+}
+
+template<typename T, int N>
+void ky_small_array<T, N>::resize(size_t s, const Type &v)
+{
+    resize(s);
+    fill(v, s);
+}
+
+template<typename T, int N>
+ky_small_array<T, N>::operator T *() const
+{
+    return __begin ();
+}
+
+template<typename T, int N>
+ky_small_array<T, N>::operator T *()
+{
+    __detach_helper ();
+    return __begin ();
+}
+
+template<typename T, int N>
+ky_small_array<T, N>::operator void *() const
+{
+    return __begin ();
+}
+
+template<typename T, int N>
+ky_small_array<T, N>::operator void *()
+{
+    __detach_helper ();
+    return __begin ();
+}
+
+template<typename T, int N>
+T *ky_small_array<T, N>::data()
+{
+    __detach_helper();
+    return __begin ();
+}
+
+template<typename T, int N>
+T *ky_small_array<T, N>::data() const
+{
+    return __begin ();
+}
+
+template<typename T, int N>
+T *ky_small_array<T, N>::offset(int inx)
+{
+    kyASSERT(inx < size() && inx >= 0, "The index is illegal");
+    __detach_helper();
+    return __begin () + inx;
+}
+
+template<typename T, int N>
+T *ky_small_array<T, N>::offset(int inx)const
+{
+    kyASSERT(inx < size() && inx >= 0, "The index is illegal");
+    return __begin () + inx;
+}
+
+template<typename T, int N>
+void ky_small_array<T, N>::clear()
+{
+    fill(Type(), size(), 0);
+}
+
+template<typename T, int N>
+void ky_small_array<T, N>::fill(const Type &c, size_t len, int pos)
+{
+    if (size())
+    {
+        __detach_helper ();
+        len = ((len+pos) > size() ? size()-pos : len);
+        T* ptr = __begin ();
+        do
+            *(ptr +pos++) = c;
+        while (--len);
+    }
+}
+
+template<typename T, int N>
+T ky_small_array<T, N>::at(int i)
+{
+    kyASSERT(i < size() && i >= 0, "The index is illegal");
+    return *(__begin () + i);
+}
+
+template<typename T, int N>
+const T ky_small_array<T, N>::at(int i)const
+{
+    kyASSERT(i < size() && i >= 0, "The index is illegal");
+    return *(__begin () + i);
+}
+
+template<typename T, int N>
+T &ky_small_array<T, N>::operator[](int i)
+{
+    kyASSERT(i < (int)size() && i >= 0, "The index is illegal");
+    __detach_helper ();
+    return *(__begin () + i);
+}
+
+template<typename T, int N>
+const T &ky_small_array<T, N>::operator[](int i) const
+{
+    kyASSERT(i < size() && i >= 0, "The index is illegal");
+    return *(__begin () + i);
+}
+
+template<typename T, int N>
+int ky_small_array<T, N>::find(const Type &c, int i)const
+{
+    for (size_t j = i; j < size(); ++j)
+        if (at(j) == c)
+            return j;
+    return -1;
+}
+
+template<typename T, int N>
+ky_small_array<T, N> &ky_small_array<T, N>::prepend(const T &c)
+{
+    return prepend(&c, 1);
+}
+
+template<typename T, int N>
+ky_small_array<T, N> &ky_small_array<T, N>::prepend(const T *s, int len)
+{
+    T* n = __slot (0, len);
+    while (len-- > 0)
+    {
+        if (not_construct)
+            *n = *s++;
+        else
+            new (n) T(*s++);
+        n ++;
+    }
+    return *this;
+}
+
+template<typename T, int N>
+ky_small_array<T, N> &ky_small_array<T, N>::prepend(const ky_small_array<T, N> &a)
+{
+    return prepend(a.data (), a.size ());
+}
+
+template<typename T, int N>
+ky_small_array<T, N> &ky_small_array<T, N>::append(const T &c)
+{
+    return append (&c, 1);
+}
+
+template<typename T, int N>
+ky_small_array<T, N> &ky_small_array<T, N>::append(const T *s, size_t len)
+{
+    T* n = __slot (INT_MAX, (int)len);
+    while (len-- > 0)
+    {
+        if (not_construct)
+            *n = *s++;
+        else
+            new (n) T(*s++);
+        n ++;
+    }
+    return *this;
+}
+
+template<typename T, int N>
+ky_small_array<T, N> &ky_small_array<T, N>::append(const ky_small_array<T, N> &a)
+{
+    return append(a.data (), a.size ());
+}
+
+template<typename T, int N>
+ky_small_array<T, N> &ky_small_array<T, N>::operator = (const ky_small_array<T, N> &rhs)
+{
+    if (this == &rhs || (!Inline::on_inline () && header == rhs.header))
+        return *this;
+
+    __destroy_helper ();
+    if (rhs.is_inline ())
+        append (rhs.data (), rhs.size ());
+    else if (!rhs.Layout::is_null())
+    {
+        Layout *x = (Layout *)&rhs;
+        if (x->refer ().has_shareable ())
+        {
+            // 内存块在对象间共享，写时再分离
+            x->addref ();
+            Inline::inline_set (-1);
+            header = x->header;
+        }
+        else
+        {
+            resize (rhs.size ());
+            T* cur = __begin ();
+            T* t = (T*)x->begin ();
+            T* to = cur + size ();
+            while(cur != to)
+            {
+                if (not_construct)
+                    *cur = *t;
+                else
+                    new (cur) T(*t);
+                cur ++;
+                t  ++;
+            }
+        }
+    }
+    return *this;
+}
+
+template<typename T, int N>
+ky_small_array<T, N> &ky_small_array<T, N>::insert(int i, const T& c)
+{
+    return insert(i, &c, 1);
+}
+
+template<typename T, int N>
+ky_small_array<T, N> &ky_small_array<T, N>::insert(int i, const T *s, size_t len)
+{
+    T* n = __slot (i, (int)len);
+    while (len-- > 0)
+    {
+        if (not_construct)
+            *n = *s++;
+        else
+            new (n) T(*s++);
+        n ++;
+    }
+    return *this;
+}
+
+template<typename T, int N>
+ky_small_array<T, N> &ky_small_array<T, N>::insert(int i, const ky_small_array<T, N> &a)
+{
+    return insert(i, a.data(), a.size());
+}
+
+template<typename T, int N>
+void ky_small_array<T, N>::remove(int i, size_t len)
+{
+    if (i >= (int)size() || i < 0)
+        return ;
+    __detach_helper ();
+
+    len = ((len +i) > size() ? size() -i : len);
+    T* cur = __begin () + i;
+    for (size_t j = 0; j < len; ++j)
+    {
+        if (not_construct)
+            ;
+        else
+            (cur + j)->~T();
+    }
+    if (Inline::on_inline ())
+        Inline::inline_remove (i, (int)len);
+    else
+        ky_memory::array::remove (i, len);
+}
+
+template<typename T, int N>
+ky_small_array<T, N> &ky_small_array<T, N>::replace(int index, const T&c)
+{
+    return replace(index, 1, &c, 1);
+}
+
+template<typename T, int N>
+ky_small_array<T, N> &ky_small_array<T, N>::replace(int index, size_t len, const T *s, size_t alen)
+{
+    if (index < (int)size() && index >= 0)
+    {
+        __detach_helper ();
+        len = ((len+index) > size() ? size()-index : len);
+        if (len > alen)
+            remove (index +alen, len - alen);
+        else if (alen > len)
+        {
+            // 新增的元素在腾出的位置上构造
+            T* n = __slot (index +len, alen-len);
+            for (size_t j = len; j < alen; ++j, ++n)
+            {
+                if (not_construct)
+                    *n = s[j];
+                else
+                    new (n) T(s[j]);
+            }
+        }
+
+        T* ptr = __begin () + index;
+        for (size_t j = 0; j < len && j < alen; ++j)
+            *ptr++ = *s++;
+    }
+    return *this;
+}
+
+template<typename T, int N>
+ky_small_array<T, N> &ky_small_array<T, N>::replace(int index, size_t len, const ky_small_array<T, N> &s)
+{
+    return replace(index, len, s.data(), s.size());
+}
+
+template<typename T, int N>
+ky_small_array<T, N> &ky_small_array<T, N>::move(int from, size_t n, int to)
+{
+    __detach_helper ();
+    if (Inline::on_inline ())
+        Inline::inline_move (from, (int)n, to);
+    else
+        Layout::move (from, n, to);
+    return *this;
+}
+
+template<typename T, int N>
+ky_small_array<T, N> &ky_small_array<T, N>::move(int from, int to)
+{
+    return move (from, 1, to);
+}
+
+// C++11
+#if kyLanguage >= kyLanguage11
+template<typename T, int N>
+ky_small_array<T, N>::ky_small_array(ky_small_array&& rhs):
+    Layout()
+{
+    *this = std::move (rhs);
+}
+
+template<typename T, int N>
+ky_small_array<T, N>& ky_small_array<T, N>::operator =(ky_small_array&& rhs)
+{
+    if (this == &rhs)
+        return *this;
+
+    __destroy_helper ();
+    if (rhs.is_inline ())
+    {
+        // 内联元素按位移动
+        ky_mem()->copy (Inline::inline_data (), rhs.__begin (), rhs.bytecount ());
+        Inline::inline_set ((int)rhs.size ());
+        rhs.Inline::inline_set (0);
+    }
+    else
+    {
+        Inline::inline_set (-1);
+        header = rhs.header;
+        rhs.header = null();
+        rhs.Inline::inline_set (0);
+    }
+    return *this;
+}
+
+template<typename T, int N>
+ky_small_array<T, N> &ky_small_array<T, N>::prepend(T &&c)
+{
+    new (__slot (0)) T(std::move (c));
+    return *this;
+}
+
+template<typename T, int N>
+ky_small_array<T, N> &ky_small_array<T, N>::append(T &&c)
+{
+    new (__slot (INT_MAX)) T(std::move (c));
+    return *this;
+}
+
+template<typename T, int N>
+ky_small_array<T, N> &ky_small_array<T, N>::insert(int i, T &&c)
+{
+    new (__slot (i)) T(std::move (c));
+    return *this;
+}
+
+template<typename T, int N>
+template <typename ... Args>
+T &ky_small_array<T, N>::emplace(int i, Args &&...args)
+{
+    return *new (__slot (i)) T(std::forward<Args>(args)...);
+}
+
+template<typename T, int N>
+ky_small_array<T, N>::ky_small_array(const std::initializer_list<T> & il):
+    Layout()
+{
+    foreach (const T & a, il)
+        append (a);
+}
+#endif
+
+template<typename T, int N>
+void ky_small_array<T, N>::swap(ky_small_array<T, N> &rhs)
+{
+    if (Inline::on_inline () || rhs.is_inline ())
+    {
+        ky_small_array<T, N> tmp(*this);
+        *this = rhs;
+        rhs = tmp;
+        return ;
+    }
+    ky_atomic<LayoutHeader*> tmp = header;
+    header = rhs.header;
+    rhs.header = tmp;
+}
+
+template<typename T, int N>
+ky_small_array<T, N> ky_small_array<T, N>::extract( int pos, int count)const
+{
+    ky_small_array<T, N> tmp(this->data(), this->size());
+    if (count > 0)
+        tmp.remove(pos, count);
+    else
+        tmp.remove(pos -abs(count), abs(count));
+    return tmp;
+}
+
+template<typename T, int N>
+ky_small_array<T, N> ky_small_array<T, N>::extract( int pos )const
+{
+    ky_small_array<T, N> tmp(this->data(), this->size());
+    tmp.remove(0, pos);
+    return tmp;
+}
+
+template<typename T, int N>
+ky_small_array<T, N> ky_small_array<T, N>::start( int count)const
+{
+    ky_small_array<T, N> tmp(this->data(), this->size());
+    tmp.remove(count, this->size() - count);
+    return tmp;
+}
+
+template<typename T, int N>
+ky_small_array<T, N> ky_small_array<T, N>::ending( int count)const
+{
+    ky_small_array<T, N> tmp(this->data(), this->size());
+    tmp.remove(0, this->size() - count);
+    return tmp;
+}
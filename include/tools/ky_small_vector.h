@@ -0,0 +1,218 @@
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_small_vector.h
+ * @brief    带内联小缓冲的模板连续数据空间容器类(支持C++11)
+ *       ky_small_vector 从ky_small_array继承，接口与ky_vector一致
+ *       N 为内联缓冲的元素数，见ky_small_array
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ */
+
+#ifndef KY_SMALL_VECTOR_H
+#define KY_SMALL_VECTOR_H
+
+#include "ky_define.h"
+#include "ky_small_array.h"
+#include "ky_algorlthm.h"
+
+#ifdef kyHasSTL
+#include <vector>
+#endif
+
+/*!
+ * \brief The ky_small_vector class 带内联小缓冲的ky_vector，见ky_small_array
+ */
+template <typename T, int N>
+class ky_small_vector : public ky_small_array<T, N>
+{
+    typedef ky_small_array<T, N> VecBase;
+public:
+    class opevec_node;
+    typedef opevec_node  iterator;
+    typedef const iterator  const_iterator;
+
+    // STL
+public:
+    ky_small_vector();
+    explicit ky_small_vector(size_t count);
+    ky_small_vector(const ky_small_vector& rhs);
+    ~ky_small_vector(){}
+
+    ky_small_vector& operator =(const ky_small_vector& rhs);
+
+    iterator begin();
+    iterator end();
+    const_iterator begin()const;
+    const_iterator end()const;
+    inline const_iterator cbegin()const{return begin();}
+    inline const_iterator cend()const{return end();}
+
+    bool empty() const;
+
+    T &front();
+    const T &front()const;
+
+    T &back();
+    const T &back()const;
+
+    void push_back(const T& v);
+    inline void push_front(const T& v){prepend(v);}
+    void pop_back();
+    inline void pop_front(){remove(0);}
+
+#if kyLanguage < kyLanguage11
+    iterator insert(iterator pos, const T& v);
+    void insert(iterator pos, size_t count, const T& v);
+
+    iterator erase(iterator pos);
+    iterator erase(iterator first, iterator last);
+#endif
+
+    // C++11
+#if kyLanguage >= kyLanguage11
+public:
+    ky_small_vector(ky_small_vector&& rhs);
+    ky_small_vector& operator =(ky_small_vector&& rhs);
+    ky_small_vector(const std::initializer_list<T> & il);
+    void push_back(T&& v);
+    inline void push_front(T&& v){prepend(std::move (v));}
+
+    ky_small_vector<T, N> &prepend(T &&c);
+    ky_small_vector<T, N> &append(T &&c);
+    ky_small_vector<T, N> &insert(size_t i, T &&c);
+
+    //!
+    //! \brief emplace 在pos位置以args就地构造元素
+    //! \param pos
+    //! \param args
+    //! \return 返回指向构造元素的迭代器
+    //!
+    using VecBase::emplace;
+    template <typename ... Args>
+    iterator emplace(const_iterator pos, Args &&...args);
+
+    iterator insert(const_iterator pos, const T& v);
+    iterator insert(const_iterator pos, T&& v);
+    iterator insert(const_iterator pos, size_t count, const T& v);
+
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+#endif
+
+    // base
+public:
+    ky_small_vector(const std::vector<T> &rhs);
+
+    std::vector<T> to_std();
+    void form(const std::vector<T> &rhs);
+    ky_small_vector& operator =(const std::vector<T>& rhs);
+
+    inline bool operator!=(const ky_small_vector<T, N> &v) const { return !(*this == v); }
+    bool operator==(const ky_small_vector<T, N> &v) const;
+    bool contains(const T &t) const;
+
+    inline ky_small_vector<T, N> &operator +=(const ky_small_vector<T, N> &l) {return append(l.data(), l.size());}
+    inline ky_small_vector<T, N> operator +(const ky_small_vector<T, N> &l) const { ky_small_vector n = *this; n += l; return n; }
+    inline ky_small_vector<T, N> &operator +=(const T &t) { append(t); return *this; }
+    inline ky_small_vector<T, N> &operator << (const T &t) { append(t); return *this; }
+    inline ky_small_vector<T, N> &operator <<(const ky_small_vector<T, N> &l) { *this += l; return *this; }
+
+    size_t count()const;
+
+    ky_small_vector<T, N> &prepend(const T &c);
+    ky_small_vector<T, N> &prepend(const T *s, int len);
+    ky_small_vector<T, N> &prepend(const ky_small_vector<T, N> &a);
+
+    ky_small_vector<T, N> &append(const T &c);
+    ky_small_vector<T, N> &append(const T *s, size_t len);
+    ky_small_vector<T, N> &append(const ky_small_vector<T, N> &a);
+
+    ky_small_vector<T, N> &insert(size_t i, const T &c);
+    ky_small_vector<T, N> &insert(size_t i, const T *s, size_t len);
+    ky_small_vector<T, N> &insert(size_t i, const ky_small_vector<T, N> &a);
+
+    void remove(size_t index, size_t len = 1);
+
+    ky_small_vector<T, N> &replace(size_t index, size_t len, const T *s, size_t alen);
+    ky_small_vector<T, N> &replace(size_t index, size_t len, const ky_small_vector<T, N> &s);
+
+    inline ky_small_vector<T, N> mid(size_t pos, int len) const {return extract(pos, len);}
+    ky_small_vector<T, N> extract( int pos, int count);
+    ky_small_vector<T, N> extract( int pos );
+    ky_small_vector<T, N> start( int count);
+    ky_small_vector<T, N> end( int count);
+
+    void sort(){ky_qsort<iterator>(begin(), end());}
+    //!
+    //! \brief swap 覆盖ky_small_array后重写
+    //! \param rhs
+    //!
+    void swap(ky_small_vector<T, N> &rhs);
+    friend void ky_swap(ky_small_vector<T, N> &a, ky_small_vector<T, N> &b) {a.swap(b);}
+
+public:
+    class opevec_node
+    {
+        friend class ky_small_vector;
+    public:
+
+        opevec_node():ope(NULL){}
+        opevec_node(T *p): ope(p){}
+        opevec_node(const opevec_node &ope_v): ope(ope_v.ope){}
+        ~opevec_node(){}
+
+        inline T* operator->(){return &ope;}
+        inline T& operator*() {return *ope;}
+        inline const T& operator*() const{return *ope;}
+
+        inline bool operator ==(const opevec_node &rhs) const { return ope == rhs.ope; }
+        inline bool operator !=(const opevec_node &rhs) const { return ope != rhs.ope; }
+        inline bool operator <(const opevec_node& rhs) const { return ope < rhs.ope; }
+        inline bool operator <=(const opevec_node& rhs) const { return ope <= rhs.ope; }
+        inline bool operator >(const opevec_node& rhs) const { return ope > rhs.ope; }
+        inline bool operator >=(const opevec_node& rhs) const { return ope >= rhs.ope; }
+
+        opevec_node operator +(int c);
+        const opevec_node operator +(int c)const;
+        inline opevec_node operator -(int c){return operator+(-c);}
+        inline const opevec_node operator -(int c)const{return operator+(-c);}
+
+        int operator - (const opevec_node &rhs);
+
+        const opevec_node& operator++()const;
+        const opevec_node operator++(int)const;
+
+        const opevec_node& operator--()const;
+        const opevec_node operator--(int)const;
+
+        opevec_node& operator++();
+        opevec_node operator++(int);
+
+        opevec_node& operator--();
+        opevec_node operator--(int);
+
+        inline opevec_node &operator +=(int c){return *this = *this + c; }
+        inline const opevec_node &operator +=(int c)const{return *this = *this + c; }
+        inline opevec_node &operator -=(int c){return *this = *this - c; }
+        inline const opevec_node &operator -=(int c)const{return *this = *this - c; }
+
+    private:
+        T *ope;
+    };
+};
+
+#include "ky_small_vector.inl"
+
+template <typename T, int N>
+struct is_relocatable<ky_small_vector<T, N> >: public true_type_t { };
+#endif // KY_SMALL_VECTOR_H
@@ -0,0 +1,434 @@
+#ifndef KY_SMALL_VECTOR_INL
+#define KY_SMALL_VECTOR_INL
+
+template <typename T, int N>
+ky_small_vector<T, N>::ky_small_vector():
+    VecBase()
+{
+
+}
+
+template <typename T, int N>
+ky_small_vector<T, N>::ky_small_vector(size_t count):
+    VecBase()
+{
+    VecBase::resize(count);
+}
+
+template <typename T, int N>
+ky_small_vector<T, N>::ky_small_vector(const ky_small_vector& rhs):
+    VecBase(rhs)
+{
+
+}
+
+
+template <typename T, int N>
+ky_small_vector<T, N>& ky_small_vector<T, N>::operator =(const ky_small_vector& rhs)
+{
+    VecBase::operator =(rhs);
+    return *this;
+}
+
+template <typename T, int N>
+typename ky_small_vector<T, N>::iterator ky_small_vector<T, N>::begin()
+{
+    return iterator(VecBase::data());
+}
+template <typename T, int N>
+typename ky_small_vector<T, N>::iterator ky_small_vector<T, N>::end()
+{
+    return iterator(VecBase::data()+VecBase::size());
+}
+template <typename T, int N>
+typename ky_small_vector<T, N>::const_iterator ky_small_vector<T, N>::begin()const
+{
+    return const_iterator(VecBase::data());
+}
+template <typename T, int N>
+typename ky_small_vector<T, N>::const_iterator ky_small_vector<T, N>::end()const
+{
+    return const_iterator(VecBase::data()+VecBase::size());
+}
+
+template <typename T, int N>
+bool ky_small_vector<T, N>::empty() const
+{
+    return VecBase::is_empty();
+}
+
+template <typename T, int N>
+T &ky_small_vector<T, N>::front()
+{
+    return *begin();
+}
+template <typename T, int N>
+const T &ky_small_vector<T, N>::front()const
+{
+    return *begin();
+}
+
+template <typename T, int N>
+T &ky_small_vector<T, N>::back()
+{
+    return *(end()-1);
+}
+template <typename T, int N>
+const T &ky_small_vector<T, N>::back()const
+{
+    return *(end()-1);
+}
+
+template <typename T, int N>
+void ky_small_vector<T, N>::push_back(const T& v)
+{
+    VecBase::append(v);
+}
+template <typename T, int N>
+void ky_small_vector<T, N>::pop_back()
+{
+    VecBase::remove(VecBase::size()-1);
+}
+
+#if kyLanguage < kyLanguage11
+template <typename T, int N>
+typename ky_small_vector<T, N>::iterator ky_small_vector<T, N>::insert(iterator pos, const T& v)
+{
+    VecBase::insert(pos.ope - begin().ope, v);
+    return pos+1;
+}
+template <typename T, int N>
+void ky_small_vector<T, N>::insert(iterator pos, size_t count, const T& v)
+{
+    VecBase::fill(v, count, pos.ope - begin().ope);
+}
+template <typename T, int N>
+typename ky_small_vector<T, N>::iterator ky_small_vector<T, N>::erase(iterator pos)
+{
+    if (pos == end())
+        VecBase::remove(count() -1);
+    else
+        VecBase::remove(pos.ope - begin().ope);
+    return begin()+(pos.ope - begin().ope);
+}
+template <typename T, int N>
+typename ky_small_vector<T, N>::iterator ky_small_vector<T, N>::erase(iterator first, iterator last)
+{
+    if (first == end())
+        return end();
+    size_t offset = (first.ope - begin().ope);
+    size_t len = (last.ope - first.ope);
+    VecBase::remove(offset, len);
+    return begin() + offset;
+}
+#endif
+
+// C++11
+#if kyLanguage >= kyLanguage11
+
+template <typename T, int N>
+ky_small_vector<T, N>::ky_small_vector(ky_small_vector&& rhs):
+    VecBase(std::move (rhs))
+{
+
+}
+template <typename T, int N>
+ky_small_vector<T, N>& ky_small_vector<T, N>::operator =(ky_small_vector&& rhs)
+{
+    VecBase::operator =(std::move (rhs));
+    return *this;
+}
+template <typename T, int N>
+ky_small_vector<T, N>::ky_small_vector(const std::initializer_list<T> & il):
+    VecBase(il)
+{
+
+}
+template <typename T, int N>
+void ky_small_vector<T, N>::push_back(T&& v)
+{
+    VecBase::append(std::move (v));
+}
+template <typename T, int N>
+ky_small_vector<T, N> &ky_small_vector<T, N>::prepend(T &&c)
+{
+    VecBase::prepend(std::move (c));
+    return *this;
+}
+template <typename T, int N>
+ky_small_vector<T, N> &ky_small_vector<T, N>::append(T &&c)
+{
+    VecBase::append(std::move (c));
+    return *this;
+}
+template <typename T, int N>
+ky_small_vector<T, N> &ky_small_vector<T, N>::insert(size_t i, T &&c)
+{
+    VecBase::insert((int)i, std::move (c));
+    return *this;
+}
+template <typename T, int N>
+template <typename ... Args>
+typename ky_small_vector<T, N>::iterator ky_small_vector<T, N>::emplace(const_iterator pos, Args &&...args)
+{
+    const int i = int(pos.ope - VecBase::data());
+    return iterator(&VecBase::emplace(i, std::forward<Args>(args)...));
+}
+template <typename T, int N>
+typename ky_small_vector<T, N>::iterator ky_small_vector<T, N>::insert(const_iterator pos, const T& v)
+{
+    VecBase::insert(pos.ope - begin().ope, v);
+    return iterator(pos+1);
+}
+template <typename T, int N>
+typename ky_small_vector<T, N>::iterator ky_small_vector<T, N>::insert(const_iterator pos, T&& v)
+{
+    return emplace(pos, std::move (v));
+}
+template <typename T, int N>
+typename ky_small_vector<T, N>::iterator ky_small_vector<T, N>::insert(const_iterator pos, size_t count, const T& v)
+{
+    VecBase::fill(v, count, pos.ope - begin().ope);
+    return iterator(pos+count);
+}
+template <typename T, int N>
+typename ky_small_vector<T, N>::iterator ky_small_vector<T, N>::erase(const_iterator pos)
+{
+    if (pos == end())
+        VecBase::remove(count() -1);
+    else
+        VecBase::remove(pos.ope - begin().ope);
+    return begin()+(pos.ope - begin().ope);
+}
+template <typename T, int N>
+typename ky_small_vector<T, N>::iterator ky_small_vector<T, N>::erase(const_iterator first, const_iterator last)
+{
+    if (first == end())
+        return end();
+    size_t offset = (first.ope - begin().ope);
+    size_t len = (last.ope - first.ope);
+    VecBase::remove(offset, len);
+    return begin() + offset;
+}
+#endif
+
+// base
+template <typename T, int N>
+ky_small_vector<T, N>::ky_small_vector(const std::vector<T> &rhs):VecBase()
+{
+    form(rhs);
+}
+
+template <typename T, int N>
+std::vector<T> ky_small_vector<T, N>::to_std()
+{
+    std::vector<T> dat;
+    dat.resize(VecBase::size());
+    ky_mem()->copy(dat.data(), VecBase::data(), VecBase::bytecount());
+    return dat;
+}
+template <typename T, int N>
+void ky_small_vector<T, N>::form(const std::vector<T> &rhs)
+{
+    VecBase::resize(rhs.size());
+    ky_mem()->copy(VecBase::data(), rhs.data(), VecBase::bytecount());
+}
+template <typename T, int N>
+ky_small_vector<T, N>& ky_small_vector<T, N>::operator =(const std::vector<T>& rhs)
+{
+    form(rhs);
+    return *this;
+}
+template <typename T, int N>
+bool ky_small_vector<T, N>::operator ==(const ky_small_vector<T, N> &v) const
+{
+    return VecBase::data() == v.data() && count() == v.count();
+}
+
+template <typename T, int N>
+bool ky_small_vector<T, N>::contains(const T &t) const
+{
+    for (iterator it = begin(); it != end(); ++it)
+        if (*it == t)
+            return true;
+    return false;
+}
+template <typename T, int N>
+size_t ky_small_vector<T, N>::count()const
+{
+    return VecBase::size();
+}
+
+template <typename T, int N>
+ky_small_vector<T, N> &ky_small_vector<T, N>::prepend(const T &c)
+{
+    return *(ky_small_vector<T, N>*)&VecBase::prepend(c);
+}
+template <typename T, int N>
+ky_small_vector<T, N> &ky_small_vector<T, N>::prepend(const T *s, int len)
+{
+    return *(ky_small_vector<T, N>*)&VecBase::prepend(s, len);
+}
+template <typename T, int N>
+ky_small_vector<T, N> &ky_small_vector<T, N>::prepend(const ky_small_vector<T, N> &a)
+{
+    return *(ky_small_vector<T, N>*)&VecBase::prepend(a);
+}
+
+template <typename T, int N>
+ky_small_vector<T, N> &ky_small_vector<T, N>::append(const T &c)
+{
+    return *(ky_small_vector<T, N>*)&VecBase::append(c);
+}
+template <typename T, int N>
+ky_small_vector<T, N> &ky_small_vector<T, N>::append(const T *s, size_t len)
+{
+    return *(ky_small_vector<T, N>*)&VecBase::append(s, len);
+}
+template <typename T, int N>
+ky_small_vector<T, N> &ky_small_vector<T, N>::append(const ky_small_vector<T, N> &a)
+{
+    return *(ky_small_vector<T, N>*)&VecBase::append(a);
+}
+
+template <typename T, int N>
+ky_small_vector<T, N> &ky_small_vector<T, N>::insert(size_t i, const T &c)
+{
+    return *(ky_small_vector<T, N>*)&VecBase::insert(i, c);
+}
+template <typename T, int N>
+ky_small_vector<T, N> &ky_small_vector<T, N>::insert(size_t i, const T *s, size_t len)
+{
+    return *(ky_small_vector<T, N>*)&VecBase::insert(i, s, len);
+}
+template <typename T, int N>
+ky_small_vector<T, N> &ky_small_vector<T, N>::insert(size_t i, const ky_small_vector<T, N> &a)
+{
+    return *(ky_small_vector<T, N>*)&VecBase::insert(i, a);
+}
+
+template <typename T, int N>
+void ky_small_vector<T, N>::remove(size_t index, size_t len)
+{
+    VecBase::remove((int)index, len);
+}
+
+template <typename T, int N>
+ky_small_vector<T, N> &ky_small_vector<T, N>::replace(size_t index, size_t len, const T *s, size_t alen)
+{
+    return *(ky_small_vector<T, N>*)&VecBase::replace(index, len, s, alen);
+}
+template <typename T, int N>
+ky_small_vector<T, N> &ky_small_vector<T, N>::replace(size_t index, size_t len, const ky_small_vector<T, N> &s)
+{
+    return *(ky_small_vector<T, N>*)&VecBase::replace(index, len, s);
+}
+
+template <typename T, int N>
+ky_small_vector<T, N> ky_small_vector<T, N>::extract( int pos, int count)
+{
+    return *(ky_small_vector<T, N>*)&VecBase::extract(pos, count);
+}
+template <typename T, int N>
+ky_small_vector<T, N> ky_small_vector<T, N>::extract( int pos )
+{
+    return *(ky_small_vector<T, N>*)&VecBase::extract(pos);
+}
+template <typename T, int N>
+ky_small_vector<T, N> ky_small_vector<T, N>::start( int count)
+{
+    return *(ky_small_vector<T, N>*)&VecBase::start(count);
+}
+template <typename T, int N>
+ky_small_vector<T, N> ky_small_vector<T, N>::end( int count)
+{
+    return *(ky_small_vector<T, N>*)&VecBase::end(count);
+}
+template <typename T, int N>
+void ky_small_vector<T, N>::swap(ky_small_vector<T, N> &rhs)
+{
+    VecBase::swap(rhs);
+}
+
+template <typename T, int N>
+typename ky_small_vector<T, N>::opevec_node ky_small_vector<T, N>::opevec_node::operator +(int c)
+{
+    opevec_node node = *this;
+    if (c > 0)
+        while (c--) ++node;
+    else
+        while (c++) --node;
+    return (node);
+}
+template <typename T, int N>
+const typename ky_small_vector<T, N>::opevec_node ky_small_vector<T, N>::opevec_node::operator +(int c)const
+{
+    opevec_node node = *this;
+    if (c > 0)
+        while (c--) ++node;
+    else
+        while (c++) --node;
+    return (node);
+}
+
+template <typename T, int N>
+const typename ky_small_vector<T, N>::opevec_node & ky_small_vector<T, N>::opevec_node::operator++()const
+{
+    opevec_node *take = (opevec_node *)this;
+    ++take->ope;
+    return *this;
+}
+template <typename T, int N>
+const typename ky_small_vector<T, N>::opevec_node ky_small_vector<T, N>::opevec_node::operator++(int)const
+{
+    opevec_node old = *this;
+    ++ope;
+    return old;
+}
+template <typename T, int N>
+const typename ky_small_vector<T, N>::opevec_node& ky_small_vector<T, N>::opevec_node::operator--()const
+{
+    opevec_node *take = (opevec_node *)this;
+    --take->ope;
+    return *this;
+}
+template <typename T, int N>
+const typename ky_small_vector<T, N>::opevec_node ky_small_vector<T, N>::opevec_node::operator--(int)const
+{
+    opevec_node old = *this;
+    --ope;
+    return old;
+}
+template <typename T, int N>
+typename ky_small_vector<T, N>::opevec_node& ky_small_vector<T, N>::opevec_node::operator++()
+{
+    ++ope;
+    return *this;
+}
+template <typename T, int N>
+typename ky_small_vector<T, N>::opevec_node ky_small_vector<T, N>::opevec_node::operator++(int)
+{
+    opevec_node old = *this;
+    ++ope;
+    return old;
+}
+template <typename T, int N>
+typename ky_small_vector<T, N>::opevec_node& ky_small_vector<T, N>::opevec_node::operator--()
+{
+    --ope;
+    return *this;
+}
+template <typename T, int N>
+typename ky_small_vector<T, N>::opevec_node ky_small_vector<T, N>::opevec_node::operator--(int)
+{
+    opevec_node old = *this;
+    --ope;
+    return old;
+}
+template <typename T, int N>
+int ky_small_vector<T, N>::opevec_node::operator - (const opevec_node &rhs)
+{
+    return int(ope - rhs.ope);
+}
+#endif // KY_SMALL_VECTOR_INL
+
@@ -0,0 +1,82 @@
+
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_sort.h
+ * @brief    并行排序及基数排序
+ *       1.ky_psort 分块模式消除快速排序后，以归并路径划分在线程池上并行归并
+ *       2.ky_rsort 整数及浮点数的LSD基数排序，每轮8位，全部相同的位跳过
+ *       3.单线程的比较排序见ky_algorlthm.h中的ky_qsort、ky_msort
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ */
+#ifndef ky_SORT_H
+#define ky_SORT_H
+
+#include "ky_define.h"
+#include "ky_thread_pool.h"
+#include "tools/ky_algorlthm.h"
+
+namespace __sort__
+{
+    enum
+    {
+        ParallelMin = 1 << 16,      ///< 短于此长度不并行
+        ParallelChunk = 1 << 13,    ///< 每个分块的最小长度
+        RadixMin = 256              ///< 短于此长度基数排序改用快速排序
+    };
+
+    //!
+    //! \brief parallel 并行排序(不稳定)
+    //! \param begin
+    //! \param end
+    //! \param comp
+    //! \param pool 执行分块排序和归并的线程池
+    //!
+    template <typename T>
+    void parallel(T *begin, T *end, ky_thread_pool &pool);
+    template <typename T, typename Compare>
+    void parallel(T *begin, T *end, Compare comp, ky_thread_pool &pool);
+    template <typename container_iterator>
+    void parallel(container_iterator begin, container_iterator end, ky_thread_pool &pool);
+    template <typename container_iterator, typename Compare>
+    void parallel(container_iterator begin, container_iterator end, Compare comp, ky_thread_pool &pool);
+
+    //!
+    //! \brief radix 基数排序(稳定)
+    //! \param arr
+    //! \param length
+    //! \note 浮点数按位模式排序：-0排在+0之前，NaN按符号排在两端
+    //!
+    template <typename T>
+    void radix(T *arr, size_t length);
+}
+
+template<typename T>
+inline void ky_psort(T *begin, T *end)
+{__sort__::parallel(begin, end, ky_thread_pool::global ());}
+template<typename container_iterator>
+inline void ky_psort(container_iterator begin, container_iterator end)
+{__sort__::parallel(begin, end, ky_thread_pool::global ());}
+template<typename T, typename Compare>
+inline void ky_psort(T *begin, T *end, Compare comp, ky_thread_pool &pool = ky_thread_pool::global ())
+{__sort__::parallel(begin, end, comp, pool);}
+template<typename container_iterator, typename Compare>
+inline void ky_psort(container_iterator begin, container_iterator end, Compare comp,
+                     ky_thread_pool &pool = ky_thread_pool::global ())
+{__sort__::parallel(begin, end, comp, pool);}
+
+template<typename T>
+inline void ky_rsort(T *arr, size_t length){__sort__::radix(arr, length);}
+
+#include "ky_sort.inl"
+#endif // ky_SORT_H
@@ -0,0 +1,271 @@
+#ifndef KY_SORT_INL
+#define KY_SORT_INL
+
+namespace __sort__ {
+
+//!
+//! \brief _corank_ 归并a[0,n)与b[0,m)时，前d个输出中来自a的个数
+//! \note 相等元素a在前，与_merge_的稳定次序一致
+//!
+template <typename In, typename Compare>
+intptr _corank_(intptr d, In a, intptr n, In b, intptr m, Compare comp)
+{
+    intptr lo = d > m ? d - m : 0;
+    intptr hi = d < n ? d : n;
+    while (lo < hi)
+    {
+        const intptr i = lo + (hi - lo) / 2;
+        const intptr j = d - i;
+        // b[j-1]不小于a[i]时a[i]应先输出，i还需增大
+        if (j > 0 && i < n && !comp (*(b + (j - 1)), *(a + i)))
+            lo = i + 1;
+        else
+            hi = i;
+    }
+    return lo;
+}
+
+//!
+//! \brief The _parallel_ struct 分块排序后逐轮两两归并
+//! \note 分块数为2的幂；每轮的归并按归并路径切成分块数个子任务，
+//!       最后一轮也能用满全部线程
+//!
+template <typename It, typename Compare, typename T>
+struct _parallel_
+{
+    It begin;
+    T *buf;
+    intptr length;
+    int parts;
+    int width;             ///< 本轮每个有序段包含的分块数
+    bool in_buffer;        ///< 本轮的有序段是否在缓冲中
+    Compare comp;
+
+    _parallel_(It b, intptr len, int p, Compare c):
+        begin(b), buf(NULL), length(len), parts(p), width(1), in_buffer(false), comp(c){}
+
+    intptr bound(int chunk) const {return (intptr)((uint64)length * (uint64)chunk / (uint64)parts);}
+
+    static void sort_task(void *arg, int i)
+    {
+        _parallel_ *self = (_parallel_ *)arg;
+        const intptr lo = self->bound (i);
+        const intptr hi = self->bound (i + 1);
+        _pdq_<It, Compare, T>::sort (self->begin + lo, self->begin + hi, self->comp);
+        It src = self->begin + lo;
+        for (intptr k = lo; k < hi; ++k, ++src)
+            new (self->buf + k) T(*src);
+    }
+
+    template <typename Src, typename Dst>
+    void merge_part(Src src, Dst dst, int task)
+    {
+        const int per = 2 * width;
+        const int pair = task / per;
+        const int sub = task % per;
+        const intptr lo = bound (pair * per);
+        const intptr mid = bound (pair * per + width);
+        const intptr hi = bound (pair * per + per);
+
+        const intptr total = hi - lo;
+        const intptr d0 = (intptr)((uint64)total * sub / per);
+        const intptr d1 = (intptr)((uint64)total * (sub + 1) / per);
+        const Src a = src + lo;
+        const Src b = src + mid;
+        const intptr i0 = _corank_ (d0, a, mid - lo, b, hi - mid, comp);
+        const intptr i1 = _corank_ (d1, a, mid - lo, b, hi - mid, comp);
+        _merge_ (a + i0, a + i1, b + (d0 - i0), b + (d1 - i1), dst + (lo + d0), comp);
+    }
+
+    static void merge_task(void *arg, int task)
+    {
+        _parallel_ *self = (_parallel_ *)arg;
+        if (self->in_buffer)
+            self->merge_part (self->buf, self->begin, task);
+        else
+            self->merge_part (self->begin, self->buf, task);
+    }
+
+    static void copy_task(void *arg, int i)
+    {
+        _parallel_ *self = (_parallel_ *)arg;
+        const intptr lo = self->bound (i);
+        const intptr hi = self->bound (i + 1);
+        It dst = self->begin + lo;
+        for (intptr k = lo; k < hi; ++k, ++dst)
+            *dst = moved (self->buf[k]);
+    }
+
+    void run(ky_thread_pool &pool)
+    {
+        buf = (T*)kyMalloc (sizeof(T) * length);
+        // 分块排序后复制到缓冲，两份数据相同，首轮从缓冲归并回原区间
+        pool.run (sort_task, this, parts);
+        in_buffer = true;
+        for (width = 1; width < parts; width *= 2)
+        {
+            pool.run (merge_task, this, parts);
+            in_buffer = !in_buffer;
+        }
+        if (in_buffer)
+            pool.run (copy_task, this, parts);
+
+        for (intptr k = 0; k < length; ++k)
+            buf[k].~T();
+        kyFree (buf);
+    }
+};
+
+template <typename It, typename Compare, typename T>
+void _parallel_sort_(It begin, It end, Compare comp, ky_thread_pool &pool, T *)
+{
+    const intptr length = end - begin;
+    int parts = 1;
+    while (parts < pool.concurrency ())
+        parts *= 2;
+    while (parts > 1 && length / parts < (intptr)ParallelChunk)
+        parts /= 2;
+
+    if (length < (intptr)ParallelMin || parts < 2)
+    {
+        _pdq_<It, Compare, T>::sort (begin, end, comp);
+        return;
+    }
+
+    _parallel_<It, Compare, T> job(begin, length, parts, comp);
+    job.run (pool);
+}
+
+template <typename T>
+void parallel(T *begin, T *end, ky_thread_pool &pool)
+{
+    _parallel_sort_ (begin, end, ky_less<T>(), pool, begin);
+}
+
+template <typename T, typename Compare>
+void parallel(T *begin, T *end, Compare comp, ky_thread_pool &pool)
+{
+    _parallel_sort_ (begin, end, comp, pool, begin);
+}
+
+template <typename It, typename T>
+inline void _parallel_lt_(It begin, It end, ky_thread_pool &pool, T *)
+{
+    _parallel_sort_ (begin, end, ky_less<T>(), pool, (T*)NULL);
+}
+
+template <typename container_iterator>
+void parallel(container_iterator begin, container_iterator end, ky_thread_pool &pool)
+{
+    if (end - begin < 2)
+        return;
+    _parallel_lt_ (begin, end, pool, &*begin);
+}
+
+template <typename container_iterator, typename Compare>
+void parallel(container_iterator begin, container_iterator end, Compare comp, ky_thread_pool &pool)
+{
+    if (end - begin < 2)
+        return;
+    _parallel_sort_ (begin, end, comp, pool, &*begin);
+}
+
+template <int Size> struct _radix_uint_;
+template <> struct _radix_uint_<1> {typedef uint8 type;};
+template <> struct _radix_uint_<2> {typedef uint16 type;};
+template <> struct _radix_uint_<4> {typedef uint32 type;};
+template <> struct _radix_uint_<8> {typedef uint64 type;};
+
+//! 将元素编码为按无符号比较时次序不变的键
+template <typename T>
+struct _radix_traits_
+{
+    kyCompilerAssert(is_int<T>::value);
+    typedef typename _radix_uint_<sizeof(T)>::type key;
+
+    static key encode(T v)
+    {
+        // 有符号数翻转符号位
+        const key sign = (T)-1 < (T)0 ? (key)((key)1 << (sizeof(T) * 8 - 1)) : (key)0;
+        return (key)v ^ sign;
+    }
+};
+template <>
+struct _radix_traits_<float>
+{
+    typedef uint32 key;
+    static key encode(float v)
+    {
+        key k;
+        memcpy (&k, &v, sizeof(k));
+        // 负数全部取反，正数翻转符号位
+        return k ^ ((key)((int32)k >> 31) | 0x80000000u);
+    }
+};
+template <>
+struct _radix_traits_<double>
+{
+    typedef uint64 key;
+    static key encode(double v)
+    {
+        key k;
+        memcpy (&k, &v, sizeof(k));
+        return k ^ ((key)((int64)k >> 63) | 0x8000000000000000ull);
+    }
+};
+
+template <typename T>
+void radix(T *arr, size_t length)
+{
+    typedef _radix_traits_<T> traits;
+    typedef typename traits::key key;
+    enum {Passes = sizeof(key)};
+
+    if (length < (size_t)RadixMin)
+    {
+        quick (arr, arr + length);
+        return;
+    }
+
+    // 一次遍历得到全部轮次的直方图
+    size_t hist[Passes][256];
+    memset (hist, 0, sizeof(hist));
+    for (size_t i = 0; i < length; ++i)
+    {
+        const key k = traits::encode (arr[i]);
+        for (int p = 0; p < Passes; ++p)
+            ++hist[p][(k >> (p * 8)) & 0xff];
+    }
+
+    T *buf = (T*)kyMalloc (sizeof(T) * length);
+    T *src = arr;
+    T *dst = buf;
+    for (int p = 0; p < Passes; ++p)
+    {
+        size_t *h = hist[p];
+        // 本轮全部元素的这一位相同，分配后次序不变
+        if (h[(traits::encode (src[0]) >> (p * 8)) & 0xff] == length)
+            continue;
+
+        size_t sum = 0;
+        for (int d = 0; d < 256; ++d)
+        {
+            const size_t c = h[d];
+            h[d] = sum;
+            sum += c;
+        }
+        for (size_t i = 0; i < length; ++i)
+            dst[h[(traits::encode (src[i]) >> (p * 8)) & 0xff]++] = src[i];
+
+        T *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    if (src != arr)
+        memcpy (arr, src, sizeof(T) * length);
+    kyFree (buf);
+}
+
+}
+
+#endif // KY_SORT_INL
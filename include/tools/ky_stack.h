@@ -10,7 +10,7 @@
  *
  * @author   kunyang
  * @email    kunyang.yk@gmail.com
- * @version  1.0.0.1
+ * @version  1.0.2.0
  * @date     2012/01/02
  * @license  GNU General Public License (GPL)
  *
@@ -18,6 +18,7 @@
  *    Date    |  Version  |  Author  |   Description
  * 2012/01/02 | 1.0.0.1   | kunyang  | 创建文件
  * 2012/01/10 | 1.0.1.0   | kunyang  | 加入引用的可共享属性
+ * 2026/10/18 | 1.0.2.0   | kunyang  | 右值入栈改为移动，加入emplace
  */
 #ifndef ky_STACK
 #define ky_STACK
@@ -43,9 +44,15 @@ public:
 
     void push(const T& val){sequence.push_back (val);}
 #if kyLanguage >= kyLanguage11
-    void push(T && v){sequence.push_back (v);}
+    void push(T && v){sequence.push_back (std::move (v));}
+    template <typename ... Args>
+    T &emplace(Args &&...args){return sequence.emplace_back (std::forward<Args>(args)...);}
 #endif
+#if kyLanguage >= kyLanguage11
+    T pop(){T out = std::move (sequence.back ()); remove ();return out;}
+#else
     T pop(){T out = sequence.back (); remove ();return out;}
+#endif
     void remove(){sequence.pop_back();}
     void swap(ky_stack& s){ky_swap (sequence, s.sequence);}
     friend void ky_swap (ky_stack &a, ky_stack &b){a.swap (b);}
@@ -28,6 +28,7 @@
 #include "ky_array.h"
 #include "ky_stream.h"
 #include "ky_variant.h"
+#include "ky_stringview.h"
 
 class ky_string;
 
@@ -253,6 +254,19 @@ public:
     ky_string_list split(const std::string &)const;
     ky_string_list split(const std::wstring &)const;
 
+    //!不复制数据的视图，字符串修改或析构后失效
+public:
+    ky_stringview view()const{return ky_stringview((const uint16 *)data (), count ());}
+    ky_stringview view(int pos, int len)const{return view ().extract (pos, len);}
+    bool contains(const ky_stringview &s)const{return view ().find (s) >= 0;}
+    int find(const ky_stringview &s, int from = 0)const{return view ().find (s, from);}
+    ky_string& append(const ky_stringview &s){return append ((const ky_char *)s.data (), s.count ());}
+    //! 惰性分割，逐个产生视图，不生成ky_string_list
+    ky_stringview::splitter split_view(const ky_stringview &sep, bool skip_empty = false)const
+    {return view ().split (sep, skip_empty);}
+    ky_stringview::splitter split_view(uint16 sep, bool skip_empty = false)const
+    {return view ().split (sep, skip_empty);}
+
     //!字符串比较
 public:
    int compare(const char*)const;
@@ -386,6 +400,7 @@ private:
    ky_array<wchar_t> s_unicode;
 };
 
+kyDeclareRelocatable(ky_string);
 
 ky_streamb &operator << (ky_streamb &in, const ky_string &v);
 ky_streamb &operator >> (ky_streamb &out, ky_string &v);
@@ -394,5 +409,8 @@ ky_streamt &operator >> (ky_streamt &out, ky_string &v);
 ky_variant &operator << (ky_variant &va, const ky_string &col);
 ky_variant &operator >> (ky_variant &va, ky_string &col);
 
+//! 按UTF-16数据散列
+inline uint64 ky_hash(const ky_string &s){return __hash_::WY(s.data (), s.length () * sizeof(ky_char));}
+
 #endif // ky_STRING
 
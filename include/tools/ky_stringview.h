@@ -0,0 +1,174 @@
+
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_stringview.h
+ * @brief    不持有数据的字符串视图
+ *       1.只保存指针和长度，提取、修饰、查找、数字转换均不分配内存
+ *       2.ky_stringview 用于ky_string的UTF-16数据，ky_u8stringview 用于UTF-8数据
+ *       3.split 返回惰性分割器，逐个产生视图，不生成字符串链表
+ *       4.视图不延长数据的生命期，原字符串修改或析构后视图失效
+ *       5.查找使用ky_search，数字转换使用ky_number
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.2
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ * 2026/10/18 | 1.0.0.2   | kunyang  | 数字转换改用ky_number
+ */
+#ifndef ky_STRINGVIEW_H
+#define ky_STRINGVIEW_H
+
+#include "ky_define.h"
+#include "ky_algorlthm.h"
+#include "ky_search.h"
+#include "ky_number.h"
+
+template <typename T>
+class ky_basic_splitter;
+
+template <typename T>
+class ky_basic_stringview
+{
+public:
+    typedef T char_type;
+    typedef const T *iterator;
+    typedef ky_basic_splitter<T> splitter;
+
+    ky_basic_stringview():d(NULL), n(0){}
+    ky_basic_stringview(const T *s, int len):d(s), n(len > 0 ? len : 0){}
+    //! 以0结尾的字符串
+    ky_basic_stringview(const T *s);
+
+    const T *data()const{return d;}
+    int count()const{return n;}
+    size_t length()const{return (size_t)n;}
+    bool is_empty()const{return n == 0;}
+
+    T operator[](int i)const{return d[i];}
+    iterator begin()const{return d;}
+    iterator end()const{return d + n;}
+
+    //!字符串提取，截断，均返回原数据上的视图
+public:
+    //! count 负数时根据pos位置向前取，此时顺序不为逆
+    ky_basic_stringview extract(int pos, int count)const;
+    ky_basic_stringview extract(int pos)const{return extract (pos, n - pos);}
+    ky_basic_stringview start(int count)const{return extract (0, count);}
+    ky_basic_stringview end(int count)const{return extract (n - count, count);}
+    //! 去除两端的ASCII空白
+    ky_basic_stringview trimmed()const;
+
+    bool starts_with(const ky_basic_stringview &s)const;
+    bool ends_with(const ky_basic_stringview &s)const;
+
+    //!字符串查找，没有时返回-1
+public:
+    int find(T c, int from = 0)const;
+    int find(const ky_basic_stringview &s, int from = 0)const;
+    bool contains(T c)const{return find (c) >= 0;}
+    bool contains(const ky_basic_stringview &s)const{return find (s) >= 0;}
+
+    //!惰性分割
+public:
+    splitter split(const ky_basic_stringview &sep, bool skip_empty = false)const;
+    splitter split(const T &sep, bool skip_empty = false)const;
+
+    //!字符串比较
+public:
+    int compare(const ky_basic_stringview &s)const;
+    bool operator == (const ky_basic_stringview &s)const{return n == s.n && compare (s) == 0;}
+    bool operator != (const ky_basic_stringview &s)const{return !(*this == s);}
+    bool operator < (const ky_basic_stringview &s)const{return compare (s) < 0;}
+    bool operator > (const ky_basic_stringview &s)const{return compare (s) > 0;}
+
+    //! 数字输出 radix 代表存储的为什么进制，遇到非数字字符时停止，没有数字或溢出时返回0
+public:
+    bool      to_bool(int radix = 10)const{return to_longlong (radix) != 0;}
+    int       to_int(int radix = 10)const{return (int)to_longlong (radix);}
+    uint      to_uint(int radix = 10)const{return (uint)to_ulonglong (radix);}
+    long      to_long(int radix = 10)const{return (long)to_longlong (radix);}
+    ulong     to_ulong(int radix = 10)const{return (ulong)to_ulonglong (radix);}
+    longlong  to_longlong(int radix = 10)const;
+    ulonglong to_ulonglong(int radix = 10)const;
+    float     to_float()const;
+    real      to_real()const;
+
+private:
+    const T *d;
+    int n;
+};
+
+typedef ky_basic_stringview<uint16> ky_stringview;
+typedef ky_basic_stringview<char> ky_u8stringview;
+
+/*!
+ * @brief The ky_basic_splitter class 按分隔符逐个产生视图
+ * @class ky_basic_splitter
+ *  for (ky_u8stringview::splitter::iterator it = s.split (',').begin (); ...)
+ *  或 while (sp.next (token)) 逐个取出
+ */
+template <typename T>
+class ky_basic_splitter
+{
+public:
+    typedef ky_basic_stringview<T> view;
+
+    ky_basic_splitter(const view &src, const view &sep, bool skip_empty = false):
+        rest(src), delim(sep), unit(0), by_unit(false), skip(skip_empty), done(false){}
+    //! 以单个字符分隔
+    ky_basic_splitter(const view &src, T sep, bool skip_empty = false):
+        rest(src), unit(sep), by_unit(true), skip(skip_empty), done(false){}
+
+    //! 取出下一段，没有时返回false
+    bool next(view &token);
+
+    class iterator
+    {
+    public:
+        iterator():valid(false){}
+        explicit iterator(const ky_basic_splitter &s):valid(false), state(s){advance ();}
+
+        const view &operator *()const{return token;}
+        const view *operator ->()const{return &token;}
+        iterator &operator ++(){advance ();return *this;}
+        iterator operator ++(int){iterator o(*this);advance ();return o;}
+        //! 只区分是否结束
+        bool operator == (const iterator &rhs)const{return valid == rhs.valid;}
+        bool operator != (const iterator &rhs)const{return valid != rhs.valid;}
+
+    private:
+        void advance(){valid = state.next (token);}
+
+        bool valid;
+        ky_basic_splitter state;
+        view token;
+    };
+
+    iterator begin()const{return iterator(*this);}
+    iterator end()const{return iterator();}
+
+private:
+    ky_basic_splitter():unit(0), by_unit(false), skip(false), done(true){}
+
+    view rest;
+    view delim;
+    //! 单个字符时保存在对象内，复制后仍有效
+    T unit;
+    bool by_unit;
+    bool skip;
+    bool done;
+};
+
+//! 与同内容的ky_string、ky_u8string散列值相同
+template <typename T>
+inline uint64 ky_hash(const ky_basic_stringview<T> &s){return __hash_::WY(s.data (), s.length () * sizeof(T));}
+
+#include "ky_stringview.inl"
+#endif // ky_STRINGVIEW_H
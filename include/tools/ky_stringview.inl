@@ -0,0 +1,227 @@
+#ifndef KY_STRINGVIEW_INL
+#define KY_STRINGVIEW_INL
+
+namespace __stringview__ {
+
+//! 字符的无符号值
+template <typename T>
+inline uint32 code(T c)
+{
+    return (uint32)c;
+}
+
+template <>
+inline uint32 code<char>(char c)
+{
+    return (uint8)c;
+}
+
+inline bool is_space(uint32 c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+//! 数字转换用的ASCII前缀，UTF-16复制到buf，超长部分不参与；UTF-8直接使用原数据
+template <typename T>
+inline const char *ascii(const T *s, int n, char *buf, int size, int &len)
+{
+    len = n < size ? n : size;
+    for (int i = 0; i < len; ++i)
+    {
+        const uint32 c = code (s[i]);
+        if (c >= 0x80)
+        {
+            len = i;
+            break;
+        }
+        buf[i] = (char)c;
+    }
+    return buf;
+}
+
+inline const char *ascii(const char *s, int n, char *, int, int &len)
+{
+    len = n;
+    return s;
+}
+
+}
+
+template <typename T>
+ky_basic_stringview<T>::ky_basic_stringview(const T *s):
+    d(s), n(0)
+{
+    if (s)
+        while (s[n])
+            ++n;
+}
+
+template <typename T>
+ky_basic_stringview<T> ky_basic_stringview<T>::extract(int pos, int cnt)const
+{
+    if (cnt < 0)
+    {
+        pos += cnt;
+        cnt = -cnt;
+    }
+    if (pos < 0)
+    {
+        cnt += pos;
+        pos = 0;
+    }
+    if (pos >= n || cnt <= 0)
+        return ky_basic_stringview();
+    if (cnt > n - pos)
+        cnt = n - pos;
+    return ky_basic_stringview(d + pos, cnt);
+}
+
+template <typename T>
+ky_basic_stringview<T> ky_basic_stringview<T>::trimmed()const
+{
+    int b = 0;
+    int e = n;
+    while (b < e && __stringview__::is_space (__stringview__::code (d[b])))
+        ++b;
+    while (e > b && __stringview__::is_space (__stringview__::code (d[e - 1])))
+        --e;
+    return ky_basic_stringview(d + b, e - b);
+}
+
+template <typename T>
+bool ky_basic_stringview<T>::starts_with(const ky_basic_stringview &s)const
+{
+    return s.n <= n && (s.n == 0 || memcmp (d, s.d, s.n * sizeof(T)) == 0);
+}
+
+template <typename T>
+bool ky_basic_stringview<T>::ends_with(const ky_basic_stringview &s)const
+{
+    return s.n <= n && (s.n == 0 || memcmp (d + n - s.n, s.d, s.n * sizeof(T)) == 0);
+}
+
+template <typename T>
+int ky_basic_stringview<T>::find(T c, int from)const
+{
+    if (from < 0)
+        from = 0;
+    if (from >= n)
+        return -1;
+    const intptr at = ky_search::find (d + from, (size_t)(n - from), c);
+    return at < 0 ? -1 : from + (int)at;
+}
+
+template <typename T>
+int ky_basic_stringview<T>::find(const ky_basic_stringview &s, int from)const
+{
+    if (from < 0)
+        from = 0;
+    if (s.n == 0)
+        return from <= n ? from : -1;
+    if (s.n > n - from)
+        return -1;
+    const intptr at = ky_search::find (d + from, (size_t)(n - from), s.d, (size_t)s.n);
+    return at < 0 ? -1 : from + (int)at;
+}
+
+template <typename T>
+ky_basic_splitter<T> ky_basic_stringview<T>::split(const ky_basic_stringview &sep, bool skip_empty)const
+{
+    return splitter(*this, sep, skip_empty);
+}
+
+template <typename T>
+ky_basic_splitter<T> ky_basic_stringview<T>::split(const T &sep, bool skip_empty)const
+{
+    return splitter(*this, sep, skip_empty);
+}
+
+template <typename T>
+int ky_basic_stringview<T>::compare(const ky_basic_stringview &s)const
+{
+    const int m = n < s.n ? n : s.n;
+    for (int i = 0; i < m; ++i)
+        if (d[i] != s.d[i])
+            return __stringview__::code (d[i]) < __stringview__::code (s.d[i]) ? -1 : 1;
+    return n < s.n ? -1 : (n > s.n ? 1 : 0);
+}
+
+template <typename T>
+ulonglong ky_basic_stringview<T>::to_ulonglong(int radix)const
+{
+    char buf[128];
+    int m = 0;
+    const ky_basic_stringview s = trimmed ();
+    ulonglong v = 0;
+    const char *p = __stringview__::ascii (s.d, s.n, buf, (int)sizeof(buf), m);
+    ky_number::parse (p, m, v, radix);
+    return v;
+}
+
+template <typename T>
+longlong ky_basic_stringview<T>::to_longlong(int radix)const
+{
+    char buf[128];
+    int m = 0;
+    const ky_basic_stringview s = trimmed ();
+    longlong v = 0;
+    const char *p = __stringview__::ascii (s.d, s.n, buf, (int)sizeof(buf), m);
+    ky_number::parse (p, m, v, radix);
+    return v;
+}
+
+template <typename T>
+float ky_basic_stringview<T>::to_float()const
+{
+    char buf[128];
+    int m = 0;
+    const ky_basic_stringview s = trimmed ();
+    float v = 0;
+    const char *p = __stringview__::ascii (s.d, s.n, buf, (int)sizeof(buf), m);
+    ky_number::parse (p, m, v);
+    return v;
+}
+
+template <typename T>
+real ky_basic_stringview<T>::to_real()const
+{
+    char buf[128];
+    int m = 0;
+    const ky_basic_stringview s = trimmed ();
+    real v = 0;
+    const char *p = __stringview__::ascii (s.d, s.n, buf, (int)sizeof(buf), m);
+    ky_number::parse (p, m, v);
+    return v;
+}
+
+template <typename T>
+bool ky_basic_splitter<T>::next(view &token)
+{
+    while (!done)
+    {
+        int at = -1;
+        int step = 1;
+        if (by_unit)
+            at = rest.find (unit);
+        else if (!delim.is_empty ())
+        {
+            at = rest.find (delim);
+            step = delim.count ();
+        }
+        if (at < 0)
+        {
+            token = rest;
+            done = true;
+        }
+        else
+        {
+            token = view(rest.data (), at);
+            rest = view(rest.data () + at + step, rest.count () - at - step);
+        }
+        if (!skip || !token.is_empty ())
+            return true;
+    }
+    return false;
+}
+
+#endif // KY_STRINGVIEW_INL
@@ -0,0 +1,246 @@
+
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_u8string.h
+ * @brief    以UTF-8存储的字符串
+ *       1.接口与ky_string一致，位置及长度均以字节计
+ *       2.套接字、文件等UTF-8数据直接存储，不经过UTF-16转换，ASCII数据占用减半
+ *       3.与ky_string通过to_string及构造函数互相转换
+ *       4.提供ky_hash和比较运算，可作为ky_hash_map、ky_map的键
+ *       5.与UTF-16的转换及校验使用ky_utf的SIMD实现
+ *       6.view、split_view 返回ky_u8stringview，不复制数据
+ *       7.数字与文本的转换使用ky_number，浮点输出为最短的可还原表示
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.5
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ * 2026/10/18 | 1.0.0.2   | kunyang  | 转换改用ky_utf，增加is_valid
+ * 2026/10/18 | 1.0.0.3   | kunyang  | 增加ky_u8stringview视图接口
+ * 2026/10/18 | 1.0.0.4   | kunyang  | 查找改用ky_search
+ * 2026/10/18 | 1.0.0.5   | kunyang  | 增加数字输入输出
+ */
+#ifndef ky_U8STRING_H
+#define ky_U8STRING_H
+
+#include "ky_define.h"
+#include "ky_string.h"
+#include "ky_small_array.h"
+#include "ky_utf.h"
+#include "ky_stringview.h"
+#include <stdarg.h>
+
+class ky_u8string;
+//! 只保存ky_small_array，可按位重定位并内联存放在ky_list中；需在ky_u8string_list实例化之前声明
+kyDeclareRelocatable(ky_u8string);
+kyDeclareListInline(ky_u8string);
+typedef ky_list<ky_u8string> ky_u8string_list;
+
+//! ky_u8string 内联缓冲的字节数，短字符串不分配内存块
+#ifndef kyU8StringInlineSize
+#define kyU8StringInlineSize 16
+#endif
+typedef ky_small_array<char, kyU8StringInlineSize> ky_u8strbase;
+
+class ky_u8string : public ky_u8strbase
+{
+public:
+    ky_u8string(){}
+    ky_u8string(const ky_u8string &rhs):ky_u8strbase(rhs){}
+    ky_u8string(const ky_u8strbase &rhs):ky_u8strbase(rhs){}
+    ky_u8string(const char *s){append (s);}
+    ky_u8string(const char *s, int length){append (s, length);}
+    ky_u8string(const std::string &s){append (s);}
+    //! 由UTF-16字符串转换
+    explicit ky_u8string(const ky_string &s){form_string (s);}
+    explicit ky_u8string(const ky_u8stringview &s){append (s.data (), s.count ());}
+#if kyLanguage >= kyLanguage11
+    ky_u8string(ky_u8string &&rhs):ky_u8strbase(std::move (rhs)){}
+    ky_u8string &operator = (ky_u8string &&rhs){ky_u8strbase::operator = (std::move (rhs));return *this;}
+#endif
+
+    std::string std_string()const{return std::string(data (), size ());}
+
+    //! 转换为UTF-16字符串
+    ky_string to_string()const;
+    //! 由UTF-16字符串转换并替换内容
+    ky_u8string &form_string(const ky_string &s);
+
+public:
+    //! 字节数
+    size_t length() const{return size ();}
+    int count() const{return (int)size ();}
+    //! 码点数，非法的字节各计一个
+    size_t chars() const;
+
+    //! 是否为合法的UTF-8
+    bool is_valid() const;
+    //! 是否全部为ASCII字符
+    bool is_ascii() const;
+    //! 是否为数字字符串
+    bool is_number() const;
+
+    //!包含指定字符串
+public:
+    bool contains(const char *s)const{return find (s) >= 0;}
+    bool contains(const ky_u8string &s)const{return find (s) >= 0;}
+    bool contains(const std::string &s)const{return find (s) >= 0;}
+
+    //!字符串连接
+public:
+    ky_u8string& append(const char c){ky_u8strbase::append (c);return *this;}
+    ky_u8string& append(const char *s, int len = -1);
+    ky_u8string& append(const ky_u8string &s){return append (s.data (), s.count ());}
+    ky_u8string& append(const std::string &s){return append (s.data (), (int)s.size ());}
+    //! 追加一个码点的UTF-8编码
+    ky_u8string& append_unicode(uint32 code);
+    ky_u8string& append(const ky_u8stringview &s){return append (s.data (), s.count ());}
+
+    //!字符串插入
+public:
+    ky_u8string& insert(int pos, const char *s, int len = -1);
+    ky_u8string& insert(int pos, const ky_u8string &s){return insert (pos, s.data (), s.count ());}
+    ky_u8string& insert(int pos, const std::string &s){return insert (pos, s.data (), (int)s.size ());}
+
+    //!字符串删除
+public:
+    ky_u8string& remove(int pos, int len);
+    ky_u8string& remove(const char *s, int len = -1);
+    ky_u8string& remove(const ky_u8string &s){return remove (s.data (), s.count ());}
+    ky_u8string& remove(const std::string &s){return remove (s.data (), (int)s.size ());}
+    //! 清空内容；ky_small_array::clear只按Type()填充，不改变长度
+    void clear(){ky_u8strbase::remove (0, size ());}
+
+    //!字符串替换，返回替换的次数
+public:
+    int replace(int pos, int len, const ky_u8string &token);
+    int replace(const char *token1, const char *token2);
+    int replace(const ky_u8string &token1, const ky_u8string &token2);
+    int replace(const std::string &token1, const std::string &token2);
+
+    //!字符串提取，截断
+public:
+    //! count 负数时根据pos位置向前取，此时顺序不为逆
+    ky_u8string extract(int pos, int count)const;
+    //! 根据pos位置将后面的全部提取
+    ky_u8string extract(int pos)const{return extract (pos, this->count () - pos);}
+    //! 从开头提取count个字节
+    ky_u8string start(int count)const{return extract (0, count);}
+    //! 从结尾提取count个字节，此时不为逆
+    ky_u8string end(int count)const{return extract (this->count () - count, count);}
+    //! 去除两端的空白
+    ky_u8string trimmed() const;
+
+    //!字符串查找，返回字节位置，没有时返回-1
+public:
+    int find(char c, int from = 0) const;
+    int find(const char *s, int from = 0) const;
+    int find(const char *s, int len, int from) const;
+    int find(const ky_u8string &s, int from = 0) const{return find (s.data (), s.count (), from);}
+    int find(const std::string &s, int from = 0) const{return find (s.data (), (int)s.size (), from);}
+
+    //!字符串分割
+public:
+    ky_u8string_list split(const char *sep)const;
+    ky_u8string_list split(const char *sep, int len)const;
+    ky_u8string_list split(const ky_u8string &sep)const{return split (sep.data (), sep.count ());}
+    ky_u8string_list split(const std::string &sep)const{return split (sep.data (), (int)sep.size ());}
+
+    //!不复制数据的视图，字符串修改或析构后失效
+public:
+    ky_u8stringview view()const{return ky_u8stringview(data (), count ());}
+    ky_u8stringview view(int pos, int len)const{return view ().extract (pos, len);}
+    bool contains(const ky_u8stringview &s)const{return find (s) >= 0;}
+    int find(const ky_u8stringview &s, int from = 0)const{return find (s.data (), s.count (), from);}
+    //! 惰性分割，逐个产生视图，不生成ky_u8string_list
+    ky_u8stringview::splitter split_view(const ky_u8stringview &sep, bool skip_empty = false)const
+    {return view ().split (sep, skip_empty);}
+    ky_u8stringview::splitter split_view(char sep, bool skip_empty = false)const
+    {return view ().split (sep, skip_empty);}
+
+    //!字符串比较，按字节比较即为码点次序
+public:
+    int compare(const char *s)const;
+    int compare(const char *s, int len)const;
+    int compare(const ky_u8string &s)const{return compare (s.data (), s.count ());}
+    int compare(const std::string &s)const{return compare (s.data (), (int)s.size ());}
+
+    //! 格式输入
+public:
+    ky_u8string& format(const char *fmt, ...);
+    static ky_u8string formats(const char *fmt, ...);
+    //! 按fmt格式化后追加
+    ky_u8string& append_format(const char *fmt, va_list ap);
+
+    //! 数字输入，radix 代表需要存储为什么进制，替换原内容
+public:
+    ky_u8string &form(int v, int radix = 10){return form ((longlong)v, radix);}
+    ky_u8string &form(uint v, int radix = 10){return form ((ulonglong)v, radix);}
+    ky_u8string &form(long v, int radix = 10){return form ((longlong)v, radix);}
+    ky_u8string &form(ulong v, int radix = 10){return form ((ulonglong)v, radix);}
+    ky_u8string &form(longlong v, int radix = 10);
+    ky_u8string &form(ulonglong v, int radix = 10);
+    //! 最短的可还原表示，to_real可得到相同的值
+    ky_u8string &form(float v);
+    ky_u8string &form(real v);
+
+    template<typename T>
+    static ky_u8string number(T v, int radix = 10){ky_u8string str; str.form (v, radix);return str;}
+    static ky_u8string number(float v){ky_u8string str; str.form (v);return str;}
+    static ky_u8string number(real v){ky_u8string str; str.form (v);return str;}
+
+    //! 数字输出 radix 代表存储的为什么进制，没有数字或溢出时返回0
+public:
+    bool      to_bool(int radix = 10)const{return view ().to_bool (radix);}
+    int       to_int(int radix = 10)const{return view ().to_int (radix);}
+    uint      to_uint(int radix = 10)const{return view ().to_uint (radix);}
+    long      to_long(int radix = 10)const{return view ().to_long (radix);}
+    ulong     to_ulong(int radix = 10)const{return view ().to_ulong (radix);}
+    longlong  to_longlong(int radix = 10)const{return view ().to_longlong (radix);}
+    ulonglong to_ulonglong(int radix = 10)const{return view ().to_ulonglong (radix);}
+    float     to_float()const{return view ().to_float ();}
+    real      to_real()const{return view ().to_real ();}
+
+public:
+    ky_u8string& operator=(const char *s){clear ();return append (s);}
+    ky_u8string& operator=(const ky_u8string &s){ky_u8strbase::operator = (s);return *this;}
+    ky_u8string& operator=(const std::string &s){clear ();return append (s);}
+
+    bool operator==(const char *str)const {return compare(str) == 0;}
+    bool operator==(const ky_u8string &str)const {return compare(str) == 0;}
+    bool operator==(const std::string &str)const {return compare(str) == 0;}
+    bool operator!=(const char *str)const {return !((*this) == str);}
+    bool operator!=(const ky_u8string &str)const {return !((*this) == str);}
+    bool operator!=(const std::string &str)const {return !((*this) == str);}
+
+    ky_u8string operator+(const char c) const{ky_u8string o(*this);return o.append (c);}
+    ky_u8string operator+(const char *s) const{ky_u8string o(*this);return o.append (s);}
+    ky_u8string operator+(const ky_u8string &s) const{ky_u8string o(*this);return o.append (s);}
+    ky_u8string operator+(const std::string &s) const{ky_u8string o(*this);return o.append (s);}
+
+    const ky_u8string& operator+=(const char c){return append(c);}
+    const ky_u8string& operator+=(const char *str){return append(str);}
+    const ky_u8string& operator+=(const ky_u8string &str){return append(str);}
+    const ky_u8string& operator+=(const std::string &str){return append(str);}
+
+    bool operator < (const ky_u8string &str)const{return compare (str) < 0;}
+    bool operator > (const ky_u8string &str)const{return compare (str) > 0;}
+
+public:
+    //! 只转换ASCII字母
+    void upper();
+    void lower();
+};
+
+//! 按UTF-8数据散列
+inline uint64 ky_hash(const ky_u8string &s){return __hash_::WY(s.data (), s.size ());}
+
+#include "ky_u8string.inl"
+#endif // ky_U8STRING_H
@@ -0,0 +1,385 @@
+#ifndef KY_U8STRING_INL
+#define KY_U8STRING_INL
+
+inline ky_string ky_u8string::to_string()const
+{
+    // UTF-16单元数不超过字节数；非法序列以U+FFFD替换
+    const size_t n = size ();
+    if (n == 0)
+        return ky_string();
+    uint16 buf[256];
+    uint16 *u = n <= 256 ? buf : (uint16 *)kyMalloc (n * sizeof(uint16));
+    const size_t w = ky_utf::utf8_to_utf16 ((const uint8 *)data (), n, u, true);
+    ky_string out((const ky_char *)u, (int)w);
+    if (u != buf)
+        kyFree (u);
+    return out;
+}
+
+inline ky_u8string &ky_u8string::form_string(const ky_string &s)
+{
+    // 每个UTF-16单元最多编码为3字节，不成对的代理项以U+FFFD替换
+    const size_t n = (size_t)s.count ();
+    clear ();
+    if (n == 0)
+        return *this;
+    resize (n * 3);
+    const size_t w = ky_utf::utf16_to_utf8 ((const uint16 *)s.data (), n,
+                                            (uint8 *)data (), true);
+    ky_u8strbase::remove (w, size () - w);
+    return *this;
+}
+
+inline bool ky_u8string::is_valid() const
+{
+    return ky_utf::validate ((const uint8 *)data (), size ());
+}
+
+inline size_t ky_u8string::chars() const
+{
+    // 只统计非后续字节(10xxxxxx)
+    const char *s = data ();
+    const size_t n = size ();
+    size_t c = 0;
+    for (size_t i = 0; i < n; ++i)
+        c += ((uint8)s[i] & 0xc0) != 0x80;
+    return c;
+}
+
+inline bool ky_u8string::is_ascii() const
+{
+    const char *s = data ();
+    const size_t n = size ();
+    uint8 acc = 0;
+    for (size_t i = 0; i < n; ++i)
+        acc |= (uint8)s[i];
+    return acc < 0x80;
+}
+
+inline bool ky_u8string::is_number() const
+{
+    const char *s = data ();
+    const int n = count ();
+    int i = (n > 0 && (s[0] == '-' || s[0] == '+')) ? 1 : 0;
+    bool digit = false;
+    bool dot = false;
+    for (; i < n; ++i)
+    {
+        if (s[i] >= '0' && s[i] <= '9')
+            digit = true;
+        else if (s[i] == '.' && !dot)
+            dot = true;
+        else
+            return false;
+    }
+    return digit;
+}
+
+inline ky_u8string& ky_u8string::append(const char *s, int len)
+{
+    if (s == NULL)
+        return *this;
+    if (len < 0)
+        len = (int)strlen (s);
+    if (len > 0)
+        ky_u8strbase::append (s, (size_t)len);
+    return *this;
+}
+
+inline ky_u8string& ky_u8string::append_unicode(uint32 code)
+{
+    char buf[4];
+    int n;
+    if (code < 0x80)
+    {
+        buf[0] = (char)code;
+        n = 1;
+    }
+    else if (code < 0x800)
+    {
+        buf[0] = (char)(0xc0 | (code >> 6));
+        buf[1] = (char)(0x80 | (code & 0x3f));
+        n = 2;
+    }
+    else if (code < 0x10000)
+    {
+        buf[0] = (char)(0xe0 | (code >> 12));
+        buf[1] = (char)(0x80 | ((code >> 6) & 0x3f));
+        buf[2] = (char)(0x80 | (code & 0x3f));
+        n = 3;
+    }
+    else
+    {
+        buf[0] = (char)(0xf0 | (code >> 18));
+        buf[1] = (char)(0x80 | ((code >> 12) & 0x3f));
+        buf[2] = (char)(0x80 | ((code >> 6) & 0x3f));
+        buf[3] = (char)(0x80 | (code & 0x3f));
+        n = 4;
+    }
+    return append (buf, n);
+}
+
+inline ky_u8string& ky_u8string::insert(int pos, const char *s, int len)
+{
+    if (s == NULL)
+        return *this;
+    if (len < 0)
+        len = (int)strlen (s);
+    if (len > 0)
+        ky_u8strbase::insert (pos, s, (size_t)len);
+    return *this;
+}
+
+inline ky_u8string& ky_u8string::remove(int pos, int len)
+{
+    if (pos < 0 || pos >= count () || len <= 0)
+        return *this;
+    if (len > count () - pos)
+        len = count () - pos;
+    ky_u8strbase::remove (pos, (size_t)len);
+    return *this;
+}
+
+inline ky_u8string& ky_u8string::remove(const char *s, int len)
+{
+    if (s == NULL)
+        return *this;
+    if (len < 0)
+        len = (int)strlen (s);
+    if (len > 0)
+        replace (ky_u8string(s, len), ky_u8string());
+    return *this;
+}
+
+inline int ky_u8string::replace(int pos, int len, const ky_u8string &token)
+{
+    if (pos < 0 || pos > count () || len < 0)
+        return 0;
+    if (len > count () - pos)
+        len = count () - pos;
+    ky_u8strbase::replace (pos, (size_t)len, token.data (), token.size ());
+    return 1;
+}
+
+inline int ky_u8string::replace(const char *token1, const char *token2)
+{
+    return replace (ky_u8string(token1), ky_u8string(token2));
+}
+
+inline int ky_u8string::replace(const std::string &token1, const std::string &token2)
+{
+    return replace (ky_u8string(token1), ky_u8string(token2));
+}
+
+inline int ky_u8string::replace(const ky_u8string &token1, const ky_u8string &token2)
+{
+    const int tl = token1.count ();
+    if (tl == 0)
+        return 0;
+    int at = find (token1);
+    if (at < 0)
+        return 0;
+
+    // 一次扫描拼接到新串，避免逐个替换时反复移动尾部
+    ky_u8string out;
+    out.reserve (size ());
+    const char *s = data ();
+    int from = 0;
+    int times = 0;
+    for (; at >= 0; at = find (token1, from))
+    {
+        out.append (s + from, at - from);
+        out.append (token2);
+        from = at + tl;
+        ++times;
+    }
+    out.append (s + from, count () - from);
+    *this = out;
+    return times;
+}
+
+inline ky_u8string ky_u8string::extract(int pos, int cnt)const
+{
+    if (cnt < 0)
+    {
+        pos += cnt;
+        cnt = -cnt;
+    }
+    if (pos < 0)
+    {
+        cnt += pos;
+        pos = 0;
+    }
+    if (pos >= count () || cnt <= 0)
+        return ky_u8string();
+    if (cnt > count () - pos)
+        cnt = count () - pos;
+    return ky_u8string(data () + pos, cnt);
+}
+
+inline ky_u8string ky_u8string::trimmed() const
+{
+    const char *s = data ();
+    int b = 0;
+    int e = count ();
+    while (b < e && isspace ((uint8)s[b]))
+        ++b;
+    while (e > b && isspace ((uint8)s[e - 1]))
+        --e;
+    return ky_u8string(s + b, e - b);
+}
+
+inline int ky_u8string::find(char c, int from) const
+{
+    if (from < 0)
+        from = 0;
+    if (from >= count ())
+        return -1;
+    const char *s = data ();
+    const char *at = (const char *)memchr (s + from, c, count () - from);
+    return at ? (int)(at - s) : -1;
+}
+
+inline int ky_u8string::find(const char *s, int from) const
+{
+    return s ? find (s, (int)strlen (s), from) : -1;
+}
+
+inline int ky_u8string::find(const char *s, int len, int from) const
+{
+    if (from < 0)
+        from = 0;
+    const int n = count ();
+    if (len <= 0)
+        return from <= n ? from : -1;
+    if (len > n - from)
+        return -1;
+    const intptr at = ky_search::find (data () + from, (size_t)(n - from), s, (size_t)len);
+    return at < 0 ? -1 : from + (int)at;
+}
+
+inline ky_u8string_list ky_u8string::split(const char *sep)const
+{
+    return split (sep, sep ? (int)strlen (sep) : 0);
+}
+
+inline ky_u8string_list ky_u8string::split(const char *sep, int len)const
+{
+    ky_u8string_list out;
+    if (len <= 0)
+    {
+        out.append (*this);
+        return out;
+    }
+    int from = 0;
+    for (int at = find (sep, len, 0); at >= 0; at = find (sep, len, from))
+    {
+        out.append (ky_u8string(data () + from, at - from));
+        from = at + len;
+    }
+    out.append (ky_u8string(data () + from, count () - from));
+    return out;
+}
+
+inline int ky_u8string::compare(const char *s)const
+{
+    return compare (s, s ? (int)strlen (s) : 0);
+}
+
+inline int ky_u8string::compare(const char *s, int len)const
+{
+    const int n = count ();
+    const int m = n < len ? n : len;
+    const int r = m > 0 ? memcmp (data (), s, m) : 0;
+    if (r != 0)
+        return r;
+    return n < len ? -1 : (n > len ? 1 : 0);
+}
+
+inline ky_u8string& ky_u8string::append_format(const char *fmt, va_list ap)
+{
+    char buf[256];
+    va_list again;
+    va_copy (again, ap);
+    const int n = vsnprintf (buf, sizeof(buf), fmt, ap);
+    if (n >= 0 && n < (int)sizeof(buf))
+        append (buf, n);
+    else if (n >= 0)
+    {
+        // 超出栈缓冲时按实际长度重新格式化
+        char *big = (char *)kyMalloc (n + 1);
+        vsnprintf (big, n + 1, fmt, again);
+        append (big, n);
+        kyFree (big);
+    }
+    va_end (again);
+    return *this;
+}
+
+inline ky_u8string& ky_u8string::format(const char *fmt, ...)
+{
+    clear ();
+    va_list ap;
+    va_start (ap, fmt);
+    append_format (fmt, ap);
+    va_end (ap);
+    return *this;
+}
+
+inline ky_u8string ky_u8string::formats(const char *fmt, ...)
+{
+    ky_u8string out;
+    va_list ap;
+    va_start (ap, fmt);
+    out.append_format (fmt, ap);
+    va_end (ap);
+    return out;
+}
+
+inline ky_u8string &ky_u8string::form(longlong v, int radix)
+{
+    char buf[ky_number::IntegerSize];
+    clear ();
+    return append (buf, ky_number::format (v, buf, radix));
+}
+
+inline ky_u8string &ky_u8string::form(ulonglong v, int radix)
+{
+    char buf[ky_number::IntegerSize];
+    clear ();
+    return append (buf, ky_number::format (v, buf, radix));
+}
+
+inline ky_u8string &ky_u8string::form(float v)
+{
+    char buf[ky_number::RealSize];
+    clear ();
+    return append (buf, ky_number::format (v, buf));
+}
+
+inline ky_u8string &ky_u8string::form(real v)
+{
+    char buf[ky_number::RealSize];
+    clear ();
+    return append (buf, ky_number::format (v, buf));
+}
+
+inline void ky_u8string::upper()
+{
+    char *s = data ();
+    const size_t n = size ();
+    for (size_t i = 0; i < n; ++i)
+        if (s[i] >= 'a' && s[i] <= 'z')
+            s[i] -= 'a' - 'A';
+}
+
+inline void ky_u8string::lower()
+{
+    char *s = data ();
+    const size_t n = size ();
+    for (size_t i = 0; i < n; ++i)
+        if (s[i] >= 'A' && s[i] <= 'Z')
+            s[i] += 'a' - 'A';
+}
+
+#endif // KY_U8STRING_INL
@@ -0,0 +1,626 @@
+#ifndef KY_URL_VIEW_INL
+#define KY_URL_VIEW_INL
+
+namespace __url__
+{
+    inline bool is_alpha(uint16 c){return (c | 0x20) >= 'a' && (c | 0x20) <= 'z';}
+    inline bool is_digit(uint16 c){return c >= '0' && c <= '9';}
+    inline bool is_scheme(uint16 c){return is_alpha (c) || is_digit (c) || c == '+' || c == '-' || c == '.';}
+    inline bool is_unreserved(int c)
+    {
+        return is_alpha ((uint16)c) || is_digit ((uint16)c) || c == '-' || c == '.' || c == '_' || c == '~';
+    }
+    inline uint16 lower(uint16 c){return c >= 'A' && c <= 'Z' ? c + 32 : c;}
+    inline int hex(uint16 c)
+    {
+        if (is_digit (c))
+            return c - '0';
+        if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+            return (c | 0x20) - 'a' + 10;
+        return -1;
+    }
+
+    //! 协议名及默认端口，名称为小写
+    struct protocol
+    {
+        const char *name;
+        int len;
+        eUrlProtocols id;
+        int port;
+    };
+    static const protocol protocols[] =
+    {
+        {"file", 4, Protocol_File, -1},
+        {"ftp", 3, Protocol_Ftp, 21},
+        {"gopher", 6, Protocol_Gopher, 70},
+        {"http", 4, Protocol_Http, 80},
+        {"https", 5, Protocol_Https, 443},
+        {"mailto", 6, Protocol_Mailto, -1},
+        {"mms", 3, Protocol_MMS, 1755},
+        {"telnet", 6, Protocol_Telnet, 23},
+        {"news", 4, Protocol_News, 119}
+    };
+    enum {ProtocolCount = sizeof(protocols) / sizeof(protocols[0])};
+
+    inline eUrlProtocols match(const uint16 *s, int n)
+    {
+        for (int i = 0; i < ProtocolCount; ++i)
+        {
+            if (protocols[i].len != n)
+                continue;
+            int k = 0;
+            while (k < n && lower (s[k]) == (uint16)protocols[i].name[k])
+                ++k;
+            if (k == n)
+                return protocols[i].id;
+        }
+        return Protocol_UrlNot;
+    }
+    inline int default_port(eUrlProtocols p)
+    {
+        for (int i = 0; i < ProtocolCount; ++i)
+            if (protocols[i].id == p)
+                return protocols[i].port;
+        return -1;
+    }
+
+    //! 没有scheme时的file
+    static const uint16 file_scheme[] = {'f', 'i', 'l', 'e'};
+
+    //!
+    //! \brief canon 按规范化后的字符逐个读取，用于不生成新串的比较
+    //!  非保留字符的转义读为字符本身，其余转义读为0x10000 | 字节
+    //!
+    struct canon
+    {
+        const uint16 *p;
+        const uint16 *e;
+        bool fold;
+
+        canon(const ky_stringview &v, bool f):p(v.data ()), e(v.data () + v.count ()), fold(f){}
+
+        int next()
+        {
+            if (p == e)
+                return -1;
+            if (*p == '%' && e - p >= 3)
+            {
+                const int h = hex (p[1]), l = hex (p[2]);
+                if (h >= 0 && l >= 0)
+                {
+                    p += 3;
+                    const int b = (h << 4) | l;
+                    if (is_unreserved (b))
+                        return fold ? lower ((uint16)b) : b;
+                    return 0x10000 | b;
+                }
+            }
+            const uint16 c = *p++;
+            return fold ? lower (c) : c;
+        }
+
+        static bool equal(const ky_stringview &a, const ky_stringview &b, bool fold)
+        {
+            canon x(a, fold), y(b, fold);
+            for (;;)
+            {
+                const int c = x.next ();
+                if (c != y.next ())
+                    return false;
+                if (c < 0)
+                    return true;
+            }
+        }
+    };
+
+    //! 只用于生成规范化的串
+    struct builder
+    {
+        uint16 *d;
+        int n;
+        int cap;
+
+        builder():d(NULL), n(0), cap(0){}
+        ~builder(){kyFree (d);}
+
+        void push(uint16 c)
+        {
+            if (n == cap)
+            {
+                cap = cap ? cap * 2 : 64;
+                d = (uint16 *)kyRealloc (d, (size_t)cap * sizeof(uint16));
+            }
+            d[n++] = c;
+        }
+        void push(const char *s){while (*s) push ((uint16)*s++);}
+        //! 写入规范化的转义
+        void escaped(const ky_stringview &v, bool fold)
+        {
+            static const char digits[] = "0123456789ABCDEF";
+            canon r(v, fold);
+            for (int c = r.next (); c >= 0; c = r.next ())
+            {
+                if (c & 0x10000)
+                {
+                    push ('%');
+                    push ((uint16)digits[(c >> 4) & 0xf]);
+                    push ((uint16)digits[c & 0xf]);
+                }
+                else
+                    push ((uint16)c);
+            }
+        }
+        //! 去掉最后一段及其前面的'/'
+        void pop_segment()
+        {
+            while (n > 0 && d[n - 1] != '/')
+                --n;
+            if (n > 0)
+                --n;
+        }
+        ky_string take()const{return ky_string((const ky_char *)d, n);}
+
+    private:
+        builder(const builder &);
+        builder &operator = (const builder &);
+    };
+
+    //! 路径中是否有.或..段
+    inline bool has_dots(const ky_stringview &v)
+    {
+        const uint16 *s = v.data ();
+        const int n = v.count ();
+        for (int i = 0; i < n; ++i)
+        {
+            if (s[i] != '.' || (i > 0 && s[i - 1] != '/'))
+                continue;
+            const int k = (i + 1 < n && s[i + 1] == '.') ? i + 2 : i + 1;
+            if (k == n || s[k] == '/')
+                return true;
+        }
+        return false;
+    }
+
+    //! RFC 3986 5.2.4，输入为已规范化转义的路径
+    inline void remove_dots(const uint16 *in, int n, builder &out)
+    {
+        int i = 0;
+        while (i < n)
+        {
+            const int left = n - i;
+            const uint16 *s = in + i;
+            if (left >= 3 && s[0] == '.' && s[1] == '.' && s[2] == '/')
+                i += 3;
+            else if (left >= 2 && s[0] == '.' && s[1] == '/')
+                i += 2;
+            else if (left >= 3 && s[0] == '/' && s[1] == '.' && s[2] == '/')
+                i += 2;
+            else if (left == 2 && s[0] == '/' && s[1] == '.')
+            {
+                out.push ('/');
+                i = n;
+            }
+            else if (left >= 4 && s[0] == '/' && s[1] == '.' && s[2] == '.' && s[3] == '/')
+            {
+                out.pop_segment ();
+                i += 3;
+            }
+            else if (left == 3 && s[0] == '/' && s[1] == '.' && s[2] == '.')
+            {
+                out.pop_segment ();
+                out.push ('/');
+                i = n;
+            }
+            else if ((left == 1 && s[0] == '.') || (left == 2 && s[0] == '.' && s[1] == '.'))
+                i = n;
+            else
+            {
+                // 移出第一段，包括开头的'/'
+                out.push (in[i++]);
+                while (i < n && in[i] != '/')
+                    out.push (in[i++]);
+            }
+        }
+    }
+}
+
+inline ky_url_view::ky_url_view():
+    digest(0),
+    port_(-1),
+    proto(Protocol_UrlNot),
+    flags(0)
+{
+    for (int i = 0; i < Url_ComponentCount; ++i)
+    {
+        spans[i].pos = 0;
+        spans[i].len = -1;
+    }
+}
+
+inline ky_url_view::ky_url_view(const ky_string &url):
+    digest(0),
+    port_(-1),
+    proto(Protocol_UrlNot),
+    flags(0)
+{
+    resolve (url);
+}
+
+inline ky_url_view::ky_url_view(const ky_url &url):
+    digest(0),
+    port_(-1),
+    proto(Protocol_UrlNot),
+    flags(0)
+{
+    resolve (url.url ());
+}
+
+inline bool ky_url_view::resolve(const ky_string &url)
+{
+    using namespace __url__;
+    url_ = url;
+    const ky_stringview v = url_.view ();
+    const uint16 *s = v.data ();
+    const int n = v.count ();
+    for (int i = 0; i < Url_ComponentCount; ++i)
+    {
+        spans[i].pos = 0;
+        spans[i].len = -1;
+    }
+    digest = ky_hash (v);
+    port_ = -1;
+    proto = Protocol_UrlNot;
+    flags = 0;
+    if (n == 0)
+        return false;
+
+    // scheme，单个字母视为盘符
+    int i = 0;
+    if (is_alpha (s[0]))
+    {
+        int k = 1;
+        while (k < n && is_scheme (s[k]))
+            ++k;
+        if (k >= 2 && k < n && s[k] == ':')
+        {
+            spans[Url_Scheme].pos = 0;
+            spans[Url_Scheme].len = k;
+            i = k + 1;
+        }
+    }
+    if (spans[Url_Scheme].len < 0)
+    {
+        spans[Url_Path].pos = 0;
+        spans[Url_Path].len = n;
+        proto = Protocol_File;
+        flags = Flag_Valid | Flag_ImplicitFile;
+        return true;
+    }
+    proto = (uint8)match (s, spans[Url_Scheme].len);
+
+    bool valid = true;
+    if (n - i >= 2 && s[i] == '/' && s[i + 1] == '/')
+    {
+        flags |= Flag_Authority;
+        const int a = i + 2;
+        int e = a, at = -1;
+        for (; e < n && s[e] != '/' && s[e] != '?' && s[e] != '#'; ++e)
+            if (s[e] == '@')
+                at = e;
+        int h = a;
+        if (at >= 0)
+        {
+            int colon = a;
+            while (colon < at && s[colon] != ':')
+                ++colon;
+            spans[Url_Username].pos = a;
+            spans[Url_Username].len = colon - a;
+            if (colon < at)
+            {
+                spans[Url_Password].pos = colon + 1;
+                spans[Url_Password].len = at - colon - 1;
+            }
+            h = at + 1;
+        }
+
+        if (proto == Protocol_File && e - h == 2 && is_alpha (s[h]) && s[h + 1] == ':')
+        {
+            // file://C:/dir 中的盘符属于路径
+            spans[Url_Host].pos = h;
+            spans[Url_Host].len = 0;
+            e = h;
+        }
+        else
+        {
+            int hend = e;
+            if (h < e && s[h] == '[')
+            {
+                // IPv6字面地址
+                int close = h;
+                while (close < e && s[close] != ']')
+                    ++close;
+                if (close == e)
+                    valid = false;
+                hend = close < e ? close + 1 : e;
+                if (hend < e && s[hend] != ':')
+                    valid = false;
+            }
+            else
+            {
+                // reg-name中不能有':'，第一个':'后为端口
+                for (int k = h; k < e && hend == e; ++k)
+                    if (s[k] == ':')
+                        hend = k;
+            }
+            spans[Url_Host].pos = h;
+            spans[Url_Host].len = hend - h;
+            if (hend < e && s[hend] == ':')
+            {
+                spans[Url_Port].pos = hend + 1;
+                spans[Url_Port].len = e - hend - 1;
+                int value = 0;
+                for (int k = hend + 1; k < e && valid; ++k)
+                {
+                    if (!is_digit (s[k]))
+                        valid = false;
+                    value = value * 10 + (s[k] - '0');
+                    if (value > 65535)
+                        valid = false;
+                }
+                if (valid && e > hend + 1)
+                    port_ = value;
+            }
+        }
+        i = e;
+    }
+
+    int k = i;
+    while (k < n && s[k] != '?' && s[k] != '#')
+        ++k;
+    spans[Url_Path].pos = i;
+    spans[Url_Path].len = k - i;
+    if (k < n && s[k] == '?')
+    {
+        const int q = ++k;
+        while (k < n && s[k] != '#')
+            ++k;
+        spans[Url_Query].pos = q;
+        spans[Url_Query].len = k - q;
+    }
+    if (k < n)
+    {
+        spans[Url_Fragment].pos = k + 1;
+        spans[Url_Fragment].len = n - k - 1;
+    }
+    if (valid)
+        flags |= Flag_Valid;
+    return valid;
+}
+
+inline bool ky_url_view::is_empty() const
+{
+    return url_.view ().is_empty ();
+}
+
+inline bool ky_url_view::is_valid() const
+{
+    return (flags & Flag_Valid) != 0;
+}
+
+inline eUrlProtocols ky_url_view::protocol() const
+{
+    return (eUrlProtocols)proto;
+}
+
+inline ky_stringview ky_url_view::view(eUrlComponents c) const
+{
+    if (c == Url_Scheme && (flags & Flag_ImplicitFile))
+        return ky_stringview(__url__::file_scheme, 4);
+    const span &sp = spans[c];
+    if (sp.len < 0)
+        return ky_stringview();
+    return ky_stringview(url_.view ().data () + sp.pos, sp.len);
+}
+
+inline bool ky_url_view::has(eUrlComponents c) const
+{
+    return spans[c].len >= 0 || (c == Url_Scheme && (flags & Flag_ImplicitFile));
+}
+
+inline ky_string ky_url_view::part(eUrlComponents c) const
+{
+    const span &sp = spans[c];
+    // 整个原串时共享数据，不复制
+    if (sp.pos == 0 && sp.len == url_.view ().count ())
+        return url_;
+    const ky_stringview v = view (c);
+    return v.is_empty () ? ky_string() : ky_string((const ky_char *)v.data (), v.count ());
+}
+
+inline ky_string ky_url_view::scheme() const
+{
+    if (flags & Flag_ImplicitFile)
+        return ky_string("file");
+    ky_string out = part (Url_Scheme);
+    out.lower ();
+    return out;
+}
+
+inline ky_string ky_url_view::host() const{return part (Url_Host);}
+inline ky_string ky_url_view::port() const{return part (Url_Port);}
+inline ky_string ky_url_view::path() const{return part (Url_Path);}
+inline ky_string ky_url_view::query() const{return part (Url_Query);}
+inline ky_string ky_url_view::fragment() const{return part (Url_Fragment);}
+inline ky_string ky_url_view::username() const{return part (Url_Username);}
+inline ky_string ky_url_view::password() const{return part (Url_Password);}
+inline ky_string ky_url_view::url() const{return url_;}
+
+inline int ky_url_view::port_number() const
+{
+    return port_ >= 0 ? port_ : __url__::default_port ((eUrlProtocols)proto);
+}
+
+inline ky_string ky_url_view::decode(const ky_stringview &v)
+{
+    if (!v.contains ((uint16)'%'))
+        return ky_string((const ky_char *)v.data (), v.count ());
+    // 先转为UTF-8，转义解码后的字节与其余字符一起按UTF-8还原
+    const size_t n = v.length ();
+    uint8 buf[256 * 3];
+    uint8 *u = n * 3 <= sizeof(buf) ? buf : (uint8 *)kyMalloc (n * 3);
+    const size_t m = ky_utf::utf16_to_utf8 (v.data (), n, u, true);
+    size_t w = 0;
+    for (size_t i = 0; i < m; ++i)
+    {
+        if (u[i] == '%' && i + 2 < m)
+        {
+            const int h = __url__::hex (u[i + 1]), l = __url__::hex (u[i + 2]);
+            if (h >= 0 && l >= 0)
+            {
+                u[w++] = (uint8)((h << 4) | l);
+                i += 2;
+                continue;
+            }
+        }
+        u[w++] = u[i];
+    }
+    uint16 wide[256];
+    uint16 *o = w <= 256 ? wide : (uint16 *)kyMalloc (w * sizeof(uint16));
+    const size_t k = ky_utf::utf8_to_utf16 (u, w, o, true);
+    const ky_string out((const ky_char *)o, (int)k);
+    if (o != wide)
+        kyFree (o);
+    if (u != buf)
+        kyFree (u);
+    return out;
+}
+
+inline ky_string ky_url_view::decoded(eUrlComponents c) const
+{
+    if (c == Url_Scheme)
+        return scheme ();
+    return decode (view (c));
+}
+
+inline ky_url_view ky_url_view::normalized() const
+{
+    using namespace __url__;
+    if (!is_valid ())
+        return *this;
+    builder b;
+    if (flags & Flag_ImplicitFile)
+    {
+        // 相对路径开头的..有意义，只处理绝对路径
+        const ky_stringview p = view (Url_Path);
+        if (p.is_empty () || p[0] != '/')
+            return *this;
+        remove_dots (p.data (), p.count (), b);
+        return ky_url_view(b.take ());
+    }
+
+    const ky_stringview sc = view (Url_Scheme);
+    for (int i = 0; i < sc.count (); ++i)
+        b.push (lower (sc[i]));
+    b.push (':');
+    if (flags & Flag_Authority)
+    {
+        b.push ("//");
+        if (has (Url_Username))
+        {
+            b.escaped (view (Url_Username), false);
+            if (has (Url_Password))
+            {
+                b.push (':');
+                b.escaped (view (Url_Password), false);
+            }
+            b.push ('@');
+        }
+        b.escaped (view (Url_Host), true);
+        if (port_ >= 0 && port_ != default_port ((eUrlProtocols)proto))
+        {
+            char digits[8];
+            int k = 0;
+            for (int v = port_; ; v /= 10)
+            {
+                digits[k++] = (char)('0' + v % 10);
+                if (v < 10)
+                    break;
+            }
+            b.push (':');
+            while (k > 0)
+                b.push ((uint16)digits[--k]);
+        }
+    }
+
+    // 路径单独去掉.段，..不会越过authority
+    builder path, clean;
+    path.escaped (view (Url_Path), false);
+    if (path.n > 0 && path.d[0] == '/')
+        remove_dots (path.d, path.n, clean);
+    else
+    {
+        // 没有//时的相对路径(如mailto:)不处理.段
+        for (int i = 0; i < path.n; ++i)
+            clean.push (path.d[i]);
+    }
+    if (clean.n == 0 && (flags & Flag_Authority) &&
+            (proto == Protocol_Http || proto == Protocol_Https))
+        clean.push ('/');
+    for (int i = 0; i < clean.n; ++i)
+        b.push (clean.d[i]);
+
+    if (has (Url_Query))
+    {
+        b.push ('?');
+        b.escaped (view (Url_Query), false);
+    }
+    if (has (Url_Fragment))
+    {
+        b.push ('#');
+        b.escaped (view (Url_Fragment), false);
+    }
+    return ky_url_view(b.take ());
+}
+
+inline bool ky_url_view::equivalent(const ky_url_view &rhs) const
+{
+    using namespace __url__;
+    if (*this == rhs)
+        return true;
+    if (!is_valid () || !rhs.is_valid ())
+        return false;
+    if (has_dots (view (Url_Path)) || has_dots (rhs.view (Url_Path)))
+        return normalized () == rhs.normalized ();
+    if ((flags & (Flag_ImplicitFile | Flag_Authority)) != (rhs.flags & (Flag_ImplicitFile | Flag_Authority)))
+        return false;
+    if (!canon::equal (view (Url_Scheme), rhs.view (Url_Scheme), true))
+        return false;
+
+    static const eUrlComponents texts[] = {Url_Username, Url_Password, Url_Query, Url_Fragment};
+    for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); ++i)
+    {
+        if (has (texts[i]) != rhs.has (texts[i]) ||
+                !canon::equal (view (texts[i]), rhs.view (texts[i]), false))
+            return false;
+    }
+    if (!canon::equal (view (Url_Host), rhs.view (Url_Host), true) ||
+            port_number () != rhs.port_number ())
+        return false;
+
+    // http(s)的空路径等同于"/"
+    const ky_stringview p = view (Url_Path), q = rhs.view (Url_Path);
+    const bool root = (flags & Flag_Authority) && (proto == Protocol_Http || proto == Protocol_Https);
+    if (root && (p.is_empty () || q.is_empty ()))
+    {
+        const ky_stringview o = p.is_empty () ? q : p;
+        return o.is_empty () || (o.count () == 1 && o[0] == '/');
+    }
+    return canon::equal (p, q, false);
+}
+
+inline ky_url ky_url_view::to_url() const
+{
+    return ky_url(url_);
+}
+
+#endif // KY_URL_VIEW_INL
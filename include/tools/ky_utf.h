@@ -0,0 +1,114 @@
+
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_utf.h
+ * @brief    UTF-8/UTF-16/UTF-32互相转换及校验
+ *       1.UTF-8校验使用查表法，SSSE3每次16字节、AVX2每次32字节
+ *       2.ASCII连续段以SSE2/AVX2整块扩展或压缩，其余码点逐个转换
+ *       3.首次使用时按ky_cpu::has选择指令集，GCC、Clang下以target属性编译各版本
+ *       4.ky_utf8_decoder 分块转换UTF-8，块末截断的码点保留到下一块，用于套接字输入
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ */
+#ifndef ky_UTF_H
+#define ky_UTF_H
+
+#include "ky_define.h"
+#include "ky_cpu.h"
+
+#if ((kyArchitecture & kyArch_X86) == kyArch_X86)
+#  if (kyCompiler == kyCompiler_GNUC) || (kyCompiler == kyCompiler_CLANG)
+#    define kyUtfSimd 1
+#    define kyUtfTarget(isa) __attribute__((target(isa)))
+#  elif kyCompiler == kyCompiler_MSVC
+#    define kyUtfSimd 1
+#    define kyUtfTarget(isa)
+#  endif
+#endif
+#ifdef kyUtfSimd
+#include <immintrin.h>
+#endif
+
+namespace ky_utf
+{
+    //! 转换失败时的返回值
+    static const size_t error = size_t(-1);
+
+    //! 使用的指令集
+    enum eLevels
+    {
+        Level_Scalar = 0,
+        Level_SSE,          ///< SSE2扩展压缩，SSSE3校验
+        Level_AVX2
+    };
+    //! 当前选择的指令集
+    eLevels level();
+
+    //!
+    //! \brief validate 校验编码是否合法
+    //! \note UTF-8不接受超长编码、代理项及大于U+10FFFF的码点；UTF-16代理项须成对
+    //!
+    bool validate(const uint8 *s, size_t n);
+    bool validate(const uint16 *s, size_t n);
+
+    //!
+    //! \brief utf16_length utf8_length 合法输入转换后的单元数
+    //!
+    size_t utf16_length(const uint8 *s, size_t n);
+    size_t utf8_length(const uint16 *s, size_t n);
+
+    //!
+    //! \brief utf8_to_utf16 等转换函数
+    //! \param s 输入
+    //! \param n 输入的单元数
+    //! \param out 输出，容量：UTF-8转换时不少于n，转为UTF-8时UTF-16为3n、UTF-32为4n，
+    //!            UTF-32转UTF-16时为2n
+    //! \param replace 为true时非法序列输出U+FFFD，否则返回error
+    //! \return 写出的单元数
+    //!
+    size_t utf8_to_utf16(const uint8 *s, size_t n, uint16 *out, bool replace = false);
+    size_t utf8_to_utf32(const uint8 *s, size_t n, uint32 *out, bool replace = false);
+    size_t utf16_to_utf8(const uint16 *s, size_t n, uint8 *out, bool replace = false);
+    size_t utf16_to_utf32(const uint16 *s, size_t n, uint32 *out, bool replace = false);
+    size_t utf32_to_utf8(const uint32 *s, size_t n, uint8 *out, bool replace = false);
+    size_t utf32_to_utf16(const uint32 *s, size_t n, uint16 *out, bool replace = false);
+}
+
+/*!
+ * @brief The ky_utf8_decoder class 分块转换UTF-8到UTF-16
+ * @class ky_utf8_decoder
+ */
+class ky_utf8_decoder
+{
+public:
+    ky_utf8_decoder():held(0){}
+
+    //!
+    //! \brief feed 转换一块数据，块末不完整的码点保留到下一块
+    //! \param s
+    //! \param n
+    //! \param out 容量不少于n + 2
+    //! \return 写出的单元数，数据非法时返回ky_utf::error
+    //!
+    size_t feed(const uint8 *s, size_t n, uint16 *out);
+    //! 输入结束时是否没有残留的不完整码点
+    bool finish()const{return held == 0;}
+    void reset(){held = 0;}
+
+private:
+    uint8 hold[4];
+    int held;
+};
+
+#include "ky_utf.inl"
+#endif // ky_UTF_H
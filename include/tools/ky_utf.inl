@@ -0,0 +1,720 @@
+#ifndef KY_UTF_INL
+#define KY_UTF_INL
+
+namespace ky_utf {
+
+//! 各指令集的实现
+struct _kernels_
+{
+    eLevels level;
+    bool (*validate)(const uint8 *s, size_t n);
+    //! 转换开头的ASCII连续段，返回转换的单元数
+    size_t (*widen16)(const uint8 *s, size_t n, uint16 *out);
+    size_t (*widen32)(const uint8 *s, size_t n, uint32 *out);
+    size_t (*narrow16)(const uint16 *s, size_t n, uint8 *out);
+};
+
+//! 首字节对应的序列长度，非法首字节为0
+inline int _sequence_(uint8 c)
+{
+    if (c < 0x80)
+        return 1;
+    if (c < 0xc2)
+        return 0;
+    if (c < 0xe0)
+        return 2;
+    if (c < 0xf0)
+        return 3;
+    if (c < 0xf5)
+        return 4;
+    return 0;
+}
+
+//! 校验并解码一个码点，返回字节数，非法或不完整时返回0
+inline int _decode_(const uint8 *s, size_t n, uint32 &cp)
+{
+    const int len = _sequence_ (s[0]);
+    if (len == 0 || (size_t)len > n)
+        return 0;
+    switch (len)
+    {
+    case 1:
+        cp = s[0];
+        return 1;
+    case 2:
+        if ((s[1] & 0xc0) != 0x80)
+            return 0;
+        cp = ((s[0] & 0x1f) << 6) | (s[1] & 0x3f);
+        return 2;
+    case 3:
+        if ((s[1] & 0xc0) != 0x80 || (s[2] & 0xc0) != 0x80)
+            return 0;
+        cp = ((s[0] & 0x0f) << 12) | ((s[1] & 0x3f) << 6) | (s[2] & 0x3f);
+        return (cp < 0x800 || (cp >= 0xd800 && cp < 0xe000)) ? 0 : 3;
+    default:
+        if ((s[1] & 0xc0) != 0x80 || (s[2] & 0xc0) != 0x80 || (s[3] & 0xc0) != 0x80)
+            return 0;
+        cp = ((uint32)(s[0] & 0x07) << 18) | ((s[1] & 0x3f) << 12) | ((s[2] & 0x3f) << 6) | (s[3] & 0x3f);
+        return (cp < 0x10000 || cp > 0x10ffff) ? 0 : 4;
+    }
+}
+
+//! 编码一个码点，返回字节数
+inline int _encode_(uint32 cp, uint8 *o)
+{
+    if (cp < 0x80)
+    {
+        o[0] = (uint8)cp;
+        return 1;
+    }
+    if (cp < 0x800)
+    {
+        o[0] = (uint8)(0xc0 | (cp >> 6));
+        o[1] = (uint8)(0x80 | (cp & 0x3f));
+        return 2;
+    }
+    if (cp < 0x10000)
+    {
+        o[0] = (uint8)(0xe0 | (cp >> 12));
+        o[1] = (uint8)(0x80 | ((cp >> 6) & 0x3f));
+        o[2] = (uint8)(0x80 | (cp & 0x3f));
+        return 3;
+    }
+    o[0] = (uint8)(0xf0 | (cp >> 18));
+    o[1] = (uint8)(0x80 | ((cp >> 12) & 0x3f));
+    o[2] = (uint8)(0x80 | ((cp >> 6) & 0x3f));
+    o[3] = (uint8)(0x80 | (cp & 0x3f));
+    return 4;
+}
+
+// 标量实现
+
+inline bool _validate_scalar_(const uint8 *s, size_t n)
+{
+    for (size_t i = 0; i < n; )
+    {
+        // 每次跳过8个ASCII字节
+        uint64 w;
+        if (i + 8 <= n && (memcpy (&w, s + i, 8), (w & 0x8080808080808080ULL) == 0))
+        {
+            i += 8;
+            continue;
+        }
+        if (s[i] < 0x80)
+        {
+            ++i;
+            continue;
+        }
+        uint32 cp;
+        const int len = _decode_ (s + i, n - i, cp);
+        if (len == 0)
+            return false;
+        i += len;
+    }
+    return true;
+}
+
+inline size_t _widen16_scalar_(const uint8 *s, size_t n, uint16 *out)
+{
+    size_t i = 0;
+    for (; i < n && s[i] < 0x80; ++i)
+        out[i] = s[i];
+    return i;
+}
+
+inline size_t _widen32_scalar_(const uint8 *s, size_t n, uint32 *out)
+{
+    size_t i = 0;
+    for (; i < n && s[i] < 0x80; ++i)
+        out[i] = s[i];
+    return i;
+}
+
+inline size_t _narrow16_scalar_(const uint16 *s, size_t n, uint8 *out)
+{
+    size_t i = 0;
+    for (; i < n && s[i] < 0x80; ++i)
+        out[i] = (uint8)s[i];
+    return i;
+}
+
+#ifdef kyUtfSimd
+// Keiser-Lemire查表校验：以前一字节的高、低4位和当前字节的高4位各查一次表，
+// 三个结果相与不为0即为非法的两字节组合；三、四字节序列的后续字节数另行检查
+enum
+{
+    TooShort = 1 << 0,      ///< 11______ 0_______ / 11______ 11______
+    TooLong = 1 << 1,       ///< 0_______ 10______
+    Overlong3 = 1 << 2,     ///< 11100000 100_____
+    TooLarge = 1 << 3,      ///< 11110100 1001____ 及更大
+    Surrogate = 1 << 4,     ///< 11101101 101_____
+    Overlong2 = 1 << 5,     ///< 1100000_ 10______
+    TooLarge1000 = 1 << 6,  ///< 11110101 1000____ 及更大
+    Overlong4 = 1 << 6,     ///< 11110000 1000____
+    TwoConts = 1 << 7,      ///< 10______ 10______
+    Carry = TooShort | TooLong | TwoConts
+};
+
+static const uint8 _byte1_high_[16] =
+{
+    TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong, TooLong,
+    TwoConts, TwoConts, TwoConts, TwoConts,
+    TooShort | Overlong2,
+    TooShort,
+    TooShort | Overlong3 | Surrogate,
+    TooShort | TooLarge | TooLarge1000 | Overlong4
+};
+static const uint8 _byte1_low_[16] =
+{
+    Carry | Overlong3 | Overlong2 | Overlong4,
+    Carry | Overlong2,
+    Carry,
+    Carry,
+    Carry | TooLarge,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000 | Surrogate,
+    Carry | TooLarge | TooLarge1000,
+    Carry | TooLarge | TooLarge1000
+};
+static const uint8 _byte2_high_[16] =
+{
+    TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort, TooShort,
+    TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge1000 | Overlong4,
+    TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge,
+    TooLong | Overlong2 | TwoConts | Surrogate | TooLarge,
+    TooLong | Overlong2 | TwoConts | Surrogate | TooLarge,
+    TooShort, TooShort, TooShort, TooShort
+};
+//! 块末字节的上限，超过时序列延续到下一块
+static const uint8 _incomplete_[32] =
+{
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xef, 0xdf, 0xbf
+};
+
+//! SSSE3：每次16字节
+struct _ssse3_state_
+{
+    __m128i error;
+    __m128i prev;
+    __m128i incomplete;
+};
+
+kyUtfTarget("ssse3")
+inline void _check_ssse3_(_ssse3_state_ &st, __m128i in)
+{
+    if (_mm_movemask_epi8 (in) == 0)
+    {
+        st.error = _mm_or_si128 (st.error, st.incomplete);
+        st.prev = in;
+        st.incomplete = _mm_setzero_si128 ();
+        return;
+    }
+    const __m128i low = _mm_set1_epi8 (0x0f);
+    const __m128i prev1 = _mm_alignr_epi8 (in, st.prev, 15);
+    const __m128i b1h = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *)_byte1_high_),
+                                          _mm_and_si128 (_mm_srli_epi16 (prev1, 4), low));
+    const __m128i b1l = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *)_byte1_low_),
+                                          _mm_and_si128 (prev1, low));
+    const __m128i b2h = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *)_byte2_high_),
+                                          _mm_and_si128 (_mm_srli_epi16 (in, 4), low));
+    const __m128i sc = _mm_and_si128 (_mm_and_si128 (b1h, b1l), b2h);
+
+    // 三、四字节首字节之后的第2、3字节必须是后续字节
+    const __m128i prev2 = _mm_alignr_epi8 (in, st.prev, 14);
+    const __m128i prev3 = _mm_alignr_epi8 (in, st.prev, 13);
+    const __m128i third = _mm_subs_epu8 (prev2, _mm_set1_epi8 ((char)(0xe0 - 0x80)));
+    const __m128i fourth = _mm_subs_epu8 (prev3, _mm_set1_epi8 ((char)(0xf0 - 0x80)));
+    const __m128i must23 = _mm_and_si128 (_mm_or_si128 (third, fourth), _mm_set1_epi8 ((char)0x80));
+
+    st.error = _mm_or_si128 (st.error, _mm_xor_si128 (must23, sc));
+    st.incomplete = _mm_subs_epu8 (in, _mm_loadu_si128 ((const __m128i *)(_incomplete_ + 16)));
+    st.prev = in;
+}
+
+kyUtfTarget("ssse3")
+inline bool _validate_ssse3_(const uint8 *s, size_t n)
+{
+    _ssse3_state_ st;
+    st.error = _mm_setzero_si128 ();
+    st.prev = _mm_setzero_si128 ();
+    st.incomplete = _mm_setzero_si128 ();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+        _check_ssse3_ (st, _mm_loadu_si128 ((const __m128i *)(s + i)));
+    if (i < n)
+    {
+        // 不足一块时补0，0为ASCII，截断的序列会被判为过短
+        uint8 tail[16] = {0};
+        memcpy (tail, s + i, n - i);
+        _check_ssse3_ (st, _mm_loadu_si128 ((const __m128i *)tail));
+    }
+    st.error = _mm_or_si128 (st.error, st.incomplete);
+    return _mm_movemask_epi8 (_mm_cmpeq_epi8 (st.error, _mm_setzero_si128 ())) == 0xffff;
+}
+
+kyUtfTarget("sse2")
+inline size_t _widen16_sse2_(const uint8 *s, size_t n, uint16 *out)
+{
+    const __m128i zero = _mm_setzero_si128 ();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m128i v = _mm_loadu_si128 ((const __m128i *)(s + i));
+        if (_mm_movemask_epi8 (v))
+            break;
+        _mm_storeu_si128 ((__m128i *)(out + i), _mm_unpacklo_epi8 (v, zero));
+        _mm_storeu_si128 ((__m128i *)(out + i + 8), _mm_unpackhi_epi8 (v, zero));
+    }
+    return i + _widen16_scalar_ (s + i, n - i, out + i);
+}
+
+kyUtfTarget("sse2")
+inline size_t _widen32_sse2_(const uint8 *s, size_t n, uint32 *out)
+{
+    const __m128i zero = _mm_setzero_si128 ();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m128i v = _mm_loadu_si128 ((const __m128i *)(s + i));
+        if (_mm_movemask_epi8 (v))
+            break;
+        const __m128i lo = _mm_unpacklo_epi8 (v, zero);
+        const __m128i hi = _mm_unpackhi_epi8 (v, zero);
+        _mm_storeu_si128 ((__m128i *)(out + i), _mm_unpacklo_epi16 (lo, zero));
+        _mm_storeu_si128 ((__m128i *)(out + i + 4), _mm_unpackhi_epi16 (lo, zero));
+        _mm_storeu_si128 ((__m128i *)(out + i + 8), _mm_unpacklo_epi16 (hi, zero));
+        _mm_storeu_si128 ((__m128i *)(out + i + 12), _mm_unpackhi_epi16 (hi, zero));
+    }
+    return i + _widen32_scalar_ (s + i, n - i, out + i);
+}
+
+kyUtfTarget("sse2")
+inline size_t _narrow16_sse2_(const uint16 *s, size_t n, uint8 *out)
+{
+    const __m128i high = _mm_set1_epi16 ((short)0xff80);
+    const __m128i zero = _mm_setzero_si128 ();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m128i a = _mm_loadu_si128 ((const __m128i *)(s + i));
+        const __m128i b = _mm_loadu_si128 ((const __m128i *)(s + i + 8));
+        const __m128i h = _mm_and_si128 (_mm_or_si128 (a, b), high);
+        if (_mm_movemask_epi8 (_mm_cmpeq_epi16 (h, zero)) != 0xffff)
+            break;
+        _mm_storeu_si128 ((__m128i *)(out + i), _mm_packus_epi16 (a, b));
+    }
+    return i + _narrow16_scalar_ (s + i, n - i, out + i);
+}
+
+//! AVX2：每次32字节
+struct _avx2_state_
+{
+    __m256i error;
+    __m256i prev;
+    __m256i incomplete;
+};
+
+kyUtfTarget("avx2")
+inline void _check_avx2_(_avx2_state_ &st, __m256i in)
+{
+    if (_mm256_movemask_epi8 (in) == 0)
+    {
+        st.error = _mm256_or_si256 (st.error, st.incomplete);
+        st.prev = in;
+        st.incomplete = _mm256_setzero_si256 ();
+        return;
+    }
+    const __m256i low = _mm256_set1_epi8 (0x0f);
+    // 跨128位通道取前N个字节
+    const __m256i carry = _mm256_permute2x128_si256 (st.prev, in, 0x21);
+    const __m256i prev1 = _mm256_alignr_epi8 (in, carry, 15);
+    const __m256i prev2 = _mm256_alignr_epi8 (in, carry, 14);
+    const __m256i prev3 = _mm256_alignr_epi8 (in, carry, 13);
+
+    const __m256i t1h = _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i *)_byte1_high_));
+    const __m256i t1l = _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i *)_byte1_low_));
+    const __m256i t2h = _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i *)_byte2_high_));
+    const __m256i b1h = _mm256_shuffle_epi8 (t1h, _mm256_and_si256 (_mm256_srli_epi16 (prev1, 4), low));
+    const __m256i b1l = _mm256_shuffle_epi8 (t1l, _mm256_and_si256 (prev1, low));
+    const __m256i b2h = _mm256_shuffle_epi8 (t2h, _mm256_and_si256 (_mm256_srli_epi16 (in, 4), low));
+    const __m256i sc = _mm256_and_si256 (_mm256_and_si256 (b1h, b1l), b2h);
+
+    const __m256i third = _mm256_subs_epu8 (prev2, _mm256_set1_epi8 ((char)(0xe0 - 0x80)));
+    const __m256i fourth = _mm256_subs_epu8 (prev3, _mm256_set1_epi8 ((char)(0xf0 - 0x80)));
+    const __m256i must23 = _mm256_and_si256 (_mm256_or_si256 (third, fourth), _mm256_set1_epi8 ((char)0x80));
+
+    st.error = _mm256_or_si256 (st.error, _mm256_xor_si256 (must23, sc));
+    st.incomplete = _mm256_subs_epu8 (in, _mm256_loadu_si256 ((const __m256i *)_incomplete_));
+    st.prev = in;
+}
+
+kyUtfTarget("avx2")
+inline bool _validate_avx2_(const uint8 *s, size_t n)
+{
+    _avx2_state_ st;
+    st.error = _mm256_setzero_si256 ();
+    st.prev = _mm256_setzero_si256 ();
+    st.incomplete = _mm256_setzero_si256 ();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+        _check_avx2_ (st, _mm256_loadu_si256 ((const __m256i *)(s + i)));
+    if (i < n)
+    {
+        uint8 tail[32] = {0};
+        memcpy (tail, s + i, n - i);
+        _check_avx2_ (st, _mm256_loadu_si256 ((const __m256i *)tail));
+    }
+    st.error = _mm256_or_si256 (st.error, st.incomplete);
+    return _mm256_testz_si256 (st.error, st.error) != 0;
+}
+
+kyUtfTarget("avx2")
+inline size_t _widen16_avx2_(const uint8 *s, size_t n, uint16 *out)
+{
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        const __m256i v = _mm256_loadu_si256 ((const __m256i *)(s + i));
+        if (_mm256_movemask_epi8 (v))
+            break;
+        _mm256_storeu_si256 ((__m256i *)(out + i), _mm256_cvtepu8_epi16 (_mm256_castsi256_si128 (v)));
+        _mm256_storeu_si256 ((__m256i *)(out + i + 16), _mm256_cvtepu8_epi16 (_mm256_extracti128_si256 (v, 1)));
+    }
+    return i + _widen16_scalar_ (s + i, n - i, out + i);
+}
+
+kyUtfTarget("avx2")
+inline size_t _widen32_avx2_(const uint8 *s, size_t n, uint32 *out)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m128i v = _mm_loadu_si128 ((const __m128i *)(s + i));
+        if (_mm_movemask_epi8 (v))
+            break;
+        _mm256_storeu_si256 ((__m256i *)(out + i), _mm256_cvtepu8_epi32 (v));
+        _mm256_storeu_si256 ((__m256i *)(out + i + 8), _mm256_cvtepu8_epi32 (_mm_srli_si128 (v, 8)));
+    }
+    return i + _widen32_scalar_ (s + i, n - i, out + i);
+}
+
+kyUtfTarget("avx2")
+inline size_t _narrow16_avx2_(const uint16 *s, size_t n, uint8 *out)
+{
+    const __m256i high = _mm256_set1_epi16 ((short)0xff80);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        const __m256i a = _mm256_loadu_si256 ((const __m256i *)(s + i));
+        const __m256i b = _mm256_loadu_si256 ((const __m256i *)(s + i + 16));
+        const __m256i h = _mm256_and_si256 (_mm256_or_si256 (a, b), high);
+        if (!_mm256_testz_si256 (h, h))
+            break;
+        // packus按128位通道交错，调整为原次序
+        const __m256i p = _mm256_permute4x64_epi64 (_mm256_packus_epi16 (a, b), 0xd8);
+        _mm256_storeu_si256 ((__m256i *)(out + i), p);
+    }
+    return i + _narrow16_scalar_ (s + i, n - i, out + i);
+}
+#endif
+
+inline _kernels_ _select_()
+{
+    _kernels_ k = {Level_Scalar, _validate_scalar_, _widen16_scalar_,
+                   _widen32_scalar_, _narrow16_scalar_};
+#ifdef kyUtfSimd
+    ky_cpu cpu;
+    if (cpu.has (CPU_AVX2))
+    {
+        _kernels_ avx2 = {Level_AVX2, _validate_avx2_, _widen16_avx2_,
+                          _widen32_avx2_, _narrow16_avx2_};
+        k = avx2;
+    }
+    else if (cpu.has (CPU_SSSE3))
+    {
+        _kernels_ sse = {Level_SSE, _validate_ssse3_, _widen16_sse2_,
+                         _widen32_sse2_, _narrow16_sse2_};
+        k = sse;
+    }
+#endif
+    return k;
+}
+
+//! 首次使用时选择，之后不变
+inline const _kernels_ &_kernels()
+{
+    static const _kernels_ k = _select_ ();
+    return k;
+}
+
+inline eLevels level()
+{
+    return _kernels ().level;
+}
+
+inline bool validate(const uint8 *s, size_t n)
+{
+    return _kernels ().validate (s, n);
+}
+
+inline bool validate(const uint16 *s, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        const uint16 c = s[i];
+        if (c < 0xd800 || c >= 0xe000)
+            continue;
+        if (c >= 0xdc00 || i + 1 >= n || s[i + 1] < 0xdc00 || s[i + 1] >= 0xe000)
+            return false;
+        ++i;
+    }
+    return true;
+}
+
+inline size_t utf16_length(const uint8 *s, size_t n)
+{
+    // 每个非后续字节一个单元，四字节序列再加一个
+    size_t c = 0;
+    for (size_t i = 0; i < n; ++i)
+        c += ((s[i] & 0xc0) != 0x80) + (s[i] >= 0xf0);
+    return c;
+}
+
+inline size_t utf8_length(const uint16 *s, size_t n)
+{
+    // 代理对两个单元各计2字节
+    size_t c = 0;
+    for (size_t i = 0; i < n; ++i)
+        c += 1 + (s[i] >= 0x80) + (s[i] >= 0x800 && (s[i] < 0xd800 || s[i] >= 0xe000));
+    return c;
+}
+
+//! 已校验的UTF-8转换，多字节序列不再检查
+template <typename Out>
+size_t _decode_valid_(const uint8 *s, size_t n, Out *out,
+                      size_t (*widen)(const uint8 *, size_t, Out *))
+{
+    size_t i = 0;
+    size_t o = 0;
+    while (i < n)
+    {
+        const uint8 c = s[i];
+        if (c < 0x80)
+        {
+            const size_t a = widen (s + i, n - i, out + o);
+            i += a;
+            o += a;
+        }
+        else if (c < 0xe0)
+        {
+            out[o++] = (Out)(((c & 0x1f) << 6) | (s[i + 1] & 0x3f));
+            i += 2;
+        }
+        else if (c < 0xf0)
+        {
+            out[o++] = (Out)(((c & 0x0f) << 12) | ((s[i + 1] & 0x3f) << 6) | (s[i + 2] & 0x3f));
+            i += 3;
+        }
+        else
+        {
+            const uint32 cp = ((uint32)(c & 0x07) << 18) | ((s[i + 1] & 0x3f) << 12) |
+                              ((s[i + 2] & 0x3f) << 6) | (s[i + 3] & 0x3f);
+            if (sizeof(Out) == 2)
+            {
+                out[o++] = (Out)(0xd7c0 + (cp >> 10));
+                out[o++] = (Out)(0xdc00 + (cp & 0x3ff));
+            }
+            else
+                out[o++] = (Out)cp;
+            i += 4;
+        }
+    }
+    return o;
+}
+
+//! 逐个码点转换，非法字节输出U+FFFD
+template <typename Out>
+size_t _decode_replace_(const uint8 *s, size_t n, Out *out)
+{
+    size_t o = 0;
+    for (size_t i = 0; i < n; )
+    {
+        uint32 cp;
+        int len = _decode_ (s + i, n - i, cp);
+        if (len == 0)
+        {
+            cp = 0xfffd;
+            len = 1;
+        }
+        if (sizeof(Out) == 2 && cp >= 0x10000)
+        {
+            out[o++] = (Out)(0xd7c0 + (cp >> 10));
+            out[o++] = (Out)(0xdc00 + (cp & 0x3ff));
+        }
+        else
+            out[o++] = (Out)cp;
+        i += len;
+    }
+    return o;
+}
+
+inline size_t utf8_to_utf16(const uint8 *s, size_t n, uint16 *out, bool replace)
+{
+    // 先整体校验，转换时不再逐个检查
+    const _kernels_ &k = _kernels ();
+    if (k.validate (s, n))
+        return _decode_valid_ (s, n, out, k.widen16);
+    return replace ? _decode_replace_ (s, n, out) : error;
+}
+
+inline size_t utf8_to_utf32(const uint8 *s, size_t n, uint32 *out, bool replace)
+{
+    const _kernels_ &k = _kernels ();
+    if (k.validate (s, n))
+        return _decode_valid_ (s, n, out, k.widen32);
+    return replace ? _decode_replace_ (s, n, out) : error;
+}
+
+inline size_t utf16_to_utf8(const uint16 *s, size_t n, uint8 *out, bool replace)
+{
+    const _kernels_ &k = _kernels ();
+    size_t i = 0;
+    size_t o = 0;
+    while (i < n)
+    {
+        uint32 c = s[i];
+        if (c < 0x80)
+        {
+            const size_t a = k.narrow16 (s + i, n - i, out + o);
+            i += a;
+            o += a;
+            continue;
+        }
+        ++i;
+        if (c >= 0xd800 && c < 0xe000)
+        {
+            if (c < 0xdc00 && i < n && s[i] >= 0xdc00 && s[i] < 0xe000)
+                c = 0x10000 + ((c - 0xd800) << 10) + (s[i++] - 0xdc00);
+            else if (replace)
+                c = 0xfffd;
+            else
+                return error;
+        }
+        o += _encode_ (c, out + o);
+    }
+    return o;
+}
+
+inline size_t utf16_to_utf32(const uint16 *s, size_t n, uint32 *out, bool replace)
+{
+    size_t o = 0;
+    for (size_t i = 0; i < n; )
+    {
+        uint32 c = s[i++];
+        if (c >= 0xd800 && c < 0xe000)
+        {
+            if (c < 0xdc00 && i < n && s[i] >= 0xdc00 && s[i] < 0xe000)
+                c = 0x10000 + ((c - 0xd800) << 10) + (s[i++] - 0xdc00);
+            else if (replace)
+                c = 0xfffd;
+            else
+                return error;
+        }
+        out[o++] = c;
+    }
+    return o;
+}
+
+inline size_t utf32_to_utf8(const uint32 *s, size_t n, uint8 *out, bool replace)
+{
+    size_t o = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint32 c = s[i];
+        if (c > 0x10ffff || (c >= 0xd800 && c < 0xe000))
+        {
+            if (!replace)
+                return error;
+            c = 0xfffd;
+        }
+        o += _encode_ (c, out + o);
+    }
+    return o;
+}
+
+inline size_t utf32_to_utf16(const uint32 *s, size_t n, uint16 *out, bool replace)
+{
+    size_t o = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint32 c = s[i];
+        if (c > 0x10ffff || (c >= 0xd800 && c < 0xe000))
+        {
+            if (!replace)
+                return error;
+            c = 0xfffd;
+        }
+        if (c >= 0x10000)
+        {
+            out[o++] = (uint16)(0xd7c0 + (c >> 10));
+            out[o++] = (uint16)(0xdc00 + (c & 0x3ff));
+        }
+        else
+            out[o++] = (uint16)c;
+    }
+    return o;
+}
+
+}
+
+inline size_t ky_utf8_decoder::feed(const uint8 *s, size_t n, uint16 *out)
+{
+    size_t o = 0;
+    if (held > 0)
+    {
+        // 先补齐上一块末尾的码点
+        const int need = ky_utf::_sequence_ (hold[0]);
+        while (held < need && n > 0)
+        {
+            if ((*s & 0xc0) != 0x80)
+                return ky_utf::error;
+            hold[held++] = *s++;
+            --n;
+        }
+        if (held < need)
+            return 0;
+        o = ky_utf::utf8_to_utf16 (hold, held, out);
+        if (o == ky_utf::error)
+            return o;
+        held = 0;
+    }
+
+    // 从末尾向前找最后一个首字节，其序列不完整时留到下一块
+    size_t keep = 0;
+    for (size_t k = 1; k <= 3 && k <= n; ++k)
+    {
+        const uint8 c = s[n - k];
+        if ((c & 0xc0) == 0x80)
+            continue;
+        if (c >= 0xc0 && ky_utf::_sequence_ (c) > (int)k)
+            keep = k;
+        break;
+    }
+
+    const size_t r = ky_utf::utf8_to_utf16 (s, n - keep, out + o);
+    if (r == ky_utf::error)
+        return r;
+    memcpy (hold, s + n - keep, keep);
+    held = (int)keep;
+    return o + r;
+}
+
+#endif // KY_UTF_INL
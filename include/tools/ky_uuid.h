@@ -26,6 +26,7 @@
 #include "ky_string.h"
 #include "ky_datetime.h"
 #include "ky_variant.h"
+#include "ky_format.h"
 
 struct ky_uuid
 {
@@ -113,5 +114,28 @@ ky_streamt &operator << (ky_streamt &in, const ky_uuid &v);
 ky_streamt &operator >> (ky_streamt &out, ky_uuid &v);
 ky_variant &operator << (ky_variant &va, const ky_uuid &uid);
 ky_variant &operator >> (ky_variant &va, ky_uuid &uid);
+
+inline uint64 ky_hash(const ky_uuid &u)
+{
+    uint64 lo;
+    memcpy (&lo, u.data4, sizeof(lo));
+    const uint64 hi = ((uint64)u.data1 << 32) | ((uint64)u.data2 << 16) | u.data3;
+    return __hash_::mix (hi ^ __hash_::seed (), lo ^ 0x8bb84b93962eacc9ull);
+}
+
+//! 输出为xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx，类型为X时大写
+inline void ky_format_value(ky_format::writer &w, const ky_format::spec &sp, const ky_uuid &u)
+{
+    char buf[40];
+    const char *fmt = sp.type == 'X' ?
+                "{:08X}-{:04X}-{:04X}-{:02X}{:02X}-{:02X}{:02X}{:02X}{:02X}{:02X}{:02X}" :
+                "{:08x}-{:04x}-{:04x}-{:02x}{:02x}-{:02x}{:02x}{:02x}{:02x}{:02x}{:02x}";
+    ky_format::format_to (buf, fmt, u.data1, u.data2, u.data3,
+                          u.data4[0], u.data4[1], u.data4[2], u.data4[3],
+                          u.data4[4], u.data4[5], u.data4[6], u.data4[7]);
+    ky_format::spec text = sp;
+    text.type = 0;
+    ky_format::value (w, text, (const char *)buf);
+}
 #endif // ky_UUID
 
@@ -8,7 +8,7 @@
  *
  * @author   kunyang
  * @email    kunyang.yk@gmail.com
- * @version  1.0.1.5
+ * @version  1.0.2.1
  * @date     2010/05/08
  * @license  GNU General Public License (GPL)
  *
@@ -18,6 +18,7 @@
  * 2010/08/10 | 1.0.1.0   | kunyang  | 将原有继承std::vector完成类修改为ky_array
  * 2012/04/02 | 1.0.1.2   | kunyang  | 将迭代接口进行重新编写
  * 2014/03/09 | 1.0.1.5   | kunyang  | 加入C++11支持
+ * 2026/10/18 | 1.0.2.1   | kunyang  | 加入右值添加及emplace，添加元素改为引用传递
  */
 
 #ifndef VECTOR_H
@@ -84,8 +85,24 @@ public:
 #if kyLanguage >= kyLanguage11
 public:
     ky_vector(ky_vector&& rhs);
+    ky_vector& operator =(ky_vector&& rhs);
     ky_vector(const std::initializer_list<T> & il);
     void push_back(T&& v);
+    inline void push_front(T&& v){prepend(std::move (v));}
+
+    ky_vector<T> &prepend(T &&c);
+    ky_vector<T> &append(T &&c);
+    ky_vector<T> &insert(size_t i, T &&c);
+
+    //!
+    //! \brief emplace 在pos位置以args就地构造元素
+    //! \param pos
+    //! \param args
+    //! \return 返回指向构造元素的迭代器
+    //!
+    using VecBase::emplace;
+    template <typename ... Args>
+    iterator emplace(const_iterator pos, Args &&...args);
 
     iterator insert(const_iterator pos, const T& v);
     iterator insert(const_iterator pos, T&& v);
@@ -115,15 +132,15 @@ public:
 
     size_t count()const;
 
-    ky_vector<T> &prepend(T c);
+    ky_vector<T> &prepend(const T &c);
     ky_vector<T> &prepend(const T *s, int len);
     ky_vector<T> &prepend(const ky_vector<T> &a);
 
-    ky_vector<T> &append(T c);
+    ky_vector<T> &append(const T &c);
     ky_vector<T> &append(const T *s, size_t len);
     ky_vector<T> &append(const ky_vector<T> &a);
 
-    ky_vector<T> &insert(size_t i, T c);
+    ky_vector<T> &insert(size_t i, const T &c);
     ky_vector<T> &insert(size_t i, const T *s, size_t len);
     ky_vector<T> &insert(size_t i, const ky_vector<T> &a);
 
@@ -198,4 +215,7 @@ public:
 };
 
 #include "ky_vector.inl"
+
+template <typename T>
+struct is_relocatable<ky_vector<T> >: public true_type_t { };
 #endif // VECTOR_H
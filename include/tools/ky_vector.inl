@@ -128,9 +128,15 @@ typename ky_vector<T>::iterator ky_vector<T>::erase(iterator first, iterator las
 
 template <typename T >
 ky_vector<T>::ky_vector(ky_vector&& rhs):
-    VecBase(rhs)
+    VecBase(std::move (rhs))
 {
 
+}
+template <typename T >
+ky_vector<T>& ky_vector<T>::operator =(ky_vector&& rhs)
+{
+    VecBase::operator =(std::move (rhs));
+    return *this;
 }
 template <typename T >
 ky_vector<T>::ky_vector(const std::initializer_list<T> & il):
@@ -141,7 +147,32 @@ ky_vector<T>::ky_vector(const std::initializer_list<T> & il):
 template <typename T >
 void ky_vector<T>::push_back(T&& v)
 {
-    VecBase::append(v);
+    VecBase::append(std::move (v));
+}
+template <typename T >
+ky_vector<T> &ky_vector<T>::prepend(T &&c)
+{
+    VecBase::prepend(std::move (c));
+    return *this;
+}
+template <typename T >
+ky_vector<T> &ky_vector<T>::append(T &&c)
+{
+    VecBase::append(std::move (c));
+    return *this;
+}
+template <typename T >
+ky_vector<T> &ky_vector<T>::insert(size_t i, T &&c)
+{
+    VecBase::insert((int)i, std::move (c));
+    return *this;
+}
+template <typename T >
+template <typename ... Args>
+typename ky_vector<T>::iterator ky_vector<T>::emplace(const_iterator pos, Args &&...args)
+{
+    const int i = int(pos.ope - VecBase::data());
+    return iterator(&VecBase::emplace(i, std::forward<Args>(args)...));
 }
 template <typename T >
 typename ky_vector<T>::iterator ky_vector<T>::insert(const_iterator pos, const T& v)
@@ -152,8 +183,7 @@ typename ky_vector<T>::iterator ky_vector<T>::insert(const_iterator pos, const T
 template <typename T >
 typename ky_vector<T>::iterator ky_vector<T>::insert(const_iterator pos, T&& v)
 {
-    VecBase::insert(pos.ope - begin().ope, v);
-    return iterator(pos.ope+1);
+    return emplace(pos, std::move (v));
 }
 template <typename T >
 typename ky_vector<T>::iterator ky_vector<T>::insert(const_iterator pos, size_t count, const T& v)
@@ -230,7 +260,7 @@ size_t ky_vector<T>::count()const
 }
 
 template <typename T >
-ky_vector<T> &ky_vector<T>::prepend(T c)
+ky_vector<T> &ky_vector<T>::prepend(const T &c)
 {
     return *(ky_vector<T>*)&VecBase::prepend(c);
 }
@@ -246,7 +276,7 @@ ky_vector<T> &ky_vector<T>::prepend(const ky_vector<T> &a)
 }
 
 template <typename T >
-ky_vector<T> &ky_vector<T>::append(T c)
+ky_vector<T> &ky_vector<T>::append(const T &c)
 {
     return *(ky_vector<T>*)&VecBase::append(c);
 }
@@ -262,7 +292,7 @@ ky_vector<T> &ky_vector<T>::append(const ky_vector<T> &a)
 }
 
 template <typename T >
-ky_vector<T> &ky_vector<T>::insert(size_t i, T c)
+ky_vector<T> &ky_vector<T>::insert(size_t i, const T &c)
 {
     return *(ky_vector<T>*)&VecBase::insert(i, c);
 }
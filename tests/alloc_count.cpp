@@ -0,0 +1,42 @@
+#include "ky_test.h"
+#include <stdlib.h>
+
+// glibc下替换malloc族函数计数，再转给libc的实现；sanitizer自带替换，此时不计数
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+#define KY_TEST_COUNT_ALLOC 1
+#endif
+
+#ifdef KY_TEST_COUNT_ALLOC
+static long alloc_calls = 0;
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *p, size_t size);
+
+void *malloc(size_t size)
+{
+    __atomic_add_fetch (&alloc_calls, 1, __ATOMIC_RELAXED);
+    return __libc_malloc (size);
+}
+void *calloc(size_t n, size_t size)
+{
+    __atomic_add_fetch (&alloc_calls, 1, __ATOMIC_RELAXED);
+    return __libc_calloc (n, size);
+}
+void *realloc(void *p, size_t size)
+{
+    __atomic_add_fetch (&alloc_calls, 1, __ATOMIC_RELAXED);
+    return __libc_realloc (p, size);
+}
+}
+#endif
+
+long ky_test::allocations()
+{
+#ifdef KY_TEST_COUNT_ALLOC
+    return __atomic_load_n (&alloc_calls, __ATOMIC_RELAXED);
+#else
+    return -1;
+#endif
+}
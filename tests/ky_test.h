@@ -0,0 +1,67 @@
+/**
+ * Basic tool library
+ * Copyright (C) 2014 kunyang kunyang.yk@gmail.com
+ *
+ * @file     ky_test.h
+ * @brief    单元测试的最小框架
+ *       1.kyTestCase定义测试用例，静态注册，由main依次执行
+ *       2.kyTestCheck检查条件，失败时输出文件及行号并继续执行
+ *       3.allocations统计内存分配次数，用于检查不分配内存的操作
+ *
+ * @author   kunyang
+ * @email    kunyang.yk@gmail.com
+ * @version  1.0.0.1
+ * @date     2026/10/18
+ * @license  GNU General Public License (GPL)
+ *
+ * Change History :
+ *    Date    |  Version  |  Author  |   Description
+ * 2026/10/18 | 1.0.0.1   | kunyang  | 创建文件
+ */
+
+#ifndef KY_TEST_H
+#define KY_TEST_H
+
+#include <cstdio>
+
+struct ky_test
+{
+    typedef void (*func)();
+
+    const char *name;
+    func run;
+    ky_test *next;
+
+    //! 按定义顺序加入链表尾部
+    ky_test(const char *n, func f):name(n), run(f), next(NULL)
+    {
+        ky_test **t = &head ();
+        while (*t)
+            t = &(*t)->next;
+        *t = this;
+    }
+
+    static ky_test *&head(){static ky_test *h = NULL; return h;}
+    static int &failed(){static int n = 0; return n;}
+    //! 进程内的内存分配次数，不支持计数时返回-1
+    static long allocations();
+
+    static bool check(bool ok, const char *expr, const char *file, int line)
+    {
+        if (!ok)
+        {
+            std::fprintf (stderr, "%s:%d: check failed: %s\n", file, line, expr);
+            ++failed ();
+        }
+        return ok;
+    }
+};
+
+#define kyTestCase(name) \
+    static void name(); \
+    static ky_test name##_test(#name, name); \
+    static void name()
+
+#define kyTestCheck(expr) ky_test::check ((expr), #expr, __FILE__, __LINE__)
+
+#endif // KY_TEST_H
@@ -0,0 +1,14 @@
+#include "ky_test.h"
+
+int main()
+{
+    int cases = 0;
+    for (ky_test *t = ky_test::head (); t; t = t->next, ++cases)
+    {
+        const int before = ky_test::failed ();
+        t->run ();
+        std::printf ("%s %s\n", ky_test::failed () == before ? "PASS" : "FAIL", t->name);
+    }
+    std::printf ("%d cases, %d failed checks\n", cases, ky_test::failed ());
+    return ky_test::failed () ? 1 : 0;
+}
@@ -0,0 +1,28 @@
+# 单元测试，头文件取自include，链接lib下预编译的libky
+TEMPLATE = app
+TARGET = ky_tests
+CONFIG += console
+CONFIG -= qt app_bundle
+
+include (../include.pri)
+
+INCLUDEPATH += $${PWD}/../include $${PWD}/../include/tools
+LibKY_Lib_Dir = $${PWD}/../lib/linux/x86_64/release
+LIBS -= -lky
+LIBS += -L$${LibKY_Lib_Dir} -l:libky.so.1.0.0 -laio -lz -ldl
+QMAKE_RPATHDIR += $${LibKY_Lib_Dir}
+
+HEADERS += \
+    ky_test.h
+
+SOURCES += \
+    main.cpp \
+    alloc_count.cpp \
+    tst_u8string.cpp \
+    tst_regex_dfa.cpp \
+    tst_debug.cpp \
+    tst_move.cpp \
+    tst_lockfree_stack.cpp \
+    tst_stringview.cpp \
+    tst_number.cpp \
+    tst_url_view.cpp
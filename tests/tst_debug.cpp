@@ -0,0 +1,60 @@
+#include "ky_test.h"
+#include "ky_debug.h"
+#include <unistd.h>
+
+// 后台报告线程在静态析构时才退出，日志对象须活得更久
+static ky_debug &logger()
+{
+    static ky_debug dbg;
+    return dbg;
+}
+
+static int admitted(ky_debug::site &s, int n)
+{
+    int k = 0;
+    for (int i = 0; i < n; ++i)
+        k += s.pass () ? 1 : 0;
+    return k;
+}
+
+static ky_debug::filter line_filter(int line)
+{
+    ky_debug::filter f;
+    memset (&f, 0, sizeof(f));
+    f.line = line;
+    return f;
+}
+
+kyTestCase(debug_limit_rate)
+{
+    logger ();
+    static ky_debug::site s = kyLogSite;
+    kyTestCheck(admitted (s, 1000) == 1000);
+
+    // 规则加入前已匹配过的调用点也要按新规则限流
+    const ky_debug::limit l = {10, 1000, 5, 0};
+    const int h = ky_debug::append (line_filter (s.line), l);
+    kyTestCheck(admitted (s, 1000) == 5);
+    kyTestCheck(s.dropped == 995);
+
+    // 之后不再输出，丢弃计数由后台线程定时报告
+    usleep (kyLogFlushPeriod * 1500);
+    kyTestCheck(s.dropped == 0);
+
+    ky_debug::remove_limit (h);
+    kyTestCheck(admitted (s, 1000) == 1000);
+}
+
+kyTestCase(debug_limit_sample)
+{
+    logger ();
+    static ky_debug::site s = kyLogSite;
+    const ky_debug::limit l = {0, 0, 0, 10};
+    ky_debug::append (line_filter (s.line), l);
+    kyTestCheck(admitted (s, 1000) == 100);
+    kyTestCheck(s.skipped == 900);
+    ky_debug::flush_limit ();
+    kyTestCheck(s.skipped == 0);
+    ky_debug::clear_limit ();
+    kyTestCheck(admitted (s, 1000) == 1000);
+}
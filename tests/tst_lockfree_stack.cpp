@@ -0,0 +1,110 @@
+#include "ky_test.h"
+#include "ky_lockfree_stack.h"
+#include <thread>
+#include <vector>
+
+struct hooked;
+static void (*on_next)() = NULL;
+
+//! 读取next时执行一次on_next，用于在pop读取next与CAS之间插入其他操作
+struct hooked_next
+{
+    hooked *p;
+
+    operator hooked *()const
+    {
+        hooked *v = p;
+        if (on_next)
+        {
+            void (*f)() = on_next;
+            on_next = NULL;
+            f ();
+        }
+        return v;
+    }
+    hooked_next &operator = (hooked *v){p = v; return *this;}
+};
+
+struct hooked
+{
+    hooked_next next;
+    char name;
+};
+
+static ky_lockfree_stack<hooked> *aba_stack = NULL;
+static hooked *aba_a = NULL;
+
+static void aba_interleave()
+{
+    // 其他线程弹出A、B后再压回A，栈顶地址与之前相同
+    hooked *a = aba_stack->pop ();
+    aba_stack->pop ();
+    aba_stack->push (a);
+    aba_a = a;
+}
+
+kyTestCase(lockfree_stack_aba)
+{
+    hooked a = {{NULL}, 'a'}, b = {{NULL}, 'b'}, c = {{NULL}, 'c'};
+    ky_lockfree_stack<hooked> s;
+    s.push (&c);
+    s.push (&b);
+    s.push (&a);
+    aba_stack = &s;
+    on_next = aba_interleave;
+
+    // pop读到栈顶A及A的next为B，之后栈变为A->C；
+    // 只比较地址时交换会成功并把已弹出的B放回栈顶
+    hooked *first = s.pop ();
+    kyTestCheck(aba_a == &a);
+    kyTestCheck(first == &a);
+    hooked *second = s.pop ();
+    kyTestCheck(second == &c);
+    kyTestCheck(s.pop () == NULL);
+    kyTestCheck(s.count () == 0);
+}
+
+struct owned : ky_lockfree_node
+{
+    ky_atomic<int> owner;
+};
+
+kyTestCase(lockfree_stack_churn)
+{
+    enum {Nodes = 64, Threads = 4, Rounds = 200000};
+    static owned nodes[Nodes];
+    ky_lockfree_stack<owned> s;
+    for (int i = 0; i < Nodes; ++i)
+    {
+        nodes[i].owner = 0;
+        s.push (&nodes[i]);
+    }
+
+    // 同一节点不能同时被两个线程弹出
+    ky_atomic<int> conflicts(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < Threads; ++t)
+    {
+        workers.push_back (std::thread([&s, &conflicts, t]()
+        {
+            for (int i = 0; i < Rounds; ++i)
+            {
+                owned *n = s.pop ();
+                if (n == NULL)
+                    continue;
+                if (!n->owner.compare_exchange (0, t + 1))
+                    conflicts++;
+                n->owner = 0;
+                s.push (n);
+            }
+        }));
+    }
+    for (size_t i = 0; i < workers.size (); ++i)
+        workers[i].join ();
+
+    kyTestCheck(conflicts == 0);
+    int recovered = 0;
+    while (s.pop ())
+        ++recovered;
+    kyTestCheck(recovered == Nodes);
+}
@@ -0,0 +1,150 @@
+#include "ky_test.h"
+#include "ky_list.h"
+#include "ky_array.h"
+#include "ky_vector.h"
+#include "ky_linked.h"
+#include "ky_queue.h"
+#include "ky_stack.h"
+
+// 记录拷贝、移动及析构次数的元素
+struct counted
+{
+    static int copies;
+    static int moves;
+    static int alive;
+
+    int value;
+
+    counted(int v = 0):value(v){++alive;}
+    counted(const counted &rhs):value(rhs.value){++copies; ++alive;}
+    counted(counted &&rhs):value(rhs.value){rhs.value = -1; ++moves; ++alive;}
+    ~counted(){--alive;}
+    counted &operator = (const counted &rhs){value = rhs.value; ++copies; return *this;}
+    counted &operator = (counted &&rhs){value = rhs.value; rhs.value = -1; ++moves; return *this;}
+    bool operator == (const counted &rhs)const{return value == rhs.value;}
+    bool operator != (const counted &rhs)const{return value != rhs.value;}
+
+    static void reset(){copies = 0; moves = 0;}
+};
+int counted::copies = 0;
+int counted::moves = 0;
+int counted::alive = 0;
+
+kyTestCase(move_list)
+{
+    counted::reset ();
+    {
+        ky_list<counted> l;
+        for (int i = 0; i < 100; ++i)
+            l.append (counted(i));
+        for (int i = 0; i < 100; ++i)
+            l.emplace_back (100 + i);
+        kyTestCheck(l.count () == 200);
+        kyTestCheck(l.at (150).value == 150);
+        kyTestCheck(counted::copies == 0);
+
+        ky_list<counted> m(std::move (l));
+        kyTestCheck(m.count () == 200);
+        kyTestCheck(counted::copies == 0);
+    }
+    kyTestCheck(counted::alive == 0);
+}
+
+kyTestCase(move_array)
+{
+    counted::reset ();
+    {
+        ky_array<counted> a;
+        for (int i = 0; i < 100; ++i)
+            a.append (counted(i));
+        for (int i = 0; i < 100; ++i)
+            a.emplace_back (100 + i);
+        kyTestCheck(a.size () == 200);
+        kyTestCheck(a[150].value == 150);
+        kyTestCheck(counted::copies == 0);
+
+        ky_array<counted> b(std::move (a));
+        kyTestCheck(b.size () == 200);
+        kyTestCheck(counted::copies == 0);
+    }
+    kyTestCheck(counted::alive == 0);
+}
+
+kyTestCase(move_vector)
+{
+    counted::reset ();
+    {
+        ky_vector<counted> v;
+        for (int i = 0; i < 100; ++i)
+            v.push_back (counted(i));
+        for (int i = 0; i < 100; ++i)
+            v.emplace_back (100 + i);
+        kyTestCheck(v.size () == 200);
+        kyTestCheck(v[150].value == 150);
+        kyTestCheck(counted::copies == 0);
+
+        ky_vector<counted> w(std::move (v));
+        kyTestCheck(w.size () == 200);
+        kyTestCheck(counted::copies == 0);
+    }
+    kyTestCheck(counted::alive == 0);
+}
+
+kyTestCase(move_linked)
+{
+    counted::reset ();
+    {
+        ky_linked<counted> l;
+        for (int i = 0; i < 100; ++i)
+            l.append (counted(i));
+        for (int i = 0; i < 100; ++i)
+            l.emplace_front (-i);
+        kyTestCheck(l.count () == 200);
+        kyTestCheck(counted::copies == 0);
+
+        ky_linked<counted> m(std::move (l));
+        kyTestCheck(m.count () == 200);
+        kyTestCheck(counted::copies == 0);
+    }
+    kyTestCheck(counted::alive == 0);
+}
+
+kyTestCase(move_queue_stack)
+{
+    counted::reset ();
+    {
+        ky_queue<counted> q;
+        ky_stack<counted> s;
+        for (int i = 0; i < 50; ++i)
+        {
+            q.push (counted(i));
+            s.emplace (i);
+        }
+        int order = 0;
+        for (int i = 0; i < 50; ++i)
+        {
+            order += q.pop ().value == i ? 1 : 0;
+            order += s.pop ().value == 49 - i ? 1 : 0;
+        }
+        kyTestCheck(order == 100);
+        kyTestCheck(counted::copies == 0);
+    }
+    kyTestCheck(counted::alive == 0);
+}
+
+kyTestCase(move_shared_detach)
+{
+    // 共享的数据在修改前分离，此时才发生拷贝
+    counted::reset ();
+    {
+        ky_vector<counted> v;
+        for (int i = 0; i < 10; ++i)
+            v.emplace_back (i);
+        ky_vector<counted> w = v;
+        kyTestCheck(counted::copies == 0);
+        w.emplace_back (10);
+        kyTestCheck(counted::copies == 10);
+        kyTestCheck(v.size () == 10 && w.size () == 11);
+    }
+    kyTestCheck(counted::alive == 0);
+}
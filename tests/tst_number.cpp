@@ -0,0 +1,118 @@
+#include "ky_test.h"
+#include "ky_number.h"
+#include <random>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+// 随机位模式覆盖全部指数及非规格化数，跳过inf和nan
+static real random_double(std::mt19937_64 &rng)
+{
+    for (;;)
+    {
+        const uint64 bits = rng ();
+        real v;
+        memcpy (&v, &bits, sizeof(v));
+        if (std::isfinite (v))
+            return v;
+    }
+}
+
+kyTestCase(number_real_roundtrip)
+{
+    std::mt19937_64 rng(46);
+    int mismatched = 0, unparsed = 0, strtod_differs = 0;
+    for (int i = 0; i < 200000; ++i)
+    {
+        const real v = random_double (rng);
+        char buf[ky_number::RealSize + 1];
+        const int n = ky_number::format (v, buf);
+        buf[n] = 0;
+
+        real back = 0;
+        if (ky_number::parse (buf, n, back) != n)
+            ++unparsed;
+        else if (memcmp (&back, &v, sizeof(v)) != 0)
+            ++mismatched;
+        // 输出的文本由strtod读回也应为同一个值
+        const real ref = strtod (buf, NULL);
+        if (memcmp (&ref, &v, sizeof(v)) != 0)
+            ++strtod_differs;
+    }
+    kyTestCheck(unparsed == 0);
+    kyTestCheck(mismatched == 0);
+    kyTestCheck(strtod_differs == 0);
+}
+
+kyTestCase(number_real_parse_matches_strtod)
+{
+    // 随机的十进制文本，解析结果与strtod一致
+    std::mt19937_64 rng(4646);
+    int differs = 0;
+    for (int i = 0; i < 100000; ++i)
+    {
+        char buf[64];
+        const int digits = 1 + (int)(rng () % 19);
+        int k = 0;
+        if (rng () & 1)
+            buf[k++] = '-';
+        for (int d = 0; d < digits; ++d)
+        {
+            buf[k++] = (char)('0' + rng () % 10);
+            if (d == 0 && (rng () & 1))
+                buf[k++] = '.';
+        }
+        k += snprintf (buf + k, sizeof(buf) - k, "e%d", (int)(rng () % 640) - 330);
+
+        real v = 0;
+        const int used = ky_number::parse (buf, k, v);
+        const real ref = strtod (buf, NULL);
+        if (used != k || memcmp (&v, &ref, sizeof(v)) != 0)
+            ++differs;
+    }
+    kyTestCheck(differs == 0);
+}
+
+kyTestCase(number_float_roundtrip)
+{
+    std::mt19937 rng(46);
+    int mismatched = 0;
+    for (int i = 0; i < 200000; ++i)
+    {
+        const uint32 bits = rng ();
+        float v;
+        memcpy (&v, &bits, sizeof(v));
+        if (!std::isfinite (v))
+            continue;
+        char buf[ky_number::RealSize + 1];
+        const int n = ky_number::format (v, buf);
+        float back = 0;
+        if (ky_number::parse (buf, n, back) != n || memcmp (&back, &v, sizeof(v)) != 0)
+            ++mismatched;
+    }
+    kyTestCheck(mismatched == 0);
+}
+
+kyTestCase(number_integer_roundtrip)
+{
+    std::mt19937_64 rng(460);
+    int mismatched = 0;
+    for (int i = 0; i < 200000; ++i)
+    {
+        const longlong v = (longlong)(rng () >> (rng () % 64));
+        const longlong s = (i & 1) ? (longlong)(0 - (ulonglong)v) : v;
+        const int radix = (i % 7 == 0) ? 2 + (int)(rng () % 35) : 10;
+        char buf[ky_number::IntegerSize + 1];
+        const int n = ky_number::format (s, buf, radix);
+        longlong back = 0;
+        if (ky_number::parse (buf, n, back, radix) != n || back != s)
+            ++mismatched;
+    }
+    kyTestCheck(mismatched == 0);
+
+    // 溢出返回0
+    longlong big = 0;
+    kyTestCheck(ky_number::parse ("9223372036854775808", 19, big) == 0);
+    kyTestCheck(ky_number::parse ("-9223372036854775808", 20, big) == 20);
+    kyTestCheck(big == (longlong)((ulonglong)1 << 63));
+}
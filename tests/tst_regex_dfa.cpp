@@ -0,0 +1,100 @@
+#include "ky_test.h"
+#include "ky_regex_dfa.h"
+#include <regex>
+#include <random>
+#include <string>
+
+// 每个起始位置的首个匹配及整体匹配都与std::regex(ECMAScript)一致
+static bool same_as_std(const char *pat, const std::string &txt)
+{
+    ky_regex_dfa r(pat);
+    if (!r.is_valid ())
+        return false;
+    std::regex sr(pat);
+    for (size_t from = 0; from <= txt.size (); ++from)
+    {
+        size_t pos = 0, len = 0;
+        const bool found = r.find (txt.data (), txt.size (), from, pos, len);
+        std::smatch m;
+        const std::regex_constants::match_flag_type fl = from ?
+                    std::regex_constants::match_prev_avail : std::regex_constants::match_default;
+        const bool expect = std::regex_search (txt.cbegin () + from, txt.cend (), m, sr, fl);
+        if (found != expect)
+            return false;
+        if (found && (pos != (size_t)m.position () + from || len != (size_t)m.length ()))
+            return false;
+    }
+    return (r.match (txt.c_str ()) != 0) == std::regex_match (txt, sr);
+}
+
+kyTestCase(regex_dfa_fixed)
+{
+    static const char *pats[] =
+    {
+        "a", "ab", "a|b", "a*", "a+", "a?b", "(a|ab)(c|bcd)(d*)", "[a-c]+", "[^a]+",
+        "a{2,3}", "a{2,}", "a*?b", "(ab)+", "\\bab\\b", "\\Bb", "^ab", "ab$", "^$",
+        "(a|b)*c", "\\d+", "\\w+\\s", "(?:a|b)+?c", "a.c", "abc|abd|ab", "(a*)*b", "(a|)+b"
+    };
+    static const char *txts[] =
+    {
+        "", "a", "ab", "abc", "aab", "abcd", "aaaab", "xabcdx", "ab ab ab",
+        "abbbc", "a-b_c 123 d", "aXc a\nc", "ba", "bba"
+    };
+    for (size_t i = 0; i < sizeof(pats) / sizeof(pats[0]); ++i)
+        for (size_t k = 0; k < sizeof(txts) / sizeof(txts[0]); ++k)
+            kyTestCheck(same_as_std (pats[i], txts[k]));
+}
+
+kyTestCase(regex_dfa_random)
+{
+    static const char *atoms[] = {"a", "b", "c", ".", "[ab]", "[^a]", "(a|b)", "(ab|a)", "(?:b|)"};
+    static const char *quants[] = {"", "", "", "*", "+", "?", "*?", "+?", "{1,2}", "??"};
+    std::mt19937 rng(1);
+    int fails = 0;
+    for (int k = 0; k < 2000; ++k)
+    {
+        std::string p;
+        for (int i = 0, n = 1 + rng () % 4; i < n; ++i)
+        {
+            p += atoms[rng () % 9];
+            p += quants[rng () % 10];
+        }
+        if (rng () % 4 == 0)
+            p += std::string("|") + atoms[rng () % 9];
+        std::string t;
+        for (int i = 0, m = rng () % 8; i < m; ++i)
+            t += "abc "[rng () % 4];
+        if (!same_as_std (p.c_str (), t))
+            ++fails;
+    }
+    kyTestCheck(fails == 0);
+}
+
+kyTestCase(regex_dfa_linear)
+{
+    // 回溯引擎在此为指数时间
+    const std::string xs(50000, 'x');
+    ky_regex_dfa r("(x+x+)+y");
+    kyTestCheck(!r.contains (xs.data (), xs.size ()));
+}
+
+kyTestCase(regex_dfa_from_regex)
+{
+    ky_regex r(ky_string("ab+c"));
+    ky_regex_dfa d(r);
+    kyTestCheck(d.regex () == r.regex ());
+    kyTestCheck(d.match ("abbc") == 1);
+    kyTestCheck(d.match ("ac") == 0);
+}
+
+kyTestCase(regex_set_match)
+{
+    ky_regex_set set;
+    kyTestCheck(set.append ("foo") == 0);
+    kyTestCheck(set.append ("ba+r") == 1);
+    kyTestCheck(set.append ("\\d{3}") == 2);
+    kyTestCheck(set.compile ());
+    kyTestCheck(set.match ("xx baaar 12") == 1);
+    kyTestCheck(set.match ("foo 123 bar") == 3);
+    kyTestCheck(!set.contains (ky_u8stringview("nothing")));
+}
@@ -0,0 +1,99 @@
+#include "ky_test.h"
+#include "ky_string.h"
+#include "ky_u8string.h"
+#include <string>
+
+// 每行为"  key_i = i  "，取出各值求和
+template <typename V>
+static longlong tokenize(typename V::splitter rows, typename V::char_type equal, int &lines)
+{
+    longlong sum = 0;
+    lines = 0;
+    V line;
+    while (rows.next (line))
+    {
+        const int eq = line.find (equal);
+        if (eq < 0 || line.start (eq).trimmed ().count () < 5)
+            continue;
+        sum += line.extract (eq + 1).trimmed ().to_longlong ();
+        ++lines;
+    }
+    return sum;
+}
+
+static std::string config_text(int lines, longlong &sum)
+{
+    std::string text;
+    sum = 0;
+    for (int i = 0; i < lines; ++i)
+    {
+        text += "  key_" + std::to_string (i) + " = " + std::to_string (i * 7) + "  \n";
+        sum += i * 7;
+    }
+    return text;
+}
+
+kyTestCase(stringview_alloc_counter)
+{
+    // 计数本身可用，下面的零分配检查才有意义
+    const long before = ky_test::allocations ();
+    void *volatile p = malloc (16);
+    free (p);
+    if (before >= 0)
+        kyTestCheck(ky_test::allocations () == before + 1);
+}
+
+kyTestCase(stringview_tokenize_u8)
+{
+    longlong expect = 0;
+    const std::string text = config_text (20000, expect);
+    const ky_u8string s(text);
+
+    int lines = 0;
+    const long before = ky_test::allocations ();
+    const longlong sum = tokenize<ky_u8stringview> (s.split_view ('\n', true), '=', lines);
+    const long after = ky_test::allocations ();
+    kyTestCheck(lines == 20000);
+    kyTestCheck(sum == expect);
+    if (before >= 0)
+        kyTestCheck(after == before);
+}
+
+kyTestCase(stringview_tokenize_utf16)
+{
+    longlong expect = 0;
+    const std::string text = config_text (20000, expect);
+    const ky_string s = ky_u8string(text).to_string ();
+
+    int lines = 0;
+    const long before = ky_test::allocations ();
+    const longlong sum = tokenize<ky_stringview> (s.split_view ((uint16)'\n', true), '=', lines);
+    const long after = ky_test::allocations ();
+    kyTestCheck(lines == 20000);
+    kyTestCheck(sum == expect);
+    if (before >= 0)
+        kyTestCheck(after == before);
+}
+
+kyTestCase(stringview_split_matches_std)
+{
+    const char *texts[] = {"", ",", "a", "a,b", ",a,,b,", "abc,,def,g,"};
+    for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); ++i)
+    {
+        const std::string t(texts[i]);
+        std::string joined;
+        ky_u8stringview::splitter sp = ky_u8stringview(texts[i]).split (',');
+        ky_u8stringview tok;
+        int n = 0;
+        while (sp.next (tok))
+        {
+            joined += (n++ ? "|" : "") + std::string(tok.data (), tok.length ());
+        }
+        // 按逗号分割后再以|连接，与替换逗号的结果相同
+        std::string expect = t;
+        for (size_t k = 0; k < expect.size (); ++k)
+            if (expect[k] == ',')
+                expect[k] = '|';
+        kyTestCheck(joined == expect);
+    }
+}
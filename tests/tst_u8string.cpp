@@ -0,0 +1,48 @@
+#include "ky_test.h"
+#include "ky_u8string.h"
+
+static bool equal(const ky_u8string &s, const char *v)
+{
+    return s.count () == (int)strlen (v) && memcmp (s.data (), v, s.size ()) == 0;
+}
+
+kyTestCase(u8string_clear)
+{
+    ky_u8string s("abc");
+    s.clear ();
+    kyTestCheck(s.count () == 0);
+
+    // 超出内联缓冲，位于内存块中并被共享
+    ky_u8string l("0123456789abcdefghijklmnop");
+    ky_u8string c = l;
+    c.clear ();
+    kyTestCheck(c.count () == 0);
+    kyTestCheck(equal (l, "0123456789abcdefghijklmnop"));
+}
+
+kyTestCase(u8string_reassign)
+{
+    ky_u8string s("hello");
+    s = "ab";
+    kyTestCheck(equal (s, "ab"));
+    s = std::string("xyz");
+    kyTestCheck(equal (s, "xyz"));
+
+    ky_u8string l("0123456789abcdefghijklmnop");
+    l = "q";
+    kyTestCheck(equal (l, "q"));
+}
+
+kyTestCase(u8string_format)
+{
+    ky_u8string f;
+    f.format ("%d", 7);
+    f.format ("%d", 7);
+    kyTestCheck(equal (f, "7"));
+
+    ky_u8string g("abc");
+    g.form (42);
+    kyTestCheck(equal (g, "42"));
+    g.form ((ulonglong)255, 16);
+    kyTestCheck(g.count () == 2);
+}
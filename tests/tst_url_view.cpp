@@ -0,0 +1,106 @@
+#include "ky_test.h"
+#include "ky_url_view.h"
+#include "ky_u8string.h"
+#include <random>
+#include <string>
+
+static ky_string to_string(const std::string &s)
+{
+    return ky_u8string(s).to_string ();
+}
+
+kyTestCase(url_view_components)
+{
+    const ky_url_view u(to_string ("HTTP://user:pw@Example.COM:8080/a/b?x=1#top"));
+    kyTestCheck(u.is_valid ());
+    kyTestCheck(u.protocol () == Protocol_Http);
+    kyTestCheck(u.scheme () == ky_string("http"));
+    kyTestCheck(u.username () == ky_string("user"));
+    kyTestCheck(u.password () == ky_string("pw"));
+    kyTestCheck(u.host () == ky_string("Example.COM"));
+    kyTestCheck(u.port_number () == 8080);
+    kyTestCheck(u.path () == ky_string("/a/b"));
+    kyTestCheck(u.query () == ky_string("x=1"));
+    kyTestCheck(u.fragment () == ky_string("top"));
+
+    const ky_url_view f(to_string ("/tmp/data.bin"));
+    kyTestCheck(f.protocol () == Protocol_File);
+    kyTestCheck(f.path () == ky_string("/tmp/data.bin"));
+    kyTestCheck(!f.has (Url_Query));
+
+    // 主机中的':'使端口无效，不按最后一个':'分割
+    kyTestCheck(!ky_url_view(to_string ("http://a:b:80/")).is_valid ());
+    const ky_url_view p(to_string ("http://h:/x"));
+    kyTestCheck(p.is_valid () && p.host () == ky_string("h") && p.port_number () == 80);
+
+    const ky_url_view e(to_string ("http://h/?"));
+    kyTestCheck(e.has (Url_Query) && e.view (Url_Query).is_empty ());
+}
+
+kyTestCase(url_view_normalized)
+{
+    const ky_url_view a(to_string ("HTTP://Example.COM:80/a/./b/../c/%7euser?q=%2f"));
+    const ky_url_view b(to_string ("http://example.com/a/c/~user?q=%2F"));
+    kyTestCheck(a.normalized () == b);
+    kyTestCheck(a.equivalent (b));
+    kyTestCheck(!a.equivalent (ky_url_view(to_string ("http://example.com/a/c/~User?q=%2F"))));
+    kyTestCheck(ky_url_view::decode (to_string ("a%20b").view ()) == ky_string("a b"));
+}
+
+kyTestCase(url_view_to_url)
+{
+    const ky_url u(to_string ("http://example.com/index.html"));
+    const ky_url_view v(u);
+    kyTestCheck(v.host () == ky_string("example.com"));
+    kyTestCheck(v.to_url ().url () == u.url ());
+}
+
+// 各部分的视图都在原串内，并按URL中的顺序排列
+static bool spans_ordered(const ky_url_view &u)
+{
+    const ky_stringview all = u.url ().view ();
+    const uint16 *lo = all.data (), *hi = all.data () + all.count ();
+    static const eUrlComponents order[] =
+    {Url_Username, Url_Password, Url_Host, Url_Port, Url_Path, Url_Query, Url_Fragment};
+    const uint16 *last = lo;
+    for (size_t i = 0; i < sizeof(order) / sizeof(order[0]); ++i)
+    {
+        if (!u.has (order[i]))
+            continue;
+        const ky_stringview v = u.view (order[i]);
+        if (v.count () == 0)
+            continue;
+        if (v.data () < last || v.data () + v.count () > hi)
+            return false;
+        last = v.data () + v.count ();
+    }
+    return true;
+}
+
+kyTestCase(url_view_fuzz)
+{
+    static const char alphabet[] = "abcAB019:/?#@[]%.-_~+=&";
+    static const char *prefixes[] = {"", "http://", "https://", "file://", "ftp://u:p@", "mailto:", "C:", "//"};
+    std::mt19937 rng(50);
+    int bad_span = 0, not_idempotent = 0, not_equivalent = 0;
+    for (int i = 0; i < 100000; ++i)
+    {
+        std::string s = prefixes[rng () % (sizeof(prefixes) / sizeof(prefixes[0]))];
+        for (int k = 0, n = (int)(rng () % 24); k < n; ++k)
+            s += alphabet[rng () % (sizeof(alphabet) - 1)];
+
+        const ky_url_view u(to_string (s));
+        if (!spans_ordered (u))
+            ++bad_span;
+        if (!u.is_valid ())
+            continue;
+        const ky_url_view n = u.normalized ();
+        if (!(n.normalized () == n))
+            ++not_idempotent;
+        if (!u.equivalent (n))
+            ++not_equivalent;
+    }
+    kyTestCheck(bad_span == 0);
+    kyTestCheck(not_idempotent == 0);
+    kyTestCheck(not_equivalent == 0);
+}